@@ -303,6 +303,35 @@ dma_chunk_is_huge(struct bio_dma_chunk *chunk)
 	return d_list_empty(&chunk->bdc_link);
 }
 
+void
+ioctxt_decomp_fini(struct bio_io_context *ctxt)
+{
+	int	i;
+
+	for (i = 0; i < COMPRESS_TYPE_END; i++)
+		daos_compressor_destroy(&ctxt->bic_decomp[i]);
+}
+
+static void
+iod_free_decomp_bufs(struct bio_desc *biod)
+{
+	struct bio_sglist	*bsgl;
+	struct bio_iov		*biov;
+	int			 i, j;
+
+	for (i = 0; i < biod->bd_sgl_cnt; i++) {
+		bsgl = &biod->bd_sgls[i];
+
+		for (j = 0; j < bsgl->bs_nr_out; j++) {
+			biov = &bsgl->bs_iovs[j];
+			if (BIO_ADDR_IS_DECOMP_BUF(&biov->bi_addr)) {
+				D_FREE(biov->bi_buf);
+				biov->bi_addr.ba_flags &= ~BIO_FLAG_DECOMP_BUF;
+			}
+		}
+	}
+}
+
 /*
  * Release all the DMA chunks held by @biod, once the use count of any
  * chunk drops to zero, put it back to free list.
@@ -314,6 +343,10 @@ iod_release_buffer(struct bio_desc *biod)
 	struct bio_rsrvd_dma *rsrvd_dma = &biod->bd_rsrvd;
 	int i;
 
+	/* Release decompression buffers */
+	if (biod->bd_compressed)
+		iod_free_decomp_bufs(biod);
+
 	/* Release bulk handles */
 	bulk_iod_release(biod);
 
@@ -1333,6 +1366,70 @@ out:
 	return rc;
 }
 
+static int
+check_compressed_one(struct bio_desc *biod, struct bio_iov *biov, void *arg)
+{
+	if (BIO_ADDR_IS_COMPRESSED(&biov->bi_addr) && !bio_addr_is_hole(&biov->bi_addr)) {
+		D_ASSERT(biod->bd_type == BIO_IOD_TYPE_FETCH);
+		biod->bd_compressed = 1;
+		return 1;
+	}
+	return 0;
+}
+
+static int
+decompress_one(struct bio_desc *biod, struct bio_iov *biov, void *arg)
+{
+	struct bio_io_context	*ctxt = biod->bd_ctxt;
+	struct daos_compressor	*decomp;
+	uint8_t			 ctype = biov->bi_addr.ba_ctype;
+	void			*buf;
+	size_t			 produced = 0;
+	int			 rc;
+
+	if (!BIO_ADDR_IS_COMPRESSED(&biov->bi_addr) || bio_addr_is_hole(&biov->bi_addr))
+		return 0;
+
+	if (ctype == COMPRESS_TYPE_UNKNOWN || ctype >= COMPRESS_TYPE_END) {
+		D_ERROR("Invalid compression type %u\n", ctype);
+		return -DER_INVAL;
+	}
+
+	decomp = ctxt->bic_decomp[ctype];
+	if (decomp == NULL) {
+		rc = daos_compressor_init_with_type(&decomp, ctype, false, 0);
+		if (rc) {
+			D_ERROR("Failed to init decompressor %u. "DF_RC"\n", ctype, DP_RC(rc));
+			return rc;
+		}
+		ctxt->bic_decomp[ctype] = decomp;
+	}
+
+	D_ALLOC(buf, biov->bi_data_len);
+	if (buf == NULL)
+		return -DER_NOMEM;
+
+	rc = daos_compressor_decompress(decomp, bio_iov2raw_buf(biov), biov->bi_addr.ba_csize,
+					buf, biov->bi_data_len, &produced);
+	if (rc == 0 && produced != biov->bi_data_len) {
+		D_ERROR("Decompressed "DF_U64" bytes, expected "DF_U64"\n",
+			(uint64_t)produced, (uint64_t)biov->bi_data_len);
+		rc = -DER_CSUM;
+	}
+	if (rc) {
+		D_ERROR("Failed to decompress extent "DF_X64". "DF_RC"\n",
+			biov->bi_addr.ba_off, DP_RC(rc));
+		D_FREE(buf);
+		return rc;
+	}
+
+	/* From now on, the biov looks like a plain extent cached in DRAM */
+	BIO_ADDR_CLEAR_COMPRESSED(&biov->bi_addr);
+	biov->bi_addr.ba_flags |= BIO_FLAG_DECOMP_BUF;
+	bio_iov_set_raw_buf(biov, buf);
+	return 0;
+}
+
 int
 bio_iod_prep(struct bio_desc *biod, unsigned int type, void *bulk_ctxt,
 	     unsigned int bulk_perm)
@@ -1349,7 +1446,15 @@ bio_iod_prep(struct bio_desc *biod, unsigned int type, void *bulk_ctxt,
 	/* For rebuild pull, the DMA buffer will be used as RDMA client */
 	biod->bd_rdma = (bulk_ctxt != NULL) || (type == BIO_CHK_TYPE_REBUILD);
 
-	if (bulk_ctxt != NULL && !(daos_io_bypass & IOBP_SRV_BULK_CACHE)) {
+	if (biod->bd_type == BIO_IOD_TYPE_FETCH)
+		iterate_biov(biod, check_compressed_one, NULL);
+
+	/*
+	 * Data of compressed extent is transferred from the decompression
+	 * buffer, bypass bulk cache since it maps media data only.
+	 */
+	if (bulk_ctxt != NULL && !(daos_io_bypass & IOBP_SRV_BULK_CACHE) &&
+	    !biod->bd_compressed) {
 		bulk_arg.ba_bulk_ctxt = bulk_ctxt;
 		bulk_arg.ba_bulk_perm = bulk_perm;
 		bulk_arg.ba_sgl_idx = 0;
@@ -1361,8 +1466,14 @@ bio_iod_prep(struct bio_desc *biod, unsigned int type, void *bulk_ctxt,
 		return rc;
 
 	/* All direct SCM access, no DMA buffer prepared */
-	if (biod->bd_rsrvd.brd_rg_cnt == 0)
-		return 0;
+	if (biod->bd_rsrvd.brd_rg_cnt == 0) {
+		if (biod->bd_compressed) {
+			rc = iterate_biov(biod, decompress_one, NULL);
+			if (rc)
+				iod_release_buffer(biod);
+		}
+		return rc;
+	}
 
 	bdb = iod_dma_buf(biod);
 	bdb->bdb_active_iods++;
@@ -1388,6 +1499,12 @@ bio_iod_prep(struct bio_desc *biod, unsigned int type, void *bulk_ctxt,
 		goto failed;
 	}
 
+	if (biod->bd_compressed) {
+		rc = iterate_biov(biod, decompress_one, NULL);
+		if (rc)
+			goto failed;
+	}
+
 	return 0;
 failed:
 	iod_release_buffer(biod);
@@ -625,6 +625,7 @@ bio_ioctxt_close(struct bio_io_context *ctxt, bool skip_blob)
 	/* NVMe isn't configured or pool doesn't have NVMe partition */
 	if (!bio_nvme_configured() || skip_blob) {
 		d_list_del_init(&ctxt->bic_link);
+		ioctxt_decomp_fini(ctxt);
 		D_FREE(ctxt);
 		return 0;
 	}
@@ -637,6 +638,7 @@ bio_ioctxt_close(struct bio_io_context *ctxt, bool skip_blob)
 
 	/* Free the io context no matter if close succeeded */
 	d_list_del_init(&ctxt->bic_link);
+	ioctxt_decomp_fini(ctxt);
 	D_FREE(ctxt);
 	bio_bs_unhold(xs_ctxt->bxc_blobstore);
 
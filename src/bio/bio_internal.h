@@ -7,6 +7,7 @@
 #ifndef __BIO_INTERNAL_H__
 #define __BIO_INTERNAL_H__
 
+#include <daos/compression.h>
 #include <daos_srv/daos_engine.h>
 #include <daos_srv/bio.h>
 #include <gurt/telemetry_common.h>
@@ -378,6 +379,8 @@ struct bio_io_context {
 	uint32_t		 bic_inflight_dmas;
 	uint32_t		 bic_io_unit;
 	uuid_t			 bic_pool_id;
+	/* Decompressors for compressed extents, created on demand */
+	struct daos_compressor	*bic_decomp[COMPRESS_TYPE_END];
 	unsigned int		 bic_opening:1,
 				 bic_closing:1;
 };
@@ -432,7 +435,8 @@ struct bio_desc {
 				 bd_retry:1,
 				 bd_rdma:1,
 				 bd_copy_dst:1,
-				 bd_in_fifo:1;
+				 bd_in_fifo:1,
+				 bd_compressed:1;
 	/* Cached bulk handles being used by this IOD */
 	struct bio_bulk_hdl    **bd_bulk_hdls;
 	unsigned int		 bd_bulk_max;
@@ -577,6 +581,9 @@ dma_biov2pg(struct bio_iov *biov, uint64_t *off, uint64_t *end,
 	D_ASSERT(*pg_cnt > 0);
 }
 
+/* bio_buffer.c */
+void ioctxt_decomp_fini(struct bio_io_context *ctxt);
+
 /* bio_bulk.c */
 int bulk_map_one(struct bio_desc *biod, struct bio_iov *biov, void *data);
 void bulk_iod_release(struct bio_desc *biod);
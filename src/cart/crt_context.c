@@ -127,11 +127,353 @@ crt_context_ep_empty(crt_context_t crt_ctx)
 	return rc == 0;
 }
 
+/* Initialize an empty wheel whose next tick to expire is \a tick */
+void
+crt_tw_init(struct crt_timer_wheel *tw, uint64_t tick)
+{
+	int	i;
+	int	j;
+
+	for (i = 0; i < CRT_TW_LEVELS; i++)
+		for (j = 0; j < CRT_TW_SLOTS; j++)
+			D_INIT_LIST_HEAD(&tw->tw_slots[i][j]);
+	D_INIT_LIST_HEAD(&tw->tw_due);
+	tw->tw_tick = tick;
+	tw->tw_nr = 0;
+}
+
+/* Link \a rpc_priv to the slot of its deadline, O(1) */
+static void
+crt_tw_link(struct crt_timer_wheel *tw, struct crt_rpc_priv *rpc_priv)
+{
+	uint64_t	tick = rpc_priv->crp_timeout_ts >> CRT_TW_TICK_SHIFT;
+	uint64_t	delta;
+	int		lvl;
+
+	if (tick < tw->tw_tick) {
+		d_list_add_tail(&rpc_priv->crp_timeout_link, &tw->tw_due);
+		return;
+	}
+
+	delta = tick - tw->tw_tick;
+	for (lvl = 0; lvl < CRT_TW_LEVELS - 1; lvl++) {
+		if (delta < (1ULL << ((lvl + 1) * CRT_TW_SLOT_BITS)))
+			break;
+	}
+	/* beyond the wheel span, park it in the farthest slot */
+	if (delta >= (1ULL << (CRT_TW_LEVELS * CRT_TW_SLOT_BITS)))
+		tick = tw->tw_tick + (1ULL << (CRT_TW_LEVELS * CRT_TW_SLOT_BITS)) - 1;
+
+	d_list_add_tail(&rpc_priv->crp_timeout_link,
+			&tw->tw_slots[lvl][(tick >> (lvl * CRT_TW_SLOT_BITS)) &
+					   CRT_TW_SLOT_MASK]);
+}
+
+/*
+ * Track the deadline crp_timeout_ts of \a rpc_priv, or move it to the slot of
+ * its new deadline if it is already tracked. Return true if it was not tracked.
+ */
+bool
+crt_tw_add(struct crt_timer_wheel *tw, struct crt_rpc_priv *rpc_priv)
+{
+	bool	added = false;
+
+	if (rpc_priv->crp_in_timer == 1) {
+		d_list_del_init(&rpc_priv->crp_timeout_link);
+	} else {
+		tw->tw_nr++;
+		rpc_priv->crp_in_timer = 1;
+		added = true;
+	}
+	crt_tw_link(tw, rpc_priv);
+
+	return added;
+}
+
+/* Stop tracking \a rpc_priv, return true if it was tracked */
+bool
+crt_tw_del(struct crt_timer_wheel *tw, struct crt_rpc_priv *rpc_priv)
+{
+	if (rpc_priv->crp_in_timer == 0)
+		return false;
+
+	rpc_priv->crp_in_timer = 0;
+	d_list_del_init(&rpc_priv->crp_timeout_link);
+	tw->tw_nr--;
+
+	return true;
+}
+
+/* Re-distribute one slot of level \a lvl to the lower levels */
+static void
+crt_tw_cascade(struct crt_timer_wheel *tw, int lvl, uint32_t idx)
+{
+	struct crt_rpc_priv	*rpc_priv;
+	d_list_t		 slot;
+
+	D_INIT_LIST_HEAD(&slot);
+	d_list_splice_init(&tw->tw_slots[lvl][idx], &slot);
+	while ((rpc_priv = d_list_pop_entry(&slot, struct crt_rpc_priv,
+					    crp_timeout_link)))
+		crt_tw_link(tw, rpc_priv);
+}
+
+/*
+ * Expire all ticks before \a now_tick, RPCs that reached their deadline are
+ * moved to \a expired through crp_tmp_link. The wheel reference of each RPC
+ * is passed to the caller.
+ */
+void
+crt_tw_expire(struct crt_timer_wheel *tw, uint64_t now_tick, d_list_t *expired)
+{
+	struct crt_rpc_priv	*rpc_priv;
+	d_list_t		 slot;
+	uint64_t		 tick;
+	int			 lvl;
+
+	D_INIT_LIST_HEAD(&slot);
+	d_list_splice_init(&tw->tw_due, &slot);
+
+	while (tw->tw_tick < now_tick && tw->tw_nr > 0) {
+		tick = tw->tw_tick;
+		for (lvl = 1; lvl < CRT_TW_LEVELS; lvl++) {
+			if ((tick >> ((lvl - 1) * CRT_TW_SLOT_BITS)) & CRT_TW_SLOT_MASK)
+				break;
+			crt_tw_cascade(tw, lvl,
+				       (tick >> (lvl * CRT_TW_SLOT_BITS)) & CRT_TW_SLOT_MASK);
+		}
+
+		d_list_splice_init(&tw->tw_slots[0][tick & CRT_TW_SLOT_MASK], &slot);
+		while ((rpc_priv = d_list_pop_entry(&slot, struct crt_rpc_priv,
+						    crp_timeout_link))) {
+			/* parked deadline beyond the wheel span */
+			if ((rpc_priv->crp_timeout_ts >> CRT_TW_TICK_SHIFT) > tick) {
+				crt_tw_link(tw, rpc_priv);
+				continue;
+			}
+			rpc_priv->crp_in_timer = 0;
+			tw->tw_nr--;
+			d_list_add_tail(&rpc_priv->crp_tmp_link, expired);
+		}
+		tw->tw_tick++;
+	}
+
+	/* drain the due list when there is no tick to process */
+	while ((rpc_priv = d_list_pop_entry(&slot, struct crt_rpc_priv,
+					    crp_timeout_link))) {
+		rpc_priv->crp_in_timer = 0;
+		tw->tw_nr--;
+		d_list_add_tail(&rpc_priv->crp_tmp_link, expired);
+	}
+
+	/* nothing to track, skip idle ticks */
+	if (tw->tw_nr == 0 && tw->tw_tick < now_tick)
+		tw->tw_tick = now_tick;
+}
+
+static void
+crt_desc_pool_free(struct crt_desc_pool *pool)
+{
+	D_ASSERT(d_list_empty(&pool->cdp_list));
+	D_SPIN_DESTROY(&pool->cdp_lock);
+	D_FREE(pool);
+}
+
+/*
+ * Drop the reference of \a ctx on its pools. A pool is freed once the last
+ * descriptor taken from it is released, which can be after the context is
+ * destroyed.
+ */
+void
+crt_desc_pools_fini(struct crt_context *ctx)
+{
+	struct crt_desc_pool	*pool;
+	struct crt_rpc_priv	*rpc_priv;
+	d_list_t		 destroy_list;
+	bool			 last;
+	int			 i;
+
+	D_INIT_LIST_HEAD(&destroy_list);
+	for (i = 0; i < CRT_DESC_POOL_OPC_MAX; i++) {
+		pool = ctx->cc_desc_pools[i];
+		if (pool == NULL)
+			continue;
+		ctx->cc_desc_pools[i] = NULL;
+
+		D_SPIN_LOCK(&pool->cdp_lock);
+		pool->cdp_enabled = false;
+		pool->cdp_num = 0;
+		d_list_splice_init(&pool->cdp_list, &destroy_list);
+		last = --pool->cdp_ref == 0;
+		D_SPIN_UNLOCK(&pool->cdp_lock);
+		if (last)
+			crt_desc_pool_free(pool);
+	}
+
+	while ((rpc_priv = d_list_pop_entry(&destroy_list, struct crt_rpc_priv,
+					    crp_tmp_link)))
+		D_FREE(rpc_priv);
+}
+
+int
+crt_desc_pools_init(struct crt_context *ctx)
+{
+	struct crt_desc_pool	*pool;
+	int			 rc;
+	int			 i;
+
+	for (i = 0; i < CRT_DESC_POOL_OPC_MAX; i++) {
+		D_ALLOC_PTR(pool);
+		if (pool == NULL)
+			D_GOTO(err, rc = -DER_NOMEM);
+
+		rc = D_SPIN_INIT(&pool->cdp_lock, PTHREAD_PROCESS_PRIVATE);
+		if (rc != 0) {
+			D_FREE(pool);
+			D_GOTO(err, rc);
+		}
+		D_INIT_LIST_HEAD(&pool->cdp_list);
+		pool->cdp_num = 0;
+		pool->cdp_ref = 1;
+		pool->cdp_warm = false;
+		pool->cdp_enabled = true;
+		ctx->cc_desc_pools[i] = pool;
+	}
+
+	return 0;
+
+err:
+	crt_desc_pools_fini(ctx);
+	return rc;
+}
+
+/* Preallocate CRT_DESC_POOL_PREPOST_NUM descriptors of \a size for pool \a idx */
+static void
+crt_desc_pool_warm(struct crt_context *ctx, int idx, size_t size)
+{
+	struct crt_desc_pool	*pool = ctx->cc_desc_pools[idx];
+	struct crt_rpc_priv	*rpc_priv;
+	d_list_t		 prepost;
+	bool			 warm;
+	int			 i;
+
+	D_SPIN_LOCK(&pool->cdp_lock);
+	warm = pool->cdp_warm || !pool->cdp_enabled;
+	pool->cdp_warm = true;
+	D_SPIN_UNLOCK(&pool->cdp_lock);
+	if (warm)
+		return;
+
+	D_INIT_LIST_HEAD(&prepost);
+	for (i = 0; i < CRT_DESC_POOL_PREPOST_NUM; i++) {
+		D_ALLOC(rpc_priv, size);
+		if (rpc_priv == NULL)
+			break;
+		d_list_add_tail(&rpc_priv->crp_tmp_link, &prepost);
+	}
+
+	D_SPIN_LOCK(&pool->cdp_lock);
+	d_list_splice_init(&prepost, &pool->cdp_list);
+	pool->cdp_num += i;
+	D_SPIN_UNLOCK(&pool->cdp_lock);
+	D_DEBUG(DB_TRACE, "ctx %d, desc pool %d, prepost %d of size %zu.\n",
+		ctx->cc_idx, idx, i, size);
+}
+
+/* Prewarm the descriptor pools of all the opcodes registered so far */
+static void
+crt_desc_pools_warm(struct crt_context *ctx)
+{
+	struct crt_opc_map	*map = crt_gdata.cg_opc_map;
+	int			 i;
+
+	D_RWLOCK_RDLOCK(&map->com_rwlock);
+	for (i = 0; i < map->com_pool_nr; i++)
+		crt_desc_pool_warm(ctx, i, map->com_pool_size[i]);
+	D_RWLOCK_UNLOCK(&map->com_rwlock);
+}
+
+struct crt_rpc_priv *
+crt_context_desc_get(struct crt_context *ctx, struct crt_opc_info *opc_info)
+{
+	struct crt_desc_pool	*pool;
+	struct crt_rpc_priv	*rpc_priv = NULL;
+
+	if (ctx == NULL || !opc_info->coi_pooled)
+		goto alloc;
+
+	pool = ctx->cc_desc_pools[opc_info->coi_pool_idx];
+	/* opcode registered after the context was created */
+	if (unlikely(!pool->cdp_warm))
+		crt_desc_pool_warm(ctx, opc_info->coi_pool_idx, opc_info->coi_rpc_size);
+
+	D_SPIN_LOCK(&pool->cdp_lock);
+	rpc_priv = d_list_pop_entry(&pool->cdp_list, struct crt_rpc_priv,
+				    crp_tmp_link);
+	if (rpc_priv != NULL)
+		pool->cdp_num--;
+	/* dropped by crt_context_desc_put() */
+	pool->cdp_ref++;
+	D_SPIN_UNLOCK(&pool->cdp_lock);
+
+	if (rpc_priv != NULL) {
+		memset(rpc_priv, 0, opc_info->coi_rpc_size);
+		if (crt_gdata.cg_use_sensors)
+			d_tm_inc_counter(ctx->cc_desc_hit, 1);
+	} else {
+		if (crt_gdata.cg_use_sensors)
+			d_tm_inc_counter(ctx->cc_desc_miss, 1);
+		D_ALLOC(rpc_priv, opc_info->coi_rpc_size);
+		if (rpc_priv == NULL) {
+			/* not the last reference, the context holds one */
+			D_SPIN_LOCK(&pool->cdp_lock);
+			pool->cdp_ref--;
+			D_SPIN_UNLOCK(&pool->cdp_lock);
+			return NULL;
+		}
+	}
+	rpc_priv->crp_desc_pool = pool;
+	return rpc_priv;
+
+alloc:
+	D_ALLOC(rpc_priv, opc_info->coi_rpc_size);
+	return rpc_priv;
+}
+
+/*
+ * Release a descriptor of crt_context_desc_get(). It only refers to its pool,
+ * so it can be released after the context is destroyed.
+ */
+void
+crt_context_desc_put(struct crt_rpc_priv *rpc_priv)
+{
+	struct crt_desc_pool	*pool = rpc_priv->crp_desc_pool;
+	bool			 last;
+
+	if (pool == NULL)
+		goto free;
+
+	D_SPIN_LOCK(&pool->cdp_lock);
+	if (pool->cdp_enabled && pool->cdp_num < CRT_DESC_POOL_MAX_NUM) {
+		d_list_add(&rpc_priv->crp_tmp_link, &pool->cdp_list);
+		pool->cdp_num++;
+		rpc_priv = NULL;
+	}
+	last = --pool->cdp_ref == 0;
+	D_SPIN_UNLOCK(&pool->cdp_lock);
+	if (last)
+		crt_desc_pool_free(pool);
+	if (rpc_priv == NULL)
+		return;
+
+free:
+	D_FREE(rpc_priv);
+}
+
 static int
 crt_context_init(crt_context_t crt_ctx)
 {
 	struct crt_context	*ctx;
-	uint32_t		 bh_node_cnt;
 	int			 rc;
 
 	D_ASSERT(crt_ctx != NULL);
@@ -143,15 +485,15 @@ crt_context_init(crt_context_t crt_ctx)
 
 	D_INIT_LIST_HEAD(&ctx->cc_link);
 
-	/* create timeout binheap */
-	bh_node_cnt = CRT_DEFAULT_CREDITS_PER_EP_CTX * 64;
-	rc = d_binheap_create_inplace(DBH_FT_NOLOCK, bh_node_cnt,
-				      NULL /* priv */, &crt_timeout_bh_ops,
-				      &ctx->cc_bh_timeout);
-	if (rc != 0) {
-		D_ERROR("d_binheap_create() failed, " DF_RC "\n", DP_RC(rc));
+	/* create timeout wheel */
+	rc = D_SPIN_INIT(&ctx->cc_tw_lock, PTHREAD_PROCESS_PRIVATE);
+	if (rc != 0)
 		D_GOTO(out_mutex_destroy, rc);
-	}
+	crt_tw_init(&ctx->cc_tw, d_timeus_secdiff(0) >> CRT_TW_TICK_SHIFT);
+
+	rc = crt_desc_pools_init(ctx);
+	if (rc != 0)
+		D_GOTO(out_spin_destroy, rc);
 
 	/* create epi table, use external lock */
 	rc = d_hash_table_create_inplace(D_HASH_FT_NOLOCK, CRT_EPI_TABLE_BITS,
@@ -159,13 +501,15 @@ crt_context_init(crt_context_t crt_ctx)
 					 &ctx->cc_epi_table);
 	if (rc != 0) {
 		D_ERROR("d_hash_table_create() failed, " DF_RC "\n", DP_RC(rc));
-		D_GOTO(out_binheap_destroy, rc);
+		D_GOTO(out_pools_fini, rc);
 	}
 
 	D_GOTO(out, rc);
 
-out_binheap_destroy:
-	d_binheap_destroy_inplace(&ctx->cc_bh_timeout);
+out_pools_fini:
+	crt_desc_pools_fini(ctx);
+out_spin_destroy:
+	D_SPIN_DESTROY(&ctx->cc_tw_lock);
 out_mutex_destroy:
 	D_MUTEX_DESTROY(&ctx->cc_mutex);
 out:
@@ -277,6 +621,8 @@ crt_context_provider_create(crt_context_t *crt_ctx, crt_provider_t provider, boo
 
 	D_RWLOCK_UNLOCK(&crt_gdata.cg_rwlock);
 
+	crt_desc_pools_warm(ctx);
+
 	/** initialize sensors */
 	if (crt_gdata.cg_use_sensors) {
 		int	ret;
@@ -308,6 +654,24 @@ crt_context_provider_create(crt_context_t *crt_ctx, crt_provider_t provider, boo
 		if (ret)
 			D_WARN("Failed to create failed addr counter: "DF_RC
 			       "\n", DP_RC(ret));
+
+		ret = d_tm_add_metric(&ctx->cc_desc_hit, D_TM_COUNTER,
+				      "Total number of RPC descriptors reused "
+				      "from the context cache", "reqs",
+				      "net/%s/desc_pool/hit/ctx_%u",
+				      prov, ctx->cc_idx);
+		if (ret)
+			D_WARN("Failed to create desc pool hit counter: "DF_RC
+			       "\n", DP_RC(ret));
+
+		ret = d_tm_add_metric(&ctx->cc_desc_miss, D_TM_COUNTER,
+				      "Total number of pooled RPC descriptors "
+				      "allocated from heap", "reqs",
+				      "net/%s/desc_pool/miss/ctx_%u",
+				      prov, ctx->cc_idx);
+		if (ret)
+			D_WARN("Failed to create desc pool miss counter: "DF_RC
+			       "\n", DP_RC(ret));
 	}
 
 	if (crt_is_service() &&
@@ -644,8 +1008,6 @@ crt_context_destroy(crt_context_t crt_ctx, int force)
 			D_GOTO(err_unlock, rc);
 	}
 
-	d_binheap_destroy_inplace(&ctx->cc_bh_timeout);
-
 	D_MUTEX_UNLOCK(&ctx->cc_mutex);
 
 	provider = ctx->cc_hg_ctx.chc_provider;
@@ -665,6 +1027,8 @@ crt_context_destroy(crt_context_t crt_ctx, int force)
 
 	D_RWLOCK_UNLOCK(&crt_gdata.cg_rwlock);
 
+	crt_desc_pools_fini(ctx);
+	D_SPIN_DESTROY(&ctx->cc_tw_lock);
 	D_MUTEX_DESTROY(&ctx->cc_mutex);
 	D_DEBUG(DB_TRACE, "destroyed context (idx %d, force %d)\n", ctx->cc_idx, force);
 	D_FREE(ctx);
@@ -785,61 +1149,50 @@ out:
 	return rc2;
 }
 
-/* caller should already hold crt_ctx->cc_mutex */
+/*
+ * Track the deadline crp_timeout_ts of \a rpc_priv, or re-arm it if the RPC
+ * is already tracked. Both are O(1) under cc_tw_lock.
+ */
 int
 crt_req_timeout_track(struct crt_rpc_priv *rpc_priv)
 {
 	struct crt_context *crt_ctx = rpc_priv->crp_pub.cr_ctx;
-	int rc;
 
 	D_ASSERT(crt_ctx != NULL);
 
-	if (rpc_priv->crp_in_binheap == 1)
-		D_GOTO(out, rc = 0);
-
-	/* add to binheap for timeout tracking */
-	RPC_ADDREF(rpc_priv); /* decref in crt_req_timeout_untrack */
-	rc = d_binheap_insert(&crt_ctx->cc_bh_timeout,
-			      &rpc_priv->crp_timeout_bp_node);
-	if (rc == 0) {
-		rpc_priv->crp_in_binheap = 1;
-	} else {
-		RPC_ERROR(rpc_priv,
-			  "d_binheap_insert failed, rc: %d\n",
-			  rc);
-		RPC_DECREF(rpc_priv);
-	}
+	D_SPIN_LOCK(&crt_ctx->cc_tw_lock);
+	/* add to timer wheel for timeout tracking */
+	if (crt_tw_add(&crt_ctx->cc_tw, rpc_priv))
+		RPC_ADDREF(rpc_priv); /* decref in crt_req_timeout_untrack */
+	D_SPIN_UNLOCK(&crt_ctx->cc_tw_lock);
 
-out:
-	return rc;
+	return 0;
 }
 
-/* caller should already hold crt_ctx->cc_mutex */
 void
 crt_req_timeout_untrack(struct crt_rpc_priv *rpc_priv)
 {
-	struct crt_context *crt_ctx = rpc_priv->crp_pub.cr_ctx;
+	struct crt_context	*crt_ctx = rpc_priv->crp_pub.cr_ctx;
+	bool			 tracked;
 
 	D_ASSERT(crt_ctx != NULL);
 
-	/* remove from timeout binheap */
-	if (rpc_priv->crp_in_binheap == 1) {
-		rpc_priv->crp_in_binheap = 0;
-		d_binheap_remove(&crt_ctx->cc_bh_timeout,
-				 &rpc_priv->crp_timeout_bp_node);
+	/* remove from timer wheel */
+	D_SPIN_LOCK(&crt_ctx->cc_tw_lock);
+	tracked = crt_tw_del(&crt_ctx->cc_tw, rpc_priv);
+	D_SPIN_UNLOCK(&crt_ctx->cc_tw_lock);
+
+	if (tracked)
 		RPC_DECREF(rpc_priv); /* addref in crt_req_timeout_track */
-	}
 }
 
 static bool
 crt_req_timeout_reset(struct crt_rpc_priv *rpc_priv)
 {
 	struct crt_opc_info	*opc_info;
-	struct crt_context	*crt_ctx;
 	crt_endpoint_t		*tgt_ep;
 	int			 rc;
 
-	crt_ctx = rpc_priv->crp_pub.cr_ctx;
 	opc_info = rpc_priv->crp_opc_info;
 	D_ASSERT(opc_info != NULL);
 
@@ -867,9 +1220,7 @@ crt_req_timeout_reset(struct crt_rpc_priv *rpc_priv)
 	RPC_TRACE(DB_NET, rpc_priv, "reset_timer enabled.\n");
 
 	crt_set_timeout(rpc_priv);
-	D_MUTEX_LOCK(&crt_ctx->cc_mutex);
 	rc = crt_req_timeout_track(rpc_priv);
-	D_MUTEX_UNLOCK(&crt_ctx->cc_mutex);
 	if (rc != 0) {
 		RPC_ERROR(rpc_priv,
 			"crt_req_timeout_track(opc: %#x) failed, rc: %d.\n",
@@ -968,7 +1319,6 @@ static void
 crt_context_timeout_check(struct crt_context *crt_ctx)
 {
 	struct crt_rpc_priv		*rpc_priv;
-	struct d_binheap_node		*bh_node;
 	d_list_t			 timeout_list;
 	uint64_t			 ts_now;
 
@@ -977,23 +1327,10 @@ crt_context_timeout_check(struct crt_context *crt_ctx)
 	D_INIT_LIST_HEAD(&timeout_list);
 	ts_now = d_timeus_secdiff(0);
 
-	D_MUTEX_LOCK(&crt_ctx->cc_mutex);
-	while (1) {
-		bh_node = d_binheap_root(&crt_ctx->cc_bh_timeout);
-		if (bh_node == NULL)
-			break;
-		rpc_priv = container_of(bh_node, struct crt_rpc_priv,
-					crp_timeout_bp_node);
-		if (rpc_priv->crp_timeout_ts > ts_now)
-			break;
-
-		/* +1 to prevent it from being released in timeout_untrack */
-		RPC_ADDREF(rpc_priv);
-		crt_req_timeout_untrack(rpc_priv);
-
-		d_list_add_tail(&rpc_priv->crp_tmp_link, &timeout_list);
-	};
-	D_MUTEX_UNLOCK(&crt_ctx->cc_mutex);
+	/* the reference held by the wheel is passed to timeout_list */
+	D_SPIN_LOCK(&crt_ctx->cc_tw_lock);
+	crt_tw_expire(&crt_ctx->cc_tw, ts_now >> CRT_TW_TICK_SHIFT, &timeout_list);
+	D_SPIN_UNLOCK(&crt_ctx->cc_tw_lock);
 
 	/* handle the timeout RPCs */
 	while ((rpc_priv = d_list_pop_entry(&timeout_list,
@@ -1102,9 +1439,7 @@ crt_context_req_track(struct crt_rpc_priv *rpc_priv)
 		rpc_priv->crp_state = RPC_STATE_QUEUED;
 		rc = CRT_REQ_TRACK_IN_WAITQ;
 	} else {
-		D_MUTEX_LOCK(&crt_ctx->cc_mutex);
 		rc = crt_req_timeout_track(rpc_priv);
-		D_MUTEX_UNLOCK(&crt_ctx->cc_mutex);
 		if (rc == 0) {
 			d_list_add_tail(&rpc_priv->crp_epi_link,
 					&epi->epi_req_q);
@@ -1186,11 +1521,8 @@ crt_context_req_untrack(struct crt_rpc_priv *rpc_priv)
 	}
 	D_ASSERT(epi->epi_req_num >= epi->epi_reply_num);
 
-	if (!crt_req_timedout(rpc_priv)) {
-		D_MUTEX_LOCK(&crt_ctx->cc_mutex);
+	if (!crt_req_timedout(rpc_priv))
 		crt_req_timeout_untrack(rpc_priv);
-		D_MUTEX_UNLOCK(&crt_ctx->cc_mutex);
-	}
 
 	rpc_priv->crp_ctx_tracked = 0;
 
@@ -1214,9 +1546,7 @@ crt_context_req_untrack(struct crt_rpc_priv *rpc_priv)
 		tmp_rpc->crp_state = RPC_STATE_INITED;
 		crt_set_timeout(tmp_rpc);
 
-		D_MUTEX_LOCK(&crt_ctx->cc_mutex);
 		rc = crt_req_timeout_track(tmp_rpc);
-		D_MUTEX_UNLOCK(&crt_ctx->cc_mutex);
 		if (rc != 0)
 			RPC_ERROR(tmp_rpc,
 				"crt_req_timeout_track failed, rc: %d.\n", rc);
@@ -1709,8 +2039,6 @@ exit:
 void
 crt_req_force_timeout(struct crt_rpc_priv *rpc_priv)
 {
-	struct crt_context	*crt_ctx;
-
 	RPC_TRACE(DB_TRACE, rpc_priv, "Handling unreachable rpc\n");
 
 	if (rpc_priv == NULL) {
@@ -1725,15 +2053,10 @@ crt_req_force_timeout(struct crt_rpc_priv *rpc_priv)
 	}
 
 	/* Handle unreachable rpcs similarly to timed out rpcs */
-	crt_ctx = rpc_priv->crp_pub.cr_ctx;
-
 	/**
-	 *  set the RPC's expiration time stamp to the past, move it to the top
-	 *  of the heap.
+	 *  set the RPC's expiration time stamp to the past, re-arm it to the due
+	 *  list of the timer wheel.
 	 */
-	D_MUTEX_LOCK(&crt_ctx->cc_mutex);
-	crt_req_timeout_untrack(rpc_priv);
 	rpc_priv->crp_timeout_ts = 0;
 	crt_req_timeout_track(rpc_priv);
-	D_MUTEX_UNLOCK(&crt_ctx->cc_mutex);
 }
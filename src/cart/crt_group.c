@@ -1169,6 +1169,7 @@ crt_grp_priv_destroy(struct crt_grp_priv *grp_priv)
 	}
 
 	D_FREE(grp_priv->gp_psr_phy_addr);
+	D_FREE(grp_priv->gp_domains);
 	D_FREE(grp_priv->gp_pub.cg_grpid);
 
 	D_RWLOCK_DESTROY(&grp_priv->gp_rwlock);
@@ -3679,3 +3680,119 @@ crt_group_psrs_set(crt_group_t *grp, d_rank_list_t *rank_list)
 out:
 	return rc;
 }
+
+static int
+crt_grp_domain_cmp(const void *a, const void *b)
+{
+	const struct crt_grp_domain	*da = a;
+	const struct crt_grp_domain	*db = b;
+
+	if (da->gd_rank == db->gd_rank)
+		return 0;
+	return da->gd_rank < db->gd_rank ? -1 : 1;
+}
+
+/*
+ * Merge the sorted \a domains into the ones of the primary group, entries of
+ * the same rank are replaced. The caller holds the gp_rwlock for write.
+ */
+static int
+crt_grp_domains_merge(struct crt_grp_priv *prim_grp_priv,
+		      struct crt_grp_domain *domains, uint32_t nr)
+{
+	struct crt_grp_domain	*old = prim_grp_priv->gp_domains;
+	struct crt_grp_domain	*merged;
+	uint32_t		 old_nr = prim_grp_priv->gp_domains_nr;
+	uint32_t		 i = 0, j = 0, k = 0;
+
+	D_ALLOC_ARRAY(merged, old_nr + nr);
+	if (merged == NULL)
+		return -DER_NOMEM;
+
+	while (i < old_nr || j < nr) {
+		if (j == nr || (i < old_nr && old[i].gd_rank < domains[j].gd_rank)) {
+			merged[k++] = old[i++];
+			continue;
+		}
+		if (i < old_nr && old[i].gd_rank == domains[j].gd_rank)
+			i++;
+		merged[k++] = domains[j++];
+	}
+
+	D_FREE(prim_grp_priv->gp_domains);
+	prim_grp_priv->gp_domains = merged;
+	prim_grp_priv->gp_domains_nr = k;
+	return 0;
+}
+
+int
+crt_group_domains_set(crt_group_t *grp, d_rank_list_t *ranks,
+		      uint32_t *nodes, uint32_t *racks)
+{
+	struct crt_grp_priv	*grp_priv;
+	struct crt_grp_priv	*prim_grp_priv;
+	struct crt_grp_domain	*domains;
+	int			 i;
+	int			 rc = 0;
+
+	grp_priv = crt_grp_pub2priv(grp);
+	if (grp_priv == NULL) {
+		D_ERROR("Failed to lookup grp\n");
+		D_GOTO(out, rc = -DER_INVAL);
+	}
+
+	if (ranks == NULL || ranks->rl_nr == 0 || nodes == NULL ||
+	    racks == NULL) {
+		D_ERROR("Invalid domain arguments\n");
+		D_GOTO(out, rc = -DER_INVAL);
+	}
+
+	D_ALLOC_ARRAY(domains, ranks->rl_nr);
+	if (domains == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+
+	D_RWLOCK_RDLOCK(&grp_priv->gp_rwlock);
+	if (!grp_priv->gp_primary)
+		prim_grp_priv = grp_priv->gp_priv_prim;
+	else
+		prim_grp_priv = grp_priv;
+
+	/* Convert all passed secondary ranks to primary */
+	for (i = 0; i < ranks->rl_nr; i++) {
+		domains[i].gd_rank = grp_priv->gp_primary ? ranks->rl_ranks[i] :
+				     crt_grp_priv_get_primary_rank(grp_priv,
+							ranks->rl_ranks[i]);
+		domains[i].gd_node = nodes[i];
+		domains[i].gd_rack = racks[i];
+	}
+	D_RWLOCK_UNLOCK(&grp_priv->gp_rwlock);
+
+	qsort(domains, ranks->rl_nr, sizeof(*domains), crt_grp_domain_cmp);
+
+	D_RWLOCK_WRLOCK(&prim_grp_priv->gp_rwlock);
+	rc = crt_grp_domains_merge(prim_grp_priv, domains, ranks->rl_nr);
+	D_RWLOCK_UNLOCK(&prim_grp_priv->gp_rwlock);
+	D_FREE(domains);
+	if (rc != 0)
+		D_GOTO(out, rc);
+
+	D_DEBUG(DB_TRACE, "group %s: set domains of %u ranks\n",
+		grp_priv->gp_pub.cg_grpid, ranks->rl_nr);
+out:
+	return rc;
+}
+
+/* find the domain of a primary rank, the caller holds the gp_rwlock */
+struct crt_grp_domain *
+crt_grp_domain_lookup(struct crt_grp_priv *prim_grp_priv, d_rank_t rank)
+{
+	struct crt_grp_domain	key = { .gd_rank = rank };
+
+	D_ASSERT(prim_grp_priv->gp_primary);
+	if (prim_grp_priv->gp_domains == NULL)
+		return NULL;
+
+	return bsearch(&key, prim_grp_priv->gp_domains,
+		       prim_grp_priv->gp_domains_nr, sizeof(key),
+		       crt_grp_domain_cmp);
+}
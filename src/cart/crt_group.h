@@ -47,6 +47,13 @@ struct crt_grp_priv_sec {
 
 struct crt_grp_priv;
 
+/* fault domain of a primary rank, see crt_group_domains_set */
+struct crt_grp_domain {
+	d_rank_t		 gd_rank;
+	uint32_t		 gd_node;
+	uint32_t		 gd_rack;
+};
+
 struct crt_grp_priv {
 	d_list_t		 gp_link; /* link to crt_grp_list */
 	crt_group_t		 gp_pub; /* public grp handle */
@@ -90,6 +97,9 @@ struct crt_grp_priv {
 	d_rank_t		 gp_psr_rank;
 	/* PSR phy addr address in attached group */
 	crt_phy_addr_t		 gp_psr_phy_addr;
+	/* fault domains sorted by rank, only valid for primary group */
+	struct crt_grp_domain	*gp_domains;
+	uint32_t		 gp_domains_nr;
 	/* address lookup cache, only valid for primary group */
 	struct d_hash_table	 *gp_lookup_cache;
 
@@ -123,6 +133,9 @@ grp_priv_get_membs(struct crt_grp_priv *priv)
 d_rank_t
 crt_grp_priv_get_primary_rank(struct crt_grp_priv *priv, d_rank_t rank);
 
+struct crt_grp_domain *
+crt_grp_domain_lookup(struct crt_grp_priv *prim_grp_priv, d_rank_t rank);
+
 /*
  * This call is currently called only when group is created.
  */
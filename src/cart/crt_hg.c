@@ -1015,7 +1015,7 @@ crt_rpc_handler_common(hg_handle_t hg_hdl)
 	}
 	D_ASSERT(opc_info->coi_opc == opc);
 
-	D_ALLOC(rpc_priv, opc_info->coi_rpc_size);
+	rpc_priv = crt_context_desc_get(crt_ctx, opc_info);
 	if (unlikely(rpc_priv == NULL)) {
 		crt_hg_reply_error_send(&rpc_tmp, -DER_DOS);
 		crt_hg_unpack_cleanup(proc);
@@ -1083,6 +1083,10 @@ crt_rpc_handler_common(hg_handle_t hg_hdl)
 		D_GOTO(decref, hg_ret = HG_SUCCESS);
 	}
 
+	/* regular traffic from a rank tells SWIM it is alive */
+	if (!crt_opc_is_swim(opc))
+		crt_swim_heard(crt_ctx, rpc_priv->crp_req_hdr.cch_src_rank);
+
 	if (!is_coll_req)
 		rc = crt_rpc_common_hdlr(rpc_priv);
 	else
@@ -1284,6 +1288,10 @@ crt_hg_req_send_cb(const struct hg_cb_info *hg_cbinfo)
 		/* HLC is checked during unpacking of the response */
 		if (rpc_priv->crp_fail_hlc)
 			rc = -DER_HLC_SYNC;
+
+		if (rc == 0 && crt_is_service() && !crt_opc_is_swim(rpc_pub->cr_opc))
+			crt_swim_heard(rpc_priv->crp_pub.cr_ctx,
+				       rpc_priv->crp_req_hdr.cch_dst_rank);
 	}
 
 	crt_cbinfo.cci_rpc = rpc_pub;
@@ -40,6 +40,15 @@ void crt_rpc_complete(struct crt_rpc_priv *rpc_priv, int rc);
 int crt_req_timeout_track(struct crt_rpc_priv *rpc_priv);
 void crt_req_timeout_untrack(struct crt_rpc_priv *rpc_priv);
 void crt_req_force_timeout(struct crt_rpc_priv *rpc_priv);
+struct crt_rpc_priv *crt_context_desc_get(struct crt_context *ctx,
+					  struct crt_opc_info *opc_info);
+void crt_context_desc_put(struct crt_rpc_priv *rpc_priv);
+int crt_desc_pools_init(struct crt_context *ctx);
+void crt_desc_pools_fini(struct crt_context *ctx);
+void crt_tw_init(struct crt_timer_wheel *tw, uint64_t tick);
+bool crt_tw_add(struct crt_timer_wheel *tw, struct crt_rpc_priv *rpc_priv);
+bool crt_tw_del(struct crt_timer_wheel *tw, struct crt_rpc_priv *rpc_priv);
+void crt_tw_expire(struct crt_timer_wheel *tw, uint64_t now_tick, d_list_t *expired);
 
 /** some simple helper functions */
 
@@ -184,6 +184,61 @@ extern struct crt_plugin_gdata		crt_plugin_gdata;
 #define CRT_DEFAULT_CREDITS_PER_EP_CTX	(32)
 #define CRT_MAX_CREDITS_PER_EP_CTX	(256)
 
+/*
+ * RPC timeout wheel, CRT_TW_LEVELS levels of CRT_TW_SLOTS slots each. One tick
+ * is (1 << CRT_TW_TICK_SHIFT) micro-seconds (~1ms), level N slot covers
+ * (CRT_TW_SLOTS ^ N) ticks, so the wheel spans 2^24 ticks (~4.6 hours). Longer
+ * deadlines are parked in the last slot and re-inserted when they get there.
+ */
+#define CRT_TW_TICK_SHIFT		(10)
+#define CRT_TW_SLOT_BITS		(6)
+#define CRT_TW_SLOTS			(1U << CRT_TW_SLOT_BITS)
+#define CRT_TW_SLOT_MASK		(CRT_TW_SLOTS - 1)
+#define CRT_TW_LEVELS			(4)
+
+/* maximum number of opcodes with CRT_RPC_FEAT_POOLED */
+#define CRT_DESC_POOL_OPC_MAX		(32)
+/* maximum number of cached descriptors per context per opcode */
+#define CRT_DESC_POOL_MAX_NUM		(256)
+/* number of descriptors preallocated per context per opcode */
+#define CRT_DESC_POOL_PREPOST_NUM	(16)
+
+/* per-context cache of the RPC descriptors of one pooled opcode */
+struct crt_desc_pool {
+	pthread_spinlock_t	cdp_lock;
+	/* free descriptors, linked through crt_rpc_priv::crp_tmp_link */
+	d_list_t		cdp_list;
+	/* number of descriptors in cdp_list */
+	int32_t			cdp_num;
+	/* held by the context and by each descriptor taken from the pool */
+	int32_t			cdp_ref;
+	/* preallocation done */
+	bool			cdp_warm;
+	/* pool accepts descriptors */
+	bool			cdp_enabled;
+};
+
+/* number of slots of the per-context cache of ranks heard from */
+#define CRT_SWIM_HEARD_NUM		(64)
+
+/* a rank recently heard from by regular traffic, see crt_swim_heard */
+struct crt_swim_heard {
+	d_rank_t		csh_rank;
+	/* HLC of the last report of csh_rank to SWIM */
+	uint64_t		csh_hlc;
+};
+
+struct crt_timer_wheel {
+	/** slots of each level, list of crt_rpc_priv::crp_timeout_link */
+	d_list_t		tw_slots[CRT_TW_LEVELS][CRT_TW_SLOTS];
+	/** RPCs already past their deadline when being tracked */
+	d_list_t		tw_due;
+	/** next tick to be expired */
+	uint64_t		tw_tick;
+	/** number of RPCs in the wheel */
+	uint64_t		tw_nr;
+};
+
 /* crt_context */
 struct crt_context {
 	d_list_t		 cc_link;	/** link to gdata.cg_ctx_list */
@@ -199,15 +254,21 @@ struct crt_context {
 	/** RPC tracking */
 	/** in-flight endpoint tracking hash table */
 	struct d_hash_table	 cc_epi_table;
-	/** binheap for inflight RPC timeout tracking */
-	struct d_binheap	 cc_bh_timeout;
-	/** mutex to protect cc_epi_table and timeout binheap */
+	/** timer wheel for inflight RPC timeout tracking */
+	struct crt_timer_wheel	 cc_tw;
+	/** spinlock to protect cc_tw */
+	pthread_spinlock_t	 cc_tw_lock;
+	/** mutex to protect cc_epi_table */
 	pthread_mutex_t		 cc_mutex;
+	/** RPC descriptor caches, indexed by crt_opc_info::coi_pool_idx */
+	struct crt_desc_pool	*cc_desc_pools[CRT_DESC_POOL_OPC_MAX];
 
 	/** timeout per-context */
 	uint32_t		 cc_timeout_sec;
 	/** HLC time of last received RPC */
 	uint64_t		 cc_last_unpack_hlc;
+	/** ranks recently reported to SWIM, indexed by rank modulo size */
+	struct crt_swim_heard	 cc_swim_heard[CRT_SWIM_HEARD_NUM];
 
 	/** Per-context statistics (server-side only) */
 	/** Total number of timed out requests, of type counter */
@@ -216,6 +277,10 @@ struct crt_context {
 	struct d_tm_node_t	*cc_timedout_uri;
 	/** Total number of failed address resolution, of type counter */
 	struct d_tm_node_t	*cc_failed_addr;
+	/** Descriptors served from cc_desc_pools, of type counter */
+	struct d_tm_node_t	*cc_desc_hit;
+	/** Pooled opcode descriptors allocated from heap, of type counter */
+	struct d_tm_node_t	*cc_desc_miss;
 
 	/** Stores self uri for the current context */
 	char			 cc_self_uri[CRT_ADDR_STR_MAX_LEN];
@@ -265,7 +330,10 @@ struct crt_opc_info {
 				 coi_coops_init:1,
 				 coi_no_reply:1, /* flag of one-way RPC */
 				 coi_queue_front:1, /* add to front of queue */
-				 coi_reset_timer:1; /* reset timer on timeout */
+				 coi_reset_timer:1, /* reset timer on timeout */
+				 coi_pooled:1; /* descriptors are pooled */
+	/* index of crt_context::cc_desc_pools, valid if coi_pooled is set */
+	int			 coi_pool_idx;
 
 	crt_rpc_cb_t		 coi_rpc_cb;
 	struct crt_corpc_ops	*coi_co_ops;
@@ -303,6 +371,10 @@ struct crt_opc_map {
 	unsigned int		com_num_slots_total;
 	d_list_t		com_coq_list;
 	struct crt_opc_map_L2	*com_map;
+	/* number of pooled opcodes */
+	unsigned int		com_pool_nr;
+	/* descriptor size of each pooled opcode, by coi_pool_idx */
+	size_t			com_pool_size[CRT_DESC_POOL_OPC_MAX];
 };
 
 
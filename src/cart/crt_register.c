@@ -207,6 +207,24 @@ out:
 	return info;
 }
 
+/* Assign a descriptor pool index to \a opc_info, caller holds com_rwlock */
+static void
+crt_opc_pool_assign(struct crt_opc_info *opc_info)
+{
+	struct crt_opc_map	*map = crt_gdata.cg_opc_map;
+
+	if (map->com_pool_nr >= CRT_DESC_POOL_OPC_MAX) {
+		D_WARN("opc %#x, too many pooled opcodes (%d), not pooled\n",
+		       opc_info->coi_opc, CRT_DESC_POOL_OPC_MAX);
+		return;
+	}
+
+	opc_info->coi_pool_idx = map->com_pool_nr;
+	map->com_pool_size[map->com_pool_nr] = opc_info->coi_rpc_size;
+	map->com_pool_nr++;
+	opc_info->coi_pooled = 1;
+}
+
 static int
 crt_opc_reg(struct crt_opc_info *opc_info, crt_opcode_t opc, uint32_t flags,
 	    struct crt_req_format *crf, crt_rpc_cb_t rpc_cb,
@@ -257,13 +275,16 @@ crt_opc_reg(struct crt_opc_info *opc_info, crt_opcode_t opc, uint32_t flags,
 	opc_info->coi_no_reply = D_BIT_IS_SET(flags, CRT_RPC_FEAT_NO_REPLY);
 	opc_info->coi_reset_timer = D_BIT_IS_SET(flags, CRT_RPC_FEAT_NO_TIMEOUT);
 	opc_info->coi_queue_front = D_BIT_IS_SET(flags, CRT_RPC_FEAT_QUEUE_FRONT);
+	if (D_BIT_IS_SET(flags, CRT_RPC_FEAT_POOLED))
+		crt_opc_pool_assign(opc_info);
 
 	D_DEBUG(DB_TRACE,
-		"opc %#x, no_reply %s, reset_timer %s, queue_front %s\n",
+		"opc %#x, no_reply %s, reset_timer %s, queue_front %s, pooled %s\n",
 		opc,
 		opc_info->coi_no_reply ? "enabled" : "disabled",
 		opc_info->coi_reset_timer ? "enabled" : "disabled",
-		opc_info->coi_queue_front ? "enabled" : "disabled");
+		opc_info->coi_queue_front ? "enabled" : "disabled",
+		opc_info->coi_pooled ? "enabled" : "disabled");
 
 out:
 	return rc;
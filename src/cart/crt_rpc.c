@@ -410,8 +410,8 @@ out:
 }
 
 int
-crt_rpc_priv_alloc(crt_opcode_t opc, struct crt_rpc_priv **priv_allocated,
-		   bool forward)
+crt_rpc_priv_alloc(crt_context_t crt_ctx, crt_opcode_t opc,
+		   struct crt_rpc_priv **priv_allocated, bool forward)
 {
 	struct crt_rpc_priv	*rpc_priv;
 	struct crt_opc_info	*opc_info;
@@ -438,7 +438,7 @@ crt_rpc_priv_alloc(crt_opcode_t opc, struct crt_rpc_priv **priv_allocated,
 	if (forward)
 		D_ALLOC(rpc_priv, opc_info->coi_input_offset);
 	else
-		D_ALLOC(rpc_priv, opc_info->coi_rpc_size);
+		rpc_priv = crt_context_desc_get(crt_ctx, opc_info);
 	if (rpc_priv == NULL)
 		D_GOTO(out, rc = -DER_NOMEM);
 
@@ -469,7 +469,7 @@ crt_rpc_priv_free(struct crt_rpc_priv *rpc_priv)
 
 	D_SPIN_DESTROY(&rpc_priv->crp_lock);
 
-	D_FREE(rpc_priv);
+	crt_context_desc_put(rpc_priv);
 }
 
 static inline void
@@ -515,7 +515,7 @@ crt_req_create_internal(crt_context_t crt_ctx, crt_endpoint_t *tgt_ep,
 
 	D_ASSERT(crt_ctx != CRT_CONTEXT_NULL && req != NULL);
 
-	rc = crt_rpc_priv_alloc(opc, &rpc_priv, forward);
+	rc = crt_rpc_priv_alloc(crt_ctx, opc, &rpc_priv, forward);
 	if (rc != 0) {
 		D_ERROR("crt_rpc_priv_alloc(%#x) failed, " DF_RC "\n",
 			opc, DP_RC(rc));
@@ -1612,6 +1612,7 @@ crt_rpc_priv_init(struct crt_rpc_priv *rpc_priv, crt_context_t crt_ctx,
 	D_INIT_LIST_HEAD(&rpc_priv->crp_epi_link);
 	D_INIT_LIST_HEAD(&rpc_priv->crp_tmp_link);
 	D_INIT_LIST_HEAD(&rpc_priv->crp_parent_link);
+	D_INIT_LIST_HEAD(&rpc_priv->crp_timeout_link);
 	rpc_priv->crp_complete_cb = NULL;
 	rpc_priv->crp_arg = NULL;
 	rpc_priv->crp_completed = 0;
@@ -1770,57 +1771,6 @@ out:
 	return rc;
 }
 
-static int
-timeout_bp_node_enter(struct d_binheap *h, struct d_binheap_node *e)
-{
-	struct crt_rpc_priv	*rpc_priv;
-
-	D_ASSERT(h != NULL);
-	D_ASSERT(e != NULL);
-
-	rpc_priv = container_of(e, struct crt_rpc_priv, crp_timeout_bp_node);
-
-	RPC_TRACE(DB_NET, rpc_priv, "entering the timeout binheap.\n");
-
-	return 0;
-}
-
-static int
-timeout_bp_node_exit(struct d_binheap *h, struct d_binheap_node *e)
-{
-	struct crt_rpc_priv	*rpc_priv;
-
-	D_ASSERT(h != NULL);
-	D_ASSERT(e != NULL);
-
-	rpc_priv = container_of(e, struct crt_rpc_priv, crp_timeout_bp_node);
-
-	RPC_TRACE(DB_NET, rpc_priv, "exiting the timeout binheap.\n");
-
-	return 0;
-}
-
-static bool
-timeout_bp_node_cmp(struct d_binheap_node *a, struct d_binheap_node *b)
-{
-	struct crt_rpc_priv	*rpc_priv_a;
-	struct crt_rpc_priv	*rpc_priv_b;
-
-	D_ASSERT(a != NULL);
-	D_ASSERT(b != NULL);
-
-	rpc_priv_a = container_of(a, struct crt_rpc_priv, crp_timeout_bp_node);
-	rpc_priv_b = container_of(b, struct crt_rpc_priv, crp_timeout_bp_node);
-
-	return rpc_priv_a->crp_timeout_ts < rpc_priv_b->crp_timeout_ts;
-}
-
-struct d_binheap_ops crt_timeout_bh_ops = {
-	.hop_enter	= timeout_bp_node_enter,
-	.hop_exit	= timeout_bp_node_exit,
-	.hop_compare	= timeout_bp_node_cmp
-};
-
 int
 crt_req_src_rank_get(crt_rpc_t *rpc, d_rank_t *rank)
 {
@@ -21,7 +21,6 @@
 /* uri lookup max retry times */
 #define CRT_URI_LOOKUP_RETRY_MAX	(8)
 
-extern struct d_binheap_ops crt_timeout_bh_ops;
 void crt_hdlr_rank_evict(crt_rpc_t *rpc_req);
 void crt_hdlr_memb_sample(crt_rpc_t *rpc_req);
 
@@ -127,11 +126,11 @@ struct crt_rpc_priv {
 	d_list_t		crp_tmp_link;
 	/* link to parent RPC crp_opc_info->co_child_rpcs/co_replied_rpcs */
 	d_list_t		crp_parent_link;
-	/* binheap node for timeout management, in crt_context::cc_bh_timeout */
-	struct d_binheap_node	crp_timeout_bp_node;
+	/* link to a slot of the timeout wheel crt_context::cc_tw */
+	d_list_t		crp_timeout_link;
 	/* the timeout in seconds set by user */
 	uint32_t		crp_timeout_sec;
-	/* time stamp to be timeout, the key of timeout binheap */
+	/* time stamp to be timeout, the key of timeout wheel */
 	uint64_t		crp_timeout_ts;
 	crt_cb_t		crp_complete_cb;
 	void			*crp_arg; /* argument for crp_complete_cb */
@@ -164,8 +163,8 @@ struct crt_rpc_priv {
 				crp_uri_free:1,
 				/* flag of forwarded rpc for corpc */
 				crp_forward:1,
-				/* flag of in timeout binheap */
-				crp_in_binheap:1,
+				/* flag of in timeout wheel */
+				crp_in_timer:1,
 				/* set if a call to crt_req_reply pending */
 				crp_reply_pending:1,
 				/* set to 1 if target ep is set */
@@ -182,6 +181,8 @@ struct crt_rpc_priv {
 				crp_src_is_primary:1;
 
 	struct crt_opc_info	*crp_opc_info;
+	/* pool the descriptor is released to, NULL if not pooled */
+	struct crt_desc_pool	*crp_desc_pool;
 	/* corpc info, only valid when (crp_coll == 1) */
 	struct crt_corpc_info	*crp_corpc_info;
 	pthread_spinlock_t	crp_lock;
@@ -275,13 +276,13 @@ struct crt_rpc_priv {
 
 #define CRT_IV_RPCS_LIST						\
 	X(CRT_OPC_IV_FETCH,						\
-		0, &CQF_crt_iv_fetch,					\
+		CRT_RPC_FEAT_POOLED, &CQF_crt_iv_fetch,			\
 		crt_hdlr_iv_fetch, NULL)				\
 	X(CRT_OPC_IV_UPDATE,						\
-		0, &CQF_crt_iv_update,					\
+		CRT_RPC_FEAT_POOLED, &CQF_crt_iv_update,		\
 		crt_hdlr_iv_update, NULL)				\
 	X(CRT_OPC_IV_SYNC,						\
-		0, &CQF_crt_iv_sync,					\
+		CRT_RPC_FEAT_POOLED, &CQF_crt_iv_sync,			\
 		crt_hdlr_iv_sync, &crt_iv_sync_co_ops)			\
 
 /* Define for RPC enum population below */
@@ -623,8 +624,8 @@ crt_rpc_cb_customized(struct crt_context *crt_ctx,
 }
 
 /* crt_rpc.c */
-int crt_rpc_priv_alloc(crt_opcode_t opc, struct crt_rpc_priv **priv_allocated,
-		       bool forward);
+int crt_rpc_priv_alloc(crt_context_t crt_ctx, crt_opcode_t opc,
+		       struct crt_rpc_priv **priv_allocated, bool forward);
 void crt_rpc_priv_free(struct crt_rpc_priv *rpc_priv);
 int crt_rpc_priv_init(struct crt_rpc_priv *rpc_priv, crt_context_t crt_ctx,
 		      bool srv_flag);
@@ -643,7 +644,7 @@ crt_req_timedout(struct crt_rpc_priv *rpc_priv)
 		rpc_priv->crp_state == RPC_STATE_ADDR_LOOKUP ||
 		rpc_priv->crp_state == RPC_STATE_TIMEOUT ||
 		rpc_priv->crp_state == RPC_STATE_FWD_UNREACH) &&
-	       !rpc_priv->crp_in_binheap;
+	       !rpc_priv->crp_in_timer;
 }
 
 static inline void
@@ -104,12 +104,12 @@ static void crt_swim_srv_cb(crt_rpc_t *rpc);
 
 static struct crt_proto_rpc_format crt_swim_proto_rpc_fmt[] = {
 	{
-		.prf_flags	= CRT_RPC_FEAT_QUEUE_FRONT,
+		.prf_flags	= CRT_RPC_FEAT_QUEUE_FRONT | CRT_RPC_FEAT_POOLED,
 		.prf_req_fmt	= &CQF_crt_rpc_swim,
 		.prf_hdlr	= crt_swim_srv_cb,
 		.prf_co_ops	= NULL,
 	}, {
-		.prf_flags	= CRT_RPC_FEAT_QUEUE_FRONT,
+		.prf_flags	= CRT_RPC_FEAT_QUEUE_FRONT | CRT_RPC_FEAT_POOLED,
 		.prf_req_fmt	= &CQF_crt_rpc_swim,
 		.prf_hdlr	= crt_swim_srv_cb,
 		.prf_co_ops	= NULL,
@@ -796,24 +796,48 @@ static int crt_swim_send_reply(struct swim_context *ctx, swim_id_t from,
 	return rc;
 }
 
+/*
+ * Called by swim_progress() with the SWIM context locked. With implicit acks,
+ * ALIVE members heard from by regular traffic within the last protocol period
+ * are skipped unless there are updates to spread, as the ping would tell
+ * nothing new. If all candidates were skipped, the first of them is pinged.
+ */
 static swim_id_t crt_swim_get_dping_target(struct swim_context *ctx)
 {
 	struct crt_grp_priv	*grp_priv = crt_gdata.cg_grp->gg_primary_grp;
 	struct crt_swim_membs	*csm = &grp_priv->gp_membs_swim;
 	struct crt_swim_target	 cst;
+	struct crt_swim_target	 skipped;
 	swim_id_t		 self_id = swim_self_get(ctx);
+	uint64_t		 recent = 0;
+	uint64_t		 hlc;
 	uint32_t		 count = 0;
 
+	skipped.cst_id = SWIM_ID_INVALID;
 	if (self_id == SWIM_ID_INVALID)
 		D_GOTO(out, cst.cst_id = SWIM_ID_INVALID);
 
+	if (csm->csm_implicit_ack && TAILQ_EMPTY(&ctx->sc_updates)) {
+		hlc = d_hlc_get();
+		if (hlc > d_msec2hlc(swim_period_get()))
+			recent = hlc - d_msec2hlc(swim_period_get());
+	}
+
 	crt_swim_csm_lock(csm);
-	do {
-		if (count++ >= csm->csm_list_len) /* don't have a candidate */
-			D_GOTO(out_unlock, cst.cst_id = SWIM_ID_INVALID);
+	for (;;) {
+		if (count++ >= csm->csm_list_len) { /* don't have a candidate */
+			cst = skipped;
+			break;
+		}
 		cst = *crt_swim_membs_next_target(csm);
-	} while (cst.cst_id == self_id || cst.cst_state.sms_status == SWIM_MEMBER_DEAD);
-out_unlock:
+		if (cst.cst_id == self_id || cst.cst_state.sms_status == SWIM_MEMBER_DEAD)
+			continue;
+		if (recent == 0 || cst.cst_state.sms_status != SWIM_MEMBER_ALIVE ||
+		    cst.cst_heard < recent)
+			break;
+		if (skipped.cst_id == SWIM_ID_INVALID)
+			skipped = cst;
+	}
 	crt_swim_csm_unlock(csm);
 out:
 	if (cst.cst_id != SWIM_ID_INVALID)
@@ -1045,6 +1069,50 @@ static int64_t crt_swim_progress_cb(crt_context_t crt_ctx, int64_t timeout_us, v
 	return timeout_us;
 }
 
+/*
+ * Report a message from \a rank outside of SWIM, the successful reply to a
+ * request sent to it or a request from it. This is the implicit liveness
+ * that lets SWIM skip pinging the members that are already talking to us.
+ * A per-context cache bounds the reports to a few per protocol period and
+ * rank, to keep csm_lock off the hot path.
+ */
+void
+crt_swim_heard(struct crt_context *crt_ctx, d_rank_t rank)
+{
+	struct crt_grp_priv	*grp_priv;
+	struct crt_swim_membs	*csm;
+	struct crt_swim_heard	*csh;
+	struct crt_swim_target	*cst;
+	uint64_t		 hlc;
+	bool			 found = false;
+
+	if (!crt_gdata.cg_swim_inited || rank == CRT_NO_RANK)
+		return;
+
+	grp_priv = crt_gdata.cg_grp->gg_primary_grp;
+	csm = &grp_priv->gp_membs_swim;
+	if (!csm->csm_implicit_ack || csm->csm_ctx == NULL)
+		return;
+
+	hlc = d_hlc_get();
+	csh = &crt_ctx->cc_swim_heard[rank % CRT_SWIM_HEARD_NUM];
+	if (csh->csh_rank == rank && hlc - csh->csh_hlc < d_msec2hlc(swim_period_get()) / 4)
+		return;
+	csh->csh_rank = rank;
+	csh->csh_hlc = hlc;
+
+	crt_swim_csm_lock(csm);
+	cst = crt_swim_membs_find(csm, rank);
+	if (cst != NULL) {
+		cst->cst_heard = hlc;
+		found = true;
+	}
+	crt_swim_csm_unlock(csm);
+
+	if (found)
+		swim_member_heard(csm->csm_ctx, rank);
+}
+
 void crt_swim_fini(void)
 {
 	struct crt_grp_priv	*grp_priv = crt_gdata.cg_grp->gg_primary_grp;
@@ -1113,6 +1181,8 @@ int crt_swim_init(int crt_ctx_idx)
 	csm->csm_alive_count = 0;
 	csm->csm_nglitches = 0;
 	csm->csm_nmessages = 0;
+	csm->csm_implicit_ack = true;
+	d_getenv_bool("SWIM_IMPLICIT_ACK", &csm->csm_implicit_ack);
 	/*
 	 * Because daos needs to call crt_self_incarnation_get before it calls
 	 * crt_rank_self_set, we choose the self incarnation here instead of in
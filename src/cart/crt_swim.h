@@ -24,6 +24,8 @@ struct crt_swim_target {
 	d_list_t			 cst_link;
 	swim_id_t			 cst_id;
 	struct swim_member_state	 cst_state;
+	/* HLC of the last message from this member outside of SWIM */
+	uint64_t			 cst_heard;
 };
 
 /**
@@ -51,6 +53,8 @@ struct crt_swim_membs {
 	int				 csm_crt_ctx_idx;
 	int				 csm_nglitches;
 	int				 csm_nmessages;
+	/* regular traffic acks and replaces SWIM pings, see crt_swim_heard */
+	bool				 csm_implicit_ack;
 };
 
 static inline void
@@ -98,5 +102,6 @@ int  crt_swim_rank_del(struct crt_grp_priv *grp_priv, d_rank_t rank);
 void crt_swim_rank_del_all(struct crt_grp_priv *grp_priv);
 void crt_swim_rank_shuffle(struct crt_grp_priv *grp_priv);
 int crt_swim_rank_check(struct crt_grp_priv *grp_priv, d_rank_t rank, uint64_t incarnation);
+void crt_swim_heard(struct crt_context *crt_ctx, d_rank_t rank);
 
 #endif /* __CRT_SWIM_H__ */
@@ -81,6 +81,46 @@ out:
 	return rc;
 }
 
+/*
+ * Build the domain key of each rank of grp_rank_list from the domains of the
+ * primary group. The caller holds the gp_rwlock of grp_priv.
+ */
+static int
+crt_tree_domain_keys(struct crt_grp_priv *grp_priv,
+		     d_rank_list_t *grp_rank_list, uint64_t **keys)
+{
+	struct crt_grp_priv	*prim_grp_priv;
+	struct crt_grp_domain	*dom;
+	uint64_t		*dkeys;
+	int			 i;
+
+	D_ALLOC_ARRAY(dkeys, grp_rank_list->rl_nr);
+	if (dkeys == NULL)
+		return -DER_NOMEM;
+
+	prim_grp_priv = grp_priv->gp_primary ? grp_priv :
+			grp_priv->gp_priv_prim;
+	if (prim_grp_priv != grp_priv)
+		D_RWLOCK_RDLOCK(&prim_grp_priv->gp_rwlock);
+
+	for (i = 0; i < grp_rank_list->rl_nr; i++) {
+		dom = crt_grp_domain_lookup(prim_grp_priv,
+					    grp_rank_list->rl_ranks[i]);
+		/* unknown ranks are separate nodes of an extra rack */
+		if (dom != NULL)
+			dkeys[i] = ((uint64_t)dom->gd_rack << 32) |
+				   dom->gd_node;
+		else
+			dkeys[i] = (0xFFFFFFFFULL << 32) |
+				   grp_rank_list->rl_ranks[i];
+	}
+
+	if (prim_grp_priv != grp_priv)
+		D_RWLOCK_UNLOCK(&prim_grp_priv->gp_rwlock);
+
+	*keys = dkeys;
+	return 0;
+}
 
 #define CRT_TREE_PARAMETER_CHECKING(grp_priv, tree_topo, root, self)	\
 	do {								\
@@ -112,6 +152,7 @@ crt_tree_get_nchildren(struct crt_grp_priv *grp_priv, uint32_t grp_ver,
 	d_rank_list_t		*grp_rank_list = NULL;
 	d_rank_t		 grp_root, grp_self;
 	bool			 allocated = false;
+	uint64_t		*keys = NULL;
 	uint32_t		 tree_type, tree_ratio;
 	uint32_t		 grp_size;
 	struct crt_topo_ops	*tops;
@@ -146,9 +187,17 @@ crt_tree_get_nchildren(struct crt_grp_priv *grp_priv, uint32_t grp_ver,
 		D_GOTO(out, rc = -DER_INVAL);
 	}
 
-	tops = crt_tops[tree_type];
-	rc = tops->to_get_children_cnt(grp_size, tree_ratio, grp_root, grp_self,
-				       nchildren);
+	if (tree_type == CRT_TREE_DOMAIN) {
+		rc = crt_tree_domain_keys(grp_priv, grp_rank_list, &keys);
+		if (rc != 0)
+			D_GOTO(out, rc);
+		rc = crt_domain_get_children(grp_size, tree_ratio, grp_root,
+					     grp_self, keys, NULL, nchildren);
+	} else {
+		tops = crt_tops[tree_type];
+		rc = tops->to_get_children_cnt(grp_size, tree_ratio, grp_root,
+					       grp_self, nchildren);
+	}
 	if (rc != 0)
 		D_ERROR("to_get_children_cnt (group %s, root %d, self %d) "
 			"failed, rc: %d.\n", grp_priv->gp_pub.cg_grpid,
@@ -156,6 +205,7 @@ crt_tree_get_nchildren(struct crt_grp_priv *grp_priv, uint32_t grp_ver,
 
 out:
 	D_RWLOCK_UNLOCK(&grp_priv->gp_rwlock);
+	D_FREE(keys);
 	if (allocated)
 		d_rank_list_free(grp_rank_list);
 	return rc;
@@ -178,6 +228,7 @@ crt_tree_get_children(struct crt_grp_priv *grp_priv, uint32_t grp_ver,
 	d_rank_list_t		*result_rank_list = NULL;
 	d_rank_t		 grp_root, grp_self;
 	bool			 allocated = false;
+	uint64_t		*keys = NULL;
 	uint32_t		 tree_type, tree_ratio;
 	uint32_t		 grp_size, nchildren;
 	uint32_t		 *tree_children;
@@ -225,10 +276,17 @@ crt_tree_get_children(struct crt_grp_priv *grp_priv, uint32_t grp_ver,
 		D_GOTO(out, rc);
 	}
 
-	tops = crt_tops[tree_type];
-
-	rc = tops->to_get_children_cnt(grp_size, tree_ratio, grp_root, grp_self,
-				       &nchildren);
+	if (tree_type == CRT_TREE_DOMAIN) {
+		rc = crt_tree_domain_keys(grp_priv, grp_rank_list, &keys);
+		if (rc != 0)
+			D_GOTO(out, rc);
+		rc = crt_domain_get_children(grp_size, tree_ratio, grp_root,
+					     grp_self, keys, NULL, &nchildren);
+	} else {
+		tops = crt_tops[tree_type];
+		rc = tops->to_get_children_cnt(grp_size, tree_ratio, grp_root,
+					       grp_self, &nchildren);
+	}
 	if (rc != 0) {
 		D_ERROR("to_get_children_cnt (group %s, root %d, self %d) "
 			"failed, rc: %d.\n", grp_priv->gp_pub.cg_grpid,
@@ -248,8 +306,13 @@ crt_tree_get_children(struct crt_grp_priv *grp_priv, uint32_t grp_ver,
 		d_rank_list_free(result_rank_list);
 		D_GOTO(out, rc = -DER_NOMEM);
 	}
-	rc = tops->to_get_children(grp_size, tree_ratio, grp_root, grp_self,
-				   tree_children);
+	if (tree_type == CRT_TREE_DOMAIN)
+		rc = crt_domain_get_children(grp_size, tree_ratio, grp_root,
+					     grp_self, keys, tree_children,
+					     &nchildren);
+	else
+		rc = tops->to_get_children(grp_size, tree_ratio, grp_root,
+					   grp_self, tree_children);
 	if (rc != 0) {
 		D_ERROR("to_get_children (group %s, root %d, self %d) "
 			"failed, rc: %d.\n", grp_priv->gp_pub.cg_grpid,
@@ -268,6 +331,7 @@ crt_tree_get_children(struct crt_grp_priv *grp_priv, uint32_t grp_ver,
 
 out:
 	D_RWLOCK_UNLOCK(&grp_priv->gp_rwlock);
+	D_FREE(keys);
 	if (allocated)
 		d_rank_list_free(grp_rank_list);
 	return rc;
@@ -281,6 +345,7 @@ crt_tree_get_parent(struct crt_grp_priv *grp_priv, uint32_t grp_ver,
 	d_rank_list_t		*grp_rank_list = NULL;
 	d_rank_t		 grp_root, grp_self;
 	bool			 allocated = false;
+	uint64_t		*keys = NULL;
 	uint32_t		 tree_type, tree_ratio;
 	uint32_t		 grp_size, tree_parent;
 	struct crt_topo_ops	*tops;
@@ -315,9 +380,17 @@ crt_tree_get_parent(struct crt_grp_priv *grp_priv, uint32_t grp_ver,
 		D_GOTO(out, rc = -DER_INVAL);
 	}
 
-	tops = crt_tops[tree_type];
-	rc = tops->to_get_parent(grp_size, tree_ratio, grp_root, grp_self,
-				 &tree_parent);
+	if (tree_type == CRT_TREE_DOMAIN) {
+		rc = crt_tree_domain_keys(grp_priv, grp_rank_list, &keys);
+		if (rc != 0)
+			D_GOTO(out, rc);
+		rc = crt_domain_get_parent(grp_size, tree_ratio, grp_root,
+					   grp_self, keys, &tree_parent);
+	} else {
+		tops = crt_tops[tree_type];
+		rc = tops->to_get_parent(grp_size, tree_ratio, grp_root,
+					 grp_self, &tree_parent);
+	}
 	if (rc != 0) {
 		D_ERROR("to_get_parent (group %s, root %d, self %d) failed, "
 			"rc: %d.\n", grp_priv->gp_pub.cg_grpid, root, self, rc);
@@ -327,6 +400,7 @@ crt_tree_get_parent(struct crt_grp_priv *grp_priv, uint32_t grp_ver,
 
 out:
 	D_RWLOCK_UNLOCK(&grp_priv->gp_rwlock);
+	D_FREE(keys);
 	if (allocated)
 		d_rank_list_free(grp_rank_list);
 	return rc;
@@ -337,4 +411,5 @@ struct crt_topo_ops *crt_tops[] = {
 	&crt_flat_ops,		/* CRT_TREE_FLAT */
 	&crt_kary_ops,		/* CRT_TREE_KARY */
 	&crt_knomial_ops,	/* CRT_TREE_KNOMIAL */
+	NULL,			/* CRT_TREE_DOMAIN, see crt_tree_domain.c */
 };
@@ -69,6 +69,18 @@ extern struct crt_topo_ops	 crt_knomial_ops;
 
 extern struct crt_topo_ops	*crt_tops[];
 
+/*
+ * CRT_TREE_DOMAIN has no crt_tops entry as it also needs the domain key,
+ * (rack << 32) | node, of every group rank.
+ */
+int crt_domain_get_children(uint32_t grp_size, uint32_t tree_ratio,
+			    uint32_t grp_root, uint32_t grp_self,
+			    const uint64_t *keys, uint32_t *children,
+			    uint32_t *nchildren);
+int crt_domain_get_parent(uint32_t grp_size, uint32_t tree_ratio,
+			  uint32_t grp_root, uint32_t grp_self,
+			  const uint64_t *keys, uint32_t *parent);
+
 /* some simple helpers */
 static inline int
 crt_tree_type(int tree_topo)
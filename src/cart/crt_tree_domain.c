@@ -0,0 +1,288 @@
+/*
+ * (C) Copyright 2026 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * This file is part of CaRT. It gives out the fault domain aware tree topo
+ * related function implementation.
+ *
+ * Every group rank carries a domain key, (rack << 32) | node. The tree is
+ * built in three levels:
+ * - the root and one leader per remote rack form a k-ary tree;
+ * - in every rack, the rack leader and one leader per remote node form a
+ *   k-ary tree;
+ * - all other engines of a node are flat children of the node leader.
+ * So every engine is reached through at most one cross-rack hop, and only the
+ * node leaders talk across nodes.
+ */
+#define D_LOGFAC	DD_FAC(grp)
+
+#include "crt_internal.h"
+
+struct dom_ent {
+	uint64_t	de_key;
+	uint32_t	de_idx;
+};
+
+/* per call view of the sorted group */
+struct dom_view {
+	struct dom_ent	*dv_ents;
+	uint32_t	 dv_size;
+	uint32_t	 dv_root;
+	/* position of the root and self in dv_ents */
+	uint32_t	 dv_root_pos;
+	uint32_t	 dv_self_pos;
+};
+
+static int
+dom_ent_cmp(const void *a, const void *b)
+{
+	const struct dom_ent	*ea = a;
+	const struct dom_ent	*eb = b;
+
+	if (ea->de_key != eb->de_key)
+		return ea->de_key < eb->de_key ? -1 : 1;
+	if (ea->de_idx != eb->de_idx)
+		return ea->de_idx < eb->de_idx ? -1 : 1;
+	return 0;
+}
+
+static int
+dom_view_init(struct dom_view *dv, uint32_t grp_size, uint32_t grp_root,
+	      uint32_t grp_self, const uint64_t *keys)
+{
+	uint32_t	i;
+
+	D_ASSERT(grp_size > 0);
+	D_ASSERT(grp_root < grp_size && grp_self < grp_size);
+	D_ASSERT(keys != NULL);
+
+	D_ALLOC_ARRAY(dv->dv_ents, grp_size);
+	if (dv->dv_ents == NULL)
+		return -DER_NOMEM;
+
+	for (i = 0; i < grp_size; i++) {
+		dv->dv_ents[i].de_key = keys[i];
+		dv->dv_ents[i].de_idx = i;
+	}
+	qsort(dv->dv_ents, grp_size, sizeof(*dv->dv_ents), dom_ent_cmp);
+
+	dv->dv_size = grp_size;
+	dv->dv_root = grp_root;
+	for (i = 0; i < grp_size; i++) {
+		if (dv->dv_ents[i].de_idx == grp_root)
+			dv->dv_root_pos = i;
+		if (dv->dv_ents[i].de_idx == grp_self)
+			dv->dv_self_pos = i;
+	}
+	return 0;
+}
+
+static void
+dom_view_fini(struct dom_view *dv)
+{
+	D_FREE(dv->dv_ents);
+}
+
+/* [start, end) of the run of entries sharing the (masked) key of pos */
+static void
+dom_run(struct dom_view *dv, uint32_t pos, bool rack, uint32_t *start,
+	uint32_t *end)
+{
+	uint64_t	mask = rack ? ~0xFFFFFFFFULL : ~0ULL;
+	uint64_t	key = dv->dv_ents[pos].de_key & mask;
+	uint32_t	s = pos;
+	uint32_t	e = pos + 1;
+
+	while (s > 0 && (dv->dv_ents[s - 1].de_key & mask) == key)
+		s--;
+	while (e < dv->dv_size && (dv->dv_ents[e].de_key & mask) == key)
+		e++;
+	*start = s;
+	*end = e;
+}
+
+/*
+ * position of the leader of a run: the root if it is inside, otherwise the
+ * first entry
+ */
+static uint32_t
+dom_leader_pos(struct dom_view *dv, uint32_t start, uint32_t end)
+{
+	if (dv->dv_root_pos >= start && dv->dv_root_pos < end)
+		return dv->dv_root_pos;
+	return start;
+}
+
+static uint32_t
+dom_leader(struct dom_view *dv, uint32_t start, uint32_t end)
+{
+	return dv->dv_ents[dom_leader_pos(dv, start, end)].de_idx;
+}
+
+/*
+ * Collect the leaders of the sub-runs of [start, end) into \a list, the one
+ * of the run holding \a first_pos goes first. Runs are racks if \a rack,
+ * nodes otherwise. Returns the number of leaders.
+ */
+static uint32_t
+dom_leaders(struct dom_view *dv, uint32_t start, uint32_t end, bool rack,
+	    uint32_t first_pos, uint32_t *list)
+{
+	uint32_t	nr = 1;
+	uint32_t	s, e;
+
+	dom_run(dv, first_pos, rack, &s, &e);
+	list[0] = dom_leader(dv, s, e);
+
+	for (s = start; s < end; s = e) {
+		dom_run(dv, s, rack, &s, &e);
+		if (first_pos >= s && first_pos < e)
+			continue;
+		list[nr++] = dom_leader(dv, s, e);
+	}
+	return nr;
+}
+
+static uint32_t
+dom_list_pos(uint32_t *list, uint32_t nr, uint32_t idx)
+{
+	uint32_t	i;
+
+	for (i = 0; i < nr; i++) {
+		if (list[i] == idx)
+			return i;
+	}
+	D_ASSERT(0);
+	return 0;
+}
+
+/* append the k-ary children of list[pos] */
+static uint32_t
+dom_kary_children(uint32_t *list, uint32_t nr, uint32_t pos, uint32_t ratio,
+		  uint32_t *children, uint32_t cnt)
+{
+	uint32_t	i;
+
+	for (i = pos * ratio + 1; i < nr && i <= pos * ratio + ratio; i++) {
+		if (children != NULL)
+			children[cnt] = list[i];
+		cnt++;
+	}
+	return cnt;
+}
+
+/*
+ * query the children of \a grp_self, the cross-rack ones go first, then the
+ * intra-rack and the intra-node ones. Only counts them if \a children is
+ * NULL.
+ */
+int
+crt_domain_get_children(uint32_t grp_size, uint32_t tree_ratio,
+			uint32_t grp_root, uint32_t grp_self,
+			const uint64_t *keys, uint32_t *children,
+			uint32_t *nchildren)
+{
+	struct dom_view	 dv;
+	uint32_t	*list = NULL;
+	uint32_t	 node_s, node_e;
+	uint32_t	 rack_s, rack_e;
+	uint32_t	 nr, cnt = 0;
+	uint32_t	 i;
+	int		 rc;
+
+	D_ASSERT(nchildren != NULL);
+	D_ASSERT(tree_ratio >= CRT_TREE_MIN_RATIO &&
+		 tree_ratio <= CRT_TREE_MAX_RATIO);
+
+	rc = dom_view_init(&dv, grp_size, grp_root, grp_self, keys);
+	if (rc != 0)
+		return rc;
+
+	dom_run(&dv, dv.dv_self_pos, false, &node_s, &node_e);
+	/* only node leaders have children */
+	if (dom_leader(&dv, node_s, node_e) != grp_self)
+		D_GOTO(out, rc = 0);
+
+	D_ALLOC_ARRAY(list, grp_size);
+	if (list == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+
+	dom_run(&dv, dv.dv_self_pos, true, &rack_s, &rack_e);
+	if (dom_leader(&dv, rack_s, rack_e) == grp_self) {
+		nr = dom_leaders(&dv, 0, grp_size, true, dv.dv_root_pos, list);
+		cnt = dom_kary_children(list, nr, dom_list_pos(list, nr, grp_self),
+					tree_ratio, children, cnt);
+	}
+
+	nr = dom_leaders(&dv, rack_s, rack_e, false,
+			 dom_leader_pos(&dv, rack_s, rack_e), list);
+	cnt = dom_kary_children(list, nr, dom_list_pos(list, nr, grp_self),
+				tree_ratio, children, cnt);
+
+	for (i = node_s; i < node_e; i++) {
+		if (dv.dv_ents[i].de_idx == grp_self)
+			continue;
+		if (children != NULL)
+			children[cnt] = dv.dv_ents[i].de_idx;
+		cnt++;
+	}
+
+out:
+	D_FREE(list);
+	dom_view_fini(&dv);
+	if (rc == 0)
+		*nchildren = cnt;
+	return rc;
+}
+
+int
+crt_domain_get_parent(uint32_t grp_size, uint32_t tree_ratio,
+		      uint32_t grp_root, uint32_t grp_self,
+		      const uint64_t *keys, uint32_t *parent)
+{
+	struct dom_view	 dv;
+	uint32_t	*list = NULL;
+	uint32_t	 node_s, node_e;
+	uint32_t	 rack_s, rack_e;
+	uint32_t	 leader;
+	uint32_t	 nr;
+	int		 rc;
+
+	D_ASSERT(parent != NULL);
+	D_ASSERT(tree_ratio >= CRT_TREE_MIN_RATIO &&
+		 tree_ratio <= CRT_TREE_MAX_RATIO);
+
+	if (grp_self == grp_root)
+		return -DER_INVAL;
+
+	rc = dom_view_init(&dv, grp_size, grp_root, grp_self, keys);
+	if (rc != 0)
+		return rc;
+
+	dom_run(&dv, dv.dv_self_pos, false, &node_s, &node_e);
+	leader = dom_leader(&dv, node_s, node_e);
+	if (leader != grp_self) {
+		*parent = leader;
+		D_GOTO(out, rc = 0);
+	}
+
+	D_ALLOC_ARRAY(list, grp_size);
+	if (list == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+
+	dom_run(&dv, dv.dv_self_pos, true, &rack_s, &rack_e);
+	if (dom_leader(&dv, rack_s, rack_e) != grp_self) {
+		nr = dom_leaders(&dv, rack_s, rack_e, false,
+				 dom_leader_pos(&dv, rack_s, rack_e), list);
+	} else {
+		nr = dom_leaders(&dv, 0, grp_size, true, dv.dv_root_pos, list);
+	}
+	*parent = list[(dom_list_pos(list, nr, grp_self) - 1) / tree_ratio];
+
+out:
+	D_FREE(list);
+	dom_view_fini(&dv);
+	return rc;
+}
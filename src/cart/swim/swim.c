@@ -1174,6 +1174,40 @@ out:
 	return rc;
 }
 
+int
+swim_member_heard(struct swim_context *ctx, swim_id_t id)
+{
+	struct swim_member_state state;
+	enum swim_context_state	 ctx_state;
+	int			 rc = 0;
+
+	/* unlocked fast path, checked again under the lock */
+	if (id != ctx->sc_target || id == SWIM_ID_INVALID)
+		return 0;
+
+	swim_ctx_lock(ctx);
+	ctx_state = swim_state_get(ctx);
+	if (id != ctx->sc_target ||
+	    (ctx_state != SCS_BEGIN && ctx_state != SCS_PINGED && ctx_state != SCS_IPINGED))
+		D_GOTO(out_unlock, rc = 0);
+
+	rc = ctx->sc_ops->get_member_state(ctx, id, &state);
+	if (rc)
+		D_GOTO(out_unlock, rc);
+
+	/*
+	 * A suspected member still has to be pinged, so that it learns about
+	 * the suspicion and refutes it with a new incarnation.
+	 */
+	if (state.sms_status == SWIM_MEMBER_ALIVE) {
+		SWIM_INFO("%lu: target %lu okay by other traffic\n", ctx->sc_self, id);
+		swim_state_set(ctx, SCS_SELECT);
+	}
+out_unlock:
+	swim_ctx_unlock(ctx);
+	return rc;
+}
+
 void
 swim_member_del(struct swim_context *ctx, swim_id_t id)
 {
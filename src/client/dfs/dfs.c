@@ -497,7 +497,9 @@ out:
  * OID generation for the dfs objects.
  *
  * The oid.lo uint64_t value will be allocated from the DAOS container using the
- * unique oid allocator. 1 oid at a time will be allocated for the dfs mount.
+ * unique oid allocator. 1 oid at a time will be allocated for the dfs mount,
+ * it is usually served from the OID lease of the container handle without a
+ * round trip to the engines (see DAOS_OID_LEASE_MAX).
  * The oid.hi value has the high 32 bits reserved for DAOS (obj class, type,
  * etc.). The lower 32 bits will be used locally by the dfs mount point, and
  * hence discarded when the dfs is unmounted.
@@ -116,6 +116,8 @@ struct btr_context {
 	 * while draining the tree
 	 */
 	uint32_t                         tc_creds_on : 1;
+	/** drain credits are charged per leaf node, see dbtree_drain_bulk */
+	uint32_t                         tc_creds_bulk : 1;
 	/**
 	 * returned value of the probe, it should be reset after upsert
 	 * or delete because the probe path could have been changed.
@@ -3477,7 +3479,7 @@ btr_node_destroy(struct btr_context *tcx, umem_off_t nd_off,
 			if (rc != 0)
 				return rc;
 
-			if (!tcx->tc_creds_on)
+			if (!tcx->tc_creds_on || tcx->tc_creds_bulk)
 				continue;
 
 			/* NB: only leaf record consumes user credits */
@@ -3488,6 +3490,11 @@ btr_node_destroy(struct btr_context *tcx, umem_off_t nd_off,
 				break;
 			}
 		}
+		/* NB: bulk drain charges one credit per leaf node */
+		if (tcx->tc_creds_on && tcx->tc_creds_bulk) {
+			D_ASSERT(tcx->tc_creds > 0);
+			tcx->tc_creds--;
+		}
 	} else { /* non-leaf */
 		for (i = nd->tn_keyn; i >= 0; i--) {
 			umem_off_t	child_off;
@@ -3607,8 +3614,9 @@ dbtree_destroy(daos_handle_t toh, void *args)
  * \param args		[IN]	 user parameter for btr_ops_t::to_rec_free
  * \param destroy	[OUT]	 Tree is empty and destroyed
  */
-int
-dbtree_drain(daos_handle_t toh, int *credits, void *args, bool *destroyed)
+static int
+btr_drain(daos_handle_t toh, int *credits, void *args, bool bulk,
+	  bool *destroyed)
 {
 	struct btr_context *tcx;
 	int		    rc;
@@ -3625,6 +3633,7 @@ dbtree_drain(daos_handle_t toh, int *credits, void *args, bool *destroyed)
 		}
 		tcx->tc_creds = *credits;
 		tcx->tc_creds_on = 1;
+		tcx->tc_creds_bulk = bulk;
 	}
 
 	rc = btr_tx_tree_destroy(tcx, args, destroyed);
@@ -3635,10 +3644,34 @@ dbtree_drain(daos_handle_t toh, int *credits, void *args, bool *destroyed)
 		*credits = tcx->tc_creds;
 failed:
 	tcx->tc_creds_on = 0;
+	tcx->tc_creds_bulk = 0;
 	tcx->tc_creds = 0;
 	return rc;
 }
 
+int
+dbtree_drain(daos_handle_t toh, int *credits, void *args, bool *destroyed)
+{
+	return btr_drain(toh, credits, args, false, destroyed);
+}
+
+/**
+ * Same as dbtree_drain(), but each leaf node consumes a single credit no
+ * matter how many records it holds. Records are still freed one by one via
+ * btr_ops_t::to_rec_free, so this is meant for tearing down trees whose
+ * records are cheap to free, e.g. subtrees of a punched object.
+ *
+ * \param toh		[IN]	 Tree open handle.
+ * \param credits	[IN/OUT] Input and returned drain credits (nodes)
+ * \param args		[IN]	 user parameter for btr_ops_t::to_rec_free
+ * \param destroy	[OUT]	 Tree is empty and destroyed
+ */
+int
+dbtree_drain_bulk(daos_handle_t toh, int *credits, void *args, bool *destroyed)
+{
+	return btr_drain(toh, credits, args, true, destroyed);
+}
+
 /**** Iterator APIs *********************************************************/
 
 /**
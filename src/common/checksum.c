@@ -232,6 +232,35 @@ daos_csummer_update(struct daos_csummer *obj, uint8_t *buf, size_t buf_len)
 	return rc;
 }
 
+int
+daos_csummer_calc_bufs(struct daos_csummer *obj, uint8_t **bufs,
+		       uint32_t *buf_lens, uint8_t **csums, uint32_t nr)
+{
+	uint16_t	csum_len = daos_csummer_get_csum_len(obj);
+	uint32_t	i;
+	int		rc = 0;
+
+	if (obj->dcs_algo->cf_batch != NULL) {
+		rc = obj->dcs_algo->cf_batch(obj->dcs_ctx, bufs, buf_lens,
+					     csums, nr);
+	} else {
+		for (i = 0; i < nr && rc == 0; i++) {
+			daos_csummer_set_buffer(obj, csums[i], csum_len);
+			rc = daos_csummer_reset(obj);
+			if (rc == 0)
+				rc = daos_csummer_update(obj, bufs[i],
+							 buf_lens[i]);
+			if (rc == 0)
+				rc = daos_csummer_finish(obj);
+		}
+	}
+
+	C_TRACE("Calculated %u checksum(s) (type=%s) in batch: "DF_RC"\n", nr,
+		daos_csummer_get_name(obj), DP_RC(rc));
+
+	return rc;
+}
+
 int
 daos_csummer_finish(struct daos_csummer *obj)
 {
@@ -455,37 +484,104 @@ done:
 	return rc;
 }
 
+/** Max number of chunks to be calculated in one batch */
+#define CSUM_BATCH_MAX	32
+
+/**
+ * Chunks (possibly of different recxs & iods) whose checksums are to be
+ * calculated together by daos_csummer_calc_bufs().
+ */
+struct csum_batch {
+	uint8_t		*cb_bufs[CSUM_BATCH_MAX];
+	uint8_t		*cb_csums[CSUM_BATCH_MAX];
+	uint32_t	 cb_lens[CSUM_BATCH_MAX];
+	uint32_t	 cb_nr;
+};
+
+static int
+csum_batch_flush(struct daos_csummer *obj, struct csum_batch *batch)
+{
+	int rc;
+
+	if (batch == NULL || batch->cb_nr == 0)
+		return 0;
+
+	rc = daos_csummer_calc_bufs(obj, batch->cb_bufs, batch->cb_lens,
+				    batch->cb_csums, batch->cb_nr);
+	if (rc != 0)
+		D_ERROR("daos_csummer_calc_bufs error: "DF_RC"\n", DP_RC(rc));
+	batch->cb_nr = 0;
+
+	return rc;
+}
+
+/**
+ * Calculate the checksum of the next \a bytes of the sgl into \a csum. The
+ * chunk is queued to \a batch if it's contiguous in the sgl, otherwise (or
+ * when \a batch is NULL) it's calculated immediately.
+ */
+static int
+calc_csum_chunk(struct daos_csummer *obj, struct csum_batch *batch,
+		d_sg_list_t *sgl, struct daos_sgl_idx *idx, size_t bytes,
+		uint8_t *csum, uint32_t csum_len)
+{
+	d_iov_t	*iov;
+	int	 rc;
+
+	if (batch != NULL && obj->dcs_algo->cf_batch != NULL &&
+	    idx->iov_idx < sgl->sg_nr && bytes <= UINT32_MAX) {
+		iov = &sgl->sg_iovs[idx->iov_idx];
+		if (iov->iov_len - idx->iov_offset >= bytes) {
+			if (batch->cb_nr == CSUM_BATCH_MAX) {
+				rc = csum_batch_flush(obj, batch);
+				if (rc != 0)
+					return rc;
+			}
+			batch->cb_bufs[batch->cb_nr] = iov->iov_buf +
+						       idx->iov_offset;
+			batch->cb_lens[batch->cb_nr] = bytes;
+			batch->cb_csums[batch->cb_nr] = csum;
+			batch->cb_nr++;
+
+			daos_sgl_get_bytes(sgl, false, idx, bytes, NULL, NULL);
+			return 0;
+		}
+	}
+
+	daos_csummer_set_buffer(obj, csum, csum_len);
+	daos_csummer_reset(obj);
+
+	rc = daos_sgl_processor(sgl, false, idx, bytes, checksum_sgl_cb, obj);
+	if (rc != 0) {
+		D_ERROR("daos_sgl_processor error: "DF_RC"\n", DP_RC(rc));
+		return rc;
+	}
+
+	return daos_csummer_finish(obj);
+}
+
 static int
 calc_csum_recx_with_no_map(struct daos_csummer *obj, size_t csum_nr,
 			   daos_recx_t *recx,
 			   struct dcs_csum_info *csum_info,
 			   size_t rec_len, d_sg_list_t *sgl,
 			   uint32_t rec_chunksize,
-			   struct daos_sgl_idx *idx)
+			   struct daos_sgl_idx *idx, struct csum_batch *batch)
 {
 	struct daos_csum_range	 chunk;
-	daos_size_t		 bytes_for_csum;
-	uint8_t			*buf;
 	uint32_t		 i;
 	int			 rc;
 
 	for (i = 0; i < csum_nr; i++) {
-		buf = ci_idx2csum(csum_info, i);
-		daos_csummer_set_buffer(obj, buf, csum_info->cs_len);
-		daos_csummer_reset(obj);
-
 		chunk = csum_recx_chunkidx2range(recx, rec_len,
 						 rec_chunksize, i);
 
-		bytes_for_csum = chunk.dcr_nr * rec_len;
-		rc = daos_sgl_processor(sgl, false, idx, bytes_for_csum,
-					checksum_sgl_cb, obj);
-		if (rc != 0) {
-			D_ERROR("daos_sgl_processor error: "DF_RC"\n",
-				DP_RC(rc));
+		rc = calc_csum_chunk(obj, batch, sgl, idx,
+				     chunk.dcr_nr * rec_len,
+				     ci_idx2csum(csum_info, i),
+				     csum_info->cs_len);
+		if (rc != 0)
 			return rc;
-		}
-		daos_csummer_finish(obj);
 	}
 
 	return 0;
@@ -622,7 +718,7 @@ calc_csum_recx_with_map(struct daos_csummer *obj, size_t *csum_nr,
 static int
 calc_csum_recx(struct daos_csummer *obj, d_sg_list_t *sgl, size_t rec_len,
 	       daos_recx_t *recxs, size_t nr, struct dcs_csum_info *csums,
-	       daos_iom_t *map)
+	       daos_iom_t *map, struct csum_batch *batch)
 {
 	size_t			 csum_nr;
 	uint32_t		 rec_chunksize;
@@ -648,7 +744,8 @@ calc_csum_recx(struct daos_csummer *obj, d_sg_list_t *sgl, size_t rec_len,
 		else
 			rc = calc_csum_recx_with_no_map(obj, csum_nr, &recxs[i],
 							&csums[i], rec_len, sgl,
-							rec_chunksize, &idx);
+							rec_chunksize, &idx,
+							batch);
 		if (rc != 0)
 			return rc;
 
@@ -664,7 +761,7 @@ calc_csum_recx(struct daos_csummer *obj, d_sg_list_t *sgl, size_t rec_len,
 static int
 calc_csum_sv(struct daos_csummer *obj, d_sg_list_t *sgl, size_t rec_len,
 	     struct dcs_layout *singv_lo, int singv_idx,
-	     struct dcs_csum_info *csums)
+	     struct dcs_csum_info *csums, struct csum_batch *batch)
 {
 	size_t			 bytes_for_csum, data_len;
 	size_t			 last_size = -1;
@@ -728,15 +825,10 @@ calc_csum_sv(struct daos_csummer *obj, d_sg_list_t *sgl, size_t rec_len,
 		}
 
 		csum_buf = ci_idx2csum(&csums[0], idx);
-		daos_csummer_set_buffer(obj, csum_buf, csums->cs_len);
-		daos_csummer_reset(obj);
-
-		rc = daos_sgl_processor(sgl, false, &sgl_idx, bytes_for_csum,
-					checksum_sgl_cb, obj);
+		rc = calc_csum_chunk(obj, batch, sgl, &sgl_idx, bytes_for_csum,
+				     csum_buf, csums->cs_len);
 		if (rc)
 			return rc;
-
-		daos_csummer_finish(obj);
 	}
 
 	C_TRACE("Calculated checksum for Single Value (len=%lu) -> "
@@ -784,11 +876,16 @@ daos_csummer_calc_one(struct daos_csummer *obj, d_sg_list_t *sgl,
 		       struct dcs_csum_info *csums, size_t rec_len, size_t nr,
 		       size_t idx)
 {
-	daos_recx_t recx = { 0 };
+	daos_recx_t		recx = { 0 };
+	struct csum_batch	batch = { 0 };
+	int			rc;
 
 	recx.rx_idx = idx;
 	recx.rx_nr = nr;
-	return calc_csum_recx(obj, sgl, rec_len, &recx, 1, csums, NULL);
+	rc = calc_csum_recx(obj, sgl, rec_len, &recx, 1, csums, NULL, &batch);
+	if (rc == 0)
+		rc = csum_batch_flush(obj, &batch);
+	return rc;
 }
 
 int
@@ -801,6 +898,7 @@ daos_csummer_calc_iods(struct daos_csummer *obj, d_sg_list_t *sgls,
 	int			 i;
 	struct dcs_iod_csums	*iods_csums = NULL;
 	struct dcs_layout	*singv_lo, *los;
+	struct csum_batch	 batch = { 0 };
 	uint32_t		 iods_csums_nr;
 	uint16_t		 csum_len = daos_csummer_get_csum_len(obj);
 
@@ -854,9 +952,9 @@ daos_csummer_calc_iods(struct daos_csummer *obj, d_sg_list_t *sgls,
 		rc = is_array_iod(iod) ?
 		     calc_csum_recx(obj, &sgls[i], iod->iod_size,
 				    iod->iod_recxs, iod->iod_nr,
-				    csums->ic_data, map) :
+				    csums->ic_data, map, &batch) :
 		     calc_csum_sv(obj, &sgls[i], iod->iod_size, singv_lo,
-				  singv_idx, csums->ic_data);
+				  singv_idx, csums->ic_data, &batch);
 		csums->ic_nr = iod->iod_nr;
 
 		if (rc != 0) {
@@ -865,6 +963,11 @@ daos_csummer_calc_iods(struct daos_csummer *obj, d_sg_list_t *sgls,
 		}
 	}
 
+	/** chunks of all iods are queued, calculate what's left */
+	rc = csum_batch_flush(obj, &batch);
+	if (rc != 0)
+		goto error;
+
 	*p_iods_csums = iods_csums;
 
 	return 0;
@@ -984,6 +1087,59 @@ done:
 	return rc;
 }
 
+int
+daos_csummer_verify_iods(struct daos_csummer *obj, daos_iod_t *iods,
+			 d_sg_list_t *sgls, struct dcs_iod_csums *iods_csums,
+			 uint32_t nr, uint32_t *bad_idx)
+{
+	struct dcs_iod_csums	*new_iods_csums;
+	daos_iod_t		*iod;
+	uint32_t		 i, j;
+	int			 rc;
+
+	if (!daos_csummer_initialized(obj) || obj->dcs_skip_data_verify)
+		return 0;
+
+	if (iods == NULL || sgls == NULL || iods_csums == NULL) {
+		D_ERROR("Invalid params\n");
+		return -DER_INVAL;
+	}
+
+	rc = daos_csummer_calc_iods(obj, sgls, iods, NULL, nr, 0, NULL, 0,
+				    &new_iods_csums);
+	if (rc != 0) {
+		D_ERROR("daos_csummer_calc_iods error: "DF_RC"\n", DP_RC(rc));
+		return rc;
+	}
+
+	for (i = 0; i < nr; i++) {
+		iod = &iods[i];
+		if (!csum_iod_is_supported(iod))
+			continue;
+
+		for (j = 0; j < iod->iod_nr; j++) {
+			if (daos_csummer_compare_csum_info(obj,
+					&new_iods_csums[i].ic_data[j],
+					&iods_csums[i].ic_data[j]))
+				continue;
+
+			D_ERROR("Data corruption found for iod %u: "DF_C_IOD". "
+				"Calculated "DF_CI" != received "DF_CI"\n",
+				i, DP_C_IOD(iod),
+				DP_CI(new_iods_csums[i].ic_data[j]),
+				DP_CI(iods_csums[i].ic_data[j]));
+			if (bad_idx != NULL)
+				*bad_idx = i;
+			D_GOTO(done, rc = -DER_CSUM);
+		}
+	}
+
+done:
+	daos_csummer_free_ic(obj, &new_iods_csums);
+
+	return rc;
+}
+
 int
 daos_csummer_verify_key(struct daos_csummer *obj, daos_key_t *key,
 			struct dcs_csum_info *csum)
@@ -69,8 +69,21 @@ crc16_finish(void *daos_mhash_ctx, uint8_t *buf, size_t buf_len)
 	return 0;
 }
 
+static int
+crc16_batch(void *daos_mhash_ctx, uint8_t **bufs, uint32_t *buf_lens,
+	    uint8_t **hashes, uint32_t nr)
+{
+	uint32_t i;
+
+	for (i = 0; i < nr; i++)
+		*((uint16_t *)hashes[i]) = crc16_t10dif(0, bufs[i],
+							(int)buf_lens[i]);
+	return 0;
+}
+
 struct hash_ft crc16_algo = {
 	.cf_update	= crc16_update,
+	.cf_batch	= crc16_batch,
 	.cf_init	= crc16_init,
 	.cf_reset	= crc16_reset,
 	.cf_destroy	= crc16_destroy,
@@ -126,8 +139,21 @@ crc32_finish(void *daos_mhash_ctx, uint8_t *buf, size_t buf_len)
 	return 0;
 }
 
+static int
+crc32_batch(void *daos_mhash_ctx, uint8_t **bufs, uint32_t *buf_lens,
+	    uint8_t **hashes, uint32_t nr)
+{
+	uint32_t i;
+
+	for (i = 0; i < nr; i++)
+		*((uint32_t *)hashes[i]) = crc32_iscsi(bufs[i],
+						       (int)buf_lens[i], 0);
+	return 0;
+}
+
 struct hash_ft crc32_algo = {
 	.cf_update	= crc32_update,
+	.cf_batch	= crc32_batch,
 	.cf_init	= crc32_init,
 	.cf_reset	= crc32_reset,
 	.cf_destroy	= crc32_destroy,
@@ -180,8 +206,21 @@ adler32_finish(void *daos_mhash_ctx, uint8_t *buf, size_t buf_len)
 	return 0;
 }
 
+static int
+adler32_batch(void *daos_mhash_ctx, uint8_t **bufs, uint32_t *buf_lens,
+	      uint8_t **hashes, uint32_t nr)
+{
+	uint32_t i;
+
+	for (i = 0; i < nr; i++)
+		*((uint32_t *)hashes[i]) = isal_adler32(0, bufs[i],
+							buf_lens[i]);
+	return 0;
+}
+
 struct hash_ft adler32_algo = {
 	.cf_update	= adler32_update,
+	.cf_batch	= adler32_batch,
 	.cf_init	= adler32_init,
 	.cf_reset	= adler32_reset,
 	.cf_destroy	= adler32_destroy,
@@ -237,8 +276,21 @@ crc64_finish(void *daos_mhash_ctx, uint8_t *buf, size_t buf_len)
 	return 0;
 }
 
+static int
+crc64_batch(void *daos_mhash_ctx, uint8_t **bufs, uint32_t *buf_lens,
+	    uint8_t **hashes, uint32_t nr)
+{
+	uint32_t i;
+
+	for (i = 0; i < nr; i++)
+		*((uint64_t *)hashes[i]) = crc64_ecma_refl(0, bufs[i],
+							   buf_lens[i]);
+	return 0;
+}
+
 struct hash_ft crc64_algo = {
 	.cf_update	= crc64_update,
+	.cf_batch	= crc64_batch,
 	.cf_init	= crc64_init,
 	.cf_reset	= crc64_reset,
 	.cf_destroy	= crc64_destroy,
@@ -304,8 +356,30 @@ sha1_finish(void *daos_mhash_ctx, uint8_t *buf, size_t buf_len)
 	return 0;
 }
 
+static int
+sha1_batch(void *daos_mhash_ctx, uint8_t **bufs, uint32_t *buf_lens,
+	   uint8_t **hashes, uint32_t nr)
+{
+	struct sha1_ctx	*ctx = daos_mhash_ctx;
+	uint32_t	 i;
+	int		 rc = 0;
+
+	/** mh_sha1 is already multi-lane within a buffer */
+	for (i = 0; i < nr && rc == 0; i++) {
+		rc = mh_sha1_init(&ctx->s1_ctx);
+		if (rc == 0)
+			rc = mh_sha1_update(&ctx->s1_ctx, bufs[i], buf_lens[i]);
+		if (rc == 0)
+			rc = mh_sha1_finalize(&ctx->s1_ctx, hashes[i]);
+	}
+	ctx->s1_updated = false;
+
+	return rc;
+}
+
 struct hash_ft sha1_algo = {
 	.cf_update	= sha1_update,
+	.cf_batch	= sha1_batch,
 	.cf_init	= sha1_init,
 	.cf_reset	= sha1_reset,
 	.cf_destroy	= sha1_destroy,
@@ -371,8 +445,31 @@ sha256_finish(void *daos_mhash_ctx, uint8_t *buf, size_t buf_len)
 	return 0;
 }
 
+static int
+sha256_batch(void *daos_mhash_ctx, uint8_t **bufs, uint32_t *buf_lens,
+	     uint8_t **hashes, uint32_t nr)
+{
+	struct sha256_ctx	*ctx = daos_mhash_ctx;
+	uint32_t		 i;
+	int			 rc = 0;
+
+	/** mh_sha256 is already multi-lane within a buffer */
+	for (i = 0; i < nr && rc == 0; i++) {
+		rc = mh_sha256_init(&ctx->s2_ctx);
+		if (rc == 0)
+			rc = mh_sha256_update(&ctx->s2_ctx, bufs[i],
+					      buf_lens[i]);
+		if (rc == 0)
+			rc = mh_sha256_finalize(&ctx->s2_ctx, hashes[i]);
+	}
+	ctx->s2_updated = false;
+
+	return rc;
+}
+
 struct hash_ft sha256_algo = {
 	.cf_update	= sha256_update,
+	.cf_batch	= sha256_batch,
 	.cf_init	= sha256_init,
 	.cf_reset	= sha256_reset,
 	.cf_destroy	= sha256_destroy,
@@ -383,9 +480,14 @@ struct hash_ft sha256_algo = {
 };
 
 /** SHA512 */
+/** Number of buffers hashed in parallel by the sha512 multi-buffer manager */
+#define SHA512_BATCH_LANES	8
+
 struct sha512_ctx {
 	SHA512_HASH_CTX_MGR	s5_mgr;
 	SHA512_HASH_CTX		s5_ctx;
+	/** jobs for hashing multiple buffers at once */
+	SHA512_HASH_CTX		s5_jobs[SHA512_BATCH_LANES];
 	bool			s5_updated;
 };
 
@@ -468,8 +570,41 @@ sha512_finish(void *daos_mhash_ctx, uint8_t *buf, size_t buf_len)
 	return 0;
 }
 
+static int
+sha512_batch(void *daos_mhash_ctx, uint8_t **bufs, uint32_t *buf_lens,
+	     uint8_t **hashes, uint32_t nr)
+{
+	struct sha512_ctx	*ctx = daos_mhash_ctx;
+	uint32_t		 i, j, n;
+
+	for (i = 0; i < nr; i += n) {
+		n = min(nr - i, SHA512_BATCH_LANES);
+
+		/** submit a job for each buffer, lanes are run in parallel */
+		for (j = 0; j < n; j++) {
+			hash_ctx_init(&ctx->s5_jobs[j]);
+			sha512_ctx_mgr_submit(&ctx->s5_mgr, &ctx->s5_jobs[j],
+					      bufs[i + j], buf_lens[i + j],
+					      HASH_ENTIRE);
+		}
+
+		while (sha512_ctx_mgr_flush(&ctx->s5_mgr) != NULL)
+			;
+
+		for (j = 0; j < n; j++) {
+			if (ctx->s5_jobs[j].error)
+				return ctx->s5_jobs[j].error;
+			memcpy(hashes[i + j],
+			       ctx->s5_jobs[j].job.result_digest, 512 / 8);
+		}
+	}
+
+	return 0;
+}
+
 struct hash_ft sha512_algo = {
 	.cf_update	= sha512_update,
+	.cf_batch	= sha512_batch,
 	.cf_init	= sha512_init,
 	.cf_reset	= sha512_reset,
 	.cf_destroy	= sha512_destroy,
@@ -84,6 +84,8 @@ struct pool_map {
 	uint32_t		po_in_ver;
 	/* Current least fseq version from all DOWN targets. */
 	uint32_t		po_fseq;
+	/** flattened index of \a po_tree, see pool_map_flat */
+	struct pool_map_flat	po_flat;
 };
 
 static struct pool_comp_state_dict comp_state_dict[] = {
@@ -882,6 +884,157 @@ pool_tree_copy(struct pool_domain *dst, struct pool_domain *src)
 	pool_tree_build_ptrs(dst, &cntr);
 }
 
+/**
+ * IDs are looked up by binary search of the sorters instead of direct
+ * tables if they are sparser than this ratio.
+ */
+#define PO_FLAT_SPARSE_RATIO	4
+
+static void
+pool_map_flat_fini(struct pool_map_flat *flat)
+{
+	int	i;
+
+	if (flat->pf_layers != NULL) {
+		for (i = 0; i < flat->pf_layer_nr; i++)
+			D_FREE(flat->pf_layers[i].fl_id2idx);
+		D_FREE(flat->pf_layers);
+	}
+	D_FREE(flat->pf_child_start);
+	D_FREE(flat->pf_tgt_start);
+	D_FREE(flat->pf_tgt_id2idx);
+	D_FREE(flat->pf_rank2idx);
+	memset(flat, 0, sizeof(*flat));
+}
+
+/**
+ * Allocate a direct lookup table for \a nr components whose maximum ID
+ * (or rank) is \a max_id. No table is allocated for sparse IDs.
+ */
+static int
+pool_map_flat_table(uint32_t max_id, uint32_t nr, uint32_t **table_p,
+		    uint32_t *table_nr)
+{
+	uint32_t	*table;
+	uint32_t	 i;
+
+	*table_p = NULL;
+	*table_nr = 0;
+	if (max_id / PO_FLAT_SPARSE_RATIO >= nr)
+		return 0;
+
+	D_ALLOC_ARRAY(table, max_id + 1);
+	if (table == NULL)
+		return -DER_NOMEM;
+
+	for (i = 0; i <= max_id; i++)
+		table[i] = PO_FLAT_IDX_NONE;
+
+	*table_p = table;
+	*table_nr = max_id + 1;
+	return 0;
+}
+
+/** Build the flattened index of the component tree of \a map */
+static int
+pool_map_flat_build(struct pool_map *map)
+{
+	struct pool_map_flat	*flat = &map->po_flat;
+	struct pool_domain	*tree = map->po_tree;
+	struct pool_target	*targets = tree[0].do_targets;
+	struct pool_comp_cntr	 cntr;
+	struct pool_flat_layer	*layer;
+	uint32_t		 max_id;
+	uint32_t		 start;
+	uint32_t		 i;
+	uint32_t		 j;
+	int			 rc;
+
+	pool_tree_count(tree, &cntr);
+	flat->pf_dom_nr	  = cntr.cc_domains;
+	flat->pf_tgt_nr	  = cntr.cc_targets;
+	flat->pf_layer_nr = map->po_domain_layers;
+
+	D_ALLOC_ARRAY(flat->pf_layers, flat->pf_layer_nr);
+	D_ALLOC_ARRAY(flat->pf_child_start, flat->pf_dom_nr);
+	D_ALLOC_ARRAY(flat->pf_tgt_start, flat->pf_dom_nr);
+	if (flat->pf_layers == NULL || flat->pf_child_start == NULL ||
+	    flat->pf_tgt_start == NULL)
+		D_GOTO(failed, rc = -DER_NOMEM);
+
+	for (i = 0; i < flat->pf_dom_nr; i++) {
+		if (tree[i].do_children != NULL)
+			flat->pf_child_start[i] = tree[i].do_children - tree;
+		else
+			flat->pf_child_start[i] = tree[i].do_targets - targets;
+		flat->pf_tgt_start[i] = tree[i].do_targets - targets;
+	}
+
+	for (i = start = 0; i < flat->pf_layer_nr; i++) {
+		layer = &flat->pf_layers[i];
+		layer->fl_type	= map->po_domain_sorters[i].cs_type;
+		layer->fl_start	= start;
+		layer->fl_nr	= map->po_domain_sorters[i].cs_nr;
+		start += layer->fl_nr;
+
+		for (j = max_id = 0; j < layer->fl_nr; j++)
+			max_id = max(max_id, tree[layer->fl_start + j].do_comp.co_id);
+
+		rc = pool_map_flat_table(max_id, layer->fl_nr, &layer->fl_id2idx,
+					 &layer->fl_id_nr);
+		if (rc)
+			goto failed;
+
+		for (j = layer->fl_nr; layer->fl_id2idx != NULL && j > 0; j--) {
+			/* NB: reverse order so the first one wins for duplicate IDs */
+			layer->fl_id2idx[tree[layer->fl_start + j - 1].do_comp.co_id] =
+				layer->fl_start + j - 1;
+		}
+
+		if (layer->fl_type != PO_COMP_TP_RANK)
+			continue;
+
+		for (j = max_id = 0; j < layer->fl_nr; j++)
+			max_id = max(max_id, tree[layer->fl_start + j].do_comp.co_rank);
+
+		rc = pool_map_flat_table(max_id, layer->fl_nr, &flat->pf_rank2idx,
+					 &flat->pf_rank_nr);
+		if (rc)
+			goto failed;
+
+		for (j = layer->fl_nr; flat->pf_rank2idx != NULL && j > 0; j--)
+			flat->pf_rank2idx[tree[layer->fl_start + j - 1].do_comp.co_rank] =
+				layer->fl_start + j - 1;
+	}
+	D_ASSERT(start == flat->pf_dom_nr);
+
+	for (i = max_id = 0; i < flat->pf_tgt_nr; i++)
+		max_id = max(max_id, targets[i].ta_comp.co_id);
+
+	rc = pool_map_flat_table(max_id, flat->pf_tgt_nr, &flat->pf_tgt_id2idx,
+				 &flat->pf_tgt_id_nr);
+	if (rc)
+		goto failed;
+
+	for (i = flat->pf_tgt_nr; flat->pf_tgt_id2idx != NULL && i > 0; i--)
+		flat->pf_tgt_id2idx[targets[i - 1].ta_comp.co_id] = i - 1;
+
+	return 0;
+failed:
+	pool_map_flat_fini(flat);
+	return rc;
+}
+
+/**
+ * Return the flattened index of the component tree, NULL if the pool map is
+ * empty. It is only valid until the next tree change, e.g. pool_map_extend().
+ */
+struct pool_map_flat *
+pool_map_flat_get(struct pool_map *map)
+{
+	return pool_map_empty(map) ? NULL : &map->po_flat;
+}
+
 /** free data members of a pool map */
 static void
 pool_map_finalise(struct pool_map *map)
@@ -890,6 +1043,7 @@ pool_map_finalise(struct pool_map *map)
 
 	D_DEBUG(DB_TRACE, "Release buffers for pool map\n");
 
+	pool_map_flat_fini(&map->po_flat);
 	comp_sorter_fini(&map->po_target_sorter);
 
 	D_FREE(map->po_comp_fail_cnts);
@@ -1026,6 +1180,10 @@ pool_map_initialise(struct pool_map *map, struct pool_domain *tree)
 	if (rc != 0)
 		goto out_target_sorter;
 
+	rc = pool_map_flat_build(map);
+	if (rc != 0)
+		goto out_target_sorter;
+
 	return 0;
 
 out_target_sorter:
@@ -1799,7 +1957,7 @@ int
 pool_map_find_domain(struct pool_map *map, pool_comp_type_t type, uint32_t id,
 		     struct pool_domain **domain_pp)
 {
-	struct pool_comp_sorter *sorter;
+	struct pool_flat_layer	*layer;
 	struct pool_domain	*tmp;
 	int			 i;
 
@@ -1810,31 +1968,34 @@ pool_map_find_domain(struct pool_map *map, pool_comp_type_t type, uint32_t id,
 
 	D_ASSERT(map->po_domain_layers > 0);
 	/* all other domains under root are stored in contiguous buffer */
-	for (tmp = map->po_tree, i = 0; tmp != NULL;
-	     tmp = tmp->do_children, i++) {
-		if (tmp[0].do_comp.co_type == type)
+	for (i = 0; i < map->po_flat.pf_layer_nr; i++) {
+		if (map->po_flat.pf_layers[i].fl_type == type)
 			break;
 	}
 
-	D_ASSERT(i <= map->po_domain_layers);
-	if (i == map->po_domain_layers) {
+	if (i == map->po_flat.pf_layer_nr) {
 		D_DEBUG(DB_MGMT, "Can't find domain type %s(%d)\n",
 			pool_comp_type2str(type), type);
 		return 0;
 	}
 
-	sorter = &map->po_domain_sorters[i];
-	D_ASSERT(sorter->cs_type == type);
-
+	layer = &map->po_flat.pf_layers[i];
 	if (id == PO_COMP_ID_ALL) {
 		if (domain_pp != NULL)
-			*domain_pp = tmp;
-		return sorter->cs_nr;
+			*domain_pp = &map->po_tree[layer->fl_start];
+		return layer->fl_nr;
 	}
 
-	tmp = comp_sorter_find_domain(sorter, id);
-	if (tmp == NULL)
-		return 0;
+	if (layer->fl_id2idx != NULL) {
+		if (id >= layer->fl_id_nr || layer->fl_id2idx[id] == PO_FLAT_IDX_NONE)
+			return 0;
+		tmp = &map->po_tree[layer->fl_id2idx[id]];
+	} else {
+		D_ASSERT(map->po_domain_sorters[i].cs_type == type);
+		tmp = comp_sorter_find_domain(&map->po_domain_sorters[i], id);
+		if (tmp == NULL)
+			return 0;
+	}
 
 	if (domain_pp != NULL)
 		*domain_pp = tmp;
@@ -1889,9 +2050,16 @@ pool_map_find_target(struct pool_map *map, uint32_t id,
 		return map->po_tree[0].do_target_nr;
 	}
 
-	target = comp_sorter_find_target(sorter, id);
-	if (target == NULL)
-		return 0;
+	if (map->po_flat.pf_tgt_id2idx != NULL) {
+		if (id >= map->po_flat.pf_tgt_id_nr ||
+		    map->po_flat.pf_tgt_id2idx[id] == PO_FLAT_IDX_NONE)
+			return 0;
+		target = &map->po_tree[0].do_targets[map->po_flat.pf_tgt_id2idx[id]];
+	} else {
+		target = comp_sorter_find_target(sorter, id);
+		if (target == NULL)
+			return 0;
+	}
 
 	if (target_pp != NULL)
 		*target_pp = target;
@@ -1917,8 +2085,15 @@ pool_map_find_node_by_rank(struct pool_map *map, uint32_t rank)
 	if (doms_cnt <= 0)
 		return NULL;
 
+	if (map->po_flat.pf_rank2idx != NULL) {
+		if (rank >= map->po_flat.pf_rank_nr ||
+		    map->po_flat.pf_rank2idx[rank] == PO_FLAT_IDX_NONE)
+			return NULL;
+		return &map->po_tree[map->po_flat.pf_rank2idx[rank]];
+	}
+
 	for (i = 0; i < doms_cnt; i++) {
-		/* FIXME add rank sorter to the pool map */
+		/* NB: ranks are too sparse for the direct table of po_flat */
 		if (doms[i].do_comp.co_rank == rank) {
 			found = &doms[i];
 			break;
@@ -1210,6 +1210,66 @@ test_repeat_updates(void **state)
 	}
 }
 
+static void
+test_calc_bufs(void **state)
+{
+	enum DAOS_HASH_TYPE	 type;
+	struct daos_csummer	*csummer = NULL;
+	/** more buffers than sha512 lanes, with different lengths */
+	const uint32_t		 buf_nr = 11;
+	const daos_size_t	 data_buf_len = 4096;
+	uint8_t			 data_buf[data_buf_len];
+	/** sha512 is largest */
+	const daos_size_t	 csum_buf_len = 512 / 8;
+	uint8_t			 csum_bufs[buf_nr][csum_buf_len];
+	uint8_t			 csum_buf[csum_buf_len];
+	uint8_t			*bufs[buf_nr];
+	uint8_t			*csums[buf_nr];
+	uint32_t		 buf_lens[buf_nr];
+	uint32_t		 i;
+	int			 rc;
+
+	for (i = 0; i < data_buf_len; i++)
+		data_buf[i] = i % 251;
+
+	for (i = 0; i < buf_nr; i++) {
+		bufs[i] = data_buf + i * 256;
+		buf_lens[i] = 128 + i * 32;
+		csums[i] = csum_bufs[i];
+	}
+
+	for (type = HASH_TYPE_UNKNOWN + 1; type < HASH_TYPE_END; type++) {
+		struct hash_ft *ft = daos_mhash_type2algo(type);
+
+		rc = daos_csummer_init(&csummer, ft, CSUM_NO_CHUNK, 0);
+		assert_rc_equal(0, rc);
+
+		memset(csum_bufs, 0, sizeof(csum_bufs));
+		rc = daos_csummer_calc_bufs(csummer, bufs, buf_lens, csums,
+					    buf_nr);
+		assert_rc_equal(0, rc);
+
+		/** must be the same as calculating one buffer at a time */
+		for (i = 0; i < buf_nr; i++) {
+			memset(csum_buf, 0, csum_buf_len);
+			daos_csummer_set_buffer(csummer, csum_buf,
+						csum_buf_len);
+			rc = daos_csummer_reset(csummer);
+			assert_int_equal(0, rc);
+			rc = daos_csummer_update(csummer, bufs[i], buf_lens[i]);
+			assert_int_equal(0, rc);
+			rc = daos_csummer_finish(csummer);
+			assert_int_equal(0, rc);
+
+			if (memcmp(csum_buf, csums[i],
+				   daos_csummer_get_csum_len(csummer)) != 0)
+				fail_msg("checksum type %s, buffer %u mismatch",
+					 daos_csummer_get_name(csummer), i);
+		}
+		daos_csummer_destroy(&csummer);
+	}
+}
+
 /**
  * -----------------------------------------------------------------------------
  * Test some helper functions for indexing checksums within a daos_csum_info
@@ -1905,6 +1965,10 @@ static const struct CMUnitTest tests[] = {
 	     "for different source buffers results in same checksum if all "
 	     "data passed at once ",
 	     test_repeat_updates),
+	TEST("CSUM09.3: Test all checksum algorithms: Calculating checksums "
+	     "of multiple buffers in batch results in same checksums as one "
+	     "buffer at a time",
+	     test_calc_bufs),
 
 	TEST("CSUM10: Test map from container prop to csum type",
 	     test_container_prop_to_csum_type),
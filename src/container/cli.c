@@ -23,6 +23,17 @@
 #include "cli_internal.h"
 #include "rpc.h"
 
+/* bounds of the OID lease of a container handle */
+#define CONT_OID_LEASE_MIN	32
+#define CONT_OID_LEASE_MAX_DEF	(1 << 16)
+/* a lease used up faster than this (in seconds) doubles the next one */
+#define CONT_OID_LEASE_FAST	1
+/* and one lasting longer than this halves it */
+#define CONT_OID_LEASE_SLOW	30
+
+/* 0 disables the lease */
+static unsigned int	cont_oid_lease_max;
+
 /**
  * Initialize container interface
  */
@@ -31,6 +42,11 @@ dc_cont_init(void)
 {
 	int rc;
 
+	cont_oid_lease_max = CONT_OID_LEASE_MAX_DEF;
+	d_getenv_int("DAOS_OID_LEASE_MAX", &cont_oid_lease_max);
+	if (cont_oid_lease_max != 0 && cont_oid_lease_max < CONT_OID_LEASE_MIN)
+		cont_oid_lease_max = CONT_OID_LEASE_MIN;
+
 	/* TODO: issue a cart protocol query to an engine, then register either the
 	 * latest, or latest-1 version of the container RPC protocol. See dc_pool_init().
 	 */
@@ -475,6 +491,7 @@ dc_cont_free(struct dc_cont *dc)
 {
 	D_ASSERT(daos_hhash_link_empty(&dc->dc_hlink));
 	D_RWLOCK_DESTROY(&dc->dc_obj_list_lock);
+	D_MUTEX_DESTROY(&dc->dc_oid_lease.ol_lock);
 	D_ASSERT(d_list_empty(&dc->dc_po_list));
 	D_ASSERT(d_list_empty(&dc->dc_obj_list));
 	D_FREE(dc);
@@ -519,8 +536,15 @@ dc_cont_alloc(const uuid_t uuid)
 	uuid_copy(dc->dc_uuid, uuid);
 	D_INIT_LIST_HEAD(&dc->dc_obj_list);
 	D_INIT_LIST_HEAD(&dc->dc_po_list);
-	if (D_RWLOCK_INIT(&dc->dc_obj_list_lock, NULL) != 0)
+	dc->dc_oid_lease.ol_size = CONT_OID_LEASE_MIN;
+	if (D_MUTEX_INIT(&dc->dc_oid_lease.ol_lock, NULL) != 0) {
 		D_FREE(dc);
+		return NULL;
+	}
+	if (D_RWLOCK_INIT(&dc->dc_obj_list_lock, NULL) != 0) {
+		D_MUTEX_DESTROY(&dc->dc_oid_lease.ol_lock);
+		D_FREE(dc);
+	}
 
 	return dc;
 }
@@ -1803,8 +1827,95 @@ struct cont_oid_alloc_args {
 	daos_handle_t		hdl;
 	daos_size_t		num_oids;
 	uint64_t		*oid;
+	/* OIDs requested on top of num_oids, for the lease */
+	daos_size_t		lease_nr;
 };
 
+/* the lease is used up too fast or too slowly, resize the next one */
+static void
+cont_oid_lease_adapt(struct dc_oid_lease *ol)
+{
+	uint64_t	now = daos_gettime_coarse();
+
+	if (now - ol->ol_stamp < CONT_OID_LEASE_FAST)
+		ol->ol_size = min(ol->ol_size * 2, cont_oid_lease_max);
+	else if (now - ol->ol_stamp > CONT_OID_LEASE_SLOW)
+		ol->ol_size = max(ol->ol_size / 2, CONT_OID_LEASE_MIN);
+}
+
+/*
+ * Serve \a num_oids OIDs from the lease. Returns -DER_NONEXIST if the caller
+ * has to go to the engines, and asks for \a lease_nr more OIDs to refill the
+ * lease. \a prefetch_nr is set when the lease runs low and the next range
+ * should be fetched in the background.
+ *
+ * A request which doesn't fit in what is left of the current range switches
+ * to the spare range, and what is left of the current range is kept as the
+ * spare for smaller requests until a new range replaces it.
+ */
+static int
+cont_oid_lease_take(struct dc_oid_lease *ol, daos_size_t num_oids, uint64_t *oid,
+		    daos_size_t *lease_nr, daos_size_t *prefetch_nr)
+{
+	uint64_t	spare;
+	uint64_t	spare_nr;
+	int		rc = 0;
+
+	*lease_nr = 0;
+	*prefetch_nr = 0;
+
+	D_MUTEX_LOCK(&ol->ol_lock);
+	if (ol->ol_end - ol->ol_next < num_oids) {
+		cont_oid_lease_adapt(ol);
+		if (ol->ol_spare_nr < num_oids) {
+			*lease_nr = ol->ol_size;
+			D_GOTO(out, rc = -DER_NONEXIST);
+		}
+
+		spare = ol->ol_spare;
+		spare_nr = ol->ol_spare_nr;
+		ol->ol_spare = ol->ol_next;
+		ol->ol_spare_nr = ol->ol_end - ol->ol_next;
+		ol->ol_next = spare;
+		ol->ol_end = spare + spare_nr;
+		ol->ol_stamp = daos_gettime_coarse();
+	}
+
+	*oid = ol->ol_next;
+	ol->ol_next += num_oids;
+
+	/* the spare range, if any, only holds what was left of an older range */
+	if (!ol->ol_prefetching && ol->ol_spare_nr * 4 < ol->ol_size &&
+	    (ol->ol_end - ol->ol_next) * 4 < ol->ol_size) {
+		ol->ol_prefetching = 1;
+		*prefetch_nr = ol->ol_size;
+	}
+out:
+	D_MUTEX_UNLOCK(&ol->ol_lock);
+	return rc;
+}
+
+/* add the range [start, start + nr) leased from the engines */
+static void
+cont_oid_lease_add(struct dc_oid_lease *ol, uint64_t start, daos_size_t nr)
+{
+	if (nr == 0)
+		return;
+
+	D_MUTEX_LOCK(&ol->ol_lock);
+	if (ol->ol_next == ol->ol_end) {
+		ol->ol_next = start;
+		ol->ol_end = start + nr;
+		ol->ol_stamp = daos_gettime_coarse();
+	} else if (ol->ol_spare_nr < nr) {
+		/* what is left of the old spare range is dropped */
+		ol->ol_spare = start;
+		ol->ol_spare_nr = nr;
+	}
+	/* otherwise a concurrent refill already filled the lease, drop it */
+	D_MUTEX_UNLOCK(&ol->ol_lock);
+}
+
 static int
 cont_oid_alloc_complete(tse_task_t *task, void *data)
 {
@@ -1852,12 +1963,13 @@ cont_oid_alloc_complete(tse_task_t *task, void *data)
 		D_GOTO(out, rc);
 	}
 
-	D_DEBUG(DB_MD, DF_CONT": OID ALLOC: using hdl="DF_UUID" oid "DF_U64"/"DF_U64"\n",
-		DP_CONT(pool->dp_pool, cont->dc_uuid), DP_UUID(cont->dc_cont_hdl),
-		out->oid, arg->num_oids);
+	D_DEBUG(DB_MD, DF_CONT": OID ALLOC: using hdl="DF_UUID" oid "DF_U64"/"DF_U64
+		" lease "DF_U64"\n", DP_CONT(pool->dp_pool, cont->dc_uuid),
+		DP_UUID(cont->dc_cont_hdl), out->oid, arg->num_oids, arg->lease_nr);
 
 	if (arg->oid)
 		*arg->oid = out->oid;
+	cont_oid_lease_add(&cont->dc_oid_lease, out->oid + arg->num_oids, arg->lease_nr);
 
 out:
 	crt_req_decref(arg->rpc);
@@ -1889,34 +2001,28 @@ get_tgt_rank(struct dc_pool *pool, unsigned int *rank)
 	return 0;
 }
 
-int
-dc_cont_alloc_oids(tse_task_t *task)
+/*
+ * Send the OID allocation RPC for \a num_oids + \a lease_nr OIDs, the first
+ * \a num_oids are returned in \a oid and the others go to the lease. Consumes
+ * the reference held on \a cont.
+ */
+static int
+cont_oid_alloc_send(tse_task_t *task, struct dc_cont *cont, daos_handle_t coh,
+		    daos_size_t num_oids, uint64_t *oid, daos_size_t lease_nr)
 {
-	daos_cont_alloc_oids_t		*args;
 	struct cont_oid_alloc_in	*in;
 	struct dc_pool			*pool;
-	struct dc_cont			*cont;
 	crt_endpoint_t			ep;
 	crt_rpc_t			*rpc;
 	struct cont_oid_alloc_args	arg;
 	int				rc;
 
-	args = dc_task_get_args(task);
-	D_ASSERTF(args != NULL, "Task Argument OPC does not match DC OPC\n");
-
-	if (args->num_oids == 0 || args->oid == NULL)
-		D_GOTO(err, rc = -DER_INVAL);
-
-	cont = dc_hdl2cont(args->coh);
-	if (cont == NULL)
-		D_GOTO(err, rc = -DER_NO_HDL);
-
 	pool = dc_hdl2pool(cont->dc_pool_hdl);
 	D_ASSERT(pool != NULL);
 
-	D_DEBUG(DB_MD, DF_CONT": oid allocate: hdl="DF_UUID" num "DF_U64"\n",
+	D_DEBUG(DB_MD, DF_CONT": oid allocate: hdl="DF_UUID" num "DF_U64" lease "DF_U64"\n",
 		DP_CONT(pool->dp_pool_hdl, cont->dc_uuid), DP_UUID(cont->dc_cont_hdl),
-		args->num_oids);
+		num_oids, lease_nr);
 
 	/** randomly select a rank from the pool map */
 	ep.ep_grp = pool->dp_sys->sy_group;
@@ -1935,14 +2041,15 @@ dc_cont_alloc_oids(tse_task_t *task)
 	uuid_copy(in->coai_op.ci_pool_hdl, pool->dp_pool_hdl);
 	uuid_copy(in->coai_op.ci_uuid, cont->dc_uuid);
 	uuid_copy(in->coai_op.ci_hdl, cont->dc_cont_hdl);
-	in->num_oids = args->num_oids;
+	in->num_oids = num_oids + lease_nr;
 
 	arg.coaa_pool	= pool;
 	arg.coaa_cont	= cont;
 	arg.rpc		= rpc;
-	arg.hdl		= args->coh;
-	arg.num_oids	= args->num_oids;
-	arg.oid		= args->oid;
+	arg.hdl		= coh;
+	arg.num_oids	= num_oids;
+	arg.oid		= oid;
+	arg.lease_nr	= lease_nr;
 	crt_req_addref(rpc);
 
 	rc = tse_task_register_comp_cb(task, cont_oid_alloc_complete, &arg,
@@ -1958,6 +2065,124 @@ err_rpc:
 err_cont:
 	dc_cont_put(cont);
 	dc_pool_put(pool);
+	tse_task_complete(task, rc);
+	D_DEBUG(DB_MD, "Failed to allocate OIDs: "DF_RC"\n", DP_RC(rc));
+	return rc;
+}
+
+struct cont_oid_prefetch_args {
+	struct dc_cont	*copa_cont;
+	daos_handle_t	 copa_coh;
+	daos_size_t	 copa_nr;
+};
+
+static int
+cont_oid_prefetch(tse_task_t *task)
+{
+	struct cont_oid_prefetch_args *args = tse_task_buf_embedded(task, sizeof(*args));
+
+	/* one per run, the task is rescheduled on retry */
+	daos_hhash_link_getref(&args->copa_cont->dc_hlink);
+	return cont_oid_alloc_send(task, args->copa_cont, args->copa_coh, 0, NULL,
+				   args->copa_nr);
+}
+
+static int
+cont_oid_prefetch_complete(tse_task_t *task, void *data)
+{
+	struct dc_cont *cont = *(struct dc_cont **)data;
+
+	D_MUTEX_LOCK(&cont->dc_oid_lease.ol_lock);
+	cont->dc_oid_lease.ol_prefetching = 0;
+	D_MUTEX_UNLOCK(&cont->dc_oid_lease.ol_lock);
+	dc_cont_put(cont);
+	return 0;
+}
+
+/*
+ * Lease the next \a nr OIDs in the background. The task goes to the scheduler
+ * of \a task, so it is progressed along with the other operations of the
+ * caller and nobody waits for it.
+ */
+static void
+cont_oid_prefetch_launch(tse_task_t *task, struct dc_cont *cont, daos_handle_t coh,
+			 daos_size_t nr)
+{
+	struct cont_oid_prefetch_args	*args;
+	tse_task_t			*ptask;
+	int				 rc;
+
+	rc = tse_task_create(cont_oid_prefetch, tse_task2sched(task), NULL, &ptask);
+	if (rc != 0)
+		D_GOTO(err, rc);
+
+	args = tse_task_buf_embedded(ptask, sizeof(*args));
+	args->copa_cont = cont;
+	args->copa_coh = coh;
+	args->copa_nr = nr;
+
+	/* held until the prefetch completes */
+	daos_hhash_link_getref(&cont->dc_hlink);
+	rc = tse_task_register_comp_cb(ptask, cont_oid_prefetch_complete, &cont,
+				       sizeof(cont));
+	if (rc != 0) {
+		dc_cont_put(cont);
+		tse_task_decref(ptask);
+		D_GOTO(err, rc);
+	}
+
+	/* ignore returned value, error is reported by comp_cb */
+	tse_task_schedule(ptask, true);
+	return;
+err:
+	D_DEBUG(DB_MD, "Failed to prefetch OIDs: "DF_RC"\n", DP_RC(rc));
+	D_MUTEX_LOCK(&cont->dc_oid_lease.ol_lock);
+	cont->dc_oid_lease.ol_prefetching = 0;
+	D_MUTEX_UNLOCK(&cont->dc_oid_lease.ol_lock);
+}
+
+/*
+ * OIDs are served from a lease on the container handle: a range taken from
+ * the engines along with the first allocations, refilled in the background
+ * before it runs out. The lease doubles when it lasts less than
+ * CONT_OID_LEASE_FAST seconds and halves when it lasts more than
+ * CONT_OID_LEASE_SLOW seconds. Requests of DAOS_OID_LEASE_MAX OIDs or more
+ * go to the engines as they are. OIDs left in the lease when the handle is
+ * closed are lost.
+ */
+int
+dc_cont_alloc_oids(tse_task_t *task)
+{
+	daos_cont_alloc_oids_t		*args;
+	struct dc_cont			*cont;
+	daos_size_t			lease_nr = 0;
+	daos_size_t			prefetch_nr = 0;
+	int				rc;
+
+	args = dc_task_get_args(task);
+	D_ASSERTF(args != NULL, "Task Argument OPC does not match DC OPC\n");
+
+	if (args->num_oids == 0 || args->oid == NULL)
+		D_GOTO(err, rc = -DER_INVAL);
+
+	cont = dc_hdl2cont(args->coh);
+	if (cont == NULL)
+		D_GOTO(err, rc = -DER_NO_HDL);
+
+	if (args->num_oids < cont_oid_lease_max) {
+		rc = cont_oid_lease_take(&cont->dc_oid_lease, args->num_oids, args->oid,
+					 &lease_nr, &prefetch_nr);
+		if (prefetch_nr != 0)
+			cont_oid_prefetch_launch(task, cont, args->coh, prefetch_nr);
+		if (rc == 0) {
+			dc_cont_put(cont);
+			tse_task_complete(task, 0);
+			return 0;
+		}
+	}
+
+	return cont_oid_alloc_send(task, cont, args->coh, args->num_oids, args->oid,
+				   lease_nr);
 err:
 	tse_task_complete(task, rc);
 	D_DEBUG(DB_MD, "Failed to allocate OIDs: "DF_RC"\n", DP_RC(rc));
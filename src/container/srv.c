@@ -16,6 +16,9 @@
 #include "rpc.h"
 #include "srv_internal.h"
 
+unsigned int	cont_agg_budget;
+bool		cont_agg_metrics;
+
 static int
 init(void)
 {
@@ -33,6 +36,14 @@ init(void)
 	if (rc)
 		D_GOTO(err_cont_iv, rc);
 
+	cont_agg_budget = 1;
+	d_getenv_int("DAOS_AGG_BUDGET", &cont_agg_budget);
+	if (cont_agg_budget == 0)
+		cont_agg_budget = 1;
+
+	cont_agg_metrics = false;
+	d_getenv_bool("DAOS_CONT_AGG_METRICS", &cont_agg_metrics);
+
 	return 0;
 
 err_cont_iv:
@@ -122,6 +133,7 @@ dsm_tls_init(int xs_id, int tgt_id)
 		return NULL;
 	}
 
+	D_INIT_LIST_HEAD(&tls->dt_agg_waiters);
 	return tls;
 }
 
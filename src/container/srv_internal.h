@@ -40,6 +40,10 @@ struct cont_pool_metrics {
 struct dsm_tls {
 	struct daos_lru_cache  *dt_cont_cache;
 	struct d_hash_table	dt_cont_hdl_hash;
+	/* Containers waiting for a VOS aggregation slot of this target */
+	d_list_t		dt_agg_waiters;
+	/* Number of VOS aggregation rounds in progress on this target */
+	uint32_t		dt_agg_running;
 };
 
 extern struct dss_module_key cont_module_key;
@@ -56,6 +60,10 @@ dsm_tls_get()
 }
 
 extern bool ec_agg_disabled;
+/* Max concurrent VOS aggregation rounds per target */
+extern unsigned int cont_agg_budget;
+/* Export per-container aggregation yield telemetry */
+extern bool cont_agg_metrics;
 
 struct ec_eph {
 	d_rank_t	rank;
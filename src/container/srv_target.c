@@ -34,6 +34,8 @@
 #include "srv_internal.h"
 #include <daos/cont_props.h>
 #include <daos/dedup.h>
+#include <daos/compression.h>
+#include <gurt/telemetry_producer.h>
 
 /* Per VOS container aggregation ULT ***************************************/
 
@@ -215,11 +217,11 @@ cont_aggregate_runnable(struct ds_cont_child *cont, struct sched_request *req,
 	if (!cont->sc_props_fetched)
 		ds_cont_csummer_init(cont);
 
+	/* Compressed container is compressed by VOS aggregation */
 	if (cont->sc_props.dcp_dedup_enabled ||
-	    cont->sc_props.dcp_compress_enabled ||
 	    cont->sc_props.dcp_encrypt_enabled) {
 		D_DEBUG(DB_EPC, DF_CONT": skip aggregation for "
-			"deduped/compressed/encrypted container\n",
+			"deduped/encrypted container\n",
 			DP_CONT(cont->sc_pool->spc_uuid, cont->sc_uuid));
 		return false;
 	}
@@ -306,6 +308,7 @@ cont_child_aggregate(struct ds_cont_child *cont, cont_aggregate_cb_t agg_cb,
 	uint32_t		flags = 0;
 	int			i, rc = 0;
 
+	param->ap_ranges = 0;
 	change_hlc = max(cont->sc_snapshot_delete_hlc,
 			 cont->sc_pool->spc_rebuild_end_hlc);
 	if (param->ap_full_scan_hlc < change_hlc) {
@@ -417,6 +420,7 @@ cont_child_aggregate(struct ds_cont_child *cont, cont_aggregate_cb_t agg_cb,
 		rc = agg_cb(cont, &epoch_range, flags, param);
 		if (rc)
 			D_GOTO(free, rc);
+		param->ap_ranges++;
 		epoch_range.epr_lo = epoch_range.epr_hi + 1;
 	}
 
@@ -432,6 +436,8 @@ cont_child_aggregate(struct ds_cont_child *cont, cont_aggregate_cb_t agg_cb,
 	if (dss_xstream_is_busy())
 		flags &= ~VOS_AGG_FL_FORCE_MERGE;
 	rc = agg_cb(cont, &epoch_range, flags, param);
+	if (rc == 0)
+		param->ap_ranges++;
 out:
 	if (rc == 0 && epoch_min == 0)
 		param->ap_full_scan_hlc = hlc;
@@ -445,6 +451,209 @@ free:
 	return rc;
 }
 
+/*
+ * Per-target VOS aggregation scheduler. The VOS aggregation ULTs of all the
+ * containers on a target share cont_agg_budget concurrent rounds, the free
+ * slot goes to the waiting container with the highest estimated yield, see
+ * ds_cont_agg_account().
+ */
+
+/* Aging in bytes per second, so that containers without updates still run */
+#define CONT_AGG_AGE_BYTES	(1ULL << 20)
+/* Recheck interval (msec) of a waiting container, normally it's woken up */
+#define CONT_AGG_WAIT_MSECS	5000
+#define CONT_AGG_METRICS_BYTES	(16 * 1024)
+
+/* Estimated reclaimable bytes */
+static inline uint64_t
+cont_agg_pending(struct cont_agg_stat *cas)
+{
+	/* Merging the fresh extents frees little besides metadata */
+	return cas->cas_overwritten + ((cas->cas_written - cas->cas_overwritten) >> 3);
+}
+
+static uint64_t
+cont_agg_score(struct ds_cont_child *cont, uint64_t now)
+{
+	struct cont_agg_stat	*cas = &cont->sc_agg_stat;
+	uint64_t		 pending = cont_agg_pending(cas);
+	uint64_t		 score = pending;
+
+	d_tm_set_gauge(cas->cas_tm_pending, pending);
+	if (cas->cas_written != 0)
+		d_tm_set_gauge(cas->cas_tm_overwrite,
+			       cas->cas_overwritten * 100 / cas->cas_written);
+
+	/* Snapshot deletion, rebuild, etc. aren't accounted, age them in */
+	if (now > cas->cas_last_round)
+		score += (now - cas->cas_last_round) * CONT_AGG_AGE_BYTES / 1000;
+
+	/* Double the score for each space pressure level of the pool */
+	return score << sched_req_space_check(cont->sc_agg_req);
+}
+
+static struct ds_cont_child *
+cont_agg_top(struct dsm_tls *tls)
+{
+	struct ds_cont_child	*cont;
+	struct ds_cont_child	*top = NULL;
+	uint64_t		 now = daos_getmtime_coarse();
+	uint64_t		 score;
+	uint64_t		 top_score = 0;
+
+	d_list_for_each_entry(cont, &tls->dt_agg_waiters, sc_agg_link) {
+		score = cont_agg_score(cont, now);
+		if (top == NULL || score > top_score) {
+			top = cont;
+			top_score = score;
+		}
+	}
+	return top;
+}
+
+static void
+cont_agg_wakeup(struct dsm_tls *tls)
+{
+	struct ds_cont_child	*top;
+
+	if (tls->dt_agg_running >= cont_agg_budget)
+		return;
+
+	top = cont_agg_top(tls);
+	if (top != NULL)
+		sched_req_wakeup(top->sc_agg_req);
+}
+
+/* Wait for an aggregation slot of this target, return false if ULT is exiting */
+static bool
+cont_agg_acquire(struct ds_cont_child *cont, struct sched_request *req)
+{
+	struct dsm_tls	*tls = dsm_tls_get();
+
+	d_list_add_tail(&cont->sc_agg_link, &tls->dt_agg_waiters);
+	while (!dss_ult_exiting(req)) {
+		if (tls->dt_agg_running < cont_agg_budget && cont_agg_top(tls) == cont) {
+			d_list_del_init(&cont->sc_agg_link);
+			tls->dt_agg_running++;
+			cont->sc_agg_stat.cas_last_round = daos_getmtime_coarse();
+			return true;
+		}
+		sched_req_sleep(req, CONT_AGG_WAIT_MSECS);
+	}
+
+	d_list_del_init(&cont->sc_agg_link);
+	/* It might have been woken up for the free slot, pass it on */
+	cont_agg_wakeup(tls);
+	return false;
+}
+
+static void
+cont_agg_release(struct ds_cont_child *cont)
+{
+	struct dsm_tls	*tls = dsm_tls_get();
+
+	D_ASSERT(tls->dt_agg_running > 0);
+	tls->dt_agg_running--;
+	cont_agg_wakeup(tls);
+}
+
+static void
+cont_agg_metrics_init(struct ds_cont_child *cont)
+{
+	struct cont_agg_stat	*cas = &cont->sc_agg_stat;
+	struct ds_pool		*pool = cont->sc_pool->spc_pool;
+	int			 tgt_id = dss_get_module_info()->dmi_tgt_id;
+	int			 rc;
+
+	if (!cont_agg_metrics)
+		return;
+
+	rc = d_tm_add_ephemeral_dir(NULL, CONT_AGG_METRICS_BYTES, "%s/tgt_%d/cont_agg/"DF_UUIDF,
+				    pool->sp_path, tgt_id, DP_UUID(cont->sc_uuid));
+	if (rc != 0) {
+		D_WARN(DF_CONT": failed to create aggregation metrics dir: "DF_RC"\n",
+		       DP_CONT(pool->sp_uuid, cont->sc_uuid), DP_RC(rc));
+		return;
+	}
+
+	rc = d_tm_add_metric(&cas->cas_tm_pending, D_TM_GAUGE,
+			     "Estimated bytes reclaimable by VOS aggregation", "bytes",
+			     "%s/tgt_%d/cont_agg/"DF_UUIDF"/pending", pool->sp_path, tgt_id,
+			     DP_UUID(cont->sc_uuid));
+	if (rc != 0)
+		D_WARN("Failed to create pending gauge: "DF_RC"\n", DP_RC(rc));
+
+	rc = d_tm_add_metric(&cas->cas_tm_overwrite, D_TM_GAUGE,
+			     "Percentage of updates rewriting recently updated dkeys", "%",
+			     "%s/tgt_%d/cont_agg/"DF_UUIDF"/overwrite", pool->sp_path, tgt_id,
+			     DP_UUID(cont->sc_uuid));
+	if (rc != 0)
+		D_WARN("Failed to create overwrite gauge: "DF_RC"\n", DP_RC(rc));
+
+	rc = d_tm_add_metric(&cas->cas_tm_yield, D_TM_GAUGE,
+			     "Estimated bytes reclaimed per second of the last VOS aggregation",
+			     "bytes/s", "%s/tgt_%d/cont_agg/"DF_UUIDF"/yield", pool->sp_path,
+			     tgt_id, DP_UUID(cont->sc_uuid));
+	if (rc != 0)
+		D_WARN("Failed to create yield gauge: "DF_RC"\n", DP_RC(rc));
+
+	rc = d_tm_add_metric(&cas->cas_tm_rounds, D_TM_COUNTER,
+			     "Number of VOS aggregation rounds", "rounds",
+			     "%s/tgt_%d/cont_agg/"DF_UUIDF"/rounds", pool->sp_path, tgt_id,
+			     DP_UUID(cont->sc_uuid));
+	if (rc != 0)
+		D_WARN("Failed to create rounds counter: "DF_RC"\n", DP_RC(rc));
+}
+
+static void
+cont_agg_metrics_fini(struct ds_cont_child *cont)
+{
+	struct cont_agg_stat	*cas = &cont->sc_agg_stat;
+	struct ds_pool		*pool = cont->sc_pool->spc_pool;
+
+	if (cas->cas_tm_pending == NULL && cas->cas_tm_overwrite == NULL &&
+	    cas->cas_tm_yield == NULL && cas->cas_tm_rounds == NULL)
+		return;
+
+	cas->cas_tm_pending = NULL;
+	cas->cas_tm_overwrite = NULL;
+	cas->cas_tm_yield = NULL;
+	cas->cas_tm_rounds = NULL;
+	d_tm_del_ephemeral_dir("%s/tgt_%d/cont_agg/"DF_UUIDF, pool->sp_path,
+			       dss_get_module_info()->dmi_tgt_id, DP_UUID(cont->sc_uuid));
+}
+
+/*
+ * Run a VOS aggregation round over all the epoch ranges of the container and
+ * account its yield. The updates made during the round are left to the next.
+ */
+static int
+cont_agg_round(struct ds_cont_child *cont, cont_aggregate_cb_t cb, struct agg_param *param)
+{
+	struct cont_agg_stat	*cas = &cont->sc_agg_stat;
+	uint64_t		 written = cas->cas_written;
+	uint64_t		 overwritten = cas->cas_overwritten;
+	uint64_t		 pending = cont_agg_pending(cas);
+	uint64_t		 start = daos_getmtime_coarse();
+	int			 rc;
+
+	cas->cas_written = 0;
+	cas->cas_overwritten = 0;
+
+	rc = cont_child_aggregate(cont, cb, param);
+	if (rc != 0 || param->ap_ranges == 0) {
+		/* Failed or skipped, the estimate still stands */
+		cas->cas_written += written;
+		cas->cas_overwritten += overwritten;
+		return rc;
+	}
+
+	d_tm_inc_counter(cas->cas_tm_rounds, 1);
+	d_tm_set_gauge(cas->cas_tm_yield,
+		       pending * 1000 / max(daos_getmtime_coarse() - start, 1));
+	return 0;
+}
+
 void
 cont_aggregate_interval(struct ds_cont_child *cont, cont_aggregate_cb_t cb,
 			struct agg_param *param)
@@ -472,7 +681,16 @@ cont_aggregate_interval(struct ds_cont_child *cont, cont_aggregate_cb_t cb,
 		if (!cont_aggregate_runnable(cont, req, param->ap_vos_agg))
 			goto next;
 
-		rc = cont_child_aggregate(cont, cb, param);
+		/* EC aggregation isn't driven by the space reclaim estimate */
+		if (!param->ap_vos_agg) {
+			rc = cont_child_aggregate(cont, cb, param);
+		} else if (cont_agg_acquire(cont, req)) {
+			rc = cont_agg_round(cont, cb, param);
+			cont_agg_release(cont);
+		} else {
+			break;
+		}
+
 		if (rc == -DER_SHUTDOWN) {
 			break;	/* pool destroyed */
 		} else if (rc < 0) {
@@ -501,6 +719,12 @@ cont_vos_aggregate_cb(struct ds_cont_child *cont, daos_epoch_range_t *epr,
 {
 	int rc;
 
+	rc = vos_cont_set_compress(cont->sc_hdl, cont->sc_props.dcp_compress_enabled ?
+				   daos_contprop2compresstype(cont->sc_props.dcp_compress_type) :
+				   COMPRESS_TYPE_UNKNOWN);
+	if (rc)
+		return rc;
+
 	rc = vos_aggregate(cont->sc_hdl, epr, agg_rate_ctl, param, flags);
 
 	/* Suppress csum error and continue on other epoch ranges */
@@ -559,6 +783,8 @@ cont_stop_agg(struct ds_cont_child *cont)
 		sched_req_put(cont->sc_agg_req);
 		cont->sc_agg_req = NULL;
 	}
+
+	cont_agg_metrics_fini(cont);
 }
 
 static int
@@ -590,6 +816,7 @@ cont_start_agg(struct ds_cont_child *cont)
 		return -DER_NOMEM;
 	}
 
+	cont_agg_metrics_init(cont);
 	return 0;
 }
 
@@ -655,6 +882,8 @@ cont_child_alloc_ref(void *co_uuid, unsigned int ksize, void *po_uuid,
 	cont->sc_dtx_cos_hdl = DAOS_HDL_INVAL;
 	D_INIT_LIST_HEAD(&cont->sc_link);
 	D_INIT_LIST_HEAD(&cont->sc_open_hdls);
+	D_INIT_LIST_HEAD(&cont->sc_agg_link);
+	cont->sc_agg_stat.cas_last_round = daos_getmtime_coarse();
 
 	*link = &cont->sc_list;
 	return 0;
@@ -28,10 +28,10 @@
  * OPCODE, flags, FMT, handler, corpc_hdlr,
  */
 #define DTX_PROTO_SRV_RPC_LIST						\
-	X(DTX_COMMIT, 0, &CQF_dtx, dtx_handler, NULL, "dtx_commit")	\
-	X(DTX_ABORT, 0, &CQF_dtx, dtx_handler, NULL, "dtx_abort")	\
-	X(DTX_CHECK, 0, &CQF_dtx, dtx_handler, NULL, "dtx_check")	\
-	X(DTX_REFRESH, 0, &CQF_dtx, dtx_handler, NULL, "dtx_refresh")
+	X(DTX_COMMIT, DAOS_RPC_POOLED, &CQF_dtx, dtx_handler, NULL, "dtx_commit")	\
+	X(DTX_ABORT, DAOS_RPC_POOLED, &CQF_dtx, dtx_handler, NULL, "dtx_abort")	\
+	X(DTX_CHECK, DAOS_RPC_POOLED, &CQF_dtx, dtx_handler, NULL, "dtx_check")	\
+	X(DTX_REFRESH, DAOS_RPC_POOLED, &CQF_dtx, dtx_handler, NULL, "dtx_refresh")
 
 #define X(a, b, c, d, e, f) a,
 enum dtx_operation {
@@ -545,7 +545,9 @@ sched_info_init(struct dss_xstream *dx)
 	info->si_req_cnt = 0;
 	info->si_sleep_cnt = 0;
 	info->si_wait_cnt = 0;
+	info->si_cycle_lat = 0;
 	info->si_stop = 0;
+	info->si_relaxed = 0;
 	sched_metrics_init(dx);
 
 	rc = d_hash_table_create(D_HASH_FT_NOLOCK, 4,
@@ -1470,6 +1472,15 @@ sched_cur_seq(void)
 	return info->si_cur_seq;
 }
 
+uint64_t
+sched_cycle_latency(void)
+{
+	struct dss_xstream	*dx = dss_current_xstream();
+	struct sched_info	*info = &dx->dx_sched_info;
+
+	return info->si_cycle_lat;
+}
+
 struct sched_request *
 sched_create_ult(struct sched_req_attr *attr, void (*func)(void *), void *arg, size_t stack_size)
 {
@@ -1816,6 +1827,7 @@ sched_try_relax(struct dss_xstream *dx, ABT_pool *pools, uint32_t running)
 			D_ERROR("Sleep error: %s\n", strerror(errno));
 	}
 
+	info->si_relaxed = 1;
 	/* Rough stats, interruption isn't taken into account */
 	d_tm_inc_counter(info->si_stats.ss_relax_time, sleep_time);
 }
@@ -1847,6 +1859,16 @@ sched_start_cycle(struct sched_data *data, ABT_pool *pools)
 	duration = cur_ts - info->si_cur_ts;
 	info->si_cur_ts = cur_ts;
 
+	/*
+	 * The cycle duration is how long a runnable ULT waits before being scheduled
+	 * again, smooth it to track the latency seen by foreground I/O handlers. Cycles
+	 * following CPU relaxing are skipped since they are idle time.
+	 */
+	if (info->si_relaxed)
+		info->si_relaxed = 0;
+	else
+		info->si_cycle_lat = (info->si_cycle_lat * 7 + duration * 1000) / 8;
+
 	wakeup_all(dx);
 	process_all(dx);
 
@@ -889,9 +889,16 @@ ds_iv_ns_id_get(void *ns)
 void
 ds_iv_init()
 {
+	bool	domain = false;
+
 	D_INIT_LIST_HEAD(&ds_iv_ns_list);
 	D_INIT_LIST_HEAD(&ds_iv_class_list);
-	ds_iv_ns_tree_topo = crt_tree_topo(CRT_TREE_KNOMIAL, 4);
+	/* the pool map is distributed by IV, follow the pool broadcasts */
+	d_getenv_bool("DAOS_POOL_BCAST_DOMAIN", &domain);
+	if (domain)
+		ds_iv_ns_tree_topo = crt_tree_topo(CRT_TREE_DOMAIN, 4);
+	else
+		ds_iv_ns_tree_topo = crt_tree_topo(CRT_TREE_KNOMIAL, 4);
 }
 
 void
@@ -611,6 +611,7 @@ dss_xstream_alloc(hwloc_cpuset_t cpus)
 	dx->dx_xstream	= ABT_XSTREAM_NULL;
 	dx->dx_sched	= ABT_SCHED_NULL;
 	dx->dx_progress	= ABT_THREAD_NULL;
+	D_INIT_LIST_HEAD(&dx->dx_coll_free);
 
 	return dx;
 
@@ -635,6 +636,7 @@ dss_xstream_free(struct dss_xstream *dx)
 		dx->dx_sp = NULL;
 	}
 #endif
+	dss_coll_cache_fini(dx);
 	hwloc_bitmap_free(dx->dx_cpuset);
 	D_FREE(dx);
 }
@@ -51,7 +51,9 @@ struct sched_info {
 	uint32_t		 si_req_cnt;	/* Total inuse request count */
 	int			 si_sleep_cnt;	/* Sleeping request count */
 	int			 si_wait_cnt;	/* Long wait request count */
-	unsigned int		 si_stop:1;
+	uint64_t		 si_cycle_lat;	/* Smoothed cycle duration (us) */
+	unsigned int		 si_stop:1,
+				 si_relaxed:1;	/* Relaxed in last cycle */
 };
 
 /** Per-xstream configuration data */
@@ -85,6 +87,9 @@ struct dss_xstream {
 	struct stack_pool	*dx_sp;
 #endif
 	bool			dx_progress_started;	/* Network poll started */
+	/* cached collective descriptors, see dss_collective_reduce_internal */
+	d_list_t		dx_coll_free;
+	int			dx_coll_free_nr;
 };
 
 /** Engine module's metrics */
@@ -289,6 +294,9 @@ sched_create_thread(struct dss_xstream *dx, void (*func)(void *), void *arg,
 	return dss_abterr2der(rc);
 }
 
+/* ult.c */
+void dss_coll_cache_fini(struct dss_xstream *dx);
+
 /* tls.c */
 void dss_tls_fini(struct dss_thread_local_storage *dtls);
 struct dss_thread_local_storage *dss_tls_init(int tag, int xs_id, int tgt_id);
@@ -13,14 +13,6 @@
 
 /* ============== Thread collective functions ============================ */
 
-struct aggregator_arg_type {
-	struct dss_stream_arg_type	at_args;
-	void				(*at_reduce)(void *a_args,
-						     void *s_args);
-	int				at_rc;
-	int				at_xs_nr;
-};
-
 /**
  * Collective operations among all server xstreams
  */
@@ -36,51 +28,189 @@ struct dss_future_arg {
 	bool		dfa_async;
 };
 
-struct collective_arg {
-	struct dss_future_arg		ca_future;
+/** fan-out of the tree used to start the collective on the xstreams */
+#define DSS_COLL_FANOUT		4
+/** max number of collective descriptors cached per xstream */
+#define DSS_COLL_CACHE_MAX	8
+
+/**
+ * Descriptor of one collective call. Descriptors are cached per xstream of
+ * the caller, the arrays are sized by dss_tgt_nr and allocated along with it.
+ *
+ * The participating targets are numbered from 1 to cd_nr in cd_tids order
+ * and form a DSS_COLL_FANOUT-ary tree under the caller (number 0). Each of
+ * them starts its children before running the function, so the fan-out is
+ * spread over the xstreams, and the fan-in is one atomic decrement each.
+ */
+struct dss_coll_desc {
+	d_list_t			 cd_link;
+	ABT_eventual			 cd_eventual;
+	/** number of targets not done yet */
+	ATOMIC int			 cd_pending;
+	int				 cd_nr;
+	int				(*cd_func)(void *);
+	void				*cd_arg;
+	unsigned int			 cd_flags;
+	bool				 cd_ult;
+	/** per target arguments, indexed by target */
+	struct dss_stream_arg_type	*cd_streams;
+	/** target of each number minus one */
+	int				*cd_tids;
+	/** number of each target */
+	int				*cd_pos;
 };
 
+static struct dss_coll_desc *
+coll_desc_get(void)
+{
+	struct dss_xstream	*dx = dss_current_xstream();
+	struct dss_coll_desc	*desc;
+	int			 rc;
+
+	if (dx != NULL) {
+		desc = d_list_pop_entry(&dx->dx_coll_free, struct dss_coll_desc, cd_link);
+		if (desc != NULL) {
+			dx->dx_coll_free_nr--;
+			return desc;
+		}
+	}
+
+	D_ALLOC(desc, sizeof(*desc) + dss_tgt_nr * (sizeof(*desc->cd_streams) +
+						    2 * sizeof(int)));
+	if (desc == NULL)
+		return NULL;
+
+	rc = ABT_eventual_create(0, &desc->cd_eventual);
+	if (rc != ABT_SUCCESS) {
+		D_FREE(desc);
+		return NULL;
+	}
+
+	D_INIT_LIST_HEAD(&desc->cd_link);
+	desc->cd_streams = (struct dss_stream_arg_type *)(desc + 1);
+	desc->cd_tids = (int *)(desc->cd_streams + dss_tgt_nr);
+	desc->cd_pos = desc->cd_tids + dss_tgt_nr;
+	return desc;
+}
+
 static void
-collective_func(void *varg)
+coll_desc_free(struct dss_coll_desc *desc)
 {
-	struct dss_stream_arg_type	*a_args	= varg;
-	struct collective_arg		*carg	= a_args->st_coll_args;
-	struct dss_future_arg		*f_arg	= &carg->ca_future;
-	int				rc;
+	ABT_eventual_free(&desc->cd_eventual);
+	D_FREE(desc);
+}
 
-	/** Update just the rc value */
-	a_args->st_rc = f_arg->dfa_func(f_arg->dfa_arg);
+static void
+coll_desc_put(struct dss_coll_desc *desc)
+{
+	struct dss_xstream	*dx = dss_current_xstream();
+
+	if (dx == NULL || dx->dx_coll_free_nr >= DSS_COLL_CACHE_MAX) {
+		coll_desc_free(desc);
+		return;
+	}
+
+	ABT_eventual_reset(desc->cd_eventual);
+	d_list_add(&desc->cd_link, &dx->dx_coll_free);
+	dx->dx_coll_free_nr++;
+}
+
+/** Free the collective descriptors cached by \a dx. */
+void
+dss_coll_cache_fini(struct dss_xstream *dx)
+{
+	struct dss_coll_desc	*desc;
 
-	rc = ABT_future_set(f_arg->dfa_future, (void *)a_args);
-	if (rc != ABT_SUCCESS)
-		D_ERROR("future set failure %d\n", rc);
+	while ((desc = d_list_pop_entry(&dx->dx_coll_free, struct dss_coll_desc,
+					cd_link)) != NULL)
+		coll_desc_free(desc);
+	dx->dx_coll_free_nr = 0;
 }
 
-/* Reduce the return codes into the first element. */
 static void
-collective_reduce(void **arg)
+coll_complete(struct dss_coll_desc *desc)
+{
+	/* the caller may reuse desc as soon as the last one is done */
+	if (atomic_fetch_sub(&desc->cd_pending, 1) == 1)
+		ABT_eventual_set(desc->cd_eventual, NULL, 0);
+}
+
+/* Fail number \a pos and the whole subtree under it. */
+static void
+coll_fail(struct dss_coll_desc *desc, int pos, int rc)
+{
+	int	child;
+
+	desc->cd_streams[desc->cd_tids[pos - 1]].st_rc = rc;
+	for (child = pos * DSS_COLL_FANOUT + 1;
+	     child <= desc->cd_nr && child <= pos * DSS_COLL_FANOUT + DSS_COLL_FANOUT; child++)
+		coll_fail(desc, child, rc);
+	coll_complete(desc);
+}
+
+static void collective_func(void *varg);
+
+static void
+coll_dispatch(struct dss_coll_desc *desc, int pos)
 {
-	struct aggregator_arg_type	*aggregator;
 	struct dss_stream_arg_type	*stream;
-	int				*nfailed;
-	int				 i;
+	struct dss_xstream		*dx;
+	ABT_thread_attr			 attr = ABT_THREAD_ATTR_NULL;
+	int				 tid = desc->cd_tids[pos - 1];
+	int				 rc;
+	int				 rc1;
+
+	stream = &desc->cd_streams[tid];
+	dx = dss_get_xstream(DSS_MAIN_XS_ID(tid));
+	if (!desc->cd_ult) {
+		rc = sched_create_task(dx, collective_func, stream, NULL, desc->cd_flags);
+		goto out;
+	}
 
-	aggregator = (struct aggregator_arg_type *)arg[0];
-	nfailed = &aggregator->at_args.st_rc;
+	if (desc->cd_flags & DSS_ULT_DEEP_STACK) {
+		rc1 = ABT_thread_attr_create(&attr);
+		if (rc1 != ABT_SUCCESS)
+			D_GOTO(out, rc = dss_abterr2der(rc1));
 
-	for (i = 1; i < aggregator->at_xs_nr + 1; i++) {
-		stream = (struct dss_stream_arg_type *)arg[i];
-		if (stream->st_rc != 0) {
-			if (aggregator->at_rc == 0)
-				aggregator->at_rc = stream->st_rc;
-			(*nfailed)++;
-		}
+		rc1 = ABT_thread_attr_set_stacksize(attr, DSS_DEEP_STACK_SZ);
+		D_ASSERT(rc1 == ABT_SUCCESS);
 
-		/** optional custom aggregator call provided across streams */
-		if (aggregator->at_reduce)
-			aggregator->at_reduce(aggregator->at_args.st_arg,
-					      stream->st_arg);
+		D_DEBUG(DB_TRACE, "Create collective ult with stacksize %d\n",
+			DSS_DEEP_STACK_SZ);
+	}
+
+	rc = sched_create_thread(dx, collective_func, stream, attr, NULL, desc->cd_flags);
+	if (attr != ABT_THREAD_ATTR_NULL) {
+		rc1 = ABT_thread_attr_free(&attr);
+		D_ASSERT(rc1 == ABT_SUCCESS);
 	}
+out:
+	if (rc != 0)
+		coll_fail(desc, pos, rc);
+}
+
+static void
+coll_fanout(struct dss_coll_desc *desc, int pos)
+{
+	int	child;
+
+	for (child = pos * DSS_COLL_FANOUT + 1;
+	     child <= desc->cd_nr && child <= pos * DSS_COLL_FANOUT + DSS_COLL_FANOUT; child++)
+		coll_dispatch(desc, child);
+}
+
+static void
+collective_func(void *varg)
+{
+	struct dss_stream_arg_type	*stream = varg;
+	struct dss_coll_desc		*desc = stream->st_coll_args;
+	int				 tid = stream - desc->cd_streams;
+
+	coll_fanout(desc, desc->cd_pos[tid]);
+
+	/** Update just the rc value */
+	stream->st_rc = desc->cd_func(desc->cd_arg);
+	coll_complete(desc);
 }
 
 static int
@@ -88,15 +218,12 @@ dss_collective_reduce_internal(struct dss_coll_ops *ops,
 			       struct dss_coll_args *args, bool create_ult,
 			       unsigned int flags)
 {
-	struct collective_arg		carg;
-	struct dss_coll_stream_args	*stream_args;
+	struct dss_coll_desc		*desc;
 	struct dss_stream_arg_type	*stream;
-	struct aggregator_arg_type	aggregator;
-	struct dss_xstream		*dx;
-	ABT_future			future;
-	int				xs_nr;
-	int				rc;
-	int				tid;
+	int				 xs_nr;
+	int				 rc;
+	int				 tid;
+	int				 i;
 
 	if (ops == NULL || args == NULL || ops->co_func == NULL) {
 		D_DEBUG(DB_MD, "mandatory args missing dss_collective_reduce");
@@ -116,112 +243,67 @@ dss_collective_reduce_internal(struct dss_coll_ops *ops,
 	}
 
 	xs_nr = dss_tgt_nr;
-	stream_args = &args->ca_stream_args;
-	D_ALLOC_ARRAY(stream_args->csa_streams, xs_nr);
-	if (stream_args->csa_streams == NULL)
+	desc = coll_desc_get();
+	if (desc == NULL)
 		return -DER_NOMEM;
 
-	/*
-	 * Use the first, extra element of the value array to store the number
-	 * of failed tasks.
-	 */
-	rc = ABT_future_create(xs_nr + 1, collective_reduce, &future);
-	if (rc != ABT_SUCCESS)
-		D_GOTO(out_streams, rc = dss_abterr2der(rc));
-
-	carg.ca_future.dfa_future = future;
-	carg.ca_future.dfa_func	= ops->co_func;
-	carg.ca_future.dfa_arg	= args->ca_func_args;
-	carg.ca_future.dfa_status = 0;
-
-	memset(&aggregator, 0, sizeof(aggregator));
-	aggregator.at_xs_nr = xs_nr;
-	if (ops->co_reduce) {
-		aggregator.at_args.st_arg = args->ca_aggregator;
-		aggregator.at_reduce	  = ops->co_reduce;
-	}
+	memset(desc->cd_streams, 0, xs_nr * sizeof(*desc->cd_streams));
+	args->ca_stream_args.csa_streams = desc->cd_streams;
+	desc->cd_func = ops->co_func;
+	desc->cd_arg = args->ca_func_args;
+	desc->cd_flags = flags;
+	desc->cd_ult = create_ult;
+	desc->cd_nr = 0;
 
 	if (ops->co_reduce_arg_alloc)
 		for (tid = 0; tid < xs_nr; tid++) {
-			stream = &stream_args->csa_streams[tid];
-			rc = ops->co_reduce_arg_alloc(stream,
-						     aggregator.at_args.st_arg);
+			stream = &desc->cd_streams[tid];
+			rc = ops->co_reduce_arg_alloc(stream, args->ca_aggregator);
 			if (rc)
-				D_GOTO(out_future, rc);
+				D_GOTO(out_streams, rc);
 		}
 
-	rc = ABT_future_set(future, (void *)&aggregator);
-	D_ASSERTF(rc == ABT_SUCCESS, "%d\n", rc);
 	for (tid = 0; tid < xs_nr; tid++) {
-		stream			= &stream_args->csa_streams[tid];
-		stream->st_coll_args	= &carg;
-
-		if (args->ca_exclude_tgts_cnt) {
-			int i;
-
-			for (i = 0; i < args->ca_exclude_tgts_cnt; i++)
-				if (args->ca_exclude_tgts[i] == tid)
-					break;
-
-			if (i < args->ca_exclude_tgts_cnt) {
-				D_DEBUG(DB_TRACE, "Skip tgt %d\n", tid);
-				rc = ABT_future_set(future, (void *)stream);
-				D_ASSERTF(rc == ABT_SUCCESS, "%d\n", rc);
-				continue;
-			}
-		}
+		desc->cd_streams[tid].st_coll_args = desc;
 
-		dx = dss_get_xstream(DSS_MAIN_XS_ID(tid));
-		if (create_ult) {
-			ABT_thread_attr		attr;
-			int			rc1;
-
-			if (flags & DSS_ULT_DEEP_STACK) {
-				rc1 = ABT_thread_attr_create(&attr);
-				if (rc1 != ABT_SUCCESS)
-					D_GOTO(next, rc = dss_abterr2der(rc1));
-
-				rc1 = ABT_thread_attr_set_stacksize(attr, DSS_DEEP_STACK_SZ);
-				D_ASSERT(rc1 == ABT_SUCCESS);
-
-				D_DEBUG(DB_TRACE, "Create collective ult with stacksize %d\n",
-					DSS_DEEP_STACK_SZ);
-
-			} else {
-				attr = ABT_THREAD_ATTR_NULL;
-			}
-
-			rc = sched_create_thread(dx, collective_func, stream, attr, NULL, flags);
-			if (attr != ABT_THREAD_ATTR_NULL) {
-				rc1 = ABT_thread_attr_free(&attr);
-				D_ASSERT(rc1 == ABT_SUCCESS);
-			}
-		} else {
-			rc = sched_create_task(dx, collective_func, stream,
-					       NULL, flags);
-		}
+		for (i = 0; i < args->ca_exclude_tgts_cnt; i++)
+			if (args->ca_exclude_tgts[i] == tid)
+				break;
 
-		if (rc != 0) {
-next:
-			stream->st_rc = rc;
-			rc = ABT_future_set(future, (void *)stream);
-			D_ASSERTF(rc == ABT_SUCCESS, "%d\n", rc);
+		if (i < args->ca_exclude_tgts_cnt) {
+			D_DEBUG(DB_TRACE, "Skip tgt %d\n", tid);
+			continue;
 		}
+
+		desc->cd_tids[desc->cd_nr] = tid;
+		desc->cd_pos[tid] = ++desc->cd_nr;
 	}
 
-	ABT_future_wait(future);
+	if (desc->cd_nr > 0) {
+		atomic_store(&desc->cd_pending, desc->cd_nr);
+		coll_fanout(desc, 0);
+		ABT_eventual_wait(desc->cd_eventual, NULL);
+	}
 
-	rc = aggregator.at_rc;
+	/* Reduce the return codes, and the stream arguments if asked to. */
+	rc = 0;
+	for (tid = 0; tid < xs_nr; tid++) {
+		stream = &desc->cd_streams[tid];
+		if (stream->st_rc != 0 && rc == 0)
+			rc = stream->st_rc;
 
-out_future:
-	ABT_future_free(&future);
+		/** optional custom aggregator call provided across streams */
+		if (ops->co_reduce)
+			ops->co_reduce(args->ca_aggregator, stream->st_arg);
+	}
 
+out_streams:
 	if (ops->co_reduce_arg_free)
 		for (tid = 0; tid < xs_nr; tid++)
-			ops->co_reduce_arg_free(&stream_args->csa_streams[tid]);
+			ops->co_reduce_arg_free(&desc->cd_streams[tid]);
 
-out_streams:
-	D_FREE(args->ca_stream_args.csa_streams);
+	args->ca_stream_args.csa_streams = NULL;
+	coll_desc_put(desc);
 
 	return rc;
 }
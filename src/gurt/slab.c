@@ -8,9 +8,33 @@
 
 #include <gurt/debug.h>
 #include <gurt/common.h>
+#include <gurt/atomic.h>
+#include <gurt/telemetry_common.h>
+#include <gurt/telemetry_producer.h>
 
 #include "gurt/slab.h"
 
+/* Per-thread cache of descriptors for one type.
+ *
+ * sm_objs[0, sm_loaded_nr) are ready for use and sm_objs[size, size +
+ * sm_returned_nr) have been released by this thread but still need a reset,
+ * where size is st_mag_size.  Only the owning thread touches a magazine,
+ * except at thread exit and d_slab_destroy().  d_slab_reclaim() asks other
+ * threads to empty their magazines by setting sm_flush, which the owner
+ * checks on every call.
+ */
+struct d_slab_mag {
+	struct d_slab_type *sm_type;
+	d_list_t            sm_link;
+	int                 sm_loaded_nr;
+	int                 sm_returned_nr;
+	ATOMIC bool         sm_flush;
+	/* Not yet folded into the type statistics */
+	uint64_t            sm_hit;
+	uint64_t            sm_miss;
+	void               *sm_objs[];
+};
+
 static void
 debug_dump(struct d_slab_type *type)
 {
@@ -24,6 +48,160 @@ debug_dump(struct d_slab_type *type)
 	D_TRACE_DEBUG(DB_ANY, type, "OP: init %d reset %d", type->st_op_init, type->st_op_reset);
 	D_TRACE_DEBUG(DB_ANY, type, "No restock: current %d hwm %d", type->st_no_restock,
 		      type->st_no_restock_hwm);
+	D_TRACE_DEBUG(DB_ANY, type, "Magazine: size %d hit %" PRIu64 " miss %" PRIu64
+		      " contended %" PRIu64, type->st_mag_size, type->st_mag_hit,
+		      type->st_mag_miss, type->st_lock_contended);
+}
+
+/* Take the type lock, returns true if it had to wait for it */
+static bool
+type_lock(struct d_slab_type *type)
+{
+	if (pthread_mutex_trylock(&type->st_lock) == 0)
+		return false;
+
+	D_MUTEX_LOCK(&type->st_lock);
+	type->st_lock_contended++;
+	return true;
+}
+
+/* Publish statistics gathered under the type lock, called after dropping it */
+static void
+type_stats_publish(struct d_slab_type *type, uint64_t hit, uint64_t miss, bool contended)
+{
+	if (hit)
+		d_tm_inc_counter(type->st_tm_hit, hit);
+	if (miss)
+		d_tm_inc_counter(type->st_tm_miss, miss);
+	if (contended)
+		d_tm_inc_counter(type->st_tm_contended, 1);
+}
+
+/* Telemetry is optional, the counters stay NULL if it is not initialised */
+static void
+type_stats_init(struct d_slab_type *type)
+{
+	int rc;
+
+	rc = d_tm_add_metric(&type->st_tm_hit, D_TM_COUNTER,
+			     "Descriptors acquired from the per-thread cache", "descs",
+			     "slab/%s/hit", type->st_reg.sr_name);
+	if (rc == -DER_SUCCESS)
+		rc = d_tm_add_metric(&type->st_tm_miss, D_TM_COUNTER,
+				     "Descriptors acquired from the shared free list", "descs",
+				     "slab/%s/miss", type->st_reg.sr_name);
+	if (rc == -DER_SUCCESS)
+		rc = d_tm_add_metric(&type->st_tm_contended, D_TM_COUNTER,
+				     "Slow path calls which waited for the type lock", "calls",
+				     "slab/%s/contended", type->st_reg.sr_name);
+	if (rc != -DER_SUCCESS)
+		D_TRACE_DEBUG(DB_ANY, type, "No telemetry: " DF_RC, DP_RC(rc));
+}
+
+/* Fold the magazine statistics into the type, called with the type lock held */
+static void
+mag_stats_fold(struct d_slab_type *type, struct d_slab_mag *mag, uint64_t *hit, uint64_t *miss)
+{
+	type->st_mag_hit += mag->sm_hit;
+	type->st_mag_miss += mag->sm_miss;
+	*hit          = mag->sm_hit;
+	*miss         = mag->sm_miss;
+	mag->sm_hit   = 0;
+	mag->sm_miss  = 0;
+}
+
+/* Hand the descriptors released by this thread to the pending list.
+ *
+ * This function should be called with the type lock held.
+ */
+static void
+mag_return(struct d_slab_type *type, struct d_slab_mag *mag)
+{
+	void **returned = &mag->sm_objs[type->st_mag_size];
+	int    i;
+
+	for (i = 0; i < mag->sm_returned_nr; i++)
+		d_list_add_tail(returned[i] + type->st_reg.sr_offset, &type->st_pending_list);
+	type->st_pending_count += mag->sm_returned_nr;
+	mag->sm_returned_nr = 0;
+}
+
+/* Empty a magazine back into the type lists.
+ *
+ * This function should be called with the type lock held.
+ */
+static void
+mag_flush(struct d_slab_type *type, struct d_slab_mag *mag)
+{
+	while (mag->sm_loaded_nr > 0) {
+		d_list_t *entry = mag->sm_objs[--mag->sm_loaded_nr] + type->st_reg.sr_offset;
+
+		d_list_add(entry, &type->st_free_list);
+		type->st_free_count++;
+	}
+	mag_return(type, mag);
+	atomic_store_relaxed(&mag->sm_flush, false);
+}
+
+/* Empty a magazine back into the type lists and unlink it.
+ *
+ * This function should be called with the type lock held.
+ */
+static void
+mag_drain(struct d_slab_type *type, struct d_slab_mag *mag)
+{
+	uint64_t hit;
+	uint64_t miss;
+
+	mag_flush(type, mag);
+	mag_stats_fold(type, mag, &hit, &miss);
+	d_list_del(&mag->sm_link);
+}
+
+/* Thread exit destructor of the magazine key */
+static void
+mag_destroy_cb(void *arg)
+{
+	struct d_slab_mag  *mag  = arg;
+	struct d_slab_type *type = mag->sm_type;
+
+	D_MUTEX_LOCK(&type->st_lock);
+	mag_drain(type, mag);
+	D_MUTEX_UNLOCK(&type->st_lock);
+	D_FREE(mag);
+}
+
+/* Return the magazine of the calling thread, creating it on first use.
+ *
+ * Returns NULL if magazines are disabled for the type or allocation failed,
+ * in which case the callers use the shared lists directly.
+ */
+static struct d_slab_mag *
+mag_get(struct d_slab_type *type)
+{
+	struct d_slab_mag *mag;
+
+	if (type->st_mag_size == 0)
+		return NULL;
+
+	mag = pthread_getspecific(type->st_mag_key);
+	if (likely(mag != NULL))
+		return mag;
+
+	D_ALLOC(mag, sizeof(*mag) + 2 * type->st_mag_size * sizeof(mag->sm_objs[0]));
+	if (!mag)
+		return NULL;
+
+	mag->sm_type = type;
+	if (pthread_setspecific(type->st_mag_key, mag) != 0) {
+		D_FREE(mag);
+		return NULL;
+	}
+
+	D_MUTEX_LOCK(&type->st_lock);
+	d_list_add_tail(&mag->sm_link, &type->st_mag_list);
+	D_MUTEX_UNLOCK(&type->st_lock);
+	return mag;
 }
 
 /* Create a data slab manager */
@@ -57,6 +235,23 @@ d_slab_destroy(struct d_slab *slab)
 	if (!slab->slab_init)
 		return;
 
+	/* All other threads are expected to be done with the slab by now */
+	d_list_for_each_entry(type, &slab->slab_list, st_type_list) {
+		struct d_slab_mag *mag;
+		struct d_slab_mag *mnext;
+
+		if (type->st_mag_size == 0)
+			continue;
+
+		D_MUTEX_LOCK(&type->st_lock);
+		d_list_for_each_entry_safe(mag, mnext, &type->st_mag_list, sm_link) {
+			mag_drain(type, mag);
+			D_FREE(mag);
+		}
+		D_MUTEX_UNLOCK(&type->st_lock);
+		pthread_key_delete(type->st_mag_key);
+	}
+
 	d_list_for_each_entry(type, &slab->slab_list, st_type_list) {
 		debug_dump(type);
 	}
@@ -136,6 +331,10 @@ restock(struct d_slab_type *type, int count)
 }
 
 /* Reclaim any memory possible across all types
+ *
+ * The magazine of the calling thread is emptied first.  Magazines of other
+ * threads are flagged and emptied by their owners on their next call, their
+ * descriptors are counted as in use until then.
  *
  * Returns true of there are any descriptors in use.
  */
@@ -148,12 +347,24 @@ d_slab_reclaim(struct d_slab *slab)
 
 	D_MUTEX_LOCK(&slab->slab_lock);
 	d_list_for_each_entry(type, &slab->slab_list, st_type_list) {
-		d_list_t *entry, *enext;
+		d_list_t          *entry, *enext;
+		struct d_slab_mag *mag;
+		struct d_slab_mag *own = NULL;
 
 		D_TRACE_DEBUG(DB_ANY, type, "Resetting type");
 
+		if (type->st_mag_size != 0)
+			own = pthread_getspecific(type->st_mag_key);
+
 		D_MUTEX_LOCK(&type->st_lock);
 
+		d_list_for_each_entry(mag, &type->st_mag_list, sm_link) {
+			if (mag == own)
+				mag_flush(type, mag);
+			else
+				atomic_store_relaxed(&mag->sm_flush, true);
+		}
+
 		/* Reclaim any pending objects.  Count here just needs to be
 		 * larger than pending_count + free_count however simply
 		 * using count is adequate as is guaranteed to be larger.
@@ -266,11 +477,26 @@ d_slab_register(struct d_slab *slab, struct d_slab_reg *reg, struct d_slab_type
 
 	D_INIT_LIST_HEAD(&type->st_free_list);
 	D_INIT_LIST_HEAD(&type->st_pending_list);
+	D_INIT_LIST_HEAD(&type->st_mag_list);
 	type->st_slab = slab;
 
 	type->st_count = 0;
 	type->st_reg   = *reg;
 
+	/* Descriptors held in one thread's magazine cannot be used by another */
+	if (reg->sr_mag_size > 0 && reg->sr_max_desc == 0)
+		type->st_mag_size = reg->sr_mag_size;
+	else if (reg->sr_mag_size > 0)
+		D_TRACE_INFO(type, "No per-thread cache with max_desc %d", reg->sr_max_desc);
+
+	if (type->st_mag_size != 0) {
+		rc = pthread_key_create(&type->st_mag_key, mag_destroy_cb);
+		if (rc != 0) {
+			D_TRACE_WARN(type, "No per-thread cache %d %s", rc, strerror(rc));
+			type->st_mag_size = 0;
+		}
+	}
+
 	create_many(type);
 	create_many(type);
 
@@ -285,11 +511,15 @@ d_slab_register(struct d_slab *slab, struct d_slab_reg *reg, struct d_slab_type
 		 * injected fault would be ignored - failing the specific
 		 * test.
 		 */
+		if (type->st_mag_size != 0)
+			pthread_key_delete(type->st_mag_key);
 		D_MUTEX_DESTROY(&type->st_lock);
 		D_FREE(type);
 		return -DER_INVAL;
 	}
 
+	type_stats_init(type);
+
 	D_MUTEX_LOCK(&slab->slab_lock);
 	d_list_add_tail(&type->st_type_list, &slab->slab_list);
 	D_MUTEX_UNLOCK(&slab->slab_lock);
@@ -298,22 +528,66 @@ d_slab_register(struct d_slab *slab, struct d_slab_reg *reg, struct d_slab_type
 	return -DER_SUCCESS;
 }
 
+/* Take the first object off the free list.
+ *
+ * This function should be called with the type lock held.
+ */
+static void *
+free_list_pop(struct d_slab_type *type)
+{
+	d_list_t *entry = type->st_free_list.next;
+
+	d_list_del(entry);
+	entry->next = NULL;
+	entry->prev = NULL;
+	type->st_free_count--;
+	return (void *)entry - type->st_reg.sr_offset;
+}
+
 /* Acquire a new object.
  *
  * This is to be considered on the critical path so should be as lightweight
- * as posslble.
+ * as posslble.  The fast path pops from the magazine of the calling thread
+ * without locking, on a miss the magazine hands back what this thread has
+ * released and is refilled up to half its size in a single lock hold.  The
+ * refill only takes descriptors which are already on the free list, so no
+ * more resets than without a magazine are done on the critical path.
  */
 void *
 d_slab_acquire(struct d_slab_type *type)
 {
-	void     *ptr = NULL;
-	d_list_t *entry;
-	bool      at_limit = false;
+	struct d_slab_mag *mag;
+	void              *ptr = NULL;
+	bool               at_limit = false;
+	bool               contended;
+	uint64_t           hit  = 0;
+	uint64_t           miss = 0;
+	int                want = 1;
+
+	mag = mag_get(type);
+	if (likely(mag != NULL && mag->sm_loaded_nr > 0 &&
+		   !atomic_load_relaxed(&mag->sm_flush))) {
+		ptr = mag->sm_objs[--mag->sm_loaded_nr];
+		mag->sm_hit++;
+		D_TRACE_DEBUG(DB_ANY, type, "Using %p", ptr);
+		return ptr;
+	}
 
-	D_MUTEX_LOCK(&type->st_lock);
+	contended = type_lock(type);
 
 	type->st_no_restock++;
 
+	if (mag != NULL) {
+		mag->sm_miss++;
+		/* Don't refill a magazine which d_slab_reclaim() asked to empty */
+		if (atomic_load_relaxed(&mag->sm_flush))
+			mag_flush(type, mag);
+		else
+			want += type->st_mag_size / 2;
+		mag_return(type, mag);
+		mag_stats_fold(type, mag, &hit, &miss);
+	}
+
 	if (type->st_free_count == 0) {
 		int count = restock(type, 1);
 
@@ -321,12 +595,14 @@ d_slab_acquire(struct d_slab_type *type)
 	}
 
 	if (!d_list_empty(&type->st_free_list)) {
-		entry = type->st_free_list.next;
-		d_list_del(entry);
-		entry->next = NULL;
-		entry->prev = NULL;
-		type->st_free_count--;
-		ptr = (void *)entry - type->st_reg.sr_offset;
+		ptr = free_list_pop(type);
+
+		/* Count the batch so restock() keeps enough for the next refill */
+		while (mag != NULL && mag->sm_loaded_nr < want - 1 &&
+		       !d_list_empty(&type->st_free_list)) {
+			mag->sm_objs[mag->sm_loaded_nr++] = free_list_pop(type);
+			type->st_no_restock++;
+		}
 	} else {
 		if (!type->st_reg.sr_max_desc || type->st_count < type->st_reg.sr_max_desc) {
 			type->st_op_init++;
@@ -338,6 +614,8 @@ d_slab_acquire(struct d_slab_type *type)
 
 	D_MUTEX_UNLOCK(&type->st_lock);
 
+	type_stats_publish(type, hit, miss, contended);
+
 	if (ptr)
 		D_TRACE_DEBUG(DB_ANY, type, "Using %p", ptr);
 	else if (at_limit)
@@ -350,19 +628,40 @@ d_slab_acquire(struct d_slab_type *type)
 /* Release an object ready for reuse
  *
  * This is sometimes on the critical path, sometimes not so assume that
- * for all cases it is.
+ * for all cases it is.  The object is parked in the magazine of the calling
+ * thread, a full magazine is handed to the pending list in one go.
  *
  */
 void
 d_slab_release(struct d_slab_type *type, void *ptr)
 {
-	d_list_t *entry = ptr + type->st_reg.sr_offset;
+	d_list_t          *entry = ptr + type->st_reg.sr_offset;
+	struct d_slab_mag *mag;
+	bool               contended;
+	uint64_t           hit  = 0;
+	uint64_t           miss = 0;
 
 	D_TRACE_DOWN(DB_ANY, ptr);
-	D_MUTEX_LOCK(&type->st_lock);
+
+	mag = mag_get(type);
+	if (likely(mag != NULL && mag->sm_returned_nr < type->st_mag_size &&
+		   !atomic_load_relaxed(&mag->sm_flush))) {
+		mag->sm_objs[type->st_mag_size + mag->sm_returned_nr++] = ptr;
+		return;
+	}
+
+	contended = type_lock(type);
+	if (mag != NULL) {
+		if (atomic_load_relaxed(&mag->sm_flush))
+			mag_flush(type, mag);
+		mag_return(type, mag);
+		mag_stats_fold(type, mag, &hit, &miss);
+	}
 	type->st_pending_count++;
 	d_list_add_tail(entry, &type->st_pending_list);
 	D_MUTEX_UNLOCK(&type->st_lock);
+
+	type_stats_publish(type, hit, miss, contended);
 }
 
 /* Re-stock an object type.
@@ -379,11 +678,22 @@ d_slab_release(struct d_slab_type *type, void *ptr)
 void
 d_slab_restock(struct d_slab_type *type)
 {
+	struct d_slab_mag *mag = NULL;
+
 	D_TRACE_DEBUG(DB_ANY, type, "Count (%d/%d/%d)", type->st_pending_count, type->st_free_count,
 		      type->st_count);
 
+	if (type->st_mag_size != 0)
+		mag = pthread_getspecific(type->st_mag_key);
+
 	D_MUTEX_LOCK(&type->st_lock);
 
+	/* Let this thread's released objects be reset off the critical path */
+	if (mag != NULL && atomic_load_relaxed(&mag->sm_flush))
+		mag_flush(type, mag);
+	else if (mag != NULL)
+		mag_return(type, mag);
+
 	/* Update restock hwm metrics */
 	if (type->st_no_restock > type->st_no_restock_hwm)
 		type->st_no_restock_hwm = type->st_no_restock;
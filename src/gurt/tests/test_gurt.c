@@ -21,6 +21,7 @@
 #include <gurt/dlog.h>
 #include <gurt/hash.h>
 #include <gurt/atomic.h>
+#include <gurt/slab.h>
 
 /* machine epsilon */
 #define EPSILON (1.0E-16)
@@ -1893,6 +1894,136 @@ test_gurt_atomic(void **state)
 	assert(mix  == 123456);
 }
 
+#define SLAB_OBJ_NR	(3 * D_SLAB_MAG_SIZE)
+
+struct slab_obj {
+	d_list_t	so_list;
+	int		so_resets;
+};
+
+static bool
+slab_obj_reset(void *desc)
+{
+	struct slab_obj *obj = desc;
+
+	obj->so_resets++;
+	return true;
+}
+
+struct slab_release_arg {
+	struct d_slab_type	*sra_type;
+	struct slab_obj		*sra_objs[SLAB_OBJ_NR];
+	pthread_barrier_t	 sra_barrier;
+};
+
+static void *
+slab_release_func(void *data)
+{
+	struct slab_release_arg	*arg = data;
+	int			 i;
+
+	for (i = 0; i < SLAB_OBJ_NR; i++)
+		d_slab_release(arg->sra_type, arg->sra_objs[i]);
+	return NULL;
+}
+
+/* Keep released objects in this thread's magazine until reclaim asks for them */
+static void *
+slab_hold_func(void *data)
+{
+	struct slab_release_arg	*arg = data;
+
+	d_slab_release(arg->sra_type, arg->sra_objs[0]);
+	pthread_barrier_wait(&arg->sra_barrier);
+	/* reclaim by the main thread */
+	pthread_barrier_wait(&arg->sra_barrier);
+	d_slab_restock(arg->sra_type);
+	pthread_barrier_wait(&arg->sra_barrier);
+	/* reclaim by the main thread */
+	pthread_barrier_wait(&arg->sra_barrier);
+	return NULL;
+}
+
+static void
+test_gurt_slab(void **state)
+{
+	struct d_slab_reg	 reg = {.sr_reset = slab_obj_reset,
+					POOL_TYPE_INIT(slab_obj, so_list)};
+	struct d_slab		 slab;
+	struct d_slab_type	*type;
+	struct slab_release_arg	 arg;
+	pthread_t		 thread;
+	int			 count;
+	int			 resets;
+	int			 i;
+	int			 rc;
+
+	rc = d_slab_init(&slab, NULL);
+	assert_int_equal(rc, 0);
+
+	/* Per-thread caches are opt-in */
+	rc = d_slab_register(&slab, &reg, &type);
+	assert_int_equal(rc, 0);
+	assert_int_equal(type->st_mag_size, 0);
+
+	reg.sr_mag_size = D_SLAB_MAG_SIZE;
+	rc = d_slab_register(&slab, &reg, &type);
+	assert_int_equal(rc, 0);
+	assert_int_equal(type->st_mag_size, D_SLAB_MAG_SIZE);
+
+	for (i = 0; i < SLAB_OBJ_NR; i++) {
+		arg.sra_objs[i] = d_slab_acquire(type);
+		assert_non_null(arg.sra_objs[i]);
+	}
+	count = type->st_count;
+	arg.sra_type = type;
+
+	/* Objects released by another thread come back when it exits */
+	rc = pthread_create(&thread, NULL, slab_release_func, &arg);
+	assert_int_equal(rc, 0);
+	rc = pthread_join(thread, NULL);
+	assert_int_equal(rc, 0);
+	assert_int_equal(type->st_pending_count + type->st_free_count, count);
+
+	/* Everything needed is now on the free list, nothing created or reset on-path */
+	d_slab_restock(type);
+	count = type->st_count;
+	resets = type->st_op_reset;
+	for (i = 0; i < SLAB_OBJ_NR; i++) {
+		arg.sra_objs[i] = d_slab_acquire(type);
+		assert_non_null(arg.sra_objs[i]);
+	}
+	assert_int_equal(type->st_count, count);
+	assert_int_equal(type->st_op_reset, resets);
+	assert_true(type->st_mag_miss > 0);
+
+	/* Released into the magazine of this thread, freed by reclaim */
+	for (i = 0; i < SLAB_OBJ_NR; i++)
+		d_slab_release(type, arg.sra_objs[i]);
+	assert_false(d_slab_reclaim(&slab));
+	assert_int_equal(type->st_count, 0);
+
+	/* Another thread's magazine is handed back on its next call */
+	arg.sra_objs[0] = d_slab_acquire(type);
+	assert_non_null(arg.sra_objs[0]);
+	rc = pthread_barrier_init(&arg.sra_barrier, NULL, 2);
+	assert_int_equal(rc, 0);
+	rc = pthread_create(&thread, NULL, slab_hold_func, &arg);
+	assert_int_equal(rc, 0);
+	pthread_barrier_wait(&arg.sra_barrier);
+	assert_true(d_slab_reclaim(&slab));
+	pthread_barrier_wait(&arg.sra_barrier);
+	pthread_barrier_wait(&arg.sra_barrier);
+	assert_false(d_slab_reclaim(&slab));
+	assert_int_equal(type->st_count, 0);
+	pthread_barrier_wait(&arg.sra_barrier);
+	rc = pthread_join(thread, NULL);
+	assert_int_equal(rc, 0);
+	pthread_barrier_destroy(&arg.sra_barrier);
+
+	d_slab_destroy(&slab);
+}
+
 static void
 check_string_buffer(struct d_string_buffer_t *str_buf, int str_size,
 		    int buf_size, const char *test_str)
@@ -2087,6 +2218,7 @@ main(int argc, char **argv)
 		cmocka_unit_test(test_gurt_hash_parallel_refcounting),
 		cmocka_unit_test(test_gurt_atomic),
 		cmocka_unit_test(test_gurt_string_buffer),
+		cmocka_unit_test(test_gurt_slab),
 		cmocka_unit_test(test_hash_perf),
 	};
 
@@ -1030,7 +1030,9 @@ enum crt_tree_type {
 	CRT_TREE_FLAT		= 1,
 	CRT_TREE_KARY		= 2,
 	CRT_TREE_KNOMIAL	= 3,
-	CRT_TREE_MAX		= 3,
+	/* k-ary over racks, then over nodes, flat within a node */
+	CRT_TREE_DOMAIN		= 4,
+	CRT_TREE_MAX		= 4,
 };
 
 #define CRT_TREE_TYPE_SHIFT	(16U)
@@ -1984,6 +1986,24 @@ int crt_group_psr_set(crt_group_t *grp, d_rank_t rank);
  */
 int crt_group_psrs_set(crt_group_t *grp, d_rank_list_t *rank_list);
 
+/**
+ * Set the fault domains (node and rack) of ranks of the provided group, used
+ * by CRT_TREE_DOMAIN to build the collective RPC trees. Ranks without domain
+ * info are treated as separate nodes of one extra rack. Domains are kept on
+ * the primary group, the ones of ranks set previously are replaced, the other
+ * ranks keep theirs. Secondary ranks must be members of \a grp already.
+ *
+ * \param[in] grp               Group handle
+ * \param[in] ranks             Ranks to set the domains of
+ * \param[in] nodes             Node ID of each rank in \a ranks
+ * \param[in] racks             Rack ID of each rank in \a ranks
+ *
+ * \return                      DER_SUCCESS on success, negative value
+ *                              on failure.
+ */
+int crt_group_domains_set(crt_group_t *grp, d_rank_list_t *ranks,
+			  uint32_t *nodes, uint32_t *racks);
+
 /**
  * Add rank to the specified primary group.
  *
@@ -267,6 +267,17 @@ int swim_progress(struct swim_context *ctx, int64_t timeout);
 int swim_net_glitch_update(struct swim_context *ctx, swim_id_t id,
 			   uint64_t delay);
 
+/**
+ * Notify SWIM that a message from a member was received outside of SWIM. If
+ * the member is ALIVE and the current ping target, it is treated as acked and
+ * the next target is selected.
+ *
+ * @param[in]  ctx	SWIM context pointer from swim_init()
+ * @param[in]  id	IDs of member heard from
+ * @returns		0 on success, negative error ID otherwise
+ */
+int swim_member_heard(struct swim_context *ctx, swim_id_t id);
+
 /**
  * Delete a SWIM member.
  *
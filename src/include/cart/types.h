@@ -242,8 +242,9 @@ struct crt_proto_rpc_format {
 	/** aggregation function for co-rpc */
 	struct crt_corpc_ops	*prf_co_ops;
 	/**
-	 * RPC feature bits to toggle RPC behavior. Two flags are supported
-	 * now: \ref CRT_RPC_FEAT_NO_REPLY and \ref CRT_RPC_FEAT_NO_TIMEOUT
+	 * RPC feature bits to toggle RPC behavior, supported flags are
+	 * \ref CRT_RPC_FEAT_NO_REPLY, \ref CRT_RPC_FEAT_NO_TIMEOUT,
+	 * \ref CRT_RPC_FEAT_QUEUE_FRONT and \ref CRT_RPC_FEAT_POOLED
 	 */
 	uint32_t		 prf_flags;
 };
@@ -330,6 +331,14 @@ typedef enum {
  */
 #define CRT_RPC_FEAT_QUEUE_FRONT	(1U << 3)
 
+/**
+ * Recycle the RPC descriptors, including the input/output buffers, through
+ * per-context caches instead of allocating and freeing them for every request.
+ * The caches are prewarmed when the context is created. Meant for small, hot
+ * RPCs, only a limited number of opcodes can be pooled.
+ */
+#define CRT_RPC_FEAT_POOLED		(1U << 4)
+
 typedef void *crt_bulk_opid_t;
 
 /** Bulk transfer permissions */
@@ -237,6 +237,19 @@ daos_csummer_update(struct daos_csummer *obj, uint8_t *buf, size_t buf_len);
 int
 daos_csummer_finish(struct daos_csummer *obj);
 
+/**
+ * Calculate the checksums of \a nr independent contiguous buffers at once,
+ * the checksum of bufs[i] is written to csums[i], which must be able to hold
+ * daos_csummer_get_csum_len() bytes. Algorithms supporting multi-buffer
+ * kernels process the buffers in parallel, the others fall back to reset,
+ * update & finish for each buffer.
+ *
+ * @return		0 for success, or an error code
+ */
+int
+daos_csummer_calc_bufs(struct daos_csummer *obj, uint8_t **bufs,
+		       uint32_t *buf_lens, uint8_t **csums, uint32_t nr);
+
 bool
 daos_csummer_compare_csum_info(struct daos_csummer *obj,
 			       struct dcs_csum_info *a,
@@ -338,6 +351,26 @@ daos_csummer_verify_iod(struct daos_csummer *obj, daos_iod_t *iod,
 			struct dcs_layout *singv_lo, int singv_idx,
 			daos_iom_t *map);
 
+/**
+ * Verify multiple iods (array or single value, no EC layout) against their
+ * checksums. The checksums of all chunks of all iods are calculated in a
+ * batch, IODs not supported by checksum (see csum_iod_is_supported) are
+ * skipped.
+ *
+ * @param obj		the daos_csummer obj
+ * @param iods		The IODs describing the data
+ * @param sgls		Scatter Gather Lists with the data of \a iods
+ * @param iods_csums	checksums of the iods
+ * @param nr		number of iods, sgls & iods_csums
+ * @param bad_idx	[out] index of the first corrupted iod, optional
+ *
+ * @return		0 for success, -DER_CSUM if corruption is detected
+ */
+int
+daos_csummer_verify_iods(struct daos_csummer *obj, daos_iod_t *iods,
+			 d_sg_list_t *sgls, struct dcs_iod_csums *iods_csums,
+			 uint32_t nr, uint32_t *bad_idx);
+
 /**
  * Verify a key to a checksum
  *
@@ -17,6 +17,28 @@
 #include <daos/cont_props.h>
 #include "checksum.h"
 
+/*
+ * OIDs leased from the engines and handed out locally by
+ * dc_cont_alloc_oids(), see cont_oid_lease_take().
+ */
+struct dc_oid_lease {
+	pthread_mutex_t		ol_lock;
+	/* current range [ol_next, ol_end) */
+	uint64_t		ol_next;
+	uint64_t		ol_end;
+	/*
+	 * range prefetched for when the current one runs out, or what was
+	 * left of the previous current range
+	 */
+	uint64_t		ol_spare;
+	uint64_t		ol_spare_nr;
+	/* size of the next lease, follows the allocation rate */
+	uint64_t		ol_size;
+	/* when the current range was taken, in seconds */
+	uint64_t		ol_stamp;
+	uint32_t		ol_prefetching:1;
+};
+
 /* Client container handle */
 struct dc_cont {
 	/** link chain in the global handle hash table */
@@ -35,6 +57,7 @@ struct dc_cont {
 	daos_handle_t           dc_pool_hdl;
 	struct daos_csummer    *dc_csummer;
 	struct cont_props	dc_props;
+	struct dc_oid_lease	dc_oid_lease;
 	/* minimal pmap version */
 	uint32_t		dc_min_ver;
 	uint32_t		dc_closing:1,
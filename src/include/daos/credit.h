@@ -38,6 +38,10 @@ struct io_credit {
 	daos_event_t		 tc_ev;
 	/** points to \a tc_ev in async mode, otherwise it's NULL */
 	daos_event_t		*tc_evp;
+	/** intended start time (nsec) of the I/O, for latency measurement */
+	uint64_t		 tc_start;
+	/** operation type of the I/O, for latency measurement */
+	int			 tc_op;
 };
 
 #define DTS_CRED_MAX		1024
@@ -48,6 +48,15 @@ struct hash_ft {
 	bool		(*cf_compare)(void *daos_mhash_ctx,
 				      uint8_t *buf1, uint8_t *buf2,
 				      size_t buf_len);
+	/** Optional, calculate the hashes of \a nr independent buffers in one
+	 *  call, hash of bufs[i] is stored to hashes[i]. It's equivalent to
+	 *  calling reset, update & finish for each buffer, but allows the
+	 *  algorithm to use multi-buffer kernels and saves the per-buffer
+	 *  indirect calls.
+	 */
+	int		(*cf_batch)(void *daos_mhash_ctx, uint8_t **bufs,
+				    uint32_t *buf_lens, uint8_t **hashes,
+				    uint32_t nr);
 
 	/** Len in bytes. Ft can either statically set csum_len or provide
 	 *  a get_len function
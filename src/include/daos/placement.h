@@ -30,6 +30,11 @@ typedef enum {
 	PL_TYPE_JUMP_MAP,
 	/** reserved */
 	PL_TYPE_PETALS,
+	/**
+	 * weighted rendezvous (straw2) map, pools do not select it yet, it is
+	 * only created by explicit pl_map_create() or pl_map_update() calls.
+	 */
+	PL_TYPE_STRAW_MAP,
 } pl_map_type_t;
 
 struct pl_map_init_attr {
@@ -42,6 +47,9 @@ struct pl_map_init_attr {
 		struct pl_jump_map_init_attr {
 			pool_comp_type_t	domain;
 		} ia_jump_map;
+		struct pl_straw_map_init_attr {
+			pool_comp_type_t	domain;
+		} ia_straw_map;
 	};
 };
 
@@ -131,6 +139,10 @@ int pl_obj_place(struct pl_map *map, uint32_t gl_layout_ver, struct daos_obj_md
 		 unsigned int mode, uint32_t rebuild_ver, struct daos_obj_shard_md *shard_md,
 		 struct pl_obj_layout **layout_pp);
 
+int pl_obj_place_batch(struct pl_map *map, uint32_t gl_layout_ver, struct daos_obj_md *mds,
+		       unsigned int nr, unsigned int mode, uint32_t rebuild_ver,
+		       struct pl_obj_layout **layouts);
+
 int pl_obj_find_rebuild(struct pl_map *map, uint32_t gl_layout_ver,
 			struct daos_obj_md *md,
 			struct daos_obj_shard_md *shard_md,
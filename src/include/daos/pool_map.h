@@ -244,6 +244,64 @@ int pool_map_get_failed_cnt(struct pool_map *map, uint32_t domain);
 
 #define PO_COMP_ID_ALL		(-1)
 
+/**
+ * One domain layer of the flattened pool map, see \a pool_map_flat.
+ */
+struct pool_flat_layer {
+	/** domain type of this layer */
+	pool_comp_type_t	 fl_type;
+	/** index of the first domain of this layer in the domain array */
+	uint32_t		 fl_start;
+	/** number of domains in this layer */
+	uint32_t		 fl_nr;
+	/** size of \a fl_id2idx */
+	uint32_t		 fl_id_nr;
+	/** domain ID -> index in the domain array, NULL if IDs are sparse */
+	uint32_t		*fl_id2idx;
+};
+
+/**
+ * Flattened, struct-of-arrays index of the component tree of a pool map.
+ *
+ * It is built each time a component tree is installed, so it always matches
+ * the layout of the current map version. Component states are not copied,
+ * they should be read from the tree because they are updated in place.
+ */
+struct pool_map_flat {
+	/** number of domains of all layers, including root */
+	uint32_t		 pf_dom_nr;
+	/** number of targets */
+	uint32_t		 pf_tgt_nr;
+	/** number of domain layers */
+	uint32_t		 pf_layer_nr;
+	/** domain layers, from root to the last level */
+	struct pool_flat_layer	*pf_layers;
+	/**
+	 * per domain, index of its first child domain, or index of its first
+	 * target for the last level domain
+	 */
+	uint32_t		*pf_child_start;
+	/**
+	 * per domain, index of its first target, targets of a domain are
+	 * [pf_tgt_start[i], pf_tgt_start[i] + do_target_nr), so this is also
+	 * the cumulative target weight of all preceding domains in the layer.
+	 */
+	uint32_t		*pf_tgt_start;
+	/** size of \a pf_tgt_id2idx */
+	uint32_t		 pf_tgt_id_nr;
+	/** target ID -> index in the target array, NULL if IDs are sparse */
+	uint32_t		*pf_tgt_id2idx;
+	/** size of \a pf_rank2idx */
+	uint32_t		 pf_rank_nr;
+	/** rank -> index of the rank domain, NULL if ranks are sparse */
+	uint32_t		*pf_rank2idx;
+};
+
+/** invalid index in the lookup tables of \a pool_map_flat */
+#define PO_FLAT_IDX_NONE	((uint32_t)-1)
+
+struct pool_map_flat *pool_map_flat_get(struct pool_map *map);
+
 int pool_map_find_target(struct pool_map *map, uint32_t id,
 			 struct pool_target **target_pp);
 int pool_map_find_domain(struct pool_map *map, pool_comp_type_t type,
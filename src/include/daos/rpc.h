@@ -59,6 +59,8 @@ enum daos_module_id {
 enum daos_rpc_flags {
 	/** flag of reply disabled */
 	DAOS_RPC_NO_REPLY	= CRT_RPC_FEAT_NO_REPLY,
+	/** flag of pooled RPC descriptors */
+	DAOS_RPC_POOLED		= CRT_RPC_FEAT_POOLED,
 };
 
 struct daos_rpc_handler {
@@ -28,6 +28,9 @@
 			((addr)->ba_flags &= ~(BIO_FLAG_DEDUP_BUF))
 #define BIO_ADDR_IS_CORRUPTED(addr) ((addr)->ba_flags & BIO_FLAG_CORRUPTED)
 #define BIO_ADDR_SET_CORRUPTED(addr) ((addr)->ba_flags |= BIO_FLAG_CORRUPTED)
+#define BIO_ADDR_IS_COMPRESSED(addr) ((addr)->ba_flags & BIO_FLAG_COMPRESSED)
+#define BIO_ADDR_CLEAR_COMPRESSED(addr) ((addr)->ba_flags &= ~(BIO_FLAG_COMPRESSED))
+#define BIO_ADDR_IS_DECOMP_BUF(addr) ((addr)->ba_flags & BIO_FLAG_DECOMP_BUF)
 
 /* Can support up to 16 flags for a BIO address */
 enum BIO_FLAG {
@@ -38,6 +41,10 @@ enum BIO_FLAG {
 	/* The address is a buffer for dedup verify */
 	BIO_FLAG_DEDUP_BUF = (1 << 2),
 	BIO_FLAG_CORRUPTED = (1 << 3),
+	/* The extent is compressed, see ba_ctype & ba_csize */
+	BIO_FLAG_COMPRESSED = (1 << 4),
+	/* The buffer holds data decompressed from a compressed extent */
+	BIO_FLAG_DECOMP_BUF = (1 << 5),
 };
 
 typedef struct {
@@ -48,10 +55,12 @@ typedef struct {
 	uint64_t	ba_off;
 	/* DAOS_MEDIA_SCM or DAOS_MEDIA_NVME */
 	uint8_t		ba_type;
-	uint8_t		ba_pad1;
+	/* Compression type (DAOS_COMPRESS_TYPE) for compressed extent */
+	uint8_t		ba_ctype;
 	/* See BIO_FLAG enum */
 	uint16_t	ba_flags;
-	uint32_t	ba_pad2;
+	/* Compressed (on media) length in bytes for compressed extent */
+	uint32_t	ba_csize;
 } bio_addr_t;
 
 struct sys_db;
@@ -161,6 +170,33 @@ bio_iov_set_extra(struct bio_iov *biov,	uint64_t prefix_len,
 	biov->bi_data_len += prefix_len + suffix_len;
 }
 
+static inline void
+bio_addr_set_compressed(bio_addr_t *addr, uint8_t ctype, uint32_t csize)
+{
+	addr->ba_flags |= BIO_FLAG_COMPRESSED;
+	addr->ba_ctype = ctype;
+	addr->ba_csize = csize;
+}
+
+/*
+ * Set biov for reading [@off, @off + @len) of a compressed extent, @addr is
+ * the start address of the extent and @ext_len is its uncompressed length.
+ * The whole extent will be loaded and decompressed by bio_iod_prep().
+ */
+static inline void
+bio_iov_set_compressed(struct bio_iov *biov, bio_addr_t addr, uint64_t off,
+		       uint64_t len, uint64_t ext_len)
+{
+	D_ASSERT(BIO_ADDR_IS_COMPRESSED(&addr));
+	D_ASSERT(off + len <= ext_len);
+
+	biov->bi_addr = addr;
+	biov->bi_buf = NULL;
+	biov->bi_data_len = ext_len;
+	biov->bi_prefix_len = off;
+	biov->bi_suffix_len = ext_len - off - len;
+}
+
 static inline uint64_t
 bio_iov2off(const struct bio_iov *biov)
 {
@@ -197,6 +233,9 @@ bio_iov2raw_off(const struct bio_iov *biov)
 static inline uint64_t
 bio_iov2raw_len(const struct bio_iov *biov)
 {
+	/* Compressed extent is loaded as a whole from media */
+	if (BIO_ADDR_IS_COMPRESSED(&biov->bi_addr))
+		return biov->bi_addr.ba_csize;
 	return biov->bi_data_len;
 }
 
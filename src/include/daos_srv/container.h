@@ -42,6 +42,30 @@ int ds_cont_tgt_close(uuid_t hdl_uuid);
 int ds_cont_tgt_open(uuid_t pool_uuid, uuid_t cont_hdl_uuid,
 		     uuid_t cont_uuid, uint64_t flags, uint64_t sec_capas,
 		     uint32_t status_pm_ver);
+
+/* Number of slots of the recently updated dkeys sketch */
+#define CONT_AGG_SKETCH_NR	256
+
+/*
+ * Estimated VOS aggregation yield of a container on one target, maintained
+ * cheaply at update time and consumed by the per-target aggregation scheduler.
+ */
+struct cont_agg_stat {
+	/* Bytes written since the last VOS aggregation */
+	uint64_t		 cas_written;
+	/* Bytes of above rewriting recently updated dkeys */
+	uint64_t		 cas_overwritten;
+	/* Start time (msec) of the last VOS aggregation round */
+	uint64_t		 cas_last_round;
+	/* Hashes of recently updated (object, dkey) */
+	uint64_t		 cas_sketch[CONT_AGG_SKETCH_NR];
+	/* Yield telemetry, only created if DAOS_CONT_AGG_METRICS is set */
+	struct d_tm_node_t	*cas_tm_pending;
+	struct d_tm_node_t	*cas_tm_overwrite;
+	struct d_tm_node_t	*cas_tm_yield;
+	struct d_tm_node_t	*cas_tm_rounds;
+};
+
 /*
  * Per-thread container (memory) object
  *
@@ -78,6 +102,9 @@ struct ds_cont_child {
 
 	/* Tracks the schedule request for EC aggregation ULT */
 	struct sched_request	*sc_ec_agg_req;
+	/* Link to the waiting list of the per-target aggregation scheduler */
+	d_list_t		 sc_agg_link;
+	struct cont_agg_stat	 sc_agg_stat;
 	/*
 	 * Snapshot delete HLC (0 means no change), which is used
 	 * to compare with the aggregation HLC, so it knows whether the
@@ -135,6 +162,8 @@ struct agg_param {
 	void			*ap_data;
 	struct ds_cont_child	*ap_cont;
 	daos_epoch_t		ap_full_scan_hlc;
+	/* Epoch ranges aggregated by the last round */
+	uint32_t		ap_ranges;
 	bool			ap_vos_agg;
 };
 
@@ -156,6 +185,34 @@ cont_aggregate_interval(struct ds_cont_child *cont, cont_aggregate_cb_t cb,
  */
 int agg_rate_ctl(void *arg);
 
+/*
+ * Account an update to the aggregation yield estimate of a container. Data
+ * rewriting a recently updated dkey is assumed to be reclaimable by the next
+ * VOS aggregation.
+ *
+ * \param[in] cont	Container child
+ * \param[in] oid	Updated object
+ * \param[in] dkey_hash	Hash of the updated dkey
+ * \param[in] size	Bytes written
+ */
+static inline void
+ds_cont_agg_account(struct ds_cont_child *cont, daos_obj_id_t oid,
+		    uint64_t dkey_hash, uint64_t size)
+{
+	struct cont_agg_stat	*cas = &cont->sc_agg_stat;
+	uint64_t		 key;
+	uint64_t		*slot;
+
+	key = (oid.lo ^ (oid.hi << 32) ^ dkey_hash) * 0x9E3779B97F4A7C15ULL;
+	/* the top 8 bits select one of the CONT_AGG_SKETCH_NR slots */
+	slot = &cas->cas_sketch[key >> 56];
+	if (*slot == key)
+		cas->cas_overwritten += size;
+	else
+		*slot = key;
+	cas->cas_written += size;
+}
+
 /*
  * Per-thread container handle (memory) object
  *
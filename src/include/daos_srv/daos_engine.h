@@ -352,6 +352,13 @@ uint64_t sched_cur_msec(void);
  */
 uint64_t sched_cur_seq(void);
 
+/**
+ * Get the smoothed schedule cycle duration of current xstream in micro-seconds,
+ * which approximates how long a runnable ULT (e.g. foreground I/O handler) waits
+ * to be scheduled. Background services can use it to throttle themselves.
+ */
+uint64_t sched_cycle_latency(void);
+
 /**
  * Get current ULT/Task execution time. The execution time is the elapsed
  * time since current ULT/Task was scheduled last time.
@@ -582,6 +582,17 @@ int evt_destroy(daos_handle_t toh);
  */
 int evt_drain(daos_handle_t toh, int *credits, bool *destroyed);
 
+/**
+ * Same as evt_drain(), but a leaf node which doesn't reference any NVMe
+ * extent consumes a single credit for all its rectangles. Leaf nodes with
+ * NVMe extents are still charged per rectangle.
+ *
+ * \param toh		[IN]	 Tree open handle.
+ * \param credits	[IN/OUT] Input and returned drain credits
+ * \param destroyed	[OUT]	 Tree is empty and destroyed
+ */
+int evt_drain_bulk(daos_handle_t toh, int *credits, bool *destroyed);
+
 /**
  * Insert a new extended version \a rect and its data memory ID \a addr to
  * a opened tree.
@@ -170,6 +170,7 @@ struct ds_pool_child *ds_pool_child_lookup(const uuid_t uuid);
 struct ds_pool_child *ds_pool_child_get(struct ds_pool_child *child);
 void ds_pool_child_put(struct ds_pool_child *child);
 
+int ds_pool_bcast_topo(void);
 int ds_pool_bcast_create(crt_context_t ctx, struct ds_pool *pool,
 			 enum daos_module_id module, crt_opcode_t opcode,
 			 uint32_t version, crt_rpc_t **rpc, crt_bulk_t bulk_hdl,
@@ -287,6 +288,7 @@ void ds_pool_disable_exclude(void);
 void ds_pool_enable_exclude(void);
 
 extern bool ec_agg_disabled;
+extern bool pool_bcast_domain;
 
 int dsc_pool_open(uuid_t pool_uuid, uuid_t pool_hdl_uuid,
 		       unsigned int flags, const char *grp,
@@ -254,6 +254,19 @@ int vea_tx_publish(struct vea_space_info *vsi, struct vea_hint_context *hint,
  */
 int vea_free(struct vea_space_info *vsi, uint64_t blk_off, uint32_t blk_cnt);
 
+/**
+ * Free a batch of allocated extents in one transaction.
+ *
+ * \param vsi     [IN]		In-memory compound index
+ * \param vfes    [IN]		Extents to be freed, vfe_age is ignored
+ * \param nr      [IN]		Number of extents in \a vfes
+ *
+ * \return			Zero on success; Appropriated negative value
+ *				on error
+ */
+int vea_free_batch(struct vea_space_info *vsi, struct vea_free_extent *vfes,
+		   uint32_t nr);
+
 /**
  * Set an arbitrary age to a free extent with specified start offset.
  *
@@ -246,6 +246,27 @@ vos_self_init(const char *db_path, bool use_sys_db, int tgt_id);
 void
 vos_self_fini(void);
 
+/**
+ * Give the calling xstream its own VOS TLS and NVMe context, so several
+ * xstreams can drive standalone VOS concurrently, each one with its own pools.
+ * Must be called after vos_self_init(), and on the xstream.
+ *
+ * NB: Required only when using VOS as a standalone library.
+ *
+ * \param tgt_id [IN]	target ID of the xstream, used for NVMe device mapping
+ *
+ * \return		Zero on success, negative value if error
+ */
+int
+vos_self_xs_init(int tgt_id);
+
+/**
+ * Release the private context of the calling xstream, all the pools opened
+ * on the xstream must be closed beforehand.
+ */
+void
+vos_self_xs_fini(void);
+
 /**
  * Versioning Object Storage Pool (VOSP)
  * A VOSP creates and manages a versioned object store on a local
@@ -306,7 +327,8 @@ int
 vos_pool_open(const char *path, uuid_t uuid, unsigned int flags,
 	      daos_handle_t *poh);
 
-/** Upgrade the vos pool version
+/** Upgrade the vos pool version, pools already at or beyond \a version are
+ * left as is.
  *
  * \param poh		[IN]	Container open handle
  * \param version	[IN]	pool version
@@ -432,6 +454,18 @@ vos_cont_close(daos_handle_t coh);
 int
 vos_cont_query(daos_handle_t coh, vos_cont_info_t *cinfo);
 
+/**
+ * Set compression type for the array values rewritten by aggregation.
+ *
+ * \param coh		[IN]	Container open handle.
+ * \param type		[IN]	DAOS_COMPRESS_TYPE, COMPRESS_TYPE_UNKNOWN
+ *				disables compression.
+ *
+ * \return		Zero on success, negative value if error
+ */
+int
+vos_cont_set_compress(daos_handle_t coh, uint32_t type);
+
 enum {
 	VOS_AGG_FL_FORCE_SCAN	= (1UL << 0),	/* Scan all obj/dkey/akeys */
 	VOS_AGG_FL_FORCE_MERGE	= (1UL << 1),	/* Merge all coalesce-able EV records */
@@ -1258,6 +1292,8 @@ typedef void(*sc_put_cont_fn_t)(void *cont);
 typedef bool(*sc_cont_is_stopping_fn_t)(void *cont);
 
 typedef bool (*sc_is_idle_fn_t)();
+/* Returns the current I/O latency (in micro-seconds) seen by the engine scheduler */
+typedef uint64_t (*sc_io_lat_fn_t)(void);
 typedef int (*sc_sleep_fn_t)(void *, uint32_t msec);
 typedef int (*sc_yield_fn_t)(void *);
 typedef int (*ds_pool_tgt_drain)(struct ds_pool *pool);
@@ -1325,7 +1361,6 @@ struct scrub_ctx {
 	 */
 	daos_unit_oid_t		 sc_cur_oid;
 	daos_key_t		 sc_dkey;
-	struct dcs_csum_info	*sc_csum_to_verify;
 	daos_epoch_t		 sc_epoch;
 	uint16_t		 sc_minor_epoch;
 	daos_iod_t		 sc_iod;
@@ -1336,10 +1371,14 @@ struct scrub_ctx {
 
 	/* Schedule controlling function pointers and arg */
 	sc_is_idle_fn_t		 sc_is_idle_fn;
+	sc_io_lat_fn_t		 sc_io_lat_fn;
 	sc_sleep_fn_t		 sc_sleep_fn;
 	sc_yield_fn_t		 sc_yield_fn;
 	void			*sc_sched_arg;
 
+	/* Batch of values to be read & verified together, valid while a pass is running */
+	struct scrub_batch	*sc_batch;
+
 	enum scrub_status        sc_status;
 	uint8_t                  sc_cont_loaded : 1, /* Have all the containers been loaded */
 	    sc_first_pass_done                  : 1; /* Is this the first pass of the scrubber */
@@ -1354,6 +1393,34 @@ struct scrub_ctx {
  */
 int vos_scrub_pool(struct scrub_ctx *ctx);
 
+/*
+ * The scrubbing position of a pool is persisted every few seconds, so that an
+ * interrupted pass resumes after an engine restart instead of starting over.
+ * Containers and objects are scrubbed in the order of their VOS indexes. A
+ * pass resuming from (cont, oid) skips the containers ordered before cont and
+ * the objects of cont up to and including oid, whether they still exist or
+ * not, then scrubs everything else. Objects created before the position in the
+ * meantime are left to the next pass. A completed pass clears the position.
+ *
+ * \param[in]	poh	Pool handle
+ * \param[in]	cont	Container of \a oid
+ * \param[in]	oid	Last object fully scrubbed, NULL to clear the position
+ *
+ * \return		0 on success, negative value if error
+ */
+int vos_scrub_cursor_set(daos_handle_t poh, uuid_t cont, daos_unit_oid_t *oid);
+
+/*
+ * Get the scrubbing position of a pool, see vos_scrub_cursor_set().
+ *
+ * \param[in]	poh	Pool handle
+ * \param[out]	cont	Container of \a oid
+ * \param[out]	oid	Last object fully scrubbed
+ *
+ * \return		0 on success, -DER_NONEXIST if the next pass starts over
+ */
+int vos_scrub_cursor_get(daos_handle_t poh, uuid_t cont, daos_unit_oid_t *oid);
+
 /*
  * A generic utility function that, given a start time, duration, number of
  * periods that can be processed, and the current period index, calculate how
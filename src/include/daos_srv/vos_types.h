@@ -19,6 +19,7 @@
 
 #define VOS_POOL_DF_2_2 24
 #define VOS_POOL_DF_2_4 25
+#define VOS_POOL_DF_2_6 26
 
 struct dtx_rsrvd_uint {
 	void			*dru_scm;
@@ -281,6 +282,10 @@ enum {
 	VOS_POOL_FEAT_CHK = (1ULL << 1),
 	/** Dynamic evtree root supported for this pool */
 	VOS_POOL_FEAT_DYN_ROOT = (1ULL << 2),
+	/** Array values can be compressed by aggregation in this pool */
+	VOS_POOL_FEAT_COMPRESS = (1ULL << 3),
+	/** Records can share refcounted extents through the dedup index */
+	VOS_POOL_FEAT_DEDUP_REFS = (1ULL << 4),
 };
 
 /** Mask for any conditionals passed to to the fetch */
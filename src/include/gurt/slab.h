@@ -9,8 +9,11 @@
 
 #include <pthread.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <gurt/list.h>
 
+struct d_tm_node_t;
+
 /* A data structure used to describe and register a type */
 struct d_slab_reg {
 	/* Perform any one-time setup or assigning constants.
@@ -32,13 +35,29 @@ struct d_slab_reg {
 	int   sr_max_desc;
 	/* Maximum number of descriptors to exist on the free_list */
 	int   sr_max_free_desc;
+	/* Number of descriptors each thread may cache, 0 to disable the
+	 * per-thread caches.  Only for types whose descriptors are released by
+	 * the thread which acquired them, see D_SLAB_MAG_SIZE.
+	 */
+	int   sr_mag_size;
 };
 
 /* If max_desc is non-zero then at most max_desc descriptors can exist
  * simultaneously.  In this case restock() will not allocate new descriptors
  * so all descriptors after startup will be created on the critical path,
  * however once max_desc is reached no more descriptors will be created.
+ * Per-thread caches are never used for such types as descriptors held by one
+ * thread cannot be used by another.
+ */
+
+/* Suggested number of descriptors cached per thread.
+ *
+ * Per-thread caches are opt-in: a type acquired on some threads and released
+ * on others would fill the releasing threads' caches while the acquiring
+ * threads always miss, and large descriptors would be hoarded by threads
+ * which no longer need them.
  */
+#define D_SLAB_MAG_SIZE 32
 
 #define POOL_TYPE_INIT(itype, imember)                                                             \
 	.sr_size = sizeof(struct itype), .sr_offset = offsetof(struct itype, imember),             \
@@ -71,6 +90,19 @@ struct d_slab_type {
 	/* Number of sequental calls to acquire() without a call to restock() */
 	int               st_no_restock;     /* Current count */
 	int               st_no_restock_hwm; /* High water mark */
+
+	/* Per-thread caches (magazines), exchanged in batches with the lists above */
+	pthread_key_t     st_mag_key;
+	int               st_mag_size; /* 0 if disabled, the default */
+	d_list_t          st_mag_list; /* All magazines of this type */
+
+	/* Magazine statistics, folded in from the magazines under st_lock */
+	uint64_t          st_mag_hit;        /* acquire() served by the magazine */
+	uint64_t          st_mag_miss;       /* acquire() which went to st_free_list */
+	uint64_t          st_lock_contended; /* st_lock was busy on the slow path */
+	struct d_tm_node_t *st_tm_hit;
+	struct d_tm_node_t *st_tm_miss;
+	struct d_tm_node_t *st_tm_contended;
 };
 
 struct d_slab {
@@ -95,11 +127,18 @@ d_slab_destroy(struct d_slab *slab);
 int
 d_slab_register(struct d_slab *slab, struct d_slab_reg *reg, struct d_slab_type **type);
 
-/* Allocate a data structure in performant way */
+/* Allocate a data structure in performant way
+ *
+ * Served without locking from the calling thread's magazine when possible.
+ */
 void *
 d_slab_acquire(struct d_slab_type *type);
 
-/* Release a data structure in a performant way */
+/* Release a data structure in a performant way
+ *
+ * The descriptor is kept in the calling thread's magazine and handed back to
+ * the shared lists in batches.
+ */
 void
 d_slab_release(struct d_slab_type *type, void *desc);
 
@@ -112,6 +151,10 @@ void
 d_slab_restock(struct d_slab_type *type);
 
 /* Reclaim any memory possible across all types
+ *
+ * Descriptors cached in the calling thread's magazines are reclaimed.  Other
+ * threads hand theirs back on their next acquire, release or restock call, or
+ * at thread exit, so they are reclaimed by a later call.
  *
  * Returns true of there are any descriptors in use.
  */
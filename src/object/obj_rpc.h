@@ -47,10 +47,10 @@
 
 #define OBJ_PROTO_CLI_RPC_LIST(ver)					\
 	X(DAOS_OBJ_RPC_UPDATE,						\
-		0, &CQF_obj_rw,						\
+		DAOS_RPC_POOLED, &CQF_obj_rw,				\
 		ds_obj_rw_handler, NULL, "update")			\
 	X(DAOS_OBJ_RPC_FETCH,						\
-		0, &CQF_obj_rw,						\
+		DAOS_RPC_POOLED, &CQF_obj_rw,				\
 		ds_obj_rw_handler, NULL, "fetch")			\
 	X(DAOS_OBJ_DKEY_RPC_ENUMERATE,					\
 		0, &CQF_obj_key_enum,					\
@@ -81,7 +81,7 @@
 		0, &CQF_obj_sync,					\
 		ds_obj_sync_handler, NULL, "obj_sync")			\
 	X(DAOS_OBJ_RPC_TGT_UPDATE,					\
-		0, &CQF_obj_rw,						\
+		DAOS_RPC_POOLED, &CQF_obj_rw,				\
 		ds_obj_tgt_update_handler, NULL, "tgt_update")		\
 	X(DAOS_OBJ_RPC_TGT_PUNCH,					\
 		0, &CQF_obj_punch,					\
@@ -25,6 +25,12 @@
 
 extern struct dss_module_key obj_module_key;
 
+/*
+ * Checksum calculation (verify on update, csum recalculation on fetch) of the
+ * payload not smaller than this size is run on helper XS. 0 means disabled.
+ */
+extern unsigned int obj_csum_offload_thresh;
+
 /* Per pool attached to the migrate tls(per xstream) */
 struct migrate_pool_tls {
 	/* POOL UUID and pool to be migrated */
@@ -91,6 +97,12 @@ struct migrate_pool_tls {
 	int			mpt_inflight_max_ult;
 	uint32_t		mpt_opc;
 
+	/* Foreground latency target (us) the inflight size is adapted to, and
+	 * when the inflight size was adapted last time (ms).
+	 */
+	uint32_t		mpt_lat_target;
+	uint64_t		mpt_lat_adjust_ts;
+
 	ABT_cond		mpt_init_cond;
 	ABT_mutex		mpt_init_mutex;
 
@@ -15,6 +15,8 @@
 #include "obj_rpc.h"
 #include "srv_internal.h"
 
+unsigned int obj_csum_offload_thresh;
+
 /**
  * Switch of enable DTX or not, enabled by default.
  */
@@ -23,6 +25,11 @@ obj_mod_init(void)
 {
 	int	rc;
 
+	d_getenv_int("DAOS_CSUM_OFFLOAD_THRESH", &obj_csum_offload_thresh);
+	if (obj_csum_offload_thresh != 0)
+		D_INFO("Offload checksum of payload >= %u bytes to helper XS\n",
+		       obj_csum_offload_thresh);
+
 	rc = obj_utils_init();
 	if (rc)
 		goto out;
@@ -848,11 +848,66 @@ get_iod_csum(struct dcs_iod_csums *iod_csums, int i)
 	return &iod_csums[i];
 }
 
+/** Total data size of the biod, used for deciding checksum offload */
+static daos_size_t
+obj_biod_data_size(struct bio_desc *biod, uint32_t iods_nr)
+{
+	struct bio_sglist	*bsgl;
+	daos_size_t		 size = 0;
+	uint32_t		 i, j;
+
+	for (i = 0; i < iods_nr; i++) {
+		bsgl = bio_iod_sgl(biod, i);
+		for (j = 0; j < bsgl->bs_nr_out; j++)
+			size += bio_iov2req_len(&bsgl->bs_iovs[j]);
+	}
+
+	return size;
+}
+
+/**
+ * Whether to run the checksum calculation of \a size bytes on helper XS, so the
+ * target XS can keep serving network & NVMe while the payload is hashed.
+ */
+static inline bool
+obj_csum_offload_needed(daos_size_t size)
+{
+	return obj_csum_offload_thresh != 0 && size >= obj_csum_offload_thresh &&
+	       dss_has_enough_helper();
+}
+
+/**
+ * Execute \a func on helper XS and wait (yield) for the result. The checksum
+ * context isn't thread safe and it's shared by all ULTs of the target XS, so
+ * the offloaded ULT uses its own copy of \a csummer.
+ */
 static int
-csum_add2iods(daos_handle_t ioh, daos_iod_t *iods, uint32_t iods_nr,
-	      struct daos_csummer *csummer,
-	      struct dcs_iod_csums *iod_csums, daos_unit_oid_t oid,
-	      daos_key_t *dkey)
+obj_csum_offload(int (*func)(void *), void *arg, struct daos_csummer **csummer)
+{
+	struct daos_csummer	*orig = *csummer;
+	struct daos_csummer	*copy;
+	int			 rc;
+
+	copy = daos_csummer_copy(orig);
+	if (copy == NULL)
+		return func(arg);
+
+	copy->dcs_skip_key_calc = orig->dcs_skip_key_calc;
+	copy->dcs_skip_key_verify = orig->dcs_skip_key_verify;
+	copy->dcs_skip_data_verify = orig->dcs_skip_data_verify;
+
+	*csummer = copy;
+	rc = dss_offload_exec(func, arg);
+	*csummer = orig;
+
+	daos_csummer_destroy(&copy);
+	return rc;
+}
+
+static int
+csum_add2iods_internal(daos_handle_t ioh, daos_iod_t *iods, uint32_t iods_nr,
+		       struct daos_csummer *csummer,
+		       struct dcs_iod_csums *iod_csums)
 {
 	int	 rc = 0;
 	uint32_t biov_csums_idx = 0;
@@ -882,6 +937,44 @@ csum_add2iods(daos_handle_t ioh, daos_iod_t *iods, uint32_t iods_nr,
 	return rc;
 }
 
+struct csum_add2iods_args {
+	daos_handle_t		 caa_ioh;
+	daos_iod_t		*caa_iods;
+	struct daos_csummer	*caa_csummer;
+	struct dcs_iod_csums	*caa_iod_csums;
+	uint32_t		 caa_iods_nr;
+};
+
+static int
+csum_add2iods_ult(void *data)
+{
+	struct csum_add2iods_args *args = data;
+
+	return csum_add2iods_internal(args->caa_ioh, args->caa_iods,
+				      args->caa_iods_nr, args->caa_csummer,
+				      args->caa_iod_csums);
+}
+
+static int
+csum_add2iods(daos_handle_t ioh, daos_iod_t *iods, uint32_t iods_nr,
+	      struct daos_csummer *csummer,
+	      struct dcs_iod_csums *iod_csums, daos_unit_oid_t oid,
+	      daos_key_t *dkey)
+{
+	struct csum_add2iods_args	args;
+
+	if (!obj_csum_offload_needed(obj_biod_data_size(vos_ioh2desc(ioh), iods_nr)))
+		return csum_add2iods_internal(ioh, iods, iods_nr, csummer, iod_csums);
+
+	args.caa_ioh = ioh;
+	args.caa_iods = iods;
+	args.caa_csummer = csummer;
+	args.caa_iod_csums = iod_csums;
+	args.caa_iods_nr = iods_nr;
+
+	return obj_csum_offload(csum_add2iods_ult, &args, &args.caa_csummer);
+}
+
 static int
 csum_verify_keys(struct daos_csummer *csummer, daos_key_t *dkey,
 		 struct dcs_csum_info *dkey_csum,
@@ -2087,11 +2180,15 @@ obj_update_sensors(struct obj_io_context *ioc, int err)
 		orw = crt_req_get(ioc->ioc_rpc);
 		if (orw->orw_iod_array.oia_iods != NULL)
 			obj_ec_metrics_process(&orw->orw_iod_array, ioc);
-
+		ds_cont_agg_account(ioc->ioc_coc, orw->orw_oid.id_pub, orw->orw_dkey_hash,
+				    ioc->ioc_io_size);
 		break;
 	case DAOS_OBJ_RPC_TGT_UPDATE:
 		d_tm_inc_counter(opm->opm_update_bytes, ioc->ioc_io_size);
 		lat = tls->ot_tgt_update_lat[lat_bucket(ioc->ioc_io_size)];
+		orw = crt_req_get(ioc->ioc_rpc);
+		ds_cont_agg_account(ioc->ioc_coc, orw->orw_oid.id_pub, orw->orw_dkey_hash,
+				    ioc->ioc_io_size);
 		break;
 	case DAOS_OBJ_RPC_FETCH:
 		d_tm_inc_counter(opm->opm_fetch_bytes, ioc->ioc_io_size);
@@ -3843,12 +3940,13 @@ out:
 }
 
 static int
-obj_verify_bio_csum(daos_obj_id_t oid, daos_iod_t *iods,
-		    struct dcs_iod_csums *iod_csums, struct bio_desc *biod,
-		    struct daos_csummer *csummer, uint32_t iods_nr)
+obj_verify_bio_csum_internal(daos_obj_id_t oid, daos_iod_t *iods,
+			     struct dcs_iod_csums *iod_csums, struct bio_desc *biod,
+			     struct daos_csummer *csummer, uint32_t iods_nr)
 {
-	unsigned int	i;
-	int		rc = 0;
+	d_sg_list_t	*sgls;
+	unsigned int	 i, bad_idx = 0;
+	int		 rc = 0;
 
 	if (!daos_csummer_initialized(csummer) ||
 	    csummer->dcs_skip_data_verify ||
@@ -3856,9 +3954,7 @@ obj_verify_bio_csum(daos_obj_id_t oid, daos_iod_t *iods,
 		return 0;
 
 	for (i = 0; i < iods_nr; i++) {
-		daos_iod_t		*iod = &iods[i];
-		struct bio_sglist	*bsgl = bio_iod_sgl(biod, i);
-		d_sg_list_t		 sgl;
+		daos_iod_t *iod = &iods[i];
 
 		if (!csum_iod_is_supported(iod))
 			continue;
@@ -3870,33 +3966,88 @@ obj_verify_bio_csum(daos_obj_id_t oid, daos_iod_t *iods,
 				i, iods_nr, iod_csums[i].ic_nr, DP_C_IOD(iod));
 			return -DER_CSUM;
 		}
+	}
 
-		rc = bio_sgl_convert(bsgl, &sgl);
-
-		if (rc == 0)
-			rc = daos_csummer_verify_iod(csummer, iod, &sgl,
-						     &iod_csums[i], NULL, 0,
-						     NULL);
+	D_ALLOC_ARRAY(sgls, iods_nr);
+	if (sgls == NULL)
+		return -DER_NOMEM;
 
-		d_sgl_fini(&sgl, false);
+	for (i = 0; i < iods_nr; i++) {
+		rc = bio_sgl_convert(bio_iod_sgl(biod, i), &sgls[i]);
+		if (rc != 0)
+			goto out;
+	}
 
-		if (rc != 0) {
-			if (iod->iod_type == DAOS_IOD_SINGLE) {
-				D_ERROR("Data Verification failed (object: "
-					DF_OID"): %d\n",
-					DP_OID(oid), rc);
-			} else if (iod->iod_type == DAOS_IOD_ARRAY) {
-				D_ERROR("Data Verification failed (object: "
-					DF_OID", extent: "DF_RECX"): %d\n",
-					DP_OID(oid), DP_RECX(iod->iod_recxs[i]), rc);
-			}
-			break;
+	/* Checksums of the chunks of all iods are calculated in batch */
+	rc = daos_csummer_verify_iods(csummer, iods, sgls, iod_csums, iods_nr,
+				      &bad_idx);
+	if (rc != 0) {
+		daos_iod_t *iod = &iods[bad_idx];
+
+		if (iod->iod_type == DAOS_IOD_SINGLE) {
+			D_ERROR("Data Verification failed (object: "
+				DF_OID"): %d\n",
+				DP_OID(oid), rc);
+		} else if (iod->iod_type == DAOS_IOD_ARRAY) {
+			D_ERROR("Data Verification failed (object: "
+				DF_OID", iod: "DF_C_IOD"): %d\n",
+				DP_OID(oid), DP_C_IOD(iod), rc);
 		}
 	}
 
+out:
+	for (i = 0; i < iods_nr; i++)
+		d_sgl_fini(&sgls[i], false);
+	D_FREE(sgls);
+
 	return rc;
 }
 
+struct obj_verify_args {
+	daos_obj_id_t		 ova_oid;
+	daos_iod_t		*ova_iods;
+	struct dcs_iod_csums	*ova_iod_csums;
+	struct bio_desc		*ova_biod;
+	struct daos_csummer	*ova_csummer;
+	uint32_t		 ova_iods_nr;
+};
+
+static int
+obj_verify_bio_csum_ult(void *data)
+{
+	struct obj_verify_args *args = data;
+
+	return obj_verify_bio_csum_internal(args->ova_oid, args->ova_iods,
+					    args->ova_iod_csums, args->ova_biod,
+					    args->ova_csummer, args->ova_iods_nr);
+}
+
+static int
+obj_verify_bio_csum(daos_obj_id_t oid, daos_iod_t *iods,
+		    struct dcs_iod_csums *iod_csums, struct bio_desc *biod,
+		    struct daos_csummer *csummer, uint32_t iods_nr)
+{
+	struct obj_verify_args	args;
+
+	if (!daos_csummer_initialized(csummer) ||
+	    csummer->dcs_skip_data_verify ||
+	    !csummer->dcs_srv_verify)
+		return 0;
+
+	if (!obj_csum_offload_needed(obj_biod_data_size(biod, iods_nr)))
+		return obj_verify_bio_csum_internal(oid, iods, iod_csums, biod,
+						    csummer, iods_nr);
+
+	args.ova_oid = oid;
+	args.ova_iods = iods;
+	args.ova_iod_csums = iod_csums;
+	args.ova_biod = biod;
+	args.ova_csummer = csummer;
+	args.ova_iods_nr = iods_nr;
+
+	return obj_csum_offload(obj_verify_bio_csum_ult, &args, &args.ova_csummer);
+}
+
 static inline void
 ds_obj_cpd_set_sub_result(struct obj_cpd_out *oco, int idx,
 			  int result, daos_epoch_t epoch)
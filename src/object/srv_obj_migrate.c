@@ -37,6 +37,14 @@
 #define MIGRATE_MAX_SIZE	(1 << 28)
 /* Max migrate ULT number on the server */
 #define MIGRATE_MAX_ULT		8192
+/* Min inflight data size per xstream, and the step to grow it */
+#define MIGRATE_MIN_SIZE	(1 << 20)
+/* Default foreground latency target in micro-seconds, see migrate_inflight_adjust() */
+#define MIGRATE_LAT_TARGET	20000
+/* Interval of inflight size adjustment in milli-seconds */
+#define MIGRATE_LAT_INTVL	100
+/* Max objects dispatched to one xstream as a batch */
+#define MIGRATE_OBJ_BATCH	16
 
 struct migrate_one {
 	daos_key_t		 mo_dkey;
@@ -95,9 +103,13 @@ struct migrate_obj_key {
 	uint32_t	tgt_idx;
 };
 
+struct migrate_obj_batch;
+
 /* Argument for container iteration and migrate */
 struct iter_cont_arg {
 	struct migrate_pool_tls *pool_tls;
+	/* Objects pending to be dispatched, per target xstream */
+	struct migrate_obj_batch **batches;
 	uuid_t			pool_uuid;
 	uuid_t			pool_hdl_uuid;
 	uuid_t			cont_uuid;
@@ -125,6 +137,15 @@ struct iter_obj_arg {
 	uint32_t		generation;
 };
 
+/* Objects of one container migrated by a single ULT on one xstream */
+struct migrate_obj_batch {
+	struct iter_obj_arg	*mob_args[MIGRATE_OBJ_BATCH];
+	int			 mob_nr;
+	/* Enumeration buffer reused by all objects of the batch */
+	char			*mob_buf;
+	daos_size_t		 mob_buf_len;
+};
+
 static int
 obj_tree_destory_cb(daos_handle_t ih, d_iov_t *key_iov,
 		    d_iov_t *val_iov, void *data)
@@ -458,6 +479,8 @@ migrate_pool_tls_create_one(void *data)
 	pool_tls->mpt_inflight_max_size = MIGRATE_MAX_SIZE;
 	pool_tls->mpt_inflight_max_ult = MIGRATE_MAX_ULT;
 	pool_tls->mpt_inflight_size = 0;
+	pool_tls->mpt_lat_target = MIGRATE_LAT_TARGET;
+	d_getenv_int("DAOS_MIGRATE_LATENCY_TARGET", &pool_tls->mpt_lat_target);
 	pool_tls->mpt_refcount = 1;
 	if (arg->svc_list) {
 		rc = daos_rank_list_copy(&pool_tls->mpt_svc_list, arg->svc_list);
@@ -1650,6 +1673,46 @@ migrate_one_destroy(struct migrate_one *mrone)
 	D_FREE(mrone);
 }
 
+/**
+ * Adapt the inflight data size of current xstream to the latency seen by
+ * foreground I/O: halve it when the scheduler reports the latency exceeding
+ * the target, otherwise grow it linearly back to MIGRATE_MAX_SIZE.
+ */
+static void
+migrate_inflight_adjust(struct migrate_pool_tls *tls)
+{
+	uint64_t	now;
+	uint64_t	lat;
+	uint64_t	max_size = tls->mpt_inflight_max_size;
+
+	if (tls->mpt_lat_target == 0 || max_size == 0)
+		return;
+
+	now = sched_cur_msec();
+	if (now - tls->mpt_lat_adjust_ts < MIGRATE_LAT_INTVL)
+		return;
+	tls->mpt_lat_adjust_ts = now;
+
+	lat = sched_cycle_latency();
+	if (lat > tls->mpt_lat_target)
+		max_size = max(max_size / 2, MIGRATE_MIN_SIZE);
+	else
+		max_size = min(max_size + MIGRATE_MIN_SIZE, MIGRATE_MAX_SIZE);
+
+	if (max_size == tls->mpt_inflight_max_size)
+		return;
+
+	D_DEBUG(DB_REBUILD, DF_UUID" latency "DF_U64"/%u us, inflight max "DF_U64" -> "DF_U64"\n",
+		DP_UUID(tls->mpt_pool_uuid), lat, tls->mpt_lat_target,
+		tls->mpt_inflight_max_size, max_size);
+	if (max_size > tls->mpt_inflight_max_size) {
+		ABT_mutex_lock(tls->mpt_inflight_mutex);
+		ABT_cond_broadcast(tls->mpt_inflight_cond);
+		ABT_mutex_unlock(tls->mpt_inflight_mutex);
+	}
+	tls->mpt_inflight_max_size = max_size;
+}
+
 static void
 migrate_one_ult(void *arg)
 {
@@ -1680,7 +1743,9 @@ migrate_one_ult(void *arg)
 	D_DEBUG(DB_REBUILD, "mrone %p inflight size "DF_U64" max "DF_U64"\n",
 		mrone, tls->mpt_inflight_size, tls->mpt_inflight_max_size);
 
-	while (tls->mpt_inflight_size + data_size >=
+	/* Always let one dkey through, even if it is larger than the limit */
+	migrate_inflight_adjust(tls);
+	while (tls->mpt_inflight_size != 0 && tls->mpt_inflight_size + data_size >=
 	       tls->mpt_inflight_max_size && tls->mpt_inflight_max_size != 0
 	       && !tls->mpt_fini) {
 		D_DEBUG(DB_REBUILD, "mrone %p wait "DF_U64"/"DF_U64"\n", mrone,
@@ -1688,6 +1753,7 @@ migrate_one_ult(void *arg)
 		ABT_mutex_lock(tls->mpt_inflight_mutex);
 		ABT_cond_wait(tls->mpt_inflight_cond, tls->mpt_inflight_mutex);
 		ABT_mutex_unlock(tls->mpt_inflight_mutex);
+		migrate_inflight_adjust(tls);
 	}
 
 	if (tls->mpt_fini)
@@ -2491,12 +2557,11 @@ put:
  */
 static int
 migrate_one_epoch_object(daos_epoch_range_t *epr, struct migrate_pool_tls *tls,
-			 struct iter_obj_arg *arg)
+			 struct iter_obj_arg *arg, struct migrate_obj_batch *batch)
 {
 	daos_anchor_t		 anchor;
 	daos_anchor_t		 dkey_anchor;
 	daos_anchor_t		 akey_anchor;
-	char			 stack_buf[ITER_BUF_SIZE] = {0};
 	char			*buf = NULL;
 	daos_size_t		 buf_len;
 	daos_key_desc_t		 kds[KDS_NUM] = {0};
@@ -2526,6 +2591,13 @@ migrate_one_epoch_object(daos_epoch_range_t *epr, struct migrate_pool_tls *tls,
 		return 0;
 	}
 
+	if (batch->mob_buf == NULL) {
+		D_ALLOC(batch->mob_buf, ITER_BUF_SIZE);
+		if (batch->mob_buf == NULL)
+			D_GOTO(out, rc = -DER_NOMEM);
+		batch->mob_buf_len = ITER_BUF_SIZE;
+	}
+
 	D_ASSERT(dss_get_module_info()->dmi_xs_id != 0);
 	rc = dsc_pool_open(tls->mpt_pool_uuid, tls->mpt_poh_uuid, 0,
 			   NULL, tls->mpt_pool->spc_pool->sp_map,
@@ -2568,8 +2640,8 @@ migrate_one_epoch_object(daos_epoch_range_t *epr, struct migrate_pool_tls *tls,
 	unpack_arg.oh = oh;
 	unpack_arg.version = tls->mpt_version;
 	D_INIT_LIST_HEAD(&unpack_arg.merge_list);
-	buf = stack_buf;
-	buf_len = ITER_BUF_SIZE;
+	buf = batch->mob_buf;
+	buf_len = batch->mob_buf_len;
 
 	dsc_cont_get_props(coh, &props);
 	rc = dsc_obj_id2oc_attr(arg->oid.id_pub, &props, &unpack_arg.oc_attr);
@@ -2626,13 +2698,16 @@ migrate_one_epoch_object(daos_epoch_range_t *epr, struct migrate_pool_tls *tls,
 			else
 				buf_len = roundup(kds[0].kd_key_len * 2, 8);
 
-			if (buf != stack_buf)
-				D_FREE(buf);
-			D_ALLOC(buf, buf_len);
+			/* Keep the larger buffer for the following objects */
+			D_FREE(batch->mob_buf);
+			D_ALLOC(batch->mob_buf, buf_len);
+			buf = batch->mob_buf;
 			if (buf == NULL) {
+				batch->mob_buf_len = 0;
 				rc = -DER_NOMEM;
 				break;
 			}
+			batch->mob_buf_len = buf_len;
 			continue;
 		} else if (rc == -DER_TRUNC && p_csum != NULL &&
 			   p_csum->iov_len > p_csum->iov_buf_len) {
@@ -2719,9 +2794,6 @@ migrate_one_epoch_object(daos_epoch_range_t *epr, struct migrate_pool_tls *tls,
 		enum_flags |= DIOF_TO_LEADER;
 	}
 
-	if (buf != NULL && buf != stack_buf)
-		D_FREE(buf);
-
 	if (csum.iov_buf != NULL && csum.iov_buf != stack_csum_buf)
 		D_FREE(csum.iov_buf);
 
@@ -2827,22 +2899,21 @@ migrate_obj_punch(struct iter_obj_arg *arg)
 }
 
 /**
- * This ULT manages migration one object ID for one container. It does not do
- * the data migration itself - instead it iterates akeys/dkeys as a client and
+ * Manage migration of one object ID for one container. It does not do the
+ * data migration itself - instead it iterates akeys/dkeys as a client and
  * schedules the actual data migration on their own ULTs
  *
- * If this is reintegration, this ULT will be launched on the target where data
- * is stored so that it can be safely deleted prior to migration. If this is not
- * reintegration, this ULT will be launched on a pseudorandom ULT to increase
- * parallelism by spreading the work among many xstreams.
+ * If this is reintegration, this runs on the target where data is stored so
+ * that it can be safely deleted prior to migration. If this is not
+ * reintegration, this runs on a pseudorandom xstream to increase parallelism
+ * by spreading the work among many xstreams.
  *
- * Note that this ULT is guaranteed to only be spawned once per object per
- * container per migration session (using mpt_migrated_root)
+ * Note that each object is guaranteed to only be migrated once per container
+ * per migration session (using mpt_migrated_root)
  */
 static void
-migrate_obj_ult(void *data)
+migrate_obj_one(struct iter_obj_arg *arg, struct migrate_obj_batch *batch)
 {
-	struct iter_obj_arg	*arg = data;
 	struct migrate_pool_tls	*tls = NULL;
 	daos_epoch_range_t	 epr;
 	int			 i;
@@ -2872,7 +2943,7 @@ migrate_obj_ult(void *data)
 	for (i = 0; i < arg->snap_cnt; i++) {
 		epr.epr_lo = i > 0 ? arg->snaps[i - 1] + 1 : 0;
 		epr.epr_hi = arg->snaps[i];
-		rc = migrate_one_epoch_object(&epr, tls, arg);
+		rc = migrate_one_epoch_object(&epr, tls, arg, batch);
 		if (rc)
 			D_GOTO(free, rc);
 	}
@@ -2887,7 +2958,7 @@ migrate_obj_ult(void *data)
 	D_ASSERT(tls->mpt_max_eph != 0);
 	epr.epr_hi = tls->mpt_max_eph;
 	if (arg->epoch > 0) {
-		rc = migrate_one_epoch_object(&epr, tls, arg);
+		rc = migrate_one_epoch_object(&epr, tls, arg, batch);
 	} else {
 		/* The obj has been punched for this range */
 		D_DEBUG(DB_REBUILD, "punched obj "DF_UOID" epoch"
@@ -2930,6 +3001,82 @@ free_notls:
 	migrate_pool_tls_put(tls);
 }
 
+static void
+migrate_obj_batch_free(struct migrate_obj_batch *batch)
+{
+	int i;
+
+	for (i = 0; i < batch->mob_nr; i++) {
+		D_FREE(batch->mob_args[i]->snaps);
+		D_FREE(batch->mob_args[i]);
+	}
+	D_FREE(batch->mob_buf);
+	D_FREE(batch);
+}
+
+/**
+ * Migrate a batch of objects one after another, so that small objects share
+ * one ULT and one enumeration buffer instead of paying for them per object.
+ */
+static void
+migrate_obj_batch_ult(void *data)
+{
+	struct migrate_obj_batch	*batch = data;
+	int				 i;
+
+	for (i = 0; i < batch->mob_nr; i++) {
+		migrate_obj_one(batch->mob_args[i], batch);
+		batch->mob_args[i] = NULL;
+	}
+	batch->mob_nr = 0;
+	migrate_obj_batch_free(batch);
+}
+
+/* Dispatch the pending objects for the target xstream */
+static int
+migrate_obj_batch_flush(struct iter_cont_arg *cont_arg, unsigned int tgt_idx)
+{
+	struct migrate_pool_tls		*tls = cont_arg->pool_tls;
+	struct migrate_obj_batch	*batch = cont_arg->batches[tgt_idx];
+	int				 nr;
+	int				 rc;
+
+	if (batch == NULL)
+		return 0;
+
+	cont_arg->batches[tgt_idx] = NULL;
+	nr = batch->mob_nr;
+	rc = dss_ult_create(migrate_obj_batch_ult, batch, DSS_XS_VOS, tgt_idx,
+			    MIGRATE_STACK_SIZE, NULL);
+	if (rc) {
+		D_ERROR(DF_UUID" failed to dispatch %d objects to tgt %u: "DF_RC"\n",
+			DP_UUID(tls->mpt_pool_uuid), nr, tgt_idx, DP_RC(rc));
+		migrate_obj_batch_free(batch);
+		if (tls->mpt_status == 0)
+			tls->mpt_status = rc;
+		return rc;
+	}
+
+	tls->mpt_obj_generated_ult += nr;
+	return 0;
+}
+
+static int
+migrate_obj_batch_flush_all(struct iter_cont_arg *cont_arg)
+{
+	int	i;
+	int	rc = 0;
+	int	rc1;
+
+	for (i = 0; i < dss_tgt_nr; i++) {
+		rc1 = migrate_obj_batch_flush(cont_arg, i);
+		if (rc == 0)
+			rc = rc1;
+	}
+
+	return rc;
+}
+
 struct migrate_obj_val {
 	daos_epoch_t	epoch;
 	daos_epoch_t	punched_epoch;
@@ -2946,6 +3093,7 @@ migrate_one_object(daos_unit_oid_t oid, daos_epoch_t eph, daos_epoch_t punched_e
 	struct iter_obj_arg	*obj_arg;
 	struct migrate_pool_tls *tls = cont_arg->pool_tls;
 	daos_handle_t		 toh = tls->mpt_migrated_root_hdl;
+	struct migrate_obj_batch *batch;
 	struct migrate_obj_val	 val;
 	d_iov_t			 val_iov;
 	int			 ult_tgt_idx;
@@ -2996,14 +3144,22 @@ migrate_one_object(daos_unit_oid_t oid, daos_epoch_t eph, daos_epoch_t punched_e
 		ult_tgt_idx = oid.id_pub.lo % dss_tgt_nr;
 	}
 
-	/* Let's iterate the object on different xstream */
-	rc = dss_ult_create(migrate_obj_ult, obj_arg, DSS_XS_VOS,
-			    ult_tgt_idx, MIGRATE_STACK_SIZE,
-			    NULL);
-	if (rc)
-		goto free;
-
-	tls->mpt_obj_generated_ult++;
+	/* Let's iterate the object on different xstream, together with other
+	 * objects going to the same xstream.
+	 */
+	batch = cont_arg->batches[ult_tgt_idx];
+	if (batch == NULL) {
+		D_ALLOC_PTR(batch);
+		if (batch == NULL)
+			D_GOTO(free, rc = -DER_NOMEM);
+		cont_arg->batches[ult_tgt_idx] = batch;
+	}
+	batch->mob_args[batch->mob_nr++] = obj_arg;
+	if (batch->mob_nr == MIGRATE_OBJ_BATCH) {
+		rc = migrate_obj_batch_flush(cont_arg, ult_tgt_idx);
+		if (rc)
+			return rc;
+	}
 
 	val.epoch = eph;
 	val.shard = shard;
@@ -3091,6 +3247,7 @@ migrate_cont_iter_cb(daos_handle_t ih, d_iov_t *key_iov,
 	uuid_t			 cont_uuid;
 	int			 snap_cnt;
 	d_iov_t			 tmp_iov;
+	int			 rc1;
 	int			 rc;
 
 	uuid_copy(cont_uuid, *(uuid_t *)key_iov->iov_buf);
@@ -3113,6 +3270,10 @@ migrate_cont_iter_cb(daos_handle_t ih, d_iov_t *key_iov,
 		D_GOTO(out_put, rc);
 	}
 
+	D_ALLOC_ARRAY(arg.batches, dss_tgt_nr);
+	if (arg.batches == NULL)
+		D_GOTO(free, rc = -DER_NOMEM);
+
 	arg.yield_freq	= DEFAULT_YIELD_FREQ;
 	arg.cont_root	= root;
 	arg.snaps	= snapshots;
@@ -3153,6 +3314,9 @@ migrate_cont_iter_cb(daos_handle_t ih, d_iov_t *key_iov,
 
 		rc = dbtree_iterate(root->root_hdl, DAOS_INTENT_MIGRATION,
 				    false, migrate_obj_iter_cb, &arg);
+		rc1 = migrate_obj_batch_flush_all(&arg);
+		if (rc == 0)
+			rc = rc1;
 		if (rc || tls->mpt_fini)
 			break;
 	}
@@ -3194,6 +3358,7 @@ migrate_cont_iter_cb(daos_handle_t ih, d_iov_t *key_iov,
 free:
 	if (snapshots)
 		D_FREE(snapshots);
+	D_FREE(arg.batches);
 
 out_put:
 	if (tls->mpt_status == 0 && rc < 0)
@@ -62,6 +62,19 @@ struct pl_jump_map {
 	pool_comp_type_t	jmp_redundant_dom;
 };
 
+/**
+ * Domain/target bitmaps shared by all the layouts computed in one
+ * jump_map_obj_place_batch() call, instead of allocating them per object.
+ */
+struct jm_scratch {
+	uint8_t			*jms_dom_used;
+	uint8_t			*jms_dom_occupied;
+	uint8_t			*jms_dom_cur_grp_used;
+	uint8_t			*jms_tgts_used;
+	uint32_t		 jms_dom_array_size;
+	uint32_t		 jms_tgt_array_size;
+};
+
 /**
  * This functions finds the pairwise differences in the two layouts provided
  * and appends them into the d_list provided. The function appends the targets
@@ -716,6 +729,8 @@ remap_gpu_alloc_one(d_list_t *remap_list, uint8_t *dom_cur_grp_used)
  * \param[out]  out_list	This will contain the targets that need to
  *                              be rebuilt and in the case of rebuild, may be
  *                              returned during the rebuild process.
+ * \param[in]	scratch		Optional bitmaps shared with other layouts
+ *                              of the same batch, see jm_scratch_init().
  * \param[out]	is_extending	if there is drain/extending/reintegrating tgts
  *                              exists in this layout, which we might need
  *                              insert extra shards into the layout.
@@ -729,7 +744,7 @@ static int
 get_object_layout(struct pl_jump_map *jmap, struct pl_obj_layout *layout,
 		  struct jm_obj_placement *jmop, d_list_t *out_list,
 		  uint32_t allow_status, uint32_t allow_version, struct daos_obj_md *md,
-		  bool *is_extending)
+		  struct jm_scratch *scratch, bool *is_extending)
 {
 	struct pool_target      *target;
 	struct pool_domain      *root;
@@ -738,6 +753,7 @@ get_object_layout(struct pl_jump_map *jmap, struct pl_obj_layout *layout,
 	uint8_t                 *dom_occupied = NULL;
 	uint8_t                 *tgts_used = NULL;
 	uint8_t			*dom_cur_grp_used = NULL;
+	uint8_t			*grp_used_scratch = NULL;
 	uint8_t			dom_used_array[LOCAL_DOM_ARRAY_SIZE] = { 0 };
 	uint8_t			dom_occupied_array[LOCAL_DOM_ARRAY_SIZE] = { 0 };
 	uint8_t			tgts_used_array[LOCAL_TGT_ARRAY_SIZE] = { 0 };
@@ -777,18 +793,29 @@ get_object_layout(struct pl_jump_map *jmap, struct pl_obj_layout *layout,
 
 	dom_size = (struct pool_domain *)(root->do_targets) - (root) + 1;
 	dom_array_size = dom_size/NBBY + 1;
-	if (dom_array_size > LOCAL_DOM_ARRAY_SIZE) {
-		D_ALLOC_ARRAY(dom_used, dom_array_size);
-		D_ALLOC_ARRAY(dom_occupied, dom_array_size);
+	if (scratch != NULL) {
+		D_ASSERT(scratch->jms_dom_array_size == dom_array_size);
+		dom_used = scratch->jms_dom_used;
+		dom_occupied = scratch->jms_dom_occupied;
+		tgts_used = scratch->jms_tgts_used;
+		grp_used_scratch = scratch->jms_dom_cur_grp_used;
+		memset(dom_used, 0, dom_array_size);
+		memset(dom_occupied, 0, dom_array_size);
+		memset(tgts_used, 0, scratch->jms_tgt_array_size);
 	} else {
-		dom_used = dom_used_array;
-		dom_occupied = dom_occupied_array;
-	}
+		if (dom_array_size > LOCAL_DOM_ARRAY_SIZE) {
+			D_ALLOC_ARRAY(dom_used, dom_array_size);
+			D_ALLOC_ARRAY(dom_occupied, dom_array_size);
+		} else {
+			dom_used = dom_used_array;
+			dom_occupied = dom_occupied_array;
+		}
 
-	if (root->do_target_nr / NBBY + 1 > LOCAL_TGT_ARRAY_SIZE)
-		D_ALLOC_ARRAY(tgts_used, (root->do_target_nr / NBBY) + 1);
-	else
-		tgts_used = tgts_used_array;
+		if (root->do_target_nr / NBBY + 1 > LOCAL_TGT_ARRAY_SIZE)
+			D_ALLOC_ARRAY(tgts_used, (root->do_target_nr / NBBY) + 1);
+		else
+			tgts_used = tgts_used_array;
+	}
 
 	if (dom_used == NULL || dom_occupied == NULL || tgts_used == NULL)
 		D_GOTO(out, rc = -DER_NOMEM);
@@ -803,9 +830,17 @@ get_object_layout(struct pl_jump_map *jmap, struct pl_obj_layout *layout,
 
 		if (realloc_grp_used) {
 			realloc_grp_used = false;
-			D_ALLOC_ARRAY(dom_cur_grp_used, dom_array_size);
-			if (dom_cur_grp_used == NULL)
-				D_GOTO(out, rc = -DER_NOMEM);
+			/* NB: the scratch one can be used until it's attached
+			 * to dgu_remap_list, then allocate a new one.
+			 */
+			if (dom_cur_grp_used == NULL && grp_used_scratch != NULL) {
+				dom_cur_grp_used = grp_used_scratch;
+				memset(dom_cur_grp_used, 0, dom_array_size);
+			} else {
+				D_ALLOC_ARRAY(dom_cur_grp_used, dom_array_size);
+				if (dom_cur_grp_used == NULL)
+					D_GOTO(out, rc = -DER_NOMEM);
+			}
 		} else {
 			memset(dom_cur_grp_used, 0, dom_array_size);
 		}
@@ -892,16 +927,21 @@ out:
 			d_list_del(&dgu->dgu_list);
 			if (dgu->dgu_used == dom_cur_grp_used)
 				cur_grp_freed = true;
-			D_FREE(dgu->dgu_used);
+			if (dgu->dgu_used != grp_used_scratch)
+				D_FREE(dgu->dgu_used);
 			D_FREE(dgu);
 		}
 		/* If dom_cur_grp_used is not attached to dgu, i.e. no targets needs
 		 * be remapped, then free dom_cur_grp_used separately.
 		 */
-		if (!cur_grp_freed)
+		if (!cur_grp_freed && dom_cur_grp_used != grp_used_scratch)
 			D_FREE(dom_cur_grp_used);
 	}
 
+	/* scratch bitmaps are owned by the caller */
+	if (scratch != NULL)
+		return rc;
+
 	if (dom_used && dom_used != dom_used_array)
 		D_FREE(dom_used);
 	if (dom_occupied && dom_occupied != dom_occupied_array)
@@ -912,12 +952,53 @@ out:
 	return rc;
 }
 
+static void
+jm_scratch_fini(struct jm_scratch *scratch)
+{
+	D_FREE(scratch->jms_dom_used);
+	D_FREE(scratch->jms_dom_occupied);
+	D_FREE(scratch->jms_dom_cur_grp_used);
+	D_FREE(scratch->jms_tgts_used);
+}
+
+/** Allocate the bitmaps sized for the current pool map, see get_object_layout */
+static int
+jm_scratch_init(struct pl_jump_map *jmap, struct jm_scratch *scratch)
+{
+	struct pool_domain	*root;
+	uint32_t		 dom_size;
+	int			 rc;
+
+	memset(scratch, 0, sizeof(*scratch));
+	rc = pool_map_find_domain(jmap->jmp_map.pl_poolmap, PO_COMP_TP_ROOT,
+				  PO_COMP_ID_ALL, &root);
+	if (rc == 0) {
+		D_ERROR("Could not find root node in pool map.");
+		return -DER_NONEXIST;
+	}
+
+	dom_size = (struct pool_domain *)(root->do_targets) - (root) + 1;
+	scratch->jms_dom_array_size = dom_size / NBBY + 1;
+	scratch->jms_tgt_array_size = root->do_target_nr / NBBY + 1;
+
+	D_ALLOC_ARRAY(scratch->jms_dom_used, scratch->jms_dom_array_size);
+	D_ALLOC_ARRAY(scratch->jms_dom_occupied, scratch->jms_dom_array_size);
+	D_ALLOC_ARRAY(scratch->jms_dom_cur_grp_used, scratch->jms_dom_array_size);
+	D_ALLOC_ARRAY(scratch->jms_tgts_used, scratch->jms_tgt_array_size);
+	if (scratch->jms_dom_used == NULL || scratch->jms_dom_occupied == NULL ||
+	    scratch->jms_dom_cur_grp_used == NULL || scratch->jms_tgts_used == NULL) {
+		jm_scratch_fini(scratch);
+		return -DER_NOMEM;
+	}
+	return 0;
+}
+
 static int
 obj_layout_alloc_and_get(struct pl_jump_map *jmap,
 			 struct jm_obj_placement *jmop, struct daos_obj_md *md,
 			 uint32_t allow_status, uint32_t allow_version,
 			 struct pl_obj_layout **layout_p, d_list_t *remap_list,
-			 bool *is_extending)
+			 struct jm_scratch *scratch, bool *is_extending)
 {
 	int rc;
 
@@ -933,7 +1014,7 @@ obj_layout_alloc_and_get(struct pl_jump_map *jmap,
 	}
 
 	rc = get_object_layout(jmap, *layout_p, jmop, remap_list, allow_status,
-			       allow_version, md, is_extending);
+			       allow_version, md, scratch, is_extending);
 	if (rc) {
 		D_ERROR("get object layout failed, rc "DF_RC"\n",
 			DP_RC(rc));
@@ -1054,57 +1135,25 @@ jump_map_query(struct pl_map *map, struct pl_map_attr *attr)
 	return 0;
 }
 
-/**
- * Determines the locations that a given object shard should be located.
- *
- * \param[in]   map             A reference to the placement map being used to
- *                              place the object shard.
- * \param[in]   layout_version	layout version.
- * \param[in]   md              The object metadata which contains data about
- *                              the object being placed such as the object ID.
- * \param[in]   mode		mode of daos_obj_open(DAOS_OO_RO, DAOS_OO_RW etc).
- * \param[in]	rebuild_ver	rebuild version of the current pool.
- * \param[in]   shard_md        Shard metadata.
- * \param[out]  layout_pp       The layout generated for the object. Contains
- *                              references to the targets in the pool map where
- *                              the shards will be placed.
- *
- * \return                      An integer value containing the error
- *                              code or 0 if the function returned
- *                              successfully.
- */
 static int
-jump_map_obj_place(struct pl_map *map, uint32_t layout_version, struct daos_obj_md *md,
-		   unsigned int mode, uint32_t rebuild_version, struct daos_obj_shard_md *shard_md,
-		   struct pl_obj_layout **layout_pp)
+jm_obj_place(struct pl_jump_map *jmap, struct jm_obj_placement *jmop, struct daos_obj_md *md,
+	     unsigned int mode, uint32_t rebuild_version, struct jm_scratch *scratch,
+	     struct pl_obj_layout **layout_pp)
 {
-	struct pl_jump_map	*jmap;
 	struct pl_obj_layout	*layout = NULL;
 	struct pl_obj_layout	*extend_layout = NULL;
-	struct jm_obj_placement	jmop;
 	d_list_t		extend_list;
 	bool			is_extending = false;
 	bool			is_adding_new = false;
 	daos_obj_id_t		oid;
-	struct pool_domain	*root;
 	uint32_t		allow_status;
 	int			rc;
 
-	jmap = pl_map2jmap(map);
 	oid = md->omd_id;
-	D_DEBUG(DB_PL, "Determining location for object: "DF_OID", ver: %d/%u\n",
-		DP_OID(oid), md->omd_ver, rebuild_version);
-
-	rc = jm_obj_placement_get(jmap, md, shard_md, &jmop);
-	if (rc) {
-		D_ERROR("jm_obj_placement_get failed, rc "DF_RC"\n", DP_RC(rc));
-		return rc;
-	}
-
 	D_INIT_LIST_HEAD(&extend_list);
 	allow_status = PO_COMP_ST_UPIN | PO_COMP_ST_DRAIN;
-	rc = obj_layout_alloc_and_get(jmap, &jmop, md, allow_status, -1, &layout,
-				      NULL, &is_extending);
+	rc = obj_layout_alloc_and_get(jmap, jmop, md, allow_status, -1, &layout,
+				      NULL, scratch, &is_extending);
 	if (rc != 0) {
 		D_ERROR("get_layout_alloc failed, rc "DF_RC"\n", DP_RC(rc));
 		D_GOTO(out, rc);
@@ -1112,12 +1161,6 @@ jump_map_obj_place(struct pl_map *map, uint32_t layout_version, struct daos_obj_
 
 	obj_layout_dump(oid, layout);
 
-	rc = pool_map_find_domain(jmap->jmp_map.pl_poolmap,
-				  PO_COMP_TP_ROOT, PO_COMP_ID_ALL,
-				  &root);
-	D_ASSERT(rc == 1);
-	rc = 0;
-
 	if (is_pool_map_adding(jmap->jmp_map.pl_poolmap, rebuild_version))
 		is_adding_new = true;
 
@@ -1132,8 +1175,8 @@ jump_map_obj_place(struct pl_map *map, uint32_t layout_version, struct daos_obj_
 			is_extending ? "yes" : "no");
 
 		allow_status = PO_COMP_ST_UPIN | PO_COMP_ST_UP;
-		rc = obj_layout_alloc_and_get(jmap, &jmop, md, allow_status, rebuild_version,
-					      &extend_layout, NULL, NULL);
+		rc = obj_layout_alloc_and_get(jmap, jmop, md, allow_status, rebuild_version,
+					      &extend_layout, NULL, scratch, NULL);
 		if (rc)
 			D_GOTO(out, rc);
 
@@ -1164,6 +1207,118 @@ out:
 	return rc;
 }
 
+/**
+ * Determines the locations that a given object shard should be located.
+ *
+ * \param[in]   map             A reference to the placement map being used to
+ *                              place the object shard.
+ * \param[in]   layout_version	layout version.
+ * \param[in]   md              The object metadata which contains data about
+ *                              the object being placed such as the object ID.
+ * \param[in]   mode		mode of daos_obj_open(DAOS_OO_RO, DAOS_OO_RW etc).
+ * \param[in]	rebuild_ver	rebuild version of the current pool.
+ * \param[in]   shard_md        Shard metadata.
+ * \param[out]  layout_pp       The layout generated for the object. Contains
+ *                              references to the targets in the pool map where
+ *                              the shards will be placed.
+ *
+ * \return                      An integer value containing the error
+ *                              code or 0 if the function returned
+ *                              successfully.
+ */
+static int
+jump_map_obj_place(struct pl_map *map, uint32_t layout_version, struct daos_obj_md *md,
+		   unsigned int mode, uint32_t rebuild_version, struct daos_obj_shard_md *shard_md,
+		   struct pl_obj_layout **layout_pp)
+{
+	struct pl_jump_map	*jmap;
+	struct jm_obj_placement	jmop;
+	int			rc;
+
+	jmap = pl_map2jmap(map);
+	D_DEBUG(DB_PL, "Determining location for object: "DF_OID", ver: %d/%u\n",
+		DP_OID(md->omd_id), md->omd_ver, rebuild_version);
+
+	rc = jm_obj_placement_get(jmap, md, shard_md, &jmop);
+	if (rc) {
+		D_ERROR("jm_obj_placement_get failed, rc "DF_RC"\n", DP_RC(rc));
+		return rc;
+	}
+
+	return jm_obj_place(jmap, &jmop, md, mode, rebuild_version, NULL, layout_pp);
+}
+
+/**
+ * Determines the layouts of an array of objects, see jump_map_obj_place.
+ *
+ * The domain and target bitmaps are allocated once for the whole batch, and
+ * the layout requirements are only recomputed when the object class or the
+ * fault domain level differs from the previous object.
+ *
+ * \param[in]   map             The placement map.
+ * \param[in]   layout_version	layout version.
+ * \param[in]   mds             Metadata of the objects to place.
+ * \param[in]   nr              Number of objects in \a mds.
+ * \param[in]   mode		mode of daos_obj_open(DAOS_OO_RO, DAOS_OO_RW etc).
+ * \param[in]	rebuild_ver	rebuild version of the current pool.
+ * \param[out]  layouts         Array of \a nr generated layouts, all of them
+ *                              are freed on failure.
+ *
+ * \return                      0 on success, negative error code otherwise.
+ */
+static int
+jump_map_obj_place_batch(struct pl_map *map, uint32_t layout_version, struct daos_obj_md *mds,
+			 unsigned int nr, unsigned int mode, uint32_t rebuild_version,
+			 struct pl_obj_layout **layouts)
+{
+	struct pl_jump_map	*jmap;
+	struct jm_obj_placement	jmop;
+	struct jm_scratch	scratch;
+	daos_oclass_id_t	oc_id = OC_UNKNOWN;
+	uint32_t		fdom_lvl = 0;
+	bool			jmop_valid = false;
+	unsigned int		i;
+	int			rc;
+
+	jmap = pl_map2jmap(map);
+	D_DEBUG(DB_PL, "Determining location for %u objects, ver: %u\n", nr,
+		rebuild_version);
+
+	rc = jm_scratch_init(jmap, &scratch);
+	if (rc)
+		return rc;
+
+	for (i = 0; i < nr; i++) {
+		struct daos_obj_md *md = &mds[i];
+
+		if (!jmop_valid || daos_obj_id2class(md->omd_id) != oc_id ||
+		    md->omd_fdom_lvl != fdom_lvl) {
+			rc = jm_obj_placement_get(jmap, md, NULL, &jmop);
+			if (rc) {
+				D_ERROR("jm_obj_placement_get failed, rc "DF_RC"\n", DP_RC(rc));
+				break;
+			}
+			oc_id = daos_obj_id2class(md->omd_id);
+			fdom_lvl = md->omd_fdom_lvl;
+			jmop_valid = true;
+		}
+
+		rc = jm_obj_place(jmap, &jmop, md, mode, rebuild_version, &scratch,
+				  &layouts[i]);
+		if (rc)
+			break;
+	}
+
+	if (rc) {
+		while (i-- > 0) {
+			pl_obj_layout_free(layouts[i]);
+			layouts[i] = NULL;
+		}
+	}
+	jm_scratch_fini(&scratch);
+	return rc;
+}
+
 /**
  *
  * \param[in]   map             The placement map to be used to generate the
@@ -1218,7 +1373,7 @@ jump_map_obj_find_rebuild(struct pl_map *map, uint32_t layout_ver, struct daos_o
 
 	D_INIT_LIST_HEAD(&remap_list);
 	rc = obj_layout_alloc_and_get(jmap, &jmop, md, PO_COMP_ST_UPIN, -1, &layout,
-				      &remap_list, NULL);
+				      &remap_list, NULL, NULL);
 	if (rc < 0)
 		D_GOTO(out, rc);
 
@@ -1270,13 +1425,13 @@ jump_map_obj_find_reint(struct pl_map *map, uint32_t layout_ver, struct daos_obj
 	allow_status = PO_COMP_ST_UPIN | PO_COMP_ST_DOWN | PO_COMP_ST_DRAIN;
 	D_INIT_LIST_HEAD(&reint_list);
 	rc = obj_layout_alloc_and_get(jmap, &jop, md, allow_status, reint_ver,
-				      &layout, NULL, NULL);
+				      &layout, NULL, NULL, NULL);
 	if (rc < 0)
 		D_GOTO(out, rc);
 
 	allow_status |= PO_COMP_ST_UP;
 	rc = obj_layout_alloc_and_get(jmap, &jop, md, allow_status, reint_ver,
-				      &reint_layout, NULL, NULL);
+				      &reint_layout, NULL, NULL, NULL);
 	if (rc < 0)
 		D_GOTO(out, rc);
 
@@ -1329,13 +1484,13 @@ jump_map_obj_find_addition(struct pl_map *map, uint32_t layout_ver, struct daos_
 	allow_status = PO_COMP_ST_UPIN;
 	D_INIT_LIST_HEAD(&add_list);
 	rc = obj_layout_alloc_and_get(jmap, &jop, md, allow_status, reint_ver,
-				      &layout, NULL, NULL);
+				      &layout, NULL, NULL, NULL);
 	if (rc)
 		D_GOTO(out, rc);
 
 	allow_status |= PO_COMP_ST_UP;
 	rc = obj_layout_alloc_and_get(jmap, &jop, md, allow_status, reint_ver,
-				      &add_layout, NULL, NULL);
+				      &add_layout, NULL, NULL, NULL);
 	if (rc)
 		D_GOTO(out, rc);
 
@@ -1360,6 +1515,7 @@ struct pl_map_ops       jump_map_ops = {
 	.o_query		= jump_map_query,
 	.o_print                = jump_map_print,
 	.o_obj_place            = jump_map_obj_place,
+	.o_obj_place_batch      = jump_map_obj_place_batch,
 	.o_obj_find_rebuild     = jump_map_obj_find_rebuild,
 	.o_obj_find_reint       = jump_map_obj_find_reint,
 	.o_obj_find_addition      = jump_map_obj_find_addition,
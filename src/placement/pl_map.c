@@ -15,6 +15,7 @@
 
 extern struct pl_map_ops        ring_map_ops;
 extern struct pl_map_ops        jump_map_ops;
+extern struct pl_map_ops        straw_map_ops;
 
 /** dictionary for all unknown placement maps */
 struct pl_map_dict {
@@ -38,6 +39,11 @@ static struct pl_map_dict pl_maps[] = {
 		.pd_ops     = &jump_map_ops,
 		.pd_name    = "jump",
 	},
+	{
+		.pd_type	= PL_TYPE_STRAW_MAP,
+		.pd_ops		= &straw_map_ops,
+		.pd_name	= "straw",
+	},
 	{
 		.pd_type        = PL_TYPE_UNKNOWN,
 		.pd_ops         = NULL,
@@ -127,6 +133,43 @@ pl_obj_place(struct pl_map *map, uint32_t layout_gl_version, struct daos_obj_md
 					layout_pp);
 }
 
+/**
+ * Compute layouts for an array of objects @mds, it's equivalent to calling
+ * pl_obj_place() for each of them without shard metadata, but placement maps
+ * can share per-call state across the whole batch. Either all @nr layouts are
+ * returned in @layouts, or none of them on failure.
+ */
+int
+pl_obj_place_batch(struct pl_map *map, uint32_t layout_gl_version, struct daos_obj_md *mds,
+		   unsigned int nr, unsigned int mode, uint32_t rebuild_ver,
+		   struct pl_obj_layout **layouts)
+{
+	unsigned int	i;
+	int		rc = 0;
+
+	D_ASSERT(map->pl_ops != NULL);
+	D_ASSERT(map->pl_ops->o_obj_place != NULL);
+
+	if (map->pl_ops->o_obj_place_batch != NULL)
+		return map->pl_ops->o_obj_place_batch(map, layout_gl_version, mds, nr, mode,
+						      rebuild_ver, layouts);
+
+	for (i = 0; i < nr; i++) {
+		rc = map->pl_ops->o_obj_place(map, layout_gl_version, &mds[i], mode,
+					      rebuild_ver, NULL, &layouts[i]);
+		if (rc)
+			break;
+	}
+
+	if (rc) {
+		while (i-- > 0) {
+			pl_obj_layout_free(layouts[i]);
+			layouts[i] = NULL;
+		}
+	}
+	return rc;
+}
+
 /**
  * Check if the provided object has any shard needs to be rebuilt for the
  * given rebuild version @rebuild_ver.
@@ -369,6 +412,11 @@ pl_map_attr_init(struct pool_map *po_map, pl_map_type_t type,
 	case PL_TYPE_JUMP_MAP:
 		mia->ia_type            = PL_TYPE_JUMP_MAP;
 		mia->ia_jump_map.domain = PL_DEFAULT_DOMAIN;
+		break;
+	case PL_TYPE_STRAW_MAP:
+		mia->ia_type             = PL_TYPE_STRAW_MAP;
+		mia->ia_straw_map.domain = PL_DEFAULT_DOMAIN;
+		break;
 	}
 }
 
@@ -485,7 +533,9 @@ pl_map_update(uuid_t uuid, struct pool_map *pool_map, bool connect,
 			D_GOTO(out, rc = 0);
 		}
 
-		pl_map_attr_init(pool_map, PL_TYPE_JUMP_MAP, &mia);
+		/* a straw map must stay a straw map, or the whole pool moves */
+		pl_map_attr_init(pool_map, tmp->pl_type == PL_TYPE_STRAW_MAP ?
+				 PL_TYPE_STRAW_MAP : PL_TYPE_JUMP_MAP, &mia);
 		rc = pl_map_create_inited(pool_map, &mia, &map);
 		if (rc != 0) {
 			d_hash_rec_decref(&pl_htable, link);
@@ -39,6 +39,12 @@ struct pl_map_ops {
 			   unsigned int	mode, uint32_t rebuild_ver,
 			   struct daos_obj_shard_md *shard_md,
 			   struct pl_obj_layout **layout_pp);
+	/** see \a pl_obj_place_batch, optional */
+	int (*o_obj_place_batch)(struct pl_map *map,
+				 uint32_t layout_gl_version,
+				 struct daos_obj_md *mds, unsigned int nr,
+				 unsigned int mode, uint32_t rebuild_ver,
+				 struct pl_obj_layout **layouts);
 	/** see \a pl_map_obj_rebuild */
 	int (*o_obj_find_rebuild)(struct pl_map *map,
 				  uint32_t layout_gl_version,
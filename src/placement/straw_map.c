@@ -0,0 +1,855 @@
+/**
+ * (C) Copyright 2016-2022 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * src/placement/straw_map.c
+ *
+ * Weighted rendezvous (straw2) placement map.
+ *
+ * Every shard draws a straw for each fault domain and then for each target
+ * within the winning domain, the straw length is ln(hash) / weight and the
+ * longest straw wins. Because each draw only depends on the shard and the
+ * candidate itself, adding a domain or changing its weight only moves the
+ * shards that the new or reweighted domain wins, which is the minimum amount
+ * of data that has to move to keep the pool balanced.
+ *
+ * The weight of a fault domain is the number of targets it carries, so ranks
+ * (or nodes) with more targets receive proportionally more shards.
+ */
+#define D_LOGFAC	DD_FAC(placement)
+
+#include "pl_map.h"
+
+/** number of fractional bits of the fixed-point logarithm */
+#define STRAW_FRAC_BITS		16
+
+/** a fault domain of the straw map */
+struct straw_domain {
+	/** the pool map domain */
+	struct pool_domain	*sd_dom;
+	/** weight for normal placement (targets which are not being added) */
+	uint32_t		 sd_weight;
+	/** weight when the targets being added or reintegrated count */
+	uint32_t		 sd_weight_reint;
+};
+
+/** straw placement map */
+struct pl_straw_map {
+	/** common body */
+	struct pl_map		 smp_map;
+	/** fault domain */
+	pool_comp_type_t	 smp_domain;
+	/** number of fault domains */
+	unsigned int		 smp_domain_nr;
+	/** number of UPIN targets */
+	unsigned int		 smp_target_nr;
+	/** total number of targets in the pool map */
+	unsigned int		 smp_tgt_total;
+	/** some targets are being added or reintegrated */
+	bool			 smp_extending;
+	/** all fault domains */
+	struct straw_domain	*smp_domains;
+	/** fault domain index of each target, indexed by target position */
+	uint32_t		*smp_tgt2dom;
+};
+
+/** per-object placement parameters */
+struct straw_obj_placement {
+	/** hash key of the object */
+	uint64_t		sop_key;
+	/** the first shard of the layout */
+	unsigned int		sop_shard_id;
+	unsigned int		sop_grp_size;
+	unsigned int		sop_grp_nr;
+	/** target position of the first shard for special-rank objects */
+	int			sop_spec_pos;
+};
+
+/** scratch state while filling one layout */
+struct straw_scratch {
+	/** targets which have been taken by the layout or tried as spare */
+	uint8_t			*ss_tgts_used;
+	/** domains already used by the current group */
+	uint8_t			*ss_dom_skip;
+	/** number of targets taken from each domain */
+	uint32_t		*ss_dom_used_nr;
+	/** domain index of each shard, -1 if the shard has no target */
+	int			*ss_shard_dom;
+	/** the buffer holding all of the above */
+	void			*ss_buf;
+};
+
+static void straw_map_destroy(struct pl_map *map);
+
+static inline struct pl_straw_map *
+pl_map2smap(struct pl_map *map)
+{
+	return container_of(map, struct pl_straw_map, smp_map);
+}
+
+static inline uint64_t
+straw_hash(uint64_t key, uint64_t val)
+{
+	uint64_t x = key ^ (val * 0x9e3779b97f4a7c15ULL);
+
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdULL;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ULL;
+	x ^= x >> 33;
+	return x;
+}
+
+/** log2(@u) in fixed point with STRAW_FRAC_BITS fractional bits, u >= 1 */
+static int64_t
+straw_log2(uint64_t u)
+{
+	uint64_t	x;
+	int64_t		res;
+	int		msb;
+	int		i;
+
+	msb = 63 - __builtin_clzll(u);
+	res = (int64_t)msb << STRAW_FRAC_BITS;
+
+	/* normalise into [1, 2) with 31 fractional bits */
+	x = msb >= 31 ? u >> (msb - 31) : u << (31 - msb);
+	for (i = STRAW_FRAC_BITS - 1; i >= 0; i--) {
+		x = (x * x) >> 31;
+		if (x >= (2ULL << 31)) {
+			x >>= 1;
+			res |= 1LL << i;
+		}
+	}
+	return res;
+}
+
+/**
+ * Straw length for a candidate, ln(u) / weight with u uniform in (0, 1].
+ * The longest (i.e. the closest to zero) straw wins.
+ */
+static inline int64_t
+straw_draw(uint64_t hash, uint32_t weight)
+{
+	int64_t	ln;
+
+	D_ASSERT(weight > 0);
+	ln = straw_log2((hash & 0xffffffffULL) + 1) - (32LL << STRAW_FRAC_BITS);
+	return ln * (1LL << STRAW_FRAC_BITS) / (int64_t)weight;
+}
+
+/**
+ * A target is part of the placement unless it is brand new, i.e. it has not
+ * been added yet, or it is being added and the caller does not ask for the
+ * extended layout. Targets being reintegrated keep their place in the map and
+ * are remapped to a spare like the other unavailable targets.
+ */
+static inline bool
+straw_tgt_present(struct pool_target *tgt, bool for_reint)
+{
+	uint8_t status = tgt->ta_comp.co_status;
+
+	if (status == PO_COMP_ST_NEW)
+		return false;
+
+	if (status == PO_COMP_ST_UP && tgt->ta_comp.co_fseq <= 1)
+		return for_reint;
+
+	return true;
+}
+
+static inline uint32_t
+straw_dom_weight(struct straw_domain *sdom, bool for_reint)
+{
+	return for_reint ? sdom->sd_weight_reint : sdom->sd_weight;
+}
+
+/**
+ * Select the fault domain with the longest straw for shard key @skey,
+ * skipping domains in \a ss_dom_skip and domains without free targets.
+ *
+ * \return	domain index, or -1 if there is no candidate.
+ */
+static int
+straw_select_dom(struct pl_straw_map *smap, uint64_t skey, bool for_reint,
+		 struct straw_scratch *ss)
+{
+	struct straw_domain	*sdom;
+	int64_t			 best_draw = 0;
+	int64_t			 draw;
+	uint32_t		 weight;
+	int			 best = -1;
+	int			 i;
+
+	for (i = 0; i < smap->smp_domain_nr; i++) {
+		sdom = &smap->smp_domains[i];
+		if (isset(ss->ss_dom_skip, i))
+			continue;
+
+		weight = straw_dom_weight(sdom, for_reint);
+		if (weight == 0 || ss->ss_dom_used_nr[i] >= weight)
+			continue;
+
+		draw = straw_draw(straw_hash(skey, (uint64_t)sdom->sd_dom->do_comp.co_id << 1),
+				  weight);
+		if (best < 0 || draw > best_draw) {
+			best = i;
+			best_draw = draw;
+		}
+	}
+	return best;
+}
+
+/**
+ * Like straw_select_dom(), but if all the domains with free targets are in
+ * \a ss_dom_skip, i.e. the group has more shards than there are domains with
+ * free targets, reset the skip set and let the group reuse a domain, as
+ * jump map does.
+ */
+static int
+straw_select_dom_reuse(struct pl_straw_map *smap, uint64_t skey, bool for_reint,
+		       struct straw_scratch *ss)
+{
+	int dom;
+
+	dom = straw_select_dom(smap, skey, for_reint, ss);
+	if (dom >= 0)
+		return dom;
+
+	memset(ss->ss_dom_skip, 0, roundup(smap->smp_domain_nr, NBBY) / NBBY);
+	return straw_select_dom(smap, skey, for_reint, ss);
+}
+
+/** Select the free target with the longest straw within domain @dom_idx */
+static struct pool_target *
+straw_select_tgt(struct pl_straw_map *smap, int dom_idx, uint64_t skey,
+		 bool for_reint, struct straw_scratch *ss)
+{
+	struct pool_domain	*dom = smap->smp_domains[dom_idx].sd_dom;
+	struct pool_target	*tgts = pool_map_targets(smap->smp_map.pl_poolmap);
+	struct pool_target	*tgt;
+	struct pool_target	*best = NULL;
+	int64_t			 best_draw = 0;
+	int64_t			 draw;
+	unsigned int		 pos;
+	int			 i;
+
+	for (i = 0; i < dom->do_target_nr; i++) {
+		tgt = &dom->do_targets[i];
+		pos = tgt - tgts;
+		if (isset(ss->ss_tgts_used, pos) || !straw_tgt_present(tgt, for_reint))
+			continue;
+
+		draw = straw_draw(straw_hash(skey, ((uint64_t)tgt->ta_comp.co_id << 1) | 1), 1);
+		if (best == NULL || draw > best_draw) {
+			best = tgt;
+			best_draw = draw;
+		}
+	}
+	return best;
+}
+
+static void
+straw_take(struct pl_straw_map *smap, struct straw_scratch *ss,
+	   struct pool_target *tgt, int dom_idx)
+{
+	struct pool_target *tgts = pool_map_targets(smap->smp_map.pl_poolmap);
+
+	setbit(ss->ss_tgts_used, tgt - tgts);
+	ss->ss_dom_used_nr[dom_idx]++;
+}
+
+static int
+straw_scratch_init(struct pl_straw_map *smap, unsigned int shard_nr,
+		   struct straw_scratch *ss)
+{
+	size_t	tgt_bytes = roundup(smap->smp_tgt_total, NBBY) / NBBY;
+	size_t	dom_bytes = roundup(smap->smp_domain_nr, NBBY) / NBBY;
+	size_t	size;
+	char	*buf;
+
+	tgt_bytes = roundup(tgt_bytes, sizeof(uint32_t));
+	dom_bytes = roundup(dom_bytes, sizeof(uint32_t));
+	size = tgt_bytes + dom_bytes + smap->smp_domain_nr * sizeof(uint32_t) +
+	       shard_nr * sizeof(int);
+
+	D_ALLOC(buf, size);
+	if (buf == NULL)
+		return -DER_NOMEM;
+
+	ss->ss_buf = buf;
+	ss->ss_tgts_used = (uint8_t *)buf;
+	ss->ss_dom_skip = (uint8_t *)(buf + tgt_bytes);
+	ss->ss_dom_used_nr = (uint32_t *)(buf + tgt_bytes + dom_bytes);
+	ss->ss_shard_dom = (int *)(ss->ss_dom_used_nr + smap->smp_domain_nr);
+	return 0;
+}
+
+static void
+straw_scratch_fini(struct straw_scratch *ss)
+{
+	D_FREE(ss->ss_buf);
+}
+
+/** Build the domain table and the per-domain weights */
+static int
+straw_map_build(struct pl_straw_map *smap, struct pl_map_init_attr *mia)
+{
+	struct pool_map		*poolmap = smap->smp_map.pl_poolmap;
+	struct pool_domain	*doms;
+	struct pool_target	*tgts;
+	struct pool_target	*tgt;
+	struct straw_domain	*sdom;
+	int			 i;
+	int			 j;
+	int			 rc;
+
+	smap->smp_domain = mia->ia_straw_map.domain;
+	rc = pool_map_find_domain(poolmap, smap->smp_domain, PO_COMP_ID_ALL, &doms);
+	if (rc <= 0)
+		return rc == 0 ? -DER_INVAL : rc;
+	smap->smp_domain_nr = rc;
+
+	tgts = pool_map_targets(poolmap);
+	smap->smp_tgt_total = pool_map_target_nr(poolmap);
+	D_ALLOC_ARRAY(smap->smp_domains, smap->smp_domain_nr);
+	if (smap->smp_domains == NULL)
+		return -DER_NOMEM;
+
+	D_ALLOC_ARRAY(smap->smp_tgt2dom, smap->smp_tgt_total);
+	if (smap->smp_tgt2dom == NULL)
+		return -DER_NOMEM;
+
+	for (i = 0; i < smap->smp_domain_nr; i++) {
+		sdom = &smap->smp_domains[i];
+		sdom->sd_dom = &doms[i];
+		for (j = 0; j < doms[i].do_target_nr; j++) {
+			tgt = &doms[i].do_targets[j];
+			smap->smp_tgt2dom[tgt - tgts] = i;
+			if (straw_tgt_present(tgt, false))
+				sdom->sd_weight++;
+			if (straw_tgt_present(tgt, true))
+				sdom->sd_weight_reint++;
+			if (tgt->ta_comp.co_status == PO_COMP_ST_UP)
+				smap->smp_extending = true;
+		}
+	}
+
+	return pool_map_find_upin_tgts(poolmap, NULL, &smap->smp_target_nr);
+}
+
+static int
+straw_map_create(struct pool_map *poolmap, struct pl_map_init_attr *mia,
+		 struct pl_map **mapp)
+{
+	struct pl_straw_map	*smap;
+	int			 rc;
+
+	D_DEBUG(DB_PL, "Create straw map: domain %s\n",
+		pool_comp_type2str(mia->ia_straw_map.domain));
+
+	D_ALLOC_PTR(smap);
+	if (smap == NULL)
+		return -DER_NOMEM;
+
+	pool_map_addref(poolmap);
+	smap->smp_map.pl_poolmap = poolmap;
+
+	rc = straw_map_build(smap, mia);
+	if (rc != 0) {
+		D_ERROR("Failed to build straw map: "DF_RC"\n", DP_RC(rc));
+		straw_map_destroy(&smap->smp_map);
+		return rc;
+	}
+
+	*mapp = &smap->smp_map;
+	return 0;
+}
+
+static void
+straw_map_destroy(struct pl_map *map)
+{
+	struct pl_straw_map *smap = pl_map2smap(map);
+
+	D_FREE(smap->smp_domains);
+	D_FREE(smap->smp_tgt2dom);
+	if (smap->smp_map.pl_poolmap)
+		pool_map_decref(smap->smp_map.pl_poolmap);
+
+	D_FREE(smap);
+}
+
+static void
+straw_map_print(struct pl_map *map)
+{
+	struct pl_straw_map	*smap = pl_map2smap(map);
+	struct straw_domain	*sdom;
+	int			 i;
+
+	D_PRINT("straw map: ver %d, domain %s, domain_nr %u, tgt_nr %u\n",
+		pl_map_version(map), pool_comp_type2str(smap->smp_domain),
+		smap->smp_domain_nr, smap->smp_target_nr);
+
+	for (i = 0; i < smap->smp_domain_nr; i++) {
+		sdom = &smap->smp_domains[i];
+		D_PRINT("  domain %u: weight %u/%u\n", sdom->sd_dom->do_comp.co_id,
+			sdom->sd_weight, sdom->sd_weight_reint);
+	}
+}
+
+static int
+straw_map_query(struct pl_map *map, struct pl_map_attr *attr)
+{
+	struct pl_straw_map *smap = pl_map2smap(map);
+
+	attr->pa_type	   = PL_TYPE_STRAW_MAP;
+	attr->pa_domain	   = smap->smp_domain;
+	attr->pa_domain_nr = smap->smp_domain_nr;
+	attr->pa_target_nr = smap->smp_target_nr;
+	return 0;
+}
+
+static int
+straw_obj_placement_get(struct pl_straw_map *smap, struct daos_obj_md *md,
+			struct daos_obj_shard_md *shard_md,
+			struct straw_obj_placement *sop)
+{
+	struct daos_oclass_attr	*oc_attr;
+	daos_obj_id_t		 oid;
+	unsigned int		 pos;
+	uint32_t		 nr_grps;
+	int			 rc;
+
+	oid = md->omd_id;
+	oc_attr = daos_oclass_attr_find(oid, &nr_grps);
+	if (oc_attr == NULL) {
+		D_ERROR("Can not find obj class, invalid oid="DF_OID"\n",
+			DP_OID(oid));
+		return -DER_INVAL;
+	}
+
+	/* The straw map only knows the fault domain it was created with */
+	if (md->omd_fdom_lvl != 0 && md->omd_fdom_lvl != smap->smp_domain)
+		D_DEBUG(DB_PL, DF_OID" fault domain %u ignored, using %u\n",
+			DP_OID(oid), md->omd_fdom_lvl, smap->smp_domain);
+
+	rc = op_get_grp_size(smap->smp_domain_nr, &sop->sop_grp_size, oid);
+	if (rc != 0)
+		return rc;
+
+	if (shard_md == NULL) {
+		unsigned int grp_max = smap->smp_tgt_total / sop->sop_grp_size;
+
+		if (grp_max == 0)
+			grp_max = 1;
+
+		sop->sop_grp_nr = nr_grps;
+		if (sop->sop_grp_nr == DAOS_OBJ_GRP_MAX)
+			sop->sop_grp_nr = grp_max;
+		else if (sop->sop_grp_nr > grp_max)
+			return -DER_INVAL;
+		sop->sop_shard_id = 0;
+	} else {
+		sop->sop_grp_nr = 1;
+		sop->sop_shard_id = pl_obj_shard2grp_head(shard_md, oc_attr);
+	}
+
+	sop->sop_key = straw_hash(oid.hi, oid.lo);
+	sop->sop_spec_pos = -1;
+	if (daos_obj_is_srank(oid) && sop->sop_shard_id == 0) {
+		rc = spec_place_rank_get(&pos, oid, smap->smp_map.pl_poolmap);
+		if (rc != 0) {
+			D_ERROR("special oid "DF_OID" failed: rc %d\n",
+				DP_OID(oid), rc);
+			return rc;
+		}
+		sop->sop_spec_pos = pos;
+	}
+
+	D_DEBUG(DB_PL, "obj="DF_OID"/%u grp_size=%u grp_nr=%u\n", DP_OID(oid),
+		sop->sop_shard_id, sop->sop_grp_size, sop->sop_grp_nr);
+	return 0;
+}
+
+/**
+ * Try to remap all the failed shards in the @remap_list. The spare of a shard
+ * is the free target with the next longest straw, taken from the domains which
+ * are not used by the other shards of its group if there is any, so spares keep
+ * the fault domain separation of the group when possible.
+ */
+static int
+straw_obj_remap_shards(struct pl_straw_map *smap, struct daos_obj_md *md,
+		       struct straw_obj_placement *sop, struct pl_obj_layout *layout,
+		       d_list_t *remap_list, struct straw_scratch *ss, bool for_reint)
+{
+	struct failed_shard	*f_shard;
+	struct pl_obj_shard	*l_shard;
+	struct pool_target	*spare_tgt;
+	d_list_t		*current;
+	uint32_t		 allow_status;
+	uint64_t		 skey;
+	unsigned int		 grp_start;
+	unsigned int		 k;
+	unsigned int		 j;
+	int			 dom;
+
+	remap_dump(remap_list, md, "before remap:");
+
+	allow_status = PO_COMP_ST_UPIN;
+	if (for_reint)
+		allow_status |= PO_COMP_ST_UP;
+
+	current = remap_list->next;
+	while (current != remap_list) {
+		f_shard = d_list_entry(current, struct failed_shard, fs_list);
+		k = f_shard->fs_shard_idx;
+		l_shard = &layout->ol_shards[k];
+
+		memset(ss->ss_dom_skip, 0, roundup(smap->smp_domain_nr, NBBY) / NBBY);
+		grp_start = k - k % sop->sop_grp_size;
+		for (j = grp_start; j < grp_start + sop->sop_grp_size; j++) {
+			if (j != k && ss->ss_shard_dom[j] >= 0)
+				setbit(ss->ss_dom_skip, ss->ss_shard_dom[j]);
+		}
+
+		skey = straw_hash(sop->sop_key, sop->sop_shard_id + k);
+		spare_tgt = NULL;
+		dom = straw_select_dom_reuse(smap, skey, for_reint, ss);
+		if (dom >= 0) {
+			spare_tgt = straw_select_tgt(smap, dom, skey, for_reint, ss);
+			D_ASSERT(spare_tgt != NULL);
+			straw_take(smap, ss, spare_tgt, dom);
+		}
+
+		D_DEBUG(DB_PL, "obj:"DF_OID", shard %u select spare %d\n",
+			DP_OID(md->omd_id), k,
+			spare_tgt != NULL ? spare_tgt->ta_comp.co_id : -1);
+
+		determine_valid_spares(spare_tgt, md, spare_tgt != NULL, &current,
+				       remap_list, allow_status, -1, f_shard, l_shard,
+				       NULL);
+
+		/* The shard now lives (or failed again) on the spare */
+		if (spare_tgt != NULL &&
+		    (l_shard->po_target == spare_tgt->ta_comp.co_id ||
+		     f_shard->fs_fseq == spare_tgt->ta_comp.co_fseq))
+			ss->ss_shard_dom[k] = dom;
+	}
+
+	remap_dump(remap_list, md, "after remap:");
+	return 0;
+}
+
+/**
+ * Fill @layout for the object, shards on unavailable targets are added to
+ * @remap_list and remapped to spares.
+ */
+static int
+straw_obj_layout_fill(struct pl_straw_map *smap, struct daos_obj_md *md,
+		      struct straw_obj_placement *sop, struct pl_obj_layout *layout,
+		      d_list_t *remap_list, bool for_reint)
+{
+	struct pool_target	*tgts;
+	struct pool_target	*tgt;
+	struct straw_scratch	 ss;
+	uint64_t		 skey;
+	unsigned int		 i;
+	unsigned int		 j;
+	unsigned int		 k;
+	int			 dom;
+	int			 rc;
+
+	layout->ol_ver = pl_map_version(&smap->smp_map);
+	layout->ol_grp_size = sop->sop_grp_size;
+	layout->ol_grp_nr = sop->sop_grp_nr;
+
+	tgts = pool_map_targets(smap->smp_map.pl_poolmap);
+	if (tgts == NULL)
+		return -DER_INVAL;
+
+	rc = straw_scratch_init(smap, layout->ol_nr, &ss);
+	if (rc != 0)
+		return rc;
+
+	for (i = 0, k = 0; i < sop->sop_grp_nr; i++) {
+		memset(ss.ss_dom_skip, 0, roundup(smap->smp_domain_nr, NBBY) / NBBY);
+
+		for (j = 0; j < sop->sop_grp_size; j++, k++) {
+			skey = straw_hash(sop->sop_key, sop->sop_shard_id + k);
+			if (k == 0 && sop->sop_spec_pos >= 0) {
+				tgt = &tgts[sop->sop_spec_pos];
+				dom = smap->smp_tgt2dom[sop->sop_spec_pos];
+			} else {
+				tgt = NULL;
+				dom = straw_select_dom_reuse(smap, skey, for_reint, &ss);
+				if (dom >= 0)
+					tgt = straw_select_tgt(smap, dom, skey, for_reint, &ss);
+			}
+
+			ss.ss_shard_dom[k] = -1;
+			if (tgt == NULL) {
+				/* Not enough targets for this shard */
+				layout->ol_shards[k].po_shard = -1;
+				layout->ol_shards[k].po_target = -1;
+				continue;
+			}
+
+			straw_take(smap, &ss, tgt, dom);
+			setbit(ss.ss_dom_skip, dom);
+			ss.ss_shard_dom[k] = dom;
+
+			layout->ol_shards[k].po_shard  = sop->sop_shard_id + k;
+			layout->ol_shards[k].po_target = tgt->ta_comp.co_id;
+			layout->ol_shards[k].po_fseq   = tgt->ta_comp.co_fseq;
+
+			if (pool_target_unavail(tgt, for_reint)) {
+				rc = remap_alloc_one(remap_list, k, tgt, for_reint, NULL);
+				if (rc)
+					D_GOTO(out, rc);
+			}
+		}
+	}
+
+	rc = straw_obj_remap_shards(smap, md, sop, layout, remap_list, &ss,
+				    for_reint);
+out:
+	straw_scratch_fini(&ss);
+	if (rc)
+		D_ERROR("straw_obj_layout_fill failed, rc "DF_RC"\n", DP_RC(rc));
+	return rc;
+}
+
+/**
+ * Compare the normal layout @layout with the layout @new_layout computed with
+ * the targets being added or reintegrated, and add the shards which move into
+ * @diff_list.
+ */
+static int
+straw_layout_find_diff(struct pl_straw_map *smap, struct pl_obj_layout *layout,
+		       struct pl_obj_layout *new_layout, d_list_t *diff_list)
+{
+	struct pool_target	*tgt;
+	uint32_t		 new_tgt;
+	int			 rc;
+	int			 i;
+
+	for (i = 0; i < layout->ol_nr; i++) {
+		new_tgt = new_layout->ol_shards[i].po_target;
+		if (new_tgt == -1 || new_tgt == layout->ol_shards[i].po_target)
+			continue;
+
+		rc = pool_map_find_target(smap->smp_map.pl_poolmap, new_tgt, &tgt);
+		D_ASSERT(rc == 1);
+		rc = remap_alloc_one(diff_list, i, tgt, true, NULL);
+		if (rc)
+			return rc;
+	}
+	return 0;
+}
+
+/** Allocate and fill a layout, the remap list is freed before return */
+static int
+straw_obj_layout_get(struct pl_straw_map *smap, struct daos_obj_md *md,
+		     struct straw_obj_placement *sop, bool for_reint,
+		     struct pl_obj_layout **layout_pp)
+{
+	struct pl_obj_layout	*layout;
+	d_list_t		 remap_list;
+	int			 rc;
+
+	rc = pl_obj_layout_alloc(sop->sop_grp_size, sop->sop_grp_nr, &layout);
+	if (rc)
+		return rc;
+
+	D_INIT_LIST_HEAD(&remap_list);
+	rc = straw_obj_layout_fill(smap, md, sop, layout, &remap_list, for_reint);
+	remap_list_free_all(&remap_list);
+	if (rc) {
+		pl_obj_layout_free(layout);
+		return rc;
+	}
+
+	*layout_pp = layout;
+	return 0;
+}
+
+static int
+straw_obj_place(struct pl_map *map, uint32_t gl_layout_ver, struct daos_obj_md *md,
+		unsigned int mode, uint32_t rebuild_ver, struct daos_obj_shard_md *shard_md,
+		struct pl_obj_layout **layout_pp)
+{
+	struct pl_straw_map		*smap = pl_map2smap(map);
+	struct straw_obj_placement	 sop;
+	struct pl_obj_layout		*layout = NULL;
+	struct pl_obj_layout		*extend_layout = NULL;
+	d_list_t			 extend_list;
+	int				 rc;
+
+	rc = straw_obj_placement_get(smap, md, shard_md, &sop);
+	if (rc) {
+		D_ERROR("straw_obj_placement_get failed, rc "DF_RC"\n", DP_RC(rc));
+		return rc;
+	}
+
+	D_INIT_LIST_HEAD(&extend_list);
+	rc = straw_obj_layout_get(smap, md, &sop, false, &layout);
+	if (rc)
+		D_GOTO(out, rc);
+
+	/*
+	 * While targets are being added or reintegrated, updates must also
+	 * reach the shards which are moving there.
+	 */
+	if (unlikely(smap->smp_extending) && !(mode & DAOS_OO_RO)) {
+		rc = straw_obj_layout_get(smap, md, &sop, true, &extend_layout);
+		if (rc)
+			D_GOTO(out, rc);
+
+		rc = straw_layout_find_diff(smap, layout, extend_layout, &extend_list);
+		if (rc)
+			D_GOTO(out, rc);
+
+		rc = pl_map_extend(layout, &extend_list);
+		if (rc)
+			D_GOTO(out, rc);
+	}
+
+	obj_layout_dump(md->omd_id, layout);
+	*layout_pp = layout;
+out:
+	remap_list_free_all(&extend_list);
+	if (extend_layout != NULL)
+		pl_obj_layout_free(extend_layout);
+	if (rc != 0) {
+		D_ERROR("Could not generate placement layout, rc "DF_RC"\n", DP_RC(rc));
+		if (layout != NULL)
+			pl_obj_layout_free(layout);
+	}
+	return rc;
+}
+
+static int
+straw_obj_find_rebuild(struct pl_map *map, uint32_t gl_layout_ver, struct daos_obj_md *md,
+		       struct daos_obj_shard_md *shard_md, uint32_t rebuild_ver,
+		       uint32_t *tgt_id, uint32_t *shard_idx, unsigned int array_size)
+{
+	struct pl_straw_map		*smap = pl_map2smap(map);
+	struct straw_obj_placement	 sop;
+	struct pl_obj_layout		*layout;
+	d_list_t			 remap_list;
+	int				 idx = 0;
+	int				 rc;
+
+	/* Caller should guarantee the pl_map is up-to-date */
+	if (pl_map_version(map) < rebuild_ver) {
+		D_ERROR("pl_map version(%u) < rebuild version(%u)\n",
+			pl_map_version(map), rebuild_ver);
+		return -DER_INVAL;
+	}
+
+	rc = straw_obj_placement_get(smap, md, shard_md, &sop);
+	if (rc)
+		return rc;
+
+	rc = pl_obj_layout_alloc(sop.sop_grp_size, sop.sop_grp_nr, &layout);
+	if (rc)
+		return rc;
+
+	D_INIT_LIST_HEAD(&remap_list);
+	rc = straw_obj_layout_fill(smap, md, &sop, layout, &remap_list, false);
+	if (rc)
+		goto out;
+
+	rc = remap_list_fill(map, md, shard_md, rebuild_ver, tgt_id, shard_idx,
+			     array_size, &idx, layout, &remap_list, false);
+out:
+	remap_list_free_all(&remap_list);
+	pl_obj_layout_free(layout);
+	return rc < 0 ? rc : idx;
+}
+
+/**
+ * Find the shards which move to the targets being added or reintegrated, with
+ * straw2 these are exactly the shards won by those targets.
+ */
+static int
+straw_obj_find_moving(struct pl_map *map, struct daos_obj_md *md,
+		      struct daos_obj_shard_md *shard_md, uint32_t reint_ver,
+		      uint32_t *tgt_rank, uint32_t *shard_id, unsigned int array_size,
+		      bool for_addition)
+{
+	struct pl_straw_map		*smap = pl_map2smap(map);
+	struct straw_obj_placement	 sop;
+	struct pl_obj_layout		*layout = NULL;
+	struct pl_obj_layout		*reint_layout = NULL;
+	d_list_t			 reint_list;
+	int				 idx = 0;
+	int				 rc;
+
+	/* Caller should guarantee the pl_map is up-to-date */
+	if (pl_map_version(map) < reint_ver) {
+		D_ERROR("pl_map version(%u) < reintegration version(%u)\n",
+			pl_map_version(map), reint_ver);
+		return -DER_INVAL;
+	}
+
+	rc = straw_obj_placement_get(smap, md, shard_md, &sop);
+	if (rc)
+		return rc;
+
+	D_INIT_LIST_HEAD(&reint_list);
+	rc = straw_obj_layout_get(smap, md, &sop, false, &layout);
+	if (rc)
+		D_GOTO(out, rc);
+
+	rc = straw_obj_layout_get(smap, md, &sop, true, &reint_layout);
+	if (rc)
+		D_GOTO(out, rc);
+
+	rc = straw_layout_find_diff(smap, layout, reint_layout, &reint_list);
+	if (rc)
+		D_GOTO(out, rc);
+
+	rc = remap_list_fill(map, md, shard_md, reint_ver, tgt_rank, shard_id,
+			     array_size, &idx, reint_layout, &reint_list,
+			     for_addition);
+out:
+	remap_list_free_all(&reint_list);
+	if (layout != NULL)
+		pl_obj_layout_free(layout);
+	if (reint_layout != NULL)
+		pl_obj_layout_free(reint_layout);
+	return rc < 0 ? rc : idx;
+}
+
+static int
+straw_obj_find_reint(struct pl_map *map, uint32_t gl_layout_ver, struct daos_obj_md *md,
+		     struct daos_obj_shard_md *shard_md, uint32_t reint_ver,
+		     uint32_t *tgt_rank, uint32_t *shard_id, unsigned int array_size)
+{
+	return straw_obj_find_moving(map, md, shard_md, reint_ver, tgt_rank,
+				     shard_id, array_size, false);
+}
+
+static int
+straw_obj_find_addition(struct pl_map *map, uint32_t gl_layout_ver, struct daos_obj_md *md,
+			struct daos_obj_shard_md *shard_md, uint32_t reint_ver,
+			uint32_t *tgt_rank, uint32_t *shard_id, unsigned int array_size)
+{
+	return straw_obj_find_moving(map, md, shard_md, reint_ver, tgt_rank,
+				     shard_id, array_size, true);
+}
+
+/** API for generic placement map functionality */
+struct pl_map_ops	straw_map_ops = {
+	.o_create		= straw_map_create,
+	.o_destroy		= straw_map_destroy,
+	.o_print		= straw_map_print,
+	.o_query		= straw_map_query,
+	.o_obj_place		= straw_obj_place,
+	.o_obj_find_rebuild	= straw_obj_find_rebuild,
+	.o_obj_find_reint	= straw_obj_find_reint,
+	.o_obj_find_addition	= straw_obj_find_addition,
+};
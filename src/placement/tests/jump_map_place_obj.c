@@ -1906,6 +1906,99 @@ large_shards_over_limited_targets(void **state)
 	jtc_fini(&ctx);
 }
 
+static void
+batch_placement_matches_single(void **state)
+{
+	struct jm_test_ctx	 ctx;
+	daos_oclass_id_t	 classes[] = {OC_RP_3G2, OC_EC_4P2G2, OC_S1,
+					      OC_RP_2GX};
+	struct daos_obj_md	 mds[64];
+	struct pl_obj_layout	*layouts[64];
+	struct pl_obj_layout	*layout;
+	int			 i, j;
+
+	jtc_init(&ctx, 8, 2, 4, OC_RP_3G2, g_verbose);
+	/* some layouts need remap with a target down */
+	jtc_set_status_on_target(&ctx, DOWN, 3);
+
+	memset(mds, 0, sizeof(mds));
+	for (i = 0; i < ARRAY_SIZE(mds); i++) {
+		/* consecutive objects share the class, to reuse the jmop */
+		gen_oid(&mds[i].omd_id, i, i * 7, classes[(i / 5) % ARRAY_SIZE(classes)]);
+		mds[i].omd_ver = ctx.ver;
+	}
+
+	assert_success(pl_obj_place_batch(ctx.pl_map, 0, mds, ARRAY_SIZE(mds), 0, -1,
+					  layouts));
+
+	for (i = 0; i < ARRAY_SIZE(mds); i++) {
+		assert_success(pl_obj_place(ctx.pl_map, 0, &mds[i], 0, -1, NULL, &layout));
+		assert_int_equal(layout->ol_nr, layouts[i]->ol_nr);
+		for (j = 0; j < layout->ol_nr; j++) {
+			assert_int_equal(layout->ol_shards[j].po_target,
+					 layouts[i]->ol_shards[j].po_target);
+			assert_int_equal(layout->ol_shards[j].po_shard,
+					 layouts[i]->ol_shards[j].po_shard);
+			assert_int_equal(layout->ol_shards[j].po_rebuilding,
+					 layouts[i]->ol_shards[j].po_rebuilding);
+		}
+		pl_obj_layout_free(layout);
+		pl_obj_layout_free(layouts[i]);
+	}
+
+	jtc_fini(&ctx);
+}
+
+static void
+flat_pool_map_lookups(void **state)
+{
+	struct jm_test_ctx	 ctx;
+	struct pool_map_flat	*flat;
+	struct pool_flat_layer	*rank_layer = NULL;
+	struct pool_target	*tgts;
+	struct pool_target	*tgt;
+	struct pool_domain	*doms;
+	struct pool_domain	*dom;
+	int			 tgt_nr;
+	int			 dom_nr;
+	int			 i;
+
+	jtc_init(&ctx, 4, 2, 8, OC_RP_2G1, g_verbose);
+
+	flat = pool_map_flat_get(ctx.po_map);
+	assert_non_null(flat);
+	assert_non_null(flat->pf_tgt_id2idx);
+
+	tgt_nr = pool_map_find_target(ctx.po_map, PO_COMP_ID_ALL, &tgts);
+	assert_int_equal(tgt_nr, flat->pf_tgt_nr);
+	for (i = 0; i < tgt_nr; i++) {
+		assert_int_equal(pool_map_find_target(ctx.po_map, tgts[i].ta_comp.co_id, &tgt), 1);
+		assert_ptr_equal(tgt, &tgts[i]);
+	}
+	assert_int_equal(pool_map_find_target(ctx.po_map, tgt_nr + 100, &tgt), 0);
+
+	dom_nr = pool_map_find_nodes(ctx.po_map, PO_COMP_ID_ALL, &doms);
+	assert_true(dom_nr > 0);
+	for (i = 0; i < flat->pf_layer_nr; i++) {
+		if (flat->pf_layers[i].fl_type == PO_COMP_TP_RANK)
+			rank_layer = &flat->pf_layers[i];
+	}
+	assert_non_null(rank_layer);
+	assert_int_equal(rank_layer->fl_nr, dom_nr);
+	for (i = 0; i < dom_nr; i++) {
+		assert_int_equal(pool_map_find_nodes(ctx.po_map, doms[i].do_comp.co_id, &dom), 1);
+		assert_ptr_equal(dom, &doms[i]);
+		assert_ptr_equal(pool_map_find_node_by_rank(ctx.po_map, doms[i].do_comp.co_rank),
+				 &doms[i]);
+		/* targets of a domain start at the cumulative target count */
+		assert_ptr_equal(doms[i].do_targets,
+				 &tgts[flat->pf_tgt_start[rank_layer->fl_start + i]]);
+	}
+	assert_null(pool_map_find_node_by_rank(ctx.po_map, dom_nr + 100));
+
+	jtc_fini(&ctx);
+}
+
 /*
  * ------------------------------------------------
  * End Test Cases
@@ -1988,6 +2081,10 @@ static const struct CMUnitTest tests[] = {
 	  unbalanced_config),
 	T("shards in the same group not in the same domain",
 	  same_group_shards_not_in_same_domain),
+	T("Batched placement generates the same layouts as single placement",
+	  batch_placement_matches_single),
+	T("Flattened pool map lookups match the component tree",
+	  flat_pool_map_lookups),
 	T("large shards over limited targets",
 	  large_shards_over_limited_targets),
 };
@@ -132,6 +132,7 @@ benchmark_placement_usage()
 		"      Possible values:\n"
 		"          PL_TYPE_RING\n"
 		"          PL_TYPE_JUMP_MAP\n"
+		"          PL_TYPE_STRAW_MAP\n"
 		"\n"
 		"Optional Arguments\n"
 		"  --vtune-loop\n"
@@ -171,6 +172,9 @@ benchmark_placement(int argc, char **argv, uint32_t num_domains,
 			} else if (strncmp(optarg, "PL_TYPE_JUMP_MAP", 15)
 				   == 0) {
 				map_type = PL_TYPE_JUMP_MAP;
+			} else if (strncmp(optarg, "PL_TYPE_STRAW_MAP", 17)
+				   == 0) {
+				map_type = PL_TYPE_STRAW_MAP;
 			} else {
 				D_PRINT("ERROR: Unknown map-type '%s'\n",
 					optarg);
@@ -278,6 +282,7 @@ benchmark_add_data_movement_usage()
 		"      Possible values:\n"
 		"          PL_TYPE_RING\n"
 		"          PL_TYPE_JUMP_MAP\n"
+		"          PL_TYPE_STRAW_MAP\n"
 		"\n"
 		"Optional Arguments\n"
 		"  --num-domains-to-add <num>\n"
@@ -426,6 +431,12 @@ benchmark_add_data_movement(int argc, char **argv, uint32_t num_domains,
 						PL_TYPE_JUMP_MAP;
 					map_keys[num_map_types] =
 						"PL_TYPE_JUMP_MAP";
+				} else if (strncmp(token, "PL_TYPE_STRAW_MAP",
+						   17) == 0) {
+					map_types[num_map_types] =
+						PL_TYPE_STRAW_MAP;
+					map_keys[num_map_types] =
+						"PL_TYPE_STRAW_MAP";
 				} else {
 					D_PRINT("ERROR: Unknown map-type: %s\n",
 						token);
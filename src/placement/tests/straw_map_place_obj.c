@@ -0,0 +1,312 @@
+/**
+ * (C) Copyright 2016-2022 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+#define D_LOGFAC        DD_FAC(tests)
+
+#include <daos/common.h>
+#include <daos/placement.h>
+#include <daos.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <daos/tests_lib.h>
+#include "place_obj_common.h"
+
+#define DOM_NR          8
+#define DOM_ADD_NR      2
+#define NODE_PER_DOM    1
+#define VOS_PER_TARGET  4
+#define SPARE_MAX_NUM   (DOM_NR * 3)
+#define OBJ_NR		1000
+
+#define COMPONENT_NR    (DOM_NR + DOM_NR * NODE_PER_DOM + \
+			 DOM_NR * NODE_PER_DOM * VOS_PER_TARGET)
+#define BIG_COMPONENT_NR (COMPONENT_NR + (DOM_ADD_NR + DOM_ADD_NR * NODE_PER_DOM + \
+			  DOM_ADD_NR * NODE_PER_DOM * VOS_PER_TARGET))
+
+static bool                      pl_debug_msg;
+
+static void
+oid_gen(daos_obj_id_t *oid, daos_oclass_id_t cid, uint64_t lo)
+{
+	int rc;
+
+	oid->lo = lo;
+	oid->hi = 5;
+	rc = daos_obj_set_oid_by_class(oid, 0, cid, 0);
+	D_ASSERT(rc == 0);
+}
+
+/* Shards of the same group must sit on different ranks */
+static void
+plt_obj_grp_rank_check(struct pl_obj_layout *layout, struct pool_map *po_map)
+{
+	struct pool_target	*tgt_a;
+	struct pool_target	*tgt_b;
+	int			 i;
+	int			 j;
+	int			 grp;
+
+	for (grp = 0; grp < layout->ol_grp_nr; grp++) {
+		for (i = 0; i < layout->ol_grp_size; i++) {
+			pool_map_find_target(po_map, layout->ol_shards[grp * layout->ol_grp_size +
+					     i].po_target, &tgt_a);
+			for (j = i + 1; j < layout->ol_grp_size; j++) {
+				pool_map_find_target(po_map,
+						     layout->ol_shards[grp * layout->ol_grp_size +
+						     j].po_target, &tgt_b);
+				D_ASSERT(tgt_a->ta_comp.co_rank != tgt_b->ta_comp.co_rank);
+			}
+		}
+	}
+}
+
+/*
+ * Place the same objects on a pool map with DOM_ADD_NR more ranks, only the
+ * shards won by the new ranks should move.
+ */
+static void
+straw_addition_movement(daos_oclass_id_t cid, bool strict)
+{
+	struct pool_map		*po_map;
+	struct pool_map		*po_map_big;
+	struct pl_map		*pl_map;
+	struct pl_map		*pl_map_big;
+	struct pl_obj_layout	*lo;
+	struct pl_obj_layout	*lo_big;
+	daos_obj_id_t		 oid;
+	unsigned int		 old_tgt_nr = DOM_NR * NODE_PER_DOM * VOS_PER_TARGET;
+	unsigned int		 moved = 0;
+	unsigned int		 moved_old = 0;
+	unsigned int		 total = 0;
+	int			 i;
+	int			 j;
+
+	gen_pool_and_placement_map(DOM_NR, NODE_PER_DOM, VOS_PER_TARGET,
+				   PL_TYPE_STRAW_MAP, &po_map, &pl_map);
+	gen_pool_and_placement_map(DOM_NR + DOM_ADD_NR, NODE_PER_DOM,
+				   VOS_PER_TARGET, PL_TYPE_STRAW_MAP,
+				   &po_map_big, &pl_map_big);
+
+	for (i = 0; i < OBJ_NR; i++) {
+		oid_gen(&oid, cid, i);
+		assert_success(plt_obj_place(oid, &lo, pl_map, false));
+		assert_success(plt_obj_place(oid, &lo_big, pl_map_big, false));
+		plt_obj_layout_check(lo_big, BIG_COMPONENT_NR, 0);
+		plt_obj_grp_rank_check(lo_big, po_map_big);
+
+		D_ASSERT(lo->ol_nr == lo_big->ol_nr);
+		for (j = 0; j < lo->ol_nr; j++) {
+			total++;
+			if (lo->ol_shards[j].po_target == lo_big->ol_shards[j].po_target)
+				continue;
+			moved++;
+			if (lo_big->ol_shards[j].po_target < old_tgt_nr)
+				moved_old++;
+		}
+		pl_obj_layout_free(lo);
+		pl_obj_layout_free(lo_big);
+	}
+
+	D_PRINT("moved %u/%u shards, %u between old ranks (ideal %u)\n", moved,
+		total, moved_old, total * DOM_ADD_NR / (DOM_NR + DOM_ADD_NR));
+	/* ideal is DOM_ADD_NR / (DOM_NR + DOM_ADD_NR) = 20% */
+	D_ASSERT(moved * 10 <= total * 3);
+	if (strict)
+		D_ASSERT(moved_old == 0);
+
+	free_pool_and_placement_map(po_map, pl_map);
+	free_pool_and_placement_map(po_map_big, pl_map_big);
+}
+
+/* Ranks with more targets get proportionally more shards */
+static void
+straw_weighted_placement(void)
+{
+	struct pool_map		*po_map;
+	struct pl_map		*pl_map;
+	struct pl_obj_layout	*lo;
+	daos_obj_id_t		 oid;
+	int			 domain_targets[] = {8, 4, 4, 4};
+	unsigned int		 on_big = 0;
+	int			 i;
+
+	gen_pool_and_placement_map_non_standard(ARRAY_SIZE(domain_targets),
+						domain_targets, PL_TYPE_STRAW_MAP,
+						&po_map, &pl_map);
+
+	for (i = 0; i < OBJ_NR; i++) {
+		oid_gen(&oid, OC_S1, i);
+		assert_success(plt_obj_place(oid, &lo, pl_map, false));
+		if (lo->ol_shards[0].po_target < domain_targets[0])
+			on_big++;
+		pl_obj_layout_free(lo);
+	}
+
+	/* 8 of 20 targets, expect about 40% */
+	D_PRINT("%u/%u shards on the big rank\n", on_big, OBJ_NR);
+	D_ASSERT(on_big * 10 >= OBJ_NR * 3 && on_big * 10 <= OBJ_NR * 5);
+
+	free_pool_and_placement_map(po_map, pl_map);
+}
+
+/*
+ * GX objects take all the targets, on uneven ranks the last groups have to
+ * reuse a rank once the small ones are full.
+ */
+static void
+straw_gx_non_standard(daos_oclass_id_t cid)
+{
+	struct pool_map		*po_map;
+	struct pl_map		*pl_map;
+	struct pl_obj_layout	*lo;
+	struct pool_target	*tgt_a;
+	struct pool_target	*tgt_b;
+	daos_obj_id_t		 oid;
+	int			 domain_targets[] = {8, 4, 4, 4};
+	unsigned int		 tgt_nr = 20;
+	unsigned int		 shared = 0;
+	int			 grp;
+	int			 i;
+	int			 j;
+
+	gen_pool_and_placement_map_non_standard(ARRAY_SIZE(domain_targets),
+						domain_targets, PL_TYPE_STRAW_MAP,
+						&po_map, &pl_map);
+
+	for (i = 0; i < OBJ_NR; i++) {
+		oid_gen(&oid, cid, i);
+		assert_success(plt_obj_place(oid, &lo, pl_map, false));
+		D_ASSERT(lo->ol_grp_nr == tgt_nr / lo->ol_grp_size);
+		/* every shard gets a target, no target is used twice */
+		plt_obj_layout_check(lo, tgt_nr, 0);
+
+		for (grp = 0; grp < lo->ol_grp_nr; grp++) {
+			j = grp * lo->ol_grp_size;
+			pool_map_find_target(po_map, lo->ol_shards[j].po_target, &tgt_a);
+			pool_map_find_target(po_map, lo->ol_shards[j + 1].po_target, &tgt_b);
+			if (tgt_a->ta_comp.co_rank == tgt_b->ta_comp.co_rank)
+				shared++;
+		}
+		pl_obj_layout_free(lo);
+	}
+
+	D_PRINT("%u groups share a rank\n", shared);
+	free_pool_and_placement_map(po_map, pl_map);
+}
+
+int
+main(int argc, char **argv)
+{
+	int			 i;
+	struct pool_map		*po_map;
+	struct pl_obj_layout	*lo_1;
+	struct pl_obj_layout	*lo_2;
+	struct pl_obj_layout	*lo_3;
+	struct pl_obj_layout	*lo_4;
+	struct pl_map		*pl_map;
+	uuid_t			 pl_uuid;
+	daos_obj_id_t		 oid;
+	uint32_t		 spare_tgt_ranks[SPARE_MAX_NUM];
+	uint32_t		 shard_ids[SPARE_MAX_NUM];
+	uint32_t		 failed_tgts[SPARE_MAX_NUM];
+	static uint32_t		 po_ver;
+	unsigned int		 spare_cnt;
+	int			 rc;
+
+	po_ver = 1;
+	rc = daos_debug_init(DAOS_LOG_DEFAULT);
+	if (rc != 0)
+		return rc;
+
+	rc = pl_init();
+	if (rc != 0) {
+		daos_debug_fini();
+		return rc;
+	}
+
+	gen_pool_and_placement_map(DOM_NR, NODE_PER_DOM,
+				   VOS_PER_TARGET, PL_TYPE_STRAW_MAP,
+				   &po_map, &pl_map);
+	D_ASSERT(po_map != NULL);
+	D_ASSERT(pl_map != NULL);
+	pool_map_print(po_map);
+	pl_map_print(pl_map);
+
+	uuid_generate(pl_uuid);
+	srand(time(NULL));
+	oid_gen(&oid, OC_RP_4G2, rand());
+
+	/* initial placement when all nodes alive */
+	D_PRINT("\ntest initial placement when no failed shard ...\n");
+	assert_success(plt_obj_place(oid, &lo_1, pl_map, true));
+	plt_obj_layout_check(lo_1, COMPONENT_NR, 0);
+	plt_obj_grp_rank_check(lo_1, po_map);
+
+	D_PRINT("\ntest to fail all shards and new placement ...\n");
+	for (i = 0; i < SPARE_MAX_NUM && i < lo_1->ol_nr; i++)
+		plt_fail_tgt(lo_1->ol_shards[i].po_target, &po_ver, po_map,
+			     pl_debug_msg);
+	assert_success(plt_obj_place(oid, &lo_2, pl_map, true));
+	plt_obj_layout_check(lo_2, COMPONENT_NR, 0);
+	for (i = 0; i < lo_1->ol_nr; i++)
+		D_ASSERT(lo_1->ol_shards[i].po_target != lo_2->ol_shards[i].po_target);
+
+	D_PRINT("\ntest to add back all failed shards and new placement ...\n");
+	for (i = 0; i < SPARE_MAX_NUM && i < lo_1->ol_nr; i++)
+		plt_reint_tgt_up(lo_1->ol_shards[i].po_target, &po_ver, po_map,
+				 pl_debug_msg);
+	assert_success(plt_obj_place(oid, &lo_3, pl_map, true));
+	plt_obj_layout_check(lo_3, COMPONENT_NR, 0);
+	D_ASSERT(plt_obj_layout_match(lo_1, lo_3));
+
+	/* the spares reported by rebuild must match the degraded layout */
+	D_PRINT("\ntest pl_obj_find_rebuild to get correct spare targets ...\n");
+	failed_tgts[0] = lo_3->ol_shards[0].po_target;
+	failed_tgts[1] = lo_3->ol_shards[1].po_target;
+	for (i = 0; i < 2; i++)
+		plt_fail_tgt(failed_tgts[i], &po_ver, po_map, pl_debug_msg);
+	assert_success(plt_obj_place(oid, &lo_4, pl_map, true));
+	plt_obj_layout_check(lo_4, COMPONENT_NR, 0);
+	plt_obj_grp_rank_check(lo_4, po_map);
+	for (i = 2; i < lo_4->ol_nr; i++)
+		D_ASSERT(lo_4->ol_shards[i].po_target == lo_3->ol_shards[i].po_target);
+	for (i = 0; i < 2; i++)
+		plt_reint_tgt_up(failed_tgts[i], &po_ver, po_map, pl_debug_msg);
+
+	plt_spare_tgts_get(pl_uuid, oid, failed_tgts, 2, spare_tgt_ranks,
+			   pl_debug_msg, shard_ids, &spare_cnt, &po_ver,
+			   PL_TYPE_STRAW_MAP, SPARE_MAX_NUM, po_map, pl_map);
+	plt_obj_rebuild_unique_check(shard_ids, spare_cnt, COMPONENT_NR);
+	D_ASSERT(spare_cnt == 2);
+	for (i = 0; i < spare_cnt; i++) {
+		D_ASSERT(shard_ids[i] == 0 || shard_ids[i] == 1);
+		D_ASSERT(spare_tgt_ranks[i] == lo_4->ol_shards[shard_ids[i]].po_target);
+	}
+
+	pl_obj_layout_free(lo_1);
+	pl_obj_layout_free(lo_2);
+	pl_obj_layout_free(lo_3);
+	pl_obj_layout_free(lo_4);
+	free_pool_and_placement_map(po_map, pl_map);
+
+	D_PRINT("\ntest data movement when ranks are added ...\n");
+	straw_addition_movement(OC_S1, true);
+	straw_addition_movement(OC_RP_3G1, false);
+
+	D_PRINT("\ntest placement on ranks with different target counts ...\n");
+	straw_weighted_placement();
+
+	D_PRINT("\ntest GX objects on ranks with different target counts ...\n");
+	straw_gx_non_standard(OC_RP_2GX);
+	straw_gx_non_standard(OC_RP_3GX);
+
+	pl_fini();
+	daos_debug_fini();
+	D_PRINT("\nall tests passed!\n");
+	return 0;
+}
@@ -19,6 +19,7 @@
 #include "srv_internal.h"
 #include "srv_layout.h"
 bool ec_agg_disabled;
+bool pool_bcast_domain;
 
 static int
 init(void)
@@ -46,6 +47,11 @@ init(void)
 	if (unlikely(ec_agg_disabled))
 		D_WARN("EC aggregation is disabled.\n");
 
+	pool_bcast_domain = false;
+	d_getenv_bool("DAOS_POOL_BCAST_DOMAIN", &pool_bcast_domain);
+	if (pool_bcast_domain)
+		D_INFO("Pool broadcasts use fault domain aware trees.\n");
+
 	ds_pool_rsvc_class_register();
 
 	bio_register_ract_ops(&nvme_reaction_ops);
@@ -336,6 +336,7 @@ scrubbing_ult(void *arg)
 	ctx.sc_dmi =  dss_get_module_info();
 	ctx.sc_drain_pool_tgt_fn = drain_pool_tgt_cb;
 	ctx.sc_is_idle_fn = is_idle;
+	ctx.sc_io_lat_fn = sched_cycle_latency;
 
 	sc_add_pool_metrics(&ctx);
 	while (!dss_ult_exiting(child->spc_scrubbing_req)) {
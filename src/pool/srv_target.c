@@ -1354,6 +1354,86 @@ ds_pool_tgt_disconnect_aggregator(crt_rpc_t *source, crt_rpc_t *result,
 	return 0;
 }
 
+struct pool_domains_arg {
+	d_rank_list_t	 pda_ranks;
+	uint32_t	*pda_nodes;
+	uint32_t	*pda_racks;
+};
+
+/*
+ * Record the node and rack of each rank under \a dom. The domain right above
+ * the ranks is the node, the one above it is the rack. Ranks directly under
+ * the root are nodes of their own.
+ */
+static void
+pool_domains_collect(struct pool_domain *dom, struct pool_domain *parent,
+		     struct pool_domains_arg *arg)
+{
+	struct pool_domain	*child;
+	uint32_t		 nr;
+	int			 i;
+
+	for (i = 0; i < dom->do_child_nr; i++) {
+		child = &dom->do_children[i];
+		if (child->do_comp.co_type != PO_COMP_TP_RANK) {
+			pool_domains_collect(child, dom, arg);
+			continue;
+		}
+
+		nr = arg->pda_ranks.rl_nr++;
+		arg->pda_ranks.rl_ranks[nr] = child->do_comp.co_rank;
+		if (parent == NULL) {
+			arg->pda_nodes[nr] = child->do_comp.co_rank;
+			arg->pda_racks[nr] = 0;
+		} else {
+			arg->pda_nodes[nr] = dom->do_comp.co_id;
+			arg->pda_racks[nr] = parent->do_comp.co_type == PO_COMP_TP_ROOT ?
+					     0 : parent->do_comp.co_id;
+		}
+	}
+}
+
+/* Pass the fault domains of the pool map to CaRT for CRT_TREE_DOMAIN. */
+static int
+update_pool_domains(struct ds_pool *pool, struct pool_map *map)
+{
+	struct pool_domains_arg	 arg = { 0 };
+	struct pool_domain	*root;
+	int			 nr;
+	int			 rc;
+
+	nr = pool_map_find_domain(map, PO_COMP_TP_RANK, PO_COMP_ID_ALL, NULL);
+	if (nr <= 0 ||
+	    pool_map_find_domain(map, PO_COMP_TP_ROOT, PO_COMP_ID_ALL, &root) != 1)
+		return 0;
+
+	D_ALLOC_ARRAY(arg.pda_ranks.rl_ranks, nr);
+	D_ALLOC_ARRAY(arg.pda_nodes, nr);
+	D_ALLOC_ARRAY(arg.pda_racks, nr);
+	if (arg.pda_ranks.rl_ranks == NULL || arg.pda_nodes == NULL ||
+	    arg.pda_racks == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+
+	pool_domains_collect(root, NULL, &arg);
+	D_ASSERTF(arg.pda_ranks.rl_nr == nr, "%u != %d\n", arg.pda_ranks.rl_nr, nr);
+
+	/*
+	 * Pool ranks are primary ranks (see update_pool_group), set them on the
+	 * primary group, as the ranks joining the pool are not members of
+	 * sp_group yet.
+	 */
+	rc = crt_group_domains_set(crt_group_lookup(NULL), &arg.pda_ranks,
+				   arg.pda_nodes, arg.pda_racks);
+	if (rc != 0)
+		D_ERROR(DF_UUID": failed to set domains: "DF_RC"\n",
+			DP_UUID(pool->sp_uuid), DP_RC(rc));
+out:
+	D_FREE(arg.pda_ranks.rl_ranks);
+	D_FREE(arg.pda_nodes);
+	D_FREE(arg.pda_racks);
+	return rc;
+}
+
 static int
 update_pool_group(struct ds_pool *pool, struct pool_map *map)
 {
@@ -1366,6 +1446,16 @@ update_pool_group(struct ds_pool *pool, struct pool_map *map)
 	D_DEBUG(DB_MD, DF_UUID": %u -> %u\n", DP_UUID(pool->sp_uuid), version,
 		pool_map_get_version(map));
 
+	/*
+	 * Domains go first, so that a rank seeing the new group version also
+	 * builds the same domain trees as the others.
+	 */
+	if (pool_bcast_domain) {
+		rc = update_pool_domains(pool, map);
+		if (rc != 0)
+			return rc;
+	}
+
 	rc = map_ranks_init(map, PO_COMP_ST_UP | PO_COMP_ST_UPIN |
 			    PO_COMP_ST_DRAIN, &ranks);
 	if (rc != 0)
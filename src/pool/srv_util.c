@@ -75,6 +75,18 @@ map_ranks_fini(d_rank_list_t *ranks)
 	}
 }
 
+/* Fan-out per level of the domain tree, see CRT_TREE_DOMAIN */
+#define POOL_BCAST_DOMAIN_RATIO	16
+
+/* Tree topology of the pool collective RPCs, see DAOS_POOL_BCAST_DOMAIN */
+int
+ds_pool_bcast_topo(void)
+{
+	if (pool_bcast_domain)
+		return crt_tree_topo(CRT_TREE_DOMAIN, POOL_BCAST_DOMAIN_RATIO);
+	return crt_tree_topo(CRT_TREE_KNOMIAL, 32);
+}
+
 int
 ds_pool_bcast_create(crt_context_t ctx, struct ds_pool *pool,
 		     enum daos_module_id module, crt_opcode_t opcode,
@@ -107,7 +119,7 @@ ds_pool_bcast_create(crt_context_t ctx, struct ds_pool *pool,
 	rc = crt_corpc_req_create(ctx, pool->sp_group,
 			  excluded.rl_nr == 0 ? NULL : &excluded,
 			  opc, bulk_hdl/* co_bulk_hdl */, NULL /* priv */,
-			  0 /* flags */, crt_tree_topo(CRT_TREE_KNOMIAL, 32),
+			  0 /* flags */, ds_pool_bcast_topo(),
 			  rpc);
 
 out:
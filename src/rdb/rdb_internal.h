@@ -94,6 +94,15 @@ struct rdb {
 	ABT_thread		d_compactd;
 	size_t			d_ae_max_size;
 	unsigned int		d_ae_max_entries;
+	unsigned int		d_ae_pipeline;	/* max AE RPCs in flight per node */
+	bool			d_ae_heartbeat;	/* in raft_periodic() */
+	unsigned int		d_is_pipeline;	/* max IS chunks in flight per node */
+	int			d_is_compress;	/* DAOS_COMPRESS_TYPE of IS chunks */
+	struct daos_compressor *d_is_compressor; /* of d_is_compress */
+	struct daos_compressor *d_is_decompressor; /* of received IS chunks */
+	int			d_is_decompress; /* type of d_is_decompressor */
+	unsigned int		d_lease_timeout; /* leader lease (ms); 0 disables */
+	double			d_leader_contact; /* last AE from leader (s) */
 };
 
 /* thresholds of free space for a leader to avoid appending new log entries
@@ -133,12 +142,35 @@ struct rdb *rdb_lookup(const uuid_t uuid);
  * Per-raft_node_t INSTALLSNAPSHOT state
  *
  * dis_seq and dis_anchor track the last chunk successfully received by the
- * follower.
+ * follower. dis_next_seq and dis_next_anchor track the last chunk sent, so
+ * that up to d_is_pipeline chunks may be in flight. Whenever the chunks in
+ * flight are forgotten, dis_round is bumped; each chunk carries the round it
+ * was sent in, so that replies to earlier rounds do not release dis_inflight
+ * slots of the current one.
  */
 struct rdb_raft_is {
 	uint64_t		dis_index;	/* snapshot index */
 	uint64_t		dis_seq;	/* last sequence number */
 	struct rdb_anchor	dis_anchor;	/* last anchor */
+	uint64_t		dis_next_seq;	/* last sequence number sent */
+	struct rdb_anchor	dis_next_anchor; /* last anchor sent */
+	unsigned int		dis_inflight;	/* outstanding chunks */
+	uint64_t		dis_round;	/* of chunks in flight */
+};
+
+/*
+ * Per-raft_node_t APPENDENTRIES pipeline state
+ *
+ * raft itself keeps at most one APPENDENTRIES request with entries in flight
+ * per node. dap_next is the index following the last entry sent in the
+ * dap_inflight requests still outstanding in term dap_term, so that more
+ * requests can be sent for the entries appended since. Heartbeats, i.e. AE
+ * requests without entries, are not counted.
+ */
+struct rdb_raft_ae_pipe {
+	uint64_t		dap_term;	/* of leader */
+	uint64_t		dap_next;	/* next index to send */
+	unsigned int		dap_inflight;	/* outstanding AE RPCs */
 };
 
 /* Per-raft_node_t data */
@@ -148,6 +180,9 @@ struct rdb_raft_node {
 	/* Leader fields */
 	uint64_t		dn_term;	/* of leader */
 	struct rdb_raft_is	dn_is;
+	struct rdb_raft_ae_pipe	dn_ae;
+	uint64_t		dn_lease_term;	/* of dn_lease_ack */
+	double			dn_lease_ack;	/* send time of last acked AE */
 };
 
 int rdb_raft_init(daos_handle_t pool, daos_handle_t mc, const d_rank_list_t *replicas);
@@ -159,6 +194,16 @@ void rdb_raft_resign(struct rdb *db, uint64_t term);
 int rdb_raft_campaign(struct rdb *db);
 int rdb_raft_ping(struct rdb *db, uint64_t caller_term);
 int rdb_raft_verify_leadership(struct rdb *db);
+bool rdb_raft_lease_valid(struct rdb *db);
+bool rdb_raft_lease_held(struct rdb *db);
+bool rdb_raft_ae_pipe_trim(struct rdb_raft_ae_pipe *pipe, unsigned int depth,
+			   const msg_appendentries_t *msg, bool heartbeat,
+			   msg_appendentries_t *trimmed);
+void rdb_raft_ae_pipe_sent(struct rdb_raft_ae_pipe *pipe, const msg_appendentries_t *ae);
+void rdb_raft_ae_pipe_ack(struct rdb_raft_ae_pipe *pipe, const msg_appendentries_t *ae,
+			  bool reset);
+void rdb_raft_is_restart(struct rdb_raft_is *is);
+bool rdb_raft_is_ack(struct rdb_raft_is *is, uint64_t round);
 int rdb_raft_add_replica(struct rdb *db, d_rank_t rank);
 int rdb_raft_remove_replica(struct rdb *db, d_rank_t rank);
 int rdb_raft_append_apply(struct rdb *db, void *entry, size_t size,
@@ -168,7 +213,7 @@ int rdb_raft_get_ranks(struct rdb *db, d_rank_list_t **ranksp);
 void rdb_requestvote_handler(crt_rpc_t *rpc);
 void rdb_appendentries_handler(crt_rpc_t *rpc);
 void rdb_installsnapshot_handler(crt_rpc_t *rpc);
-void rdb_raft_process_reply(struct rdb *db, crt_rpc_t *rpc);
+void rdb_raft_process_reply(struct rdb *db, crt_rpc_t *rpc, int rc, double sent);
 void rdb_raft_free_request(struct rdb *db, crt_rpc_t *rpc);
 
 /* rdb_rpc.c ******************************************************************/
@@ -179,11 +224,19 @@ void rdb_raft_free_request(struct rdb *db, crt_rpc_t *rpc);
  * These are for daos_rpc::dr_opc and DAOS_RPC_OPCODE(opc, ...) rather than
  * crt_req_create(..., opc, ...). See src/include/daos/rpc.h.
  */
-#define DAOS_RDB_VERSION 3
-/* LIST of internal RPCS in form of:
+#define DAOS_RDB_VERSION 4
+/*
+ * Both DAOS_RDB_VERSION and DAOS_RDB_VERSION - 1 are registered. Version 4
+ * only differs from version 3 in the compression fields of INSTALLSNAPSHOT, and
+ * is only sent for INSTALLSNAPSHOT when RDB_IS_COMPRESS is set, so replicas of
+ * either version work together as long as it is not; set it only once every
+ * replica supports version 4. is_fmt is the request format of INSTALLSNAPSHOT
+ * in the version.
+ *
+ * LIST of internal RPCS in form of:
  * OPCODE, flags, FMT, handler, corpc_hdlr,
  */
-#define RDB_PROTO_SRV_RPC_LIST						\
+#define RDB_PROTO_SRV_RPC_LIST(is_fmt)					\
 	X(RDB_REQUESTVOTE,						\
 		0, &CQF_rdb_requestvote,				\
 		rdb_requestvote_handler, NULL),				\
@@ -191,19 +244,20 @@ void rdb_raft_free_request(struct rdb *db, crt_rpc_t *rpc);
 		0, &CQF_rdb_appendentries,				\
 		rdb_appendentries_handler, NULL),			\
 	X(RDB_INSTALLSNAPSHOT,						\
-		0, &CQF_rdb_installsnapshot,				\
+		0, is_fmt,						\
 		rdb_installsnapshot_handler, NULL)
 
 /* Define for RPC enum population below */
 #define X(a, b, c, d, e) a
 
 enum rdb_operation {
-	RDB_PROTO_SRV_RPC_LIST,
+	RDB_PROTO_SRV_RPC_LIST(NULL),
 };
 
 #undef X
 
-extern struct crt_proto_format rdb_proto_fmt;
+extern struct crt_proto_format rdb_proto_fmt_0;
+extern struct crt_proto_format rdb_proto_fmt_1;
 
 #define DAOS_ISEQ_RDB_OP	/* input fields */		 \
 	((uuid_t)		(ri_uuid)		CRT_VAR)
@@ -237,8 +291,9 @@ CRT_RPC_DECLARE(rdb_appendentries, DAOS_ISEQ_RDB_APPENDENTRIES,
 		DAOS_OSEQ_RDB_APPENDENTRIES)
 
 struct rdb_local {
-	d_iov_t	rl_kds_iov;	/* isi_kds buffer */
-	d_iov_t	rl_data_iov;	/* isi_data buffer */
+	d_iov_t		rl_kds_iov;	/* isi_kds buffer */
+	d_iov_t		rl_data_iov;	/* isi_data buffer */
+	uint64_t	rl_round;	/* rdb_raft_is.dis_round (sender) */
 };
 
 #define DAOS_ISEQ_RDB_INSTALLSNAPSHOT /* input fields */	 \
@@ -255,6 +310,17 @@ struct rdb_local {
 	/* Local fields (not sent over the network) */		 \
 	((struct rdb_local)	(isi_local)		CRT_VAR)
 
+/*
+ * Version 4 INSTALLSNAPSHOT input, which starts with the version 3 one, so that
+ * struct rdb_installsnapshot_in may be used for both
+ */
+#define DAOS_ISEQ_RDB_INSTALLSNAPSHOT_Z /* input fields */	 \
+	DAOS_ISEQ_RDB_INSTALLSNAPSHOT				 \
+	/* uncompressed isi_data length */			 \
+	((uint64_t)		(isi_data_len)		CRT_VAR) \
+	/* DAOS_COMPRESS_TYPE of isi_data */			 \
+	((uint32_t)		(isi_compress)		CRT_VAR)
+
 #define DAOS_OSEQ_RDB_INSTALLSNAPSHOT /* output fields */	 \
 	((struct rdb_op_out)	(iso_op)		CRT_VAR) \
 	((msg_installsnapshot_response_t) (iso_msg)	CRT_VAR) \
@@ -267,8 +333,10 @@ struct rdb_local {
 
 CRT_RPC_DECLARE(rdb_installsnapshot, DAOS_ISEQ_RDB_INSTALLSNAPSHOT,
 		DAOS_OSEQ_RDB_INSTALLSNAPSHOT)
+CRT_RPC_DECLARE(rdb_installsnapshot_z, DAOS_ISEQ_RDB_INSTALLSNAPSHOT_Z,
+		DAOS_OSEQ_RDB_INSTALLSNAPSHOT)
 
-int rdb_create_raft_rpc(crt_opcode_t opc, raft_node_t *node, crt_rpc_t **rpc);
+int rdb_create_raft_rpc(crt_opcode_t opc, int version, raft_node_t *node, crt_rpc_t **rpc);
 int rdb_send_raft_rpc(crt_rpc_t *rpc, struct rdb *db);
 int rdb_abort_raft_rpcs(struct rdb *db);
 void rdb_recvd(void *arg);
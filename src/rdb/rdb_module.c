@@ -37,7 +37,7 @@ rdb_module_fini(void)
 }
 
 static struct daos_rpc_handler rdb_handlers[] = {
-	RDB_PROTO_SRV_RPC_LIST,
+	RDB_PROTO_SRV_RPC_LIST(NULL),
 };
 
 #undef X
@@ -70,12 +70,12 @@ struct dss_module rdb_module = {
 	.sm_name	= "rdb",
 	.sm_mod_id	= DAOS_RDB_MODULE,
 	.sm_ver		= DAOS_RDB_VERSION,
-	.sm_proto_count	= 1,
+	.sm_proto_count	= 2,
 	.sm_init	= rdb_module_init,
 	.sm_fini	= rdb_module_fini,
-	.sm_proto_fmt	= &rdb_proto_fmt,
-	.sm_cli_count	= 0,
-	.sm_handlers	= rdb_handlers,
+	.sm_proto_fmt	= {&rdb_proto_fmt_0, &rdb_proto_fmt_1},
+	.sm_cli_count	= {0, 0},
+	.sm_handlers	= {rdb_handlers, rdb_handlers},
 	.sm_key		= NULL,
 	.sm_mod_ops	= &rdb_mod_ops
 };
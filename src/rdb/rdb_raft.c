@@ -33,6 +33,7 @@
 #include <daos_srv/vos.h>
 #include <daos_srv/object.h>
 #include <daos/object.h>
+#include <daos/compression.h>
 #include "rdb_internal.h"
 #include "rdb_layout.h"
 
@@ -95,7 +96,7 @@ rdb_raft_cb_send_requestvote(raft_server_t *raft, void *arg, raft_node_t *node,
 		DP_DB(db), s, raft_node_get_id(node), rdb_node->dn_rank,
 		msg->term);
 
-	rc = rdb_create_raft_rpc(RDB_REQUESTVOTE, node, &rpc);
+	rc = rdb_create_raft_rpc(RDB_REQUESTVOTE, DAOS_RDB_VERSION - 1, node, &rpc);
 	if (rc != 0) {
 		D_ERROR(DF_DB": failed to create RV%s RPC to node %d: %d\n",
 			DP_DB(db), s, raft_node_get_id(node), rc);
@@ -176,12 +177,139 @@ rdb_raft_clone_ae(struct rdb *db, const msg_appendentries_t *ae, msg_appendentri
 	return 0;
 }
 
+/*
+ * Trim the entries of \a msg that are already in flight in \a pipe, so that up
+ * to \a depth AE RPCs carrying consecutive entries may be outstanding at the
+ * same time. Empty AEs are heartbeats and always go out, outside the pipeline;
+ * if \a heartbeat, an AE with nothing left to send is turned into one. Return
+ * false if nothing shall be sent now. Caller must hold d_raft_mutex.
+ */
+bool
+rdb_raft_ae_pipe_trim(struct rdb_raft_ae_pipe *pipe, unsigned int depth,
+		      const msg_appendentries_t *msg, bool heartbeat,
+		      msg_appendentries_t *trimmed)
+{
+	uint64_t	first = msg->prev_log_idx + 1;
+	uint64_t	skip;
+
+	*trimmed = *msg;
+
+	if (pipe->dap_term != msg->term) {
+		/* RPCs sent in previous terms are not tracked any more. */
+		pipe->dap_term = msg->term;
+		pipe->dap_next = 0;
+		pipe->dap_inflight = 0;
+	}
+
+	/* Nothing in flight beyond what raft wants to send; send as is. */
+	if (msg->n_entries == 0 || pipe->dap_inflight == 0 || pipe->dap_next <= first)
+		return true;
+
+	/* All entries already in flight, or the pipeline is full. */
+	if (pipe->dap_next >= first + msg->n_entries || pipe->dap_inflight >= depth) {
+		if (!heartbeat)
+			return false;
+		trimmed->entries = NULL;
+		trimmed->n_entries = 0;
+		return true;
+	}
+
+	skip = pipe->dap_next - first;
+	trimmed->prev_log_idx = pipe->dap_next - 1;
+	trimmed->prev_log_term = msg->entries[skip - 1].term;
+	trimmed->entries = &msg->entries[skip];
+	trimmed->n_entries = msg->n_entries - skip;
+	return true;
+}
+
+/*
+ * Record an AE RPC carrying \a ae as sent. Heartbeats are not tracked. Caller
+ * must hold d_raft_mutex.
+ */
+void
+rdb_raft_ae_pipe_sent(struct rdb_raft_ae_pipe *pipe, const msg_appendentries_t *ae)
+{
+	if (ae->n_entries == 0)
+		return;
+	pipe->dap_next = ae->prev_log_idx + 1 + ae->n_entries;
+	pipe->dap_inflight++;
+}
+
+/*
+ * Record that an AE RPC carrying \a ae has completed. If \a reset, the
+ * entries in flight may not have been accepted; let raft decide what to send
+ * next. Caller must hold d_raft_mutex.
+ */
+void
+rdb_raft_ae_pipe_ack(struct rdb_raft_ae_pipe *pipe, const msg_appendentries_t *ae, bool reset)
+{
+	if (ae->n_entries == 0 || pipe->dap_term != ae->term || pipe->dap_inflight == 0)
+		return;
+	pipe->dap_inflight--;
+	if (reset || pipe->dap_inflight == 0)
+		pipe->dap_next = 0;
+}
+
+/* Call rdb_raft_ae_pipe_ack for the node of \a rank, if it is still there. */
+static void
+rdb_raft_ae_pipe_done(struct rdb *db, d_rank_t rank, const msg_appendentries_t *ae, bool reset)
+{
+	raft_node_t		*node;
+	struct rdb_raft_node	*rdb_node;
+
+	node = raft_get_node(db->d_raft, rank);
+	if (node == NULL)
+		return;
+	rdb_node = raft_node_get_udata(node);
+	if (rdb_node == NULL)
+		return;
+	rdb_raft_ae_pipe_ack(&rdb_node->dn_ae, ae, reset);
+}
+
+/*
+ * Send entries appended since the last AE RPCs to every node that still has
+ * room in its pipeline. Nodes with nothing in flight are served by raft
+ * itself. Caller must hold d_raft_mutex.
+ */
+static void
+rdb_raft_ae_pipe_fill(struct rdb *db)
+{
+	uint64_t	current = raft_get_current_idx(db->d_raft);
+	uint64_t	term = raft_get_current_term(db->d_raft);
+	int		i;
+
+	if (db->d_ae_pipeline <= 1 || !raft_is_leader(db->d_raft))
+		return;
+
+	for (i = 0; i < raft_get_num_nodes(db->d_raft); i++) {
+		raft_node_t		*node = raft_get_node_from_idx(db->d_raft, i);
+		struct rdb_raft_node	*rdb_node;
+		struct rdb_raft_ae_pipe	*pipe;
+		int			 rc;
+
+		if (raft_node_get_id(node) == raft_get_nodeid(db->d_raft) ||
+		    !raft_node_is_voting(node))
+			continue;
+		rdb_node = raft_node_get_udata(node);
+		pipe = &rdb_node->dn_ae;
+		if (pipe->dap_term != term || pipe->dap_inflight == 0 ||
+		    pipe->dap_inflight >= db->d_ae_pipeline || pipe->dap_next == 0 ||
+		    pipe->dap_next > current)
+			continue;
+		rc = raft_send_appendentries(db->d_raft, node);
+		if (rc != 0)
+			D_DEBUG(DB_TRACE, DF_DB": failed to pipeline AE to rank %u: %d\n",
+				DP_DB(db), rdb_node->dn_rank, rc);
+	}
+}
+
 static int
 rdb_raft_cb_send_appendentries(raft_server_t *raft, void *arg,
 			       raft_node_t *node, msg_appendentries_t *msg)
 {
 	struct rdb		       *db = arg;
 	struct rdb_raft_node	       *rdb_node = raft_node_get_udata(node);
+	msg_appendentries_t		ae;
 	crt_rpc_t		       *rpc;
 	struct rdb_appendentries_in    *in;
 	int				rc;
@@ -194,7 +322,14 @@ rdb_raft_cb_send_appendentries(raft_server_t *raft, void *arg,
 	if (DAOS_FAIL_CHECK(DAOS_RDB_SKIP_APPENDENTRIES_FAIL))
 		D_GOTO(err, rc = 0);
 
-	rc = rdb_create_raft_rpc(RDB_APPENDENTRIES, node, &rpc);
+	if (!rdb_raft_ae_pipe_trim(&rdb_node->dn_ae, db->d_ae_pipeline, msg, db->d_ae_heartbeat,
+				   &ae)) {
+		D_DEBUG(DB_TRACE, DF_DB": entries to rank %u up to "DF_U64" in flight\n",
+			DP_DB(db), rdb_node->dn_rank, rdb_node->dn_ae.dap_next - 1);
+		D_GOTO(err, rc = 0);
+	}
+
+	rc = rdb_create_raft_rpc(RDB_APPENDENTRIES, DAOS_RDB_VERSION - 1, node, &rpc);
 	if (rc != 0) {
 		D_ERROR(DF_DB": failed to create AE RPC to node %d: %d\n",
 			DP_DB(db), raft_node_get_id(node), rc);
@@ -202,7 +337,7 @@ rdb_raft_cb_send_appendentries(raft_server_t *raft, void *arg,
 	}
 	in = crt_req_get(rpc);
 	uuid_copy(in->aei_op.ri_uuid, db->d_uuid);
-	rc = rdb_raft_clone_ae(db, msg, &in->aei_msg);
+	rc = rdb_raft_clone_ae(db, &ae, &in->aei_msg);
 	if (rc != 0) {
 		D_ERROR(DF_DB": failed to allocate entry array\n", DP_DB(db));
 		D_GOTO(err_rpc, rc);
@@ -214,6 +349,7 @@ rdb_raft_cb_send_appendentries(raft_server_t *raft, void *arg,
 			DP_DB(db), raft_node_get_id(node), rc);
 		D_GOTO(err_in, rc);
 	}
+	rdb_raft_ae_pipe_sent(&rdb_node->dn_ae, &in->aei_msg);
 	return 0;
 
 err_in:
@@ -377,7 +513,7 @@ rdb_raft_unload_snapshot(struct rdb *db)
 }
 
 static int
-rdb_raft_pack_chunk(daos_handle_t lc, struct rdb_raft_is *is, d_iov_t *kds,
+rdb_raft_pack_chunk(daos_handle_t lc, uint64_t index, struct rdb_anchor *start, d_iov_t *kds,
 		    d_iov_t *data, struct rdb_anchor *anchor)
 {
 	d_sg_list_t			sgl;
@@ -387,14 +523,14 @@ rdb_raft_pack_chunk(daos_handle_t lc, struct rdb_raft_is *is, d_iov_t *kds,
 	int				rc;
 
 	/*
-	 * Set up the iteration for everything in the log container at
-	 * is->dis_index.
+	 * Set up the iteration for everything in the log container at index,
+	 * starting from the start anchor.
 	 */
 	param.ip_hdl = lc;
-	rdb_anchor_to_hashes(&is->dis_anchor, &anchors.ia_obj, &anchors.ia_dkey,
+	rdb_anchor_to_hashes(start, &anchors.ia_obj, &anchors.ia_dkey,
 			     &anchors.ia_akey, &anchors.ia_ev, &anchors.ia_sv);
-	param.ip_epr.epr_lo = is->dis_index;
-	param.ip_epr.epr_hi = is->dis_index;
+	param.ip_epr.epr_lo = index;
+	param.ip_epr.epr_hi = index;
 	param.ip_epc_expr = VOS_IT_EPC_LE;
 	arg.chk_key2big = true;	/* see fill_key() & fill_rec() */
 
@@ -433,22 +569,215 @@ rdb_raft_pack_chunk(daos_handle_t lc, struct rdb_raft_is *is, d_iov_t *kds,
 	return 0;
 }
 
+/* Maximum length of the data of an INSTALLSNAPSHOT chunk */
+#define RDB_IS_DATA_MAX	(1 * 1024 * 1024)
+
+/*
+ * Compress the packed chunk data in data with d_is_compressor, replacing the
+ * buffer if that saves space. Otherwise, leave data as is. Either way, fill in
+ * the compression fields of in. The compressor is shared by the ULTs of the
+ * xstream, which is fine as compressing does not yield.
+ */
+static void
+rdb_raft_compress_chunk(struct rdb *db, d_iov_t *data, struct rdb_installsnapshot_z_in *in)
+{
+	void	       *buf;
+	size_t		produced = 0;
+	int		rc;
+
+	in->isi_compress = COMPRESS_TYPE_UNKNOWN;
+	in->isi_data_len = data->iov_len;
+	if (data->iov_len == 0)
+		return;
+
+	D_ALLOC(buf, data->iov_len);
+	if (buf == NULL)
+		return;
+	rc = daos_compressor_compress(db->d_is_compressor, data->iov_buf, data->iov_len, buf,
+				      data->iov_len, &produced);
+	if (rc != DC_STATUS_OK || produced >= data->iov_len) {
+		/* Send the chunk uncompressed. */
+		D_FREE(buf);
+		return;
+	}
+
+	D_DEBUG(DB_TRACE, DF_DB": compressed chunk from "DF_U64" to %zu bytes\n", DP_DB(db),
+		data->iov_len, produced);
+	D_FREE(data->iov_buf);
+	d_iov_set(data, buf, produced);
+	in->isi_compress = db->d_is_compress;
+}
+
+/*
+ * Replace the received chunk data of in with its decompressed version. The
+ * decompressor of the last type received is kept in db; see
+ * rdb_raft_compress_chunk.
+ */
 static int
-rdb_raft_cb_send_installsnapshot(raft_server_t *raft, void *arg,
-				 raft_node_t *node, msg_installsnapshot_t *msg)
+rdb_raft_decompress_chunk(struct rdb *db, struct rdb_installsnapshot_z_in *in)
+{
+	d_iov_t	       *data = &in->isi_local.rl_data_iov;
+	void	       *buf;
+	size_t		produced = 0;
+	int		rc;
+
+	if (in->isi_compress >= COMPRESS_TYPE_END || in->isi_data_len > RDB_IS_DATA_MAX)
+		return -DER_INVAL;
+
+	if (db->d_is_decompressor == NULL || db->d_is_decompress != in->isi_compress) {
+		daos_compressor_destroy(&db->d_is_decompressor);
+		rc = daos_compressor_init_with_type(&db->d_is_decompressor, in->isi_compress,
+						    true /* qat_preferred */, RDB_IS_DATA_MAX);
+		if (rc != DC_STATUS_OK) {
+			D_ERROR(DF_DB": failed to init decompressor %u: %d\n", DP_DB(db),
+				in->isi_compress, rc);
+			db->d_is_decompressor = NULL;
+			return -DER_NOTSUPPORTED;
+		}
+		db->d_is_decompress = in->isi_compress;
+	}
+
+	D_ALLOC(buf, in->isi_data_len);
+	if (buf == NULL)
+		return -DER_NOMEM;
+	rc = daos_compressor_decompress(db->d_is_decompressor, data->iov_buf, data->iov_len, buf,
+					in->isi_data_len, &produced);
+	if (rc != DC_STATUS_OK || produced != in->isi_data_len) {
+		D_ERROR(DF_DB": failed to decompress chunk "DF_U64": rc=%d len=%zu/"DF_U64"\n",
+			DP_DB(db), in->isi_seq, rc, produced, in->isi_data_len);
+		D_FREE(buf);
+		return -DER_IO;
+	}
+
+	D_FREE(data->iov_buf);
+	d_iov_set(data, buf, produced);
+	return 0;
+}
+
+/*
+ * Create the bulks of the packed chunk buffers kds and data for the IS RPC rpc
+ * to rank, and send it. On errors, free the buffers and the RPC.
+ */
+static int
+rdb_raft_send_is_bufs(struct rdb *db, crt_rpc_t *rpc, d_rank_t rank, d_iov_t *kds,
+		      d_iov_t *data)
+{
+	struct rdb_installsnapshot_in  *in = crt_req_get(rpc);
+	d_sg_list_t			sgl;
+	struct dss_module_info	       *info = dss_get_module_info();
+	int				rc;
+
+	/*
+	 * Create bulks for the buffers. crt_bulk_create looks at iov_buf_len
+	 * instead of iov_len.
+	 */
+	kds->iov_buf_len = kds->iov_len;
+	sgl.sg_nr = 1;
+	sgl.sg_nr_out = 0;
+	sgl.sg_iovs = kds;
+	rc = crt_bulk_create(info->dmi_ctx, &sgl, CRT_BULK_RO,
+			     &in->isi_kds);
+	if (rc != 0) {
+		D_ERROR(DF_DB": failed to create key descriptor bulk for rank "
+			"%u: %d\n", DP_DB(db), rank, rc);
+		goto err_data;
+	}
+	data->iov_buf_len = data->iov_len;
+	sgl.sg_nr = 1;
+	sgl.sg_nr_out = 0;
+	sgl.sg_iovs = data;
+	rc = crt_bulk_create(info->dmi_ctx, &sgl, CRT_BULK_RO, &in->isi_data);
+	if (rc != 0) {
+		D_ERROR(DF_DB": failed to create key bulk for rank %u: %d\n",
+			DP_DB(db), rank, rc);
+		goto err_kds_bulk;
+	}
+
+	rc = rdb_send_raft_rpc(rpc, db);
+	if (rc != 0) {
+		D_ERROR(DF_DB": failed to send IS RPC to rank %u: %d\n",
+			DP_DB(db), rank, rc);
+		goto err_data_bulk;
+	}
+
+	D_DEBUG(DB_TRACE,
+		DF_DB": sent is to rank %u: term=%ld last_idx=%ld seq="DF_U64" kds.len="DF_U64
+		" data.len="DF_U64"\n", DP_DB(db), rank, in->isi_msg.term, in->isi_msg.last_idx,
+		in->isi_seq, kds->iov_len, data->iov_len);
+	return 0;
+
+err_data_bulk:
+	crt_bulk_free(in->isi_data);
+err_kds_bulk:
+	crt_bulk_free(in->isi_kds);
+err_data:
+	D_FREE(data->iov_buf);
+	D_FREE(kds->iov_buf);
+	crt_req_decref(rpc);
+	return rc;
+}
+
+/* A packed chunk to be compressed and sent by rdb_raft_is_compressd */
+struct rdb_raft_is_chunk {
+	struct rdb	       *ric_db;
+	crt_rpc_t	       *ric_rpc;
+	d_rank_t		ric_rank;
+	msg_installsnapshot_t	ric_msg;
+	uint64_t		ric_round;
+	d_iov_t			ric_kds;
+	d_iov_t			ric_data;
+};
+
+static void rdb_raft_is_reset(struct rdb *db, d_rank_t rank, msg_installsnapshot_t *msg,
+			      uint64_t round);
+
+/*
+ * ULT compressing and sending a chunk, so that d_raft_mutex is not held while
+ * compressing. If the chunk cannot be sent, forget the chunks in flight, as if
+ * it had failed.
+ */
+static void
+rdb_raft_is_compressd(void *arg)
+{
+	struct rdb_raft_is_chunk       *chunk = arg;
+	struct rdb		       *db = chunk->ric_db;
+	int				rc;
+
+	rdb_raft_compress_chunk(db, &chunk->ric_data, crt_req_get(chunk->ric_rpc));
+	rc = rdb_raft_send_is_bufs(db, chunk->ric_rpc, chunk->ric_rank, &chunk->ric_kds,
+				   &chunk->ric_data);
+	if (rc != 0) {
+		ABT_mutex_lock(db->d_raft_mutex);
+		if (db->d_raft != NULL)
+			rdb_raft_is_reset(db, chunk->ric_rank, &chunk->ric_msg, chunk->ric_round);
+		ABT_mutex_unlock(db->d_raft_mutex);
+	}
+	rdb_put(db);
+	D_FREE(chunk);
+}
+
+/*
+ * Pack chunk seq of the snapshot described by msg, starting from the start
+ * anchor, and send it to node. Return the anchor following the chunk in next.
+ * If d_is_compressor is set, the chunk is compressed and sent by a
+ * rdb_raft_is_compressd ULT. Caller must hold d_raft_mutex.
+ */
+static int
+rdb_raft_send_is_chunk(struct rdb *db, raft_node_t *node, msg_installsnapshot_t *msg,
+		       uint64_t seq, struct rdb_anchor *start, struct rdb_anchor *next)
 {
-	struct rdb		       *db = arg;
 	struct rdb_raft_node	       *rdb_node = raft_node_get_udata(node);
-	struct rdb_raft_is	       *is = &rdb_node->dn_is;
+	struct rdb_raft_is_chunk       *chunk;
 	crt_rpc_t		       *rpc;
 	struct rdb_installsnapshot_in  *in;
 	d_iov_t			kds;
 	d_iov_t			data;
-	d_sg_list_t			sgl;
-	struct dss_module_info	       *info = dss_get_module_info();
 	int				rc;
 
-	rc = rdb_create_raft_rpc(RDB_INSTALLSNAPSHOT, node, &rpc);
+	/* Use version 4 only if the chunk may be compressed. */
+	rc = rdb_create_raft_rpc(RDB_INSTALLSNAPSHOT,
+				 db->d_is_compressor != NULL ? DAOS_RDB_VERSION :
+				 DAOS_RDB_VERSION - 1, node, &rpc);
 	if (rc != 0) {
 		D_ERROR(DF_DB": failed to create IS RPC to rank %u: %d\n",
 			DP_DB(db), rdb_node->dn_rank, rc);
@@ -468,12 +797,91 @@ rdb_raft_cb_send_installsnapshot(raft_server_t *raft, void *arg,
 	kds.iov_len = 0;
 	D_ALLOC(kds.iov_buf, kds.iov_buf_len);
 	if (kds.iov_buf == NULL)
-		goto err_rpc;
-	data.iov_buf_len = 1 * 1024 * 1024;
+		D_GOTO(err_rpc, rc = -DER_NOMEM);
+	data.iov_buf_len = RDB_IS_DATA_MAX;
 	data.iov_len = 0;
 	D_ALLOC(data.iov_buf, data.iov_buf_len);
 	if (data.iov_buf == NULL)
-		goto err_kds;
+		D_GOTO(err_kds, rc = -DER_NOMEM);
+
+	/* Pack the chunk's data, anchor, and seq. */
+	rc = rdb_raft_pack_chunk(db->d_lc, msg->last_idx, start, &kds, &data, &in->isi_anchor);
+	if (rc != 0)
+		goto err_data;
+	in->isi_seq = seq;
+	in->isi_local.rl_round = rdb_node->dn_is.dis_round;
+	*next = in->isi_anchor;
+
+	if (db->d_is_compressor == NULL)
+		return rdb_raft_send_is_bufs(db, rpc, rdb_node->dn_rank, &kds, &data);
+
+	D_ALLOC_PTR(chunk);
+	if (chunk == NULL)
+		D_GOTO(err_data, rc = -DER_NOMEM);
+	chunk->ric_db = db;
+	chunk->ric_rpc = rpc;
+	chunk->ric_rank = rdb_node->dn_rank;
+	chunk->ric_msg = *msg;
+	chunk->ric_round = in->isi_local.rl_round;
+	chunk->ric_kds = kds;
+	chunk->ric_data = data;
+	rdb_get(db);
+	rc = dss_ult_create(rdb_raft_is_compressd, chunk, DSS_XS_SELF, 0, 0, NULL);
+	if (rc != 0) {
+		D_ERROR(DF_DB": failed to create IS compression ULT for rank %u: "DF_RC"\n",
+			DP_DB(db), rdb_node->dn_rank, DP_RC(rc));
+		rdb_put(db);
+		D_FREE(chunk);
+		goto err_data;
+	}
+	return 0;
+
+err_data:
+	D_FREE(data.iov_buf);
+err_kds:
+	D_FREE(kds.iov_buf);
+err_rpc:
+	crt_req_decref(rpc);
+err:
+	return rc;
+}
+
+/*
+ * Forget the chunks in flight, so that the next chunk is sent from the last
+ * chunk received. Replies to the forgotten chunks will be ignored. Caller must
+ * hold d_raft_mutex.
+ */
+void
+rdb_raft_is_restart(struct rdb_raft_is *is)
+{
+	is->dis_inflight = 0;
+	is->dis_round++;
+}
+
+/*
+ * Release the slot of a chunk sent in \a round whose reply has arrived. Return
+ * false if the chunk belongs to an earlier round, in which case its reply shall
+ * be ignored. Caller must hold d_raft_mutex.
+ */
+bool
+rdb_raft_is_ack(struct rdb_raft_is *is, uint64_t round)
+{
+	if (round != is->dis_round)
+		return false;
+	if (is->dis_inflight > 0)
+		is->dis_inflight--;
+	return true;
+}
+
+static int
+rdb_raft_cb_send_installsnapshot(raft_server_t *raft, void *arg,
+				 raft_node_t *node, msg_installsnapshot_t *msg)
+{
+	struct rdb		       *db = arg;
+	struct rdb_raft_node	       *rdb_node = raft_node_get_udata(node);
+	struct rdb_raft_is	       *is = &rdb_node->dn_is;
+	int				n = 0;
+	int				rc = 0;
 
 	/*
 	 * If the INSTALLSNAPSHOT state tracks a different term or snapshot,
@@ -485,67 +893,60 @@ rdb_raft_cb_send_installsnapshot(raft_server_t *raft, void *arg,
 		is->dis_index = msg->last_idx;
 		is->dis_seq = 0;
 		rdb_anchor_set_zero(&is->dis_anchor);
+		rdb_raft_is_restart(is);
 	}
 
-	/* Pack the chunk's data, anchor, and seq. */
-	rc = rdb_raft_pack_chunk(db->d_lc, is, &kds, &data, &in->isi_anchor);
-	if (rc != 0)
-		goto err_data;
-	in->isi_seq = is->dis_seq + 1;
+	/* With nothing in flight, continue from the last chunk received. */
+	if (is->dis_inflight == 0) {
+		is->dis_next_seq = is->dis_seq;
+		is->dis_next_anchor = is->dis_anchor;
+	}
 
 	/*
-	 * Create bulks for the buffers. crt_bulk_create looks at iov_buf_len
-	 * instead of iov_len.
+	 * Keep up to d_is_pipeline chunks in flight. Since each chunk starts
+	 * from the anchor following the previous one, the next chunk can be
+	 * packed before the previous one is acknowledged.
 	 */
-	kds.iov_buf_len = kds.iov_len;
-	sgl.sg_nr = 1;
-	sgl.sg_nr_out = 0;
-	sgl.sg_iovs = &kds;
-	rc = crt_bulk_create(info->dmi_ctx, &sgl, CRT_BULK_RO,
-			     &in->isi_kds);
-	if (rc != 0) {
-		D_ERROR(DF_DB": failed to create key descriptor bulk for rank "
-			"%u: %d\n", DP_DB(db), rdb_node->dn_rank, rc);
-		goto err_data;
-	}
-	data.iov_buf_len = data.iov_len;
-	sgl.sg_nr = 1;
-	sgl.sg_nr_out = 0;
-	sgl.sg_iovs = &data;
-	rc = crt_bulk_create(info->dmi_ctx, &sgl, CRT_BULK_RO, &in->isi_data);
-	if (rc != 0) {
-		D_ERROR(DF_DB": failed to create key bulk for rank %u: %d\n",
-			DP_DB(db), rdb_node->dn_rank, rc);
-		goto err_kds_bulk;
-	}
+	while (is->dis_inflight < db->d_is_pipeline) {
+		struct rdb_anchor next;
 
-	rc = rdb_send_raft_rpc(rpc, db);
-	if (rc != 0) {
-		D_ERROR(DF_DB": failed to send IS RPC to rank %u: %d\n",
-			DP_DB(db), rdb_node->dn_rank, rc);
-		goto err_data_bulk;
+		/* The last chunk is already in flight. */
+		if (is->dis_inflight > 0 && rdb_anchor_is_eof(&is->dis_next_anchor))
+			break;
+
+		rc = rdb_raft_send_is_chunk(db, node, msg, is->dis_next_seq + 1,
+					    &is->dis_next_anchor, &next);
+		if (rc != 0)
+			break;
+		is->dis_next_seq++;
+		is->dis_next_anchor = next;
+		is->dis_inflight++;
+		n++;
 	}
 
-	D_DEBUG(DB_TRACE,
-		DF_DB": sent is to node %u rank %u: term=%ld last_idx=%ld seq="
-		DF_U64" kds.len="DF_U64" data.len="DF_U64"\n",
-		DP_DB(db), raft_node_get_id(node), rdb_node->dn_rank,
-		in->isi_msg.term, in->isi_msg.last_idx, in->isi_seq,
-		kds.iov_len, data.iov_len);
-	return 0;
+	return n > 0 ? 0 : rc;
+}
 
-err_data_bulk:
-	crt_bulk_free(in->isi_data);
-err_kds_bulk:
-	crt_bulk_free(in->isi_kds);
-err_data:
-	D_FREE(data.iov_buf);
-err_kds:
-	D_FREE(kds.iov_buf);
-err_rpc:
-	crt_req_decref(rpc);
-err:
-	return rc;
+/*
+ * A chunk sent to rank in round for the snapshot described by msg has failed.
+ * Unless the chunk belongs to an earlier round, forget the chunks in flight.
+ * Caller must hold d_raft_mutex.
+ */
+static void
+rdb_raft_is_reset(struct rdb *db, d_rank_t rank, msg_installsnapshot_t *msg, uint64_t round)
+{
+	raft_node_t		*node;
+	struct rdb_raft_node	*rdb_node;
+
+	node = raft_get_node(db->d_raft, rank);
+	if (node == NULL)
+		return;
+	rdb_node = raft_node_get_udata(node);
+	if (rdb_node == NULL || rdb_node->dn_term != msg->term ||
+	    rdb_node->dn_is.dis_index != msg->last_idx)
+		return;
+	if (rdb_raft_is_ack(&rdb_node->dn_is, round))
+		rdb_raft_is_restart(&rdb_node->dn_is);
 }
 
 struct rdb_raft_bulk {
@@ -794,15 +1195,23 @@ rdb_raft_cb_recv_installsnapshot(raft_server_t *raft, void *arg,
 					slc_record->dlr_base);
 				destroy = true;
 			}
+		} else if (msg->last_idx == slc_record->dlr_base &&
+			   msg->last_term == slc_record->dlr_base_term) {
+			/*
+			 * The new leader is sending the same snapshot. Since
+			 * chunks are located by anchors rather than by sizes,
+			 * keep the SLC and let the new leader resume from the
+			 * last chunk we have (see the seq check below).
+			 */
+			D_DEBUG(DB_TRACE,
+				DF_DB": new leader: %ld != "DF_U64": resuming from "DF_U64"\n",
+				DP_DB(db), msg->term, slc_record->dlr_term,
+				slc_record->dlr_seq);
+			slc_record->dlr_term = msg->term;
 		} else {
 			D_DEBUG(DB_TRACE,
 				DF_DB": new leader: %ld != "DF_U64"\n",
 				DP_DB(db), msg->term, slc_record->dlr_term);
-			/*
-			 * We destroy the SLC anyway, even when the index
-			 * matches, as the new leader may use a different
-			 * maximal chunk size (once tunable).
-			 */
 			destroy = true;
 		}
 
@@ -844,10 +1253,16 @@ rdb_raft_cb_recv_installsnapshot(raft_server_t *raft, void *arg,
 		out->iso_anchor = slc_record->dlr_anchor;
 		return 0;
 	} else if (in->isi_seq > slc_record->dlr_seq + 1) {
-		/* Chunks are sent one by one for now. */
-		D_ERROR(DF_DB": might have lost chunks: "DF_U64" > "DF_U64"\n",
+		/*
+		 * With several chunks in flight, a previous chunk may have been
+		 * lost or delayed. Ask the leader to resend from our last seq.
+		 */
+		D_DEBUG(DB_TRACE, DF_DB": missing chunks: "DF_U64" > "DF_U64" + 1\n",
 			DP_DB(db), in->isi_seq, slc_record->dlr_seq);
-		return -DER_IO;
+		out->iso_success = 0;
+		out->iso_seq = slc_record->dlr_seq;
+		out->iso_anchor = slc_record->dlr_anchor;
+		return 0;
 	}
 
 	/* Save this chunk but do not update the SLC record yet. */
@@ -966,6 +1381,8 @@ rdb_raft_cb_recv_installsnapshot_resp(raft_server_t *raft, void *arg,
 		return 0;
 	}
 
+	/* rdb_raft_process_reply has released the slot of this chunk. */
+
 	/* If this chunk isn't successfully stored, ... */
 	if (!out->iso_success) {
 		/*
@@ -980,9 +1397,11 @@ rdb_raft_cb_recv_installsnapshot_resp(raft_server_t *raft, void *arg,
 		}
 
 		/*
-		 * ... and the snapshot is not complete, return a generic error so
-		 * that raft will not retry too eagerly.
+		 * ... and the snapshot is not complete, resend from the last
+		 * chunk received, and return a generic error so that raft will
+		 * not retry too eagerly.
 		 */
+		rdb_raft_is_restart(is);
 		D_DEBUG(DB_TRACE,
 			DF_DB": rank %u: unsuccessful chunk %ld/"DF_U64"("
 			DF_U64")\n", DP_DB(db), rdb_node->dn_rank,
@@ -1008,6 +1427,14 @@ rdb_raft_cb_recv_installsnapshot_resp(raft_server_t *raft, void *arg,
 	is->dis_seq = out->iso_seq;
 	is->dis_anchor = out->iso_anchor;
 
+	/*
+	 * If the follower already has more than we have sent (e.g., it is
+	 * resuming a transfer from a previous leader), the chunks in flight
+	 * are useless; continue from what the follower has.
+	 */
+	if (is->dis_seq >= is->dis_next_seq)
+		rdb_raft_is_restart(is);
+
 	return 0;
 }
 
@@ -1118,6 +1545,11 @@ out:
 	return rc;
 }
 
+/*
+ * Apply and persist \a entry at \a index. The log tail is not updated here, so
+ * that rdb_raft_cb_log_offer may persist a whole batch of entries with a
+ * single log tail update.
+ */
 static int
 rdb_raft_log_offer_single(struct rdb *db, raft_entry_t *entry, uint64_t index)
 {
@@ -1129,9 +1561,6 @@ rdb_raft_log_offer_single(struct rdb *db, raft_entry_t *entry, uint64_t index)
 	int			rc;
 	int			rc_tmp;
 
-	D_ASSERTF(index == db->d_lc_record.dlr_tail, DF_U64" == "DF_U64"\n",
-		  index, db->d_lc_record.dlr_tail);
-
 	/*
 	 * If this is an rdb_tx entry, apply it. Note that the updates involved
 	 * won't become visible to queries until entry index is committed.
@@ -1197,18 +1626,6 @@ rdb_raft_log_offer_single(struct rdb *db, raft_entry_t *entry, uint64_t index)
 		entry->data.buf = NULL;
 	}
 
-	/* Update the log tail. See the log tail assertion above. */
-	db->d_lc_record.dlr_tail++;
-	d_iov_set(&values[0], &db->d_lc_record, sizeof(db->d_lc_record));
-	rc = rdb_mc_update(db->d_mc, RDB_MC_ATTRS, 1 /* n */, &rdb_mc_lc,
-			   &values[0]);
-	if (rc != 0) {
-		D_ERROR(DF_DB": failed to update log tail "DF_U64": %d\n",
-			DP_DB(db), db->d_lc_record.dlr_tail, rc);
-		db->d_lc_record.dlr_tail--;
-		goto err_discard;
-	}
-
 	D_DEBUG(DB_TRACE, DF_DB": appended entry "DF_U64": term=%ld type=%s buf=%p len=%u\n",
 		DP_DB(db), index, entry->term, rdb_raft_entry_type_str(entry->type),
 		entry->data.buf, entry->data.len);
@@ -1228,19 +1645,46 @@ rdb_raft_cb_log_offer(raft_server_t *raft, void *arg, raft_entry_t *entries,
 		      raft_index_t index, int *n_entries)
 {
 	struct rdb     *db = arg;
+	d_iov_t		value;
 	int		i;
 	int		rc = 0;
+	int		rc_tmp;
 
 	if (!db->d_raft_loaded)
 		return 0;
 
+	D_ASSERTF(index == db->d_lc_record.dlr_tail, "%ld == "DF_U64"\n", index,
+		  db->d_lc_record.dlr_tail);
+
 	for (i = 0; i < *n_entries; ++i) {
 		rc = rdb_raft_log_offer_single(db, &entries[i], index + i);
 		if (rc != 0)
 			break;
 	}
-	*n_entries = i;
+	if (i == 0)
+		goto out;
+
+	/*
+	 * Update the log tail once for all the entries persisted above. See
+	 * the log tail assertion above.
+	 */
+	db->d_lc_record.dlr_tail += i;
+	d_iov_set(&value, &db->d_lc_record, sizeof(db->d_lc_record));
+	rc_tmp = rdb_mc_update(db->d_mc, RDB_MC_ATTRS, 1 /* n */, &rdb_mc_lc, &value);
+	if (rc_tmp != 0) {
+		D_ERROR(DF_DB": failed to update log tail "DF_U64": %d\n",
+			DP_DB(db), db->d_lc_record.dlr_tail, rc_tmp);
+		db->d_lc_record.dlr_tail -= i;
+		rc = rc_tmp;
+		rc_tmp = rdb_lc_discard(db->d_lc, index, index + i - 1);
+		if (rc_tmp != 0)
+			D_ERROR(DF_DB": failed to discard entries ["DF_U64", "DF_U64"]: %d\n",
+				DP_DB(db), index, index + i - 1, rc_tmp);
+		i = 0;
+	}
 
+out:
+	*n_entries = i;
 	return rc;
 }
 
@@ -1946,6 +2390,8 @@ rdb_raft_append_apply_internal(struct rdb *db, msg_entry_t *mentry,
 	/* The actual index must match the expected index. */
 	D_ASSERTF(mresponse.idx == index, "%ld == "DF_U64"\n",
 		  mresponse.idx, index);
+	/* Ship the new entry to nodes that already have AEs in flight. */
+	rdb_raft_ae_pipe_fill(db);
 	rc = rdb_raft_wait_applied(db, mresponse.idx, mresponse.term);
 	raft_apply_all(db->d_raft);
 
@@ -2010,6 +2456,78 @@ rdb_raft_verify_leadership(struct rdb *db)
 				     NULL /* result */);
 }
 
+/*
+ * Return the send time of the last APPENDENTRIES request that \a node has
+ * acknowledged in \a term, or a negative value if there is none. This replica
+ * acknowledges itself at \a now.
+ */
+static double
+rdb_raft_lease_ack(struct rdb *db, raft_node_t *node, uint64_t term, double now)
+{
+	struct rdb_raft_node *rdb_node = raft_node_get_udata(node);
+
+	if (raft_node_get_id(node) == raft_get_nodeid(db->d_raft))
+		return now;
+	if (!raft_node_is_voting(node) || rdb_node == NULL || rdb_node->dn_lease_term != term)
+		return -1;
+	return rdb_node->dn_lease_ack;
+}
+
+/*
+ * Check whether this leader holds a valid lease, that is, whether a quorum
+ * has acknowledged an APPENDENTRIES request sent less than d_lease_timeout
+ * ago. Since followers ignore vote requests for d_lease_timeout after hearing
+ * from the leader (see rdb_raft_lease_held), no other leader may be elected
+ * until the lease expires, and queries may skip rdb_raft_verify_leadership.
+ * Caller must hold d_raft_mutex.
+ */
+bool
+rdb_raft_lease_valid(struct rdb *db)
+{
+	uint64_t	term = raft_get_current_term(db->d_raft);
+	int		n = raft_get_num_nodes(db->d_raft);
+	int		quorum = raft_get_num_voting_nodes(db->d_raft) / 2 + 1;
+	double		now = ABT_get_wtime();
+	double		start = -1;
+	int		i;
+
+	if (db->d_lease_timeout == 0 || !raft_is_leader(db->d_raft))
+		return false;
+
+	/* Find the latest ack time that a quorum has reached. */
+	for (i = 0; i < n; i++) {
+		double	t = rdb_raft_lease_ack(db, raft_get_node_from_idx(db->d_raft, i), term,
+					       now);
+		int	count = 0;
+		int	j;
+
+		if (t <= start)
+			continue;
+		for (j = 0; j < n; j++)
+			if (rdb_raft_lease_ack(db, raft_get_node_from_idx(db->d_raft, j), term,
+					       now) >= t)
+				count++;
+		if (count >= quorum)
+			start = t;
+	}
+
+	return start >= 0 && now < start + db->d_lease_timeout / 1000.0;
+}
+
+/*
+ * Check whether this follower has heard from the leader within
+ * d_lease_timeout, in which case it must not help elect another leader.
+ * Caller must hold d_raft_mutex.
+ */
+bool
+rdb_raft_lease_held(struct rdb *db)
+{
+	if (db->d_lease_timeout == 0 || raft_is_leader(db->d_raft) ||
+	    raft_get_current_leader(db->d_raft) == -1)
+		return false;
+	return ABT_get_wtime() < db->d_leader_contact + db->d_lease_timeout / 1000.0;
+}
+
 /* Generate a random double in [0.0, 1.0]. */
 static double
 rdb_raft_rand(void)
@@ -2054,7 +2572,10 @@ rdb_timerd(void *arg)
 
 		ABT_mutex_lock(db->d_raft_mutex);
 		rdb_raft_save_state(db, &state);
+		/* AEs sent by raft_periodic() are heartbeats. */
+		db->d_ae_heartbeat = true;
 		rc = raft_periodic(db->d_raft, d_prev * 1000 /* ms */);
+		db->d_ae_heartbeat = false;
 		rc = rdb_raft_check_state(db, &state, rc);
 		ABT_mutex_unlock(db->d_raft_mutex);
 		if (rc != 0)
@@ -2434,6 +2955,72 @@ rdb_raft_get_ae_max_entries(void)
 	return value;
 }
 
+static unsigned int
+rdb_raft_get_ae_pipeline(void)
+{
+	char	       *name = "RDB_AE_PIPELINE";
+	unsigned int	default_value = 4;
+	unsigned int	value = default_value;
+
+	d_getenv_int(name, &value);
+	if (value == 0) {
+		D_WARN("%s not in (0, %u] (defaulting to %u)\n", name, UINT_MAX, default_value);
+		value = default_value;
+	}
+	return value;
+}
+
+static unsigned int
+rdb_raft_get_is_pipeline(void)
+{
+	char	       *name = "RDB_IS_PIPELINE";
+	unsigned int	default_value = 4;
+	unsigned int	value = default_value;
+
+	d_getenv_int(name, &value);
+	if (value == 0) {
+		D_WARN("%s not in (0, %u] (defaulting to %u)\n", name, UINT_MAX, default_value);
+		value = default_value;
+	}
+	return value;
+}
+
+static int
+rdb_raft_get_is_compress(void)
+{
+	char	       *name = "RDB_IS_COMPRESS";
+	char	       *value;
+	int		prop;
+
+	/* Same names as the compression container property, e.g., "lz4". */
+	value = getenv(name);
+	if (value == NULL)
+		return COMPRESS_TYPE_UNKNOWN;
+	prop = daos_str2compresscontprop(value);
+	if (prop < 0) {
+		D_WARN("%s: unknown compression type %s (defaulting to off)\n", name, value);
+		return COMPRESS_TYPE_UNKNOWN;
+	}
+	return daos_contprop2compresstype(prop);
+}
+
+static unsigned int
+rdb_raft_get_lease_timeout(unsigned int election_timeout)
+{
+	char	       *name = "RDB_LEASE_TIMEOUT";
+	unsigned int	default_value = election_timeout / 2;
+	unsigned int	value = default_value;
+
+	/* A lease must expire before any follower may start an election. */
+	d_getenv_int(name, &value);
+	if (value > election_timeout) {
+		D_WARN("%s not in [0, %u] (defaulting to %u)\n", name, election_timeout,
+		       default_value);
+		value = default_value;
+	}
+	return value;
+}
+
 static size_t
 rdb_raft_get_ae_max_size(void)
 {
@@ -2461,6 +3048,9 @@ rdb_raft_open(struct rdb *db, uint64_t caller_term)
 	db->d_compact_thres = rdb_raft_get_compact_thres();
 	db->d_ae_max_size = rdb_raft_get_ae_max_size();
 	db->d_ae_max_entries = rdb_raft_get_ae_max_entries();
+	db->d_ae_pipeline = rdb_raft_get_ae_pipeline();
+	db->d_is_pipeline = rdb_raft_get_is_pipeline();
+	db->d_is_compress = rdb_raft_get_is_compress();
 
 	rc = d_hash_table_create_inplace(D_HASH_FT_NOLOCK, 4 /* bits */,
 					 NULL /* priv */,
@@ -2531,6 +3121,17 @@ rdb_raft_open(struct rdb *db, uint64_t caller_term)
 	if (rc != 0)
 		goto err_compact_cv;
 
+	if (db->d_is_compress != COMPRESS_TYPE_UNKNOWN) {
+		rc = daos_compressor_init_with_type(&db->d_is_compressor, db->d_is_compress,
+						    true /* qat_preferred */, RDB_IS_DATA_MAX);
+		if (rc != DC_STATUS_OK) {
+			D_WARN(DF_DB": failed to init IS compressor %d: %d (defaulting to off)\n",
+			       DP_DB(db), db->d_is_compress, rc);
+			db->d_is_compressor = NULL;
+			db->d_is_compress = COMPRESS_TYPE_UNKNOWN;
+		}
+	}
+
 	return 0;
 
 err_compact_cv:
@@ -2551,6 +3152,8 @@ void
 rdb_raft_close(struct rdb *db)
 {
 	D_ASSERT(db->d_raft == NULL);
+	daos_compressor_destroy(&db->d_is_decompressor);
+	daos_compressor_destroy(&db->d_is_compressor);
 	rdb_raft_close_lc(db);
 	ABT_cond_free(&db->d_compact_cv);
 	ABT_cond_free(&db->d_replies_cv);
@@ -2641,6 +3244,7 @@ rdb_raft_start(struct rdb *db)
 	election_timeout = rdb_raft_get_election_timeout();
 	request_timeout = rdb_raft_get_request_timeout();
 	raft_set_election_timeout(db->d_raft, election_timeout);
+	db->d_lease_timeout = rdb_raft_get_lease_timeout(election_timeout);
 	raft_set_request_timeout(db->d_raft, request_timeout);
 
 	rc = dss_ult_create(rdb_recvd, db, DSS_XS_SELF, 0, 0, &db->d_recvd);
@@ -2660,9 +3264,10 @@ rdb_raft_start(struct rdb *db)
 
 	D_DEBUG(DB_MD,
 		DF_DB": raft started: election_timeout=%dms request_timeout=%dms "
-		"compact_thres="DF_U64" ae_max_entries=%u ae_max_size="DF_U64"\n", DP_DB(db),
-		election_timeout, request_timeout, db->d_compact_thres, db->d_ae_max_entries,
-		db->d_ae_max_size);
+		"compact_thres="DF_U64" ae_max_entries=%u ae_max_size="DF_U64" ae_pipeline=%u "
+		"lease_timeout=%ums is_pipeline=%u is_compress=%d\n", DP_DB(db), election_timeout,
+		request_timeout, db->d_compact_thres, db->d_ae_max_entries, db->d_ae_max_size,
+		db->d_ae_pipeline, db->d_lease_timeout, db->d_is_pipeline, db->d_is_compress);
 	return 0;
 
 err_callbackd:
@@ -2908,6 +3513,19 @@ rdb_requestvote_handler(crt_rpc_t *rpc)
 	D_DEBUG(DB_TRACE, DF_DB": handling raft rv%s from rank %u\n",
 		DP_DB(db), s, srcrank);
 	ABT_mutex_lock(db->d_raft_mutex);
+	if (rdb_raft_lease_held(db)) {
+		/*
+		 * The current leader may be serving queries under its lease;
+		 * do not let another candidate win before the lease expires.
+		 */
+		D_DEBUG(DB_MD, DF_DB": ignoring rv%s from rank %u: leader lease held\n",
+			DP_DB(db), s, srcrank);
+		out->rvo_msg.term = raft_get_current_term(db->d_raft);
+		out->rvo_msg.vote_granted = 0;
+		out->rvo_msg.prevote = in->rvi_msg.prevote;
+		ABT_mutex_unlock(db->d_raft_mutex);
+		D_GOTO(out_db, rc = 0);
+	}
 	rdb_raft_save_state(db, &state);
 	rc = raft_recv_requestvote(db->d_raft,
 				   raft_get_node(db->d_raft,
@@ -2960,6 +3578,8 @@ rdb_appendentries_handler(crt_rpc_t *rpc)
 				     raft_get_node(db->d_raft, srcrank),
 				     &in->aei_msg, &out->aeo_msg);
 	rc = rdb_raft_check_state(db, &state, rc);
+	if (out->aeo_msg.term == in->aei_msg.term)
+		db->d_leader_contact = ABT_get_wtime();
 	ABT_mutex_unlock(db->d_raft_mutex);
 	if (rc != 0) {
 		D_ERROR(DF_DB": failed to process APPENDENTRIES from rank %u: "
@@ -3015,6 +3635,17 @@ rdb_installsnapshot_handler(crt_rpc_t *rpc)
 		goto out_db;
 	}
 
+	/* Version 4 chunks may be compressed. */
+	if (((rpc->cr_opc >> RPC_VERSION_OFFSET) & RPC_VERSION_MASK) >= DAOS_RDB_VERSION) {
+		struct rdb_installsnapshot_z_in *in_z = crt_req_get(rpc);
+
+		if (in_z->isi_compress != COMPRESS_TYPE_UNKNOWN) {
+			rc = rdb_raft_decompress_chunk(db, in_z);
+			if (rc != 0)
+				goto out_bufs;
+		}
+	}
+
 	ABT_mutex_lock(db->d_raft_mutex);
 	rdb_raft_save_state(db, &state);
 	rc = raft_recv_installsnapshot(db->d_raft,
@@ -3031,6 +3662,7 @@ rdb_installsnapshot_handler(crt_rpc_t *rpc)
 		rc = 0;
 	}
 
+out_bufs:
 	D_FREE(in->isi_local.rl_data_iov.iov_buf);
 	D_FREE(in->isi_local.rl_kds_iov.iov_buf);
 out_db:
@@ -3045,28 +3677,42 @@ out:
 }
 
 void
-rdb_raft_process_reply(struct rdb *db, crt_rpc_t *rpc)
+rdb_raft_process_reply(struct rdb *db, crt_rpc_t *rpc, int rc, double sent)
 {
 	struct rdb_raft_state		state;
 	crt_opcode_t			opc = opc_get(rpc->cr_opc);
 	void			       *out = crt_reply_get(rpc);
 	struct rdb_requestvote_out     *out_rv;
+	struct rdb_appendentries_in    *in_ae;
 	struct rdb_appendentries_out   *out_ae;
+	struct rdb_installsnapshot_in  *in_is;
 	struct rdb_installsnapshot_out *out_is;
 	d_rank_t			rank;
 	raft_node_t		       *node;
-	int				rc;
+	int				rc_tmp;
 
 	/* Get the destination of the request - that is the source
 	 * rank of this reply. This CaRT API is based on request hdr.
 	 */
-	rc = crt_req_dst_rank_get(rpc, &rank);
-	D_ASSERTF(rc == 0, ""DF_RC"\n", DP_RC(rc));
+	rc_tmp = crt_req_dst_rank_get(rpc, &rank);
+	D_ASSERTF(rc_tmp == 0, ""DF_RC"\n", DP_RC(rc_tmp));
 
-	rc = ((struct rdb_op_out *)out)->ro_rc;
+	if (rc == 0)
+		rc = ((struct rdb_op_out *)out)->ro_rc;
 	if (rc != 0) {
 		D_DEBUG(DB_MD, DF_DB": opc %u failed: %d\n", DP_DB(db), opc,
 			rc);
+		if (opc == RDB_APPENDENTRIES) {
+			in_ae = crt_req_get(rpc);
+			ABT_mutex_lock(db->d_raft_mutex);
+			rdb_raft_ae_pipe_done(db, rank, &in_ae->aei_msg, true /* reset */);
+			ABT_mutex_unlock(db->d_raft_mutex);
+		} else if (opc == RDB_INSTALLSNAPSHOT) {
+			in_is = crt_req_get(rpc);
+			ABT_mutex_lock(db->d_raft_mutex);
+			rdb_raft_is_reset(db, rank, &in_is->isi_msg, in_is->isi_local.rl_round);
+			ABT_mutex_unlock(db->d_raft_mutex);
+		}
 		return;
 	}
 
@@ -3086,15 +3732,42 @@ rdb_raft_process_reply(struct rdb *db, crt_rpc_t *rpc)
 						    &out_rv->rvo_msg);
 		break;
 	case RDB_APPENDENTRIES:
+		in_ae = crt_req_get(rpc);
 		out_ae = out;
+		rdb_raft_ae_pipe_done(db, rank, &in_ae->aei_msg,
+				      !out_ae->aeo_msg.success /* reset */);
+		/* The node has accepted our leadership as of sent. */
+		if (out_ae->aeo_msg.term == in_ae->aei_msg.term) {
+			struct rdb_raft_node *rdb_node = raft_node_get_udata(node);
+
+			if (rdb_node->dn_lease_term != in_ae->aei_msg.term) {
+				rdb_node->dn_lease_term = in_ae->aei_msg.term;
+				rdb_node->dn_lease_ack = sent;
+			} else if (sent > rdb_node->dn_lease_ack) {
+				rdb_node->dn_lease_ack = sent;
+			}
+		}
 		rc = raft_recv_appendentries_response(db->d_raft, node,
 						      &out_ae->aeo_msg);
+		if (rc == 0)
+			rdb_raft_ae_pipe_fill(db);
 		break;
-	case RDB_INSTALLSNAPSHOT:
+	case RDB_INSTALLSNAPSHOT: {
+		struct rdb_raft_node *rdb_node = raft_node_get_udata(node);
+
+		in_is = crt_req_get(rpc);
 		out_is = out;
+		if (!rdb_raft_is_ack(&rdb_node->dn_is, in_is->isi_local.rl_round)) {
+			D_DEBUG(DB_TRACE, DF_DB": rank %u: chunk "DF_U64" of earlier round "
+				DF_U64"\n", DP_DB(db), rank, in_is->isi_seq,
+				in_is->isi_local.rl_round);
+			rc = 0;
+			break;
+		}
 		rc = raft_recv_installsnapshot_response(db->d_raft, node,
 							&out_is->iso_msg);
 		break;
+	}
 	default:
 		D_ASSERTF(0, DF_DB": unexpected opc: %u\n", DP_DB(db), opc);
 	}
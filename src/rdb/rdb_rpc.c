@@ -190,6 +190,8 @@ CRT_RPC_DEFINE(rdb_appendentries, DAOS_ISEQ_RDB_APPENDENTRIES,
 		DAOS_OSEQ_RDB_APPENDENTRIES)
 CRT_RPC_DEFINE(rdb_installsnapshot, DAOS_ISEQ_RDB_INSTALLSNAPSHOT,
 		DAOS_OSEQ_RDB_INSTALLSNAPSHOT)
+CRT_RPC_DEFINE(rdb_installsnapshot_z, DAOS_ISEQ_RDB_INSTALLSNAPSHOT_Z,
+		DAOS_OSEQ_RDB_INSTALLSNAPSHOT)
 
 /* Define for cont_rpcs[] array population below.
  * See RDB_PROTO_*_RPC_LIST macro definition
@@ -202,28 +204,41 @@ CRT_RPC_DEFINE(rdb_installsnapshot, DAOS_ISEQ_RDB_INSTALLSNAPSHOT,
 	.prf_co_ops  = NULL,	\
 }
 
-static struct crt_proto_rpc_format rdb_proto_rpc_fmt[] = {
-	RDB_PROTO_SRV_RPC_LIST,
+static struct crt_proto_rpc_format rdb_proto_rpc_fmt_0[] = {
+	RDB_PROTO_SRV_RPC_LIST(&CQF_rdb_installsnapshot),
+};
+
+static struct crt_proto_rpc_format rdb_proto_rpc_fmt_1[] = {
+	RDB_PROTO_SRV_RPC_LIST(&CQF_rdb_installsnapshot_z),
 };
 
 #undef X
 
-struct crt_proto_format rdb_proto_fmt = {
+struct crt_proto_format rdb_proto_fmt_0 = {
+	.cpf_name  = "rdb-proto",
+	.cpf_ver   = DAOS_RDB_VERSION - 1,
+	.cpf_count = ARRAY_SIZE(rdb_proto_rpc_fmt_0),
+	.cpf_prf   = rdb_proto_rpc_fmt_0,
+	.cpf_base  = DAOS_RPC_OPCODE(0, DAOS_RDB_MODULE, 0)
+};
+
+struct crt_proto_format rdb_proto_fmt_1 = {
 	.cpf_name  = "rdb-proto",
 	.cpf_ver   = DAOS_RDB_VERSION,
-	.cpf_count = ARRAY_SIZE(rdb_proto_rpc_fmt),
-	.cpf_prf   = rdb_proto_rpc_fmt,
+	.cpf_count = ARRAY_SIZE(rdb_proto_rpc_fmt_1),
+	.cpf_prf   = rdb_proto_rpc_fmt_1,
 	.cpf_base  = DAOS_RPC_OPCODE(0, DAOS_RDB_MODULE, 0)
 };
 
+/* Create an RPC of opc in version, DAOS_RDB_VERSION or DAOS_RDB_VERSION - 1. */
 int
-rdb_create_raft_rpc(crt_opcode_t opc, raft_node_t *node, crt_rpc_t **rpc)
+rdb_create_raft_rpc(crt_opcode_t opc, int version, raft_node_t *node, crt_rpc_t **rpc)
 {
 	crt_opcode_t		opc_full;
 	crt_endpoint_t		ep;
 	struct dss_module_info *info = dss_get_module_info();
 
-	opc_full = DAOS_RPC_OPCODE(opc, DAOS_RDB_MODULE, DAOS_RDB_VERSION);
+	opc_full = DAOS_RPC_OPCODE(opc, DAOS_RDB_MODULE, version);
 	ep.ep_grp = NULL;
 	ep.ep_rank = raft_node_get_id(node);
 	ep.ep_tag = daos_rpc_tag(DAOS_REQ_RDB, 0);
@@ -235,6 +250,7 @@ struct rdb_raft_rpc {
 	crt_rpc_t      *drc_rpc;
 	struct rdb     *drc_db;
 	double		drc_sent;
+	int		drc_rc;		/* of the RPC */
 };
 
 static struct rdb_raft_rpc *
@@ -299,7 +315,8 @@ rdb_recvd(void *arg)
 		 * become empty.
 		 */
 		if (!stop)
-			rdb_raft_process_reply(db, rrpc->drc_rpc);
+			rdb_raft_process_reply(db, rrpc->drc_rpc, rrpc->drc_rc,
+					       rrpc->drc_sent);
 		rdb_raft_free_request(db, rrpc->drc_rpc);
 		rdb_free_raft_rpc(rrpc);
 		ABT_thread_yield();
@@ -323,14 +340,12 @@ rdb_raft_rpc_cb(const struct crt_cb_info *cb_info)
 	D_DEBUG(DB_MD, DF_DB": opc=%u rank=%u rtt=%f\n", DP_DB(db), opc,
 		dstrank, ABT_get_wtime() - rrpc->drc_sent);
 	ABT_mutex_lock(db->d_mutex);
-	if (rc != 0 || db->d_stop) {
-		if (rc != -DER_CANCELED)
-			D_ERROR(DF_DB": RPC %x to rank %u failed: "DF_RC"\n",
-				DP_DB(rrpc->drc_db), opc,
-				dstrank, DP_RC(rc));
+	if (rc != 0 && rc != -DER_CANCELED)
+		D_ERROR(DF_DB": RPC %x to rank %u failed: "DF_RC"\n",
+			DP_DB(rrpc->drc_db), opc, dstrank, DP_RC(rc));
+	if (db->d_stop) {
 		/*
-		 * Drop this RPC, assuming that raft will make a new one. If we
-		 * are stopping, rdb_recvd() might have already stopped. Hence,
+		 * Drop this RPC. rdb_recvd() might have already stopped. Hence,
 		 * we shall not add any new items to db->d_replies.
 		 */
 		d_list_del_init(&rrpc->drc_entry);
@@ -339,7 +354,14 @@ rdb_raft_rpc_cb(const struct crt_cb_info *cb_info)
 		rdb_free_raft_rpc(rrpc);
 		return;
 	}
-	/* Move this RPC to db->d_replies for rdb_recvd(). */
+	/*
+	 * Move this RPC to db->d_replies for rdb_recvd(). Failed RPCs,
+	 * including canceled ones, are passed along too, so that
+	 * rdb_raft_process_reply() may release their slots in the
+	 * APPENDENTRIES pipeline and the INSTALLSNAPSHOT window; raft will
+	 * make new RPCs for them.
+	 */
+	rrpc->drc_rc = rc;
 	d_list_move_tail(&rrpc->drc_entry, &db->d_replies);
 	ABT_cond_broadcast(db->d_replies_cv);
 	ABT_mutex_unlock(db->d_mutex);
@@ -72,9 +72,11 @@ rdb_tx_begin(struct rdb *db, uint64_t term, struct rdb_tx *tx)
 	}
 	/*
 	 * If this verification succeeds, then queries in this TX will return
-	 * valid results.
+	 * valid results. While our leader lease is valid, no other leader may
+	 * have been elected, so the verification is unnecessary.
 	 */
-	rc = rdb_raft_verify_leadership(db);
+	if (term != raft_get_current_term(db->d_raft) || !rdb_raft_lease_valid(db))
+		rc = rdb_raft_verify_leadership(db);
 	ABT_mutex_unlock(db->d_raft_mutex);
 	if (rc != 0)
 		return rc;
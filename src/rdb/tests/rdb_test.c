@@ -190,6 +190,158 @@ rdbt_test_util(void)
 	ioveq(&v1, &v2);
 }
 
+/*
+ * Have raft ask for entries [1, n] in term, as a heartbeat or not, and send what
+ * the pipe lets through.
+ */
+static bool
+rdbt_ae_pipe_send_hb(struct rdb_raft_ae_pipe *pipe, msg_entry_t *entries, uint64_t term, int n,
+		     bool heartbeat, msg_appendentries_t *ae)
+{
+	msg_appendentries_t	msg = {};
+
+	msg.term = term;
+	msg.prev_log_idx = 0;
+	msg.prev_log_term = 0;
+	msg.entries = n > 0 ? entries : NULL;
+	msg.n_entries = n;
+	if (!rdb_raft_ae_pipe_trim(pipe, 3 /* depth */, &msg, heartbeat, ae))
+		return false;
+	rdb_raft_ae_pipe_sent(pipe, ae);
+	return true;
+}
+
+static bool
+rdbt_ae_pipe_send(struct rdb_raft_ae_pipe *pipe, msg_entry_t *entries, uint64_t term, int n,
+		  msg_appendentries_t *ae)
+{
+	return rdbt_ae_pipe_send_hb(pipe, entries, term, n, false /* heartbeat */, ae);
+}
+
+/* Complete an AE carrying n entries in term. */
+static void
+rdbt_ae_pipe_ack(struct rdb_raft_ae_pipe *pipe, uint64_t term, int n, bool reset)
+{
+	msg_appendentries_t	ae = {};
+
+	ae.term = term;
+	ae.n_entries = n;
+	rdb_raft_ae_pipe_ack(pipe, &ae, reset);
+}
+
+static void
+rdbt_test_ae_pipe(void)
+{
+	struct rdb_raft_ae_pipe	pipe = {};
+	msg_entry_t		entries[8] = {};
+	msg_appendentries_t	ae;
+	int			i;
+
+	for (i = 0; i < ARRAY_SIZE(entries); i++) {
+		entries[i].id = i + 1;
+		entries[i].term = 5;
+	}
+
+	D_WARN("pipeline AEs up to the depth\n");
+	D_ASSERT(rdbt_ae_pipe_send(&pipe, entries, 5, 2, &ae));
+	D_ASSERT(ae.prev_log_idx == 0 && ae.n_entries == 2);
+	D_ASSERT(rdbt_ae_pipe_send(&pipe, entries, 5, 4, &ae));
+	D_ASSERTF(ae.prev_log_idx == 2 && ae.n_entries == 2 && ae.entries == &entries[2],
+		  "%ld %d\n", (long)ae.prev_log_idx, ae.n_entries);
+	D_ASSERT(ae.prev_log_term == entries[1].term);
+	D_ASSERT(!rdbt_ae_pipe_send(&pipe, entries, 5, 4, &ae));
+	D_ASSERT(rdbt_ae_pipe_send(&pipe, entries, 5, 6, &ae));
+	D_ASSERT(ae.prev_log_idx == 4 && ae.n_entries == 2);
+	D_ASSERT(!rdbt_ae_pipe_send(&pipe, entries, 5, 8, &ae));
+	D_ASSERTF(pipe.dap_inflight == 3 && pipe.dap_next == 7, "%u "DF_U64"\n",
+		  pipe.dap_inflight, pipe.dap_next);
+
+	D_WARN("reset the pipeline on a failed or canceled AE\n");
+	rdbt_ae_pipe_ack(&pipe, 5, 2, true /* reset */);
+	D_ASSERT(pipe.dap_inflight == 2 && pipe.dap_next == 0);
+	D_ASSERT(rdbt_ae_pipe_send(&pipe, entries, 5, 8, &ae));
+	D_ASSERT(ae.prev_log_idx == 0 && ae.n_entries == 8);
+	D_ASSERT(pipe.dap_inflight == 3 && pipe.dap_next == 9);
+
+	D_WARN("drain the pipeline\n");
+	rdbt_ae_pipe_ack(&pipe, 4, 2, false /* reset */);
+	D_ASSERT(pipe.dap_inflight == 3 && pipe.dap_next == 9);
+	rdbt_ae_pipe_ack(&pipe, 5, 2, false /* reset */);
+	rdbt_ae_pipe_ack(&pipe, 5, 2, false /* reset */);
+	D_ASSERT(pipe.dap_inflight == 1 && pipe.dap_next == 9);
+	rdbt_ae_pipe_ack(&pipe, 5, 2, false /* reset */);
+	D_ASSERT(pipe.dap_inflight == 0 && pipe.dap_next == 0);
+	rdbt_ae_pipe_ack(&pipe, 5, 2, true /* reset */);
+	D_ASSERT(pipe.dap_inflight == 0 && pipe.dap_next == 0);
+
+	D_WARN("reset the pipeline on a new term\n");
+	D_ASSERT(rdbt_ae_pipe_send(&pipe, entries, 5, 2, &ae));
+	D_ASSERT(rdbt_ae_pipe_send(&pipe, entries, 5, 4, &ae));
+	D_ASSERT(rdbt_ae_pipe_send(&pipe, entries, 6, 4, &ae));
+	D_ASSERT(ae.prev_log_idx == 0 && ae.n_entries == 4);
+	D_ASSERT(pipe.dap_term == 6 && pipe.dap_inflight == 1 && pipe.dap_next == 5);
+	rdbt_ae_pipe_ack(&pipe, 5, 2, true /* reset */);
+	D_ASSERT(pipe.dap_inflight == 1 && pipe.dap_next == 5);
+	rdbt_ae_pipe_ack(&pipe, 6, 4, false /* reset */);
+	D_ASSERT(pipe.dap_inflight == 0 && pipe.dap_next == 0);
+
+	D_WARN("let heartbeats through a full pipeline\n");
+	D_ASSERT(rdbt_ae_pipe_send(&pipe, entries, 6, 2, &ae));
+	D_ASSERT(rdbt_ae_pipe_send(&pipe, entries, 6, 4, &ae));
+	D_ASSERT(rdbt_ae_pipe_send(&pipe, entries, 6, 6, &ae));
+	D_ASSERT(!rdbt_ae_pipe_send(&pipe, entries, 6, 8, &ae));
+	D_ASSERT(pipe.dap_inflight == 3 && pipe.dap_next == 7);
+	D_ASSERT(rdbt_ae_pipe_send(&pipe, entries, 6, 0, &ae));
+	D_ASSERT(ae.prev_log_idx == 0 && ae.n_entries == 0);
+	D_ASSERT(rdbt_ae_pipe_send_hb(&pipe, entries, 6, 8, true /* heartbeat */, &ae));
+	D_ASSERT(ae.prev_log_idx == 0 && ae.n_entries == 0 && ae.entries == NULL);
+	D_ASSERT(pipe.dap_inflight == 3 && pipe.dap_next == 7);
+	rdbt_ae_pipe_ack(&pipe, 6, 0, false /* reset */);
+	rdbt_ae_pipe_ack(&pipe, 6, 0, true /* reset */);
+	D_ASSERT(pipe.dap_inflight == 3 && pipe.dap_next == 7);
+
+	D_WARN("let heartbeats through with all entries in flight\n");
+	rdbt_ae_pipe_ack(&pipe, 6, 2, false /* reset */);
+	D_ASSERT(pipe.dap_inflight == 2 && pipe.dap_next == 7);
+	D_ASSERT(!rdbt_ae_pipe_send(&pipe, entries, 6, 6, &ae));
+	D_ASSERT(rdbt_ae_pipe_send_hb(&pipe, entries, 6, 6, true /* heartbeat */, &ae));
+	D_ASSERT(ae.prev_log_idx == 0 && ae.n_entries == 0);
+	D_ASSERT(pipe.dap_inflight == 2 && pipe.dap_next == 7);
+
+	D_WARN("heartbeats carry new entries when there is room\n");
+	D_ASSERT(rdbt_ae_pipe_send_hb(&pipe, entries, 6, 8, true /* heartbeat */, &ae));
+	D_ASSERT(ae.prev_log_idx == 6 && ae.n_entries == 2);
+	D_ASSERT(pipe.dap_inflight == 3 && pipe.dap_next == 9);
+}
+
+static void
+rdbt_test_is_window(void)
+{
+	struct rdb_raft_is	is = {};
+	uint64_t		round;
+
+	D_WARN("release IS window slots\n");
+	round = is.dis_round;
+	is.dis_inflight = 3;
+	D_ASSERT(rdb_raft_is_ack(&is, round));
+	D_ASSERT(is.dis_inflight == 2);
+
+	D_WARN("ignore replies to chunks of earlier rounds\n");
+	rdb_raft_is_restart(&is);
+	D_ASSERT(is.dis_inflight == 0 && is.dis_round == round + 1);
+	D_ASSERT(!rdb_raft_is_ack(&is, round));
+	D_ASSERT(is.dis_inflight == 0);
+	is.dis_inflight = 2;
+	D_ASSERT(!rdb_raft_is_ack(&is, round));
+	D_ASSERT(!rdb_raft_is_ack(&is, round));
+	D_ASSERTF(is.dis_inflight == 2, "%u\n", is.dis_inflight);
+	D_ASSERT(rdb_raft_is_ack(&is, round + 1));
+	D_ASSERT(rdb_raft_is_ack(&is, round + 1));
+	D_ASSERT(is.dis_inflight == 0);
+	D_ASSERT(rdb_raft_is_ack(&is, round + 1));
+	D_ASSERT(is.dis_inflight == 0);
+}
+
 struct rdbt_test_path_arg {
 	int		n;
 	d_iov_t     *keys;
@@ -441,6 +593,33 @@ out:
 	return rc;
 }
 
+/*
+ * Check the leases of \a db, whose leader has just committed an entry and keeps
+ * heartbeating. A quorum has acknowledged a recent APPENDENTRIES request, so
+ * the leader must hold a valid lease, and a follower that knows the leader must
+ * refuse to vote.
+ */
+static void
+rdbt_test_lease(struct rdb *db, bool leader)
+{
+	unsigned int	timeout;
+
+	ABT_mutex_lock(db->d_raft_mutex);
+	timeout = db->d_lease_timeout;
+	D_WARN("check %s lease: timeout=%ums\n", leader ? "leader" : "follower", timeout);
+	if (timeout != 0 && raft_get_current_leader(db->d_raft) != -1) {
+		D_ASSERT(rdb_raft_lease_valid(db) == leader);
+		D_ASSERT(rdb_raft_lease_held(db) == !leader);
+	}
+
+	D_WARN("check disabled lease\n");
+	db->d_lease_timeout = 0;
+	D_ASSERT(!rdb_raft_lease_valid(db));
+	D_ASSERT(!rdb_raft_lease_held(db));
+	db->d_lease_timeout = timeout;
+	ABT_mutex_unlock(db->d_raft_mutex);
+}
+
 static int
 rdbt_test_tx(bool update, enum rdbt_membership_op memb_op, uint64_t user_key,
 	     uint64_t user_val_in, uint64_t *user_val_outp,
@@ -541,10 +720,14 @@ proceed:
 			ds_rsvc_put_leader(rsvc);
 			return rc;
 		}
+		if (memb_op == RDBT_MEMBER_NOOP)
+			rdbt_test_lease(svc->rt_rsvc.s_db, true /* leader */);
 	}
 
-	if (follower)
+	if (follower) {
+		rdbt_test_lease(rsvc->s_db, false /* leader */);
 		rdb_stop(rsvc->s_db, &storage);
+	}
 
 	D_WARN("query regular keys\n");
 	if (follower)
@@ -729,6 +912,8 @@ rdbt_test_handler(crt_rpc_t *rpc)
 	D_WARN("testing rank %u: update=%d %s\n", rank, in->tti_update,
 	       rdbt_membership_opname(in->tti_memb_op));
 	rdbt_test_util();
+	rdbt_test_ae_pipe();
+	rdbt_test_is_window();
 	rdbt_test_path();
 	rdbt_test_rsvc();
 	rc = rdbt_test_tx(in->tti_update, in->tti_memb_op, in->tti_key,
@@ -19,6 +19,7 @@
 #include <daos/pool_map.h>
 #include <daos_srv/daos_engine.h>
 #include <daos_srv/rebuild.h>
+#include <gurt/telemetry_producer.h>
 
 /* Track the pool rebuild status on each target, which exists on
  * all server targets. Then each target will report its rebuild
@@ -294,6 +295,17 @@ struct rebuild_iv {
 
 #define SCAN_YIELD_FREQ		4096
 #define SCAN_OBJ_YIELD_CNT	128
+/* Number of objects whose placement is evaluated together by the scanner */
+#define SCAN_BATCH_SIZE		64
+
+/* Per-pool, per-target rebuild metrics */
+struct rebuild_pool_metrics {
+	struct d_tm_node_t	*rpm_scan_objs;
+	struct d_tm_node_t	*rpm_scan_shards;
+	struct d_tm_node_t	*rpm_scan_rate;
+};
+
+extern struct dss_module_metrics rebuild_metrics;
 
 extern struct dss_module_key rebuild_module_key;
 static inline struct rebuild_tls *
@@ -388,6 +388,14 @@ rebuild_object_insert(struct rebuild_tgt_pool_tracker *rpt, uuid_t co_uuid,
 
 #define LOCAL_ARRAY_SIZE	128
 #define NUM_SHARDS_STEP_INCREASE	10
+
+/* An object collected by the scanner, waiting for placement evaluation */
+struct rebuild_scan_ent {
+	daos_unit_oid_t		rse_oid;
+	daos_epoch_t		rse_epoch;
+	uint32_t		rse_vis_flags;
+};
+
 /* The structure for scan per xstream */
 struct rebuild_scan_arg {
 	struct rebuild_tgt_pool_tracker *rpt;
@@ -396,16 +404,33 @@ struct rebuild_scan_arg {
 	int				snapshot_cnt;
 	uint32_t			yield_freq;
 	int32_t				obj_yield_cnt;
+	/* objects pending placement evaluation */
+	struct rebuild_scan_ent		*batch;
+	int				batch_nr;
+	/* placement input and output of a reclaim batch */
+	struct daos_obj_md		*mds;
+	struct pl_obj_layout		**layouts;
+	/* VOS handle of the container being scanned */
+	daos_handle_t			coh;
+	/* placement output scratch shared by all objects of the scan */
+	unsigned int			*tgts;
+	unsigned int			*shards;
+	uint32_t			shards_size;
+	/* scan progress */
+	struct rebuild_pool_metrics	*metrics;
+	uint64_t			scan_start;
+	uint64_t			objs_scanned;
+	uint64_t			objs_reported;
+	uint64_t			shards_found;
 };
 
 /**
  * Invoke placement to find the object shards that need rebuilding
  *
- * This is an optimized function - it first tries to use the provided stack
- * arrays to avoid allocating buffers to fill.
+ * The caller provides the output arrays, which are reused across objects.
  *
- * It's possible that placement might return -DER_REC2BIG, in which case a
- * larger buffer will be allocated and the request repeated until it succeeds.
+ * It's possible that placement might return -DER_REC2BIG, in which case the
+ * arrays are enlarged and the request repeated until it succeeds.
  *
  * \param[in]	map			placement map
  * \param[in]	gl_layout_ver		global layout version from pool/container.
@@ -414,11 +439,9 @@ struct rebuild_scan_arg {
  * \param[in]	rebuild_op		the rebuild operation
  * \param[in]	rebuild_ver		the rebuild version
  * \param[in]	myrank			this system's rank
- * \param[out]	tgts			filled remap list, caller must free if
- *					it is re-allocated.
- * \param[out]	shards			filled remap list, caller must free if
- *					it is re-allocated.
- * \param[in]   orig_array_size		original size of tgts and shards
+ * \param[in,out] tgts			remap list, may be re-allocated.
+ * \param[in,out] shards		remap list, may be re-allocated.
+ * \param[in,out] array_size		size of tgts and shards
  *
  * \retval	>= 0	Success
  * \retval	> 0	number of filled entries in tgts and shards needs to be remapped
@@ -428,28 +451,30 @@ static int
 find_rebuild_shards(struct pl_map *map, uint32_t gl_layout_ver, struct daos_obj_md *md,
 		    uint32_t num_rebuild_tgts, daos_rebuild_opc_t rebuild_op,
 		    uint32_t rebuild_ver, d_rank_t myrank, unsigned int **tgts,
-		    unsigned int **shards, uint32_t orig_array_size)
+		    unsigned int **shards, uint32_t *array_size)
 {
-	uint32_t max_shards_size = orig_array_size;
-	int	rc = 0;
+	unsigned int	*new_tgts;
+	unsigned int	*new_shards;
+	uint32_t	 new_size;
+	int		 rc = 0;
 
 retry:
 	switch (rebuild_op) {
 	case RB_OP_EXCLUDE:
 		rc = pl_obj_find_rebuild(map, gl_layout_ver, md, NULL, rebuild_ver,
-					 *tgts, *shards, max_shards_size);
+					 *tgts, *shards, *array_size);
 		break;
 	case RB_OP_DRAIN:
 		rc = pl_obj_find_drain(map, gl_layout_ver, md, NULL, rebuild_ver,
-				       *tgts, *shards, max_shards_size);
+				       *tgts, *shards, *array_size);
 		break;
 	case RB_OP_REINT:
 		rc = pl_obj_find_reint(map, gl_layout_ver, md, NULL, rebuild_ver,
-				       *tgts, *shards, max_shards_size);
+				       *tgts, *shards, *array_size);
 		break;
 	case RB_OP_EXTEND:
 		rc = pl_obj_find_addition(map, gl_layout_ver, md, NULL, rebuild_ver,
-					  *tgts, *shards, max_shards_size);
+					  *tgts, *shards, *array_size);
 		break;
 	default:
 		D_ASSERT(0);
@@ -460,70 +485,52 @@ retry:
 		 * The last attempt failed because there was not enough
 		 * room for all the remapped shards.
 		 *
-		 * Need to allocate more space and try again
+		 * Increase by the step size and try again. The larger
+		 * arrays are kept for the following objects.
 		 */
-		if (max_shards_size != orig_array_size && *tgts != NULL)
-			D_FREE(*tgts);
-		if (max_shards_size != orig_array_size && *shards != NULL)
-			D_FREE(*shards);
-
-		/* Increase by the step size */
-		max_shards_size += NUM_SHARDS_STEP_INCREASE;
+		new_size = *array_size + NUM_SHARDS_STEP_INCREASE;
 		D_DEBUG(DB_REBUILD, "Got REC2BIG, increase rebuild array size by %u to %u",
-			NUM_SHARDS_STEP_INCREASE, max_shards_size);
-		D_ALLOC_ARRAY(*tgts, max_shards_size);
-		D_ALLOC_ARRAY(*shards, max_shards_size);
-		if (*tgts == NULL || *shards == NULL)
-			D_GOTO(out, rc = -DER_NOMEM);
+			NUM_SHARDS_STEP_INCREASE, new_size);
+		D_REALLOC_ARRAY(new_tgts, *tgts, *array_size, new_size);
+		if (new_tgts == NULL)
+			return -DER_NOMEM;
+		*tgts = new_tgts;
+
+		D_REALLOC_ARRAY(new_shards, *shards, *array_size, new_size);
+		if (new_shards == NULL)
+			return -DER_NOMEM;
+		*shards = new_shards;
+		*array_size = new_size;
 
 		goto retry;
 	}
 
-out:
-	if (rc < 0) {
-		/*
-		 * Free any non-stack buffers that were allocated
-		 * on the last attempt
-		 */
-		if (max_shards_size != orig_array_size && *tgts != NULL)
-			D_FREE(*tgts);
-		if (max_shards_size != orig_array_size && *shards != NULL)
-			D_FREE(*shards);
-	}
-
 	return rc;
 }
 
 static int
-obj_reclaim(struct pl_map *map, uint32_t layout_ver, uint32_t new_layout_ver,
-	    struct daos_obj_md *md, struct rebuild_tgt_pool_tracker *rpt,
-	    d_rank_t myrank, daos_unit_oid_t oid, vos_iter_param_t *param,
-	    unsigned *acts)
+obj_reclaim(struct rebuild_scan_arg *arg, struct pl_obj_layout *layout, d_rank_t myrank,
+	    daos_unit_oid_t oid, unsigned *acts)
 {
+	struct rebuild_tgt_pool_tracker *rpt = arg->rpt;
 	uint32_t		mytarget = dss_get_module_info()->dmi_tgt_id;
-	struct pl_obj_layout	*layout = NULL;
 	struct rebuild_pool_tls *tls;
 	daos_epoch_range_t	discard_epr;
 	bool			still_needed;
 	int			rc;
 
 	/*
-	 * Compute placement for the object, then check if the layout
-	 * still includes the current rank. If not, the object can be
-	 * deleted/reclaimed because it is no longer reachable
+	 * Check if the layout of the object still includes the current
+	 * rank. If not, the object can be deleted/reclaimed because it is
+	 * no longer reachable
 	 */
-	rc = pl_obj_place(map, layout_ver, md, DAOS_OO_RO, -1, NULL, &layout);
-	if (rc != 0)
-		return rc;
-
 	still_needed = pl_obj_layout_contains(rpt->rt_pool->sp_map, layout, myrank, mytarget,
 					      oid.id_shard);
-	pl_obj_layout_free(layout);
-	if (still_needed && new_layout_ver <= oid.id_layout_ver)
+	if (still_needed && rpt->rt_new_layout_ver <= oid.id_layout_ver)
 		return 0;
 
 	D_DEBUG(DB_REBUILD, "deleting stale object "DF_UOID" rank %u tgt %u oid layout %u/%u",
-		DP_UOID(oid), myrank, mytarget, oid.id_layout_ver, new_layout_ver);
+		DP_UOID(oid), myrank, mytarget, oid.id_layout_ver, rpt->rt_new_layout_ver);
 	tls = rebuild_pool_tls_lookup(rpt->rt_pool_uuid, rpt->rt_rebuild_ver, rpt->rt_rebuild_gen);
 	D_ASSERT(tls != NULL);
 	tls->rebuild_pool_reclaim_obj_count++;
@@ -538,7 +545,7 @@ obj_reclaim(struct pl_map *map, uint32_t layout_ver, uint32_t new_layout_ver,
 	do {
 		/* Inform the iterator and delete the object */
 		*acts |= VOS_ITER_CB_DELETE;
-		rc = vos_discard(param->ip_hdl, &oid, &discard_epr, NULL, NULL);
+		rc = vos_discard(arg->coh, &oid, &discard_epr, NULL, NULL);
 		if (rc != -DER_BUSY && rc != -DER_INPROGRESS)
 			break;
 
@@ -613,7 +620,8 @@ rebuild_object_local(struct rebuild_tgt_pool_tracker *rpt, uuid_t co_uuid,
 
 static int
 rebuild_object(struct rebuild_tgt_pool_tracker *rpt, uuid_t co_uuid, daos_unit_oid_t oid,
-	       unsigned int tgt, uint32_t shard, d_rank_t myrank, vos_iter_entry_t *ent)
+	       unsigned int tgt, uint32_t shard, d_rank_t myrank, daos_epoch_t epoch,
+	       uint32_t vis_flags)
 {
 	uint32_t		mytarget = dss_get_module_info()->dmi_tgt_id;
 	struct pool_target	*target;
@@ -632,11 +640,11 @@ rebuild_object(struct rebuild_tgt_pool_tracker *rpt, uuid_t co_uuid, daos_unit_o
 		return 0;
 	}
 
-	if (ent->ie_vis_flags & VOS_VIS_FLAG_COVERED) {
+	if (vis_flags & VOS_VIS_FLAG_COVERED) {
 		eph = 0;
-		punched_eph = ent->ie_epoch;
+		punched_eph = epoch;
 	} else {
-		eph = ent->ie_epoch;
+		eph = epoch;
 		punched_eph = 0;
 	}
 
@@ -649,84 +657,60 @@ rebuild_object(struct rebuild_tgt_pool_tracker *rpt, uuid_t co_uuid, daos_unit_o
 	return rc;
 }
 
+static void
+rebuild_scan_metrics_update(struct rebuild_scan_arg *arg)
+{
+	uint64_t	elapsed;
+
+	if (arg->metrics == NULL || arg->objs_scanned == arg->objs_reported)
+		return;
+
+	d_tm_inc_counter(arg->metrics->rpm_scan_objs, arg->objs_scanned - arg->objs_reported);
+	arg->objs_reported = arg->objs_scanned;
+
+	elapsed = daos_gettime_coarse() - arg->scan_start;
+	d_tm_set_gauge(arg->metrics->rpm_scan_rate,
+		       arg->objs_scanned / (elapsed == 0 ? 1 : elapsed));
+}
+
+/* Find the shards to rebuild for one collected object and queue them */
 static int
-rebuild_obj_scan_cb(daos_handle_t ch, vos_iter_entry_t *ent,
-		    vos_iter_type_t type, vos_iter_param_t *param,
-		    void *data, unsigned *acts)
+rebuild_obj_scan_one(struct rebuild_scan_arg *arg, struct pl_map *map, d_rank_t myrank,
+		     struct rebuild_scan_ent *rse)
 {
-	struct rebuild_scan_arg		*arg = data;
 	struct rebuild_tgt_pool_tracker *rpt = arg->rpt;
-	struct pl_map			*map = NULL;
 	struct daos_obj_md		md;
-	daos_unit_oid_t			oid = ent->ie_oid;
-	unsigned int			tgt_array[LOCAL_ARRAY_SIZE];
-	unsigned int			shard_array[LOCAL_ARRAY_SIZE];
-	unsigned int			*tgts = NULL;
-	unsigned int			*shards = NULL;
+	daos_unit_oid_t			oid = rse->rse_oid;
 	struct daos_oclass_attr		*oc_attr;
 	uint32_t			grp_size;
-	int				rebuild_nr = 0;
-	d_rank_t			myrank;
+	int				rebuild_nr;
 	int				i;
-	int				rc = 0;
-
-	if (rpt->rt_abort) {
-		D_DEBUG(DB_REBUILD, "rebuild is aborted\n");
-		return 1;
-	}
-
-	/* If the OID is invisible, then snapshots must be created on the object. */
-	D_ASSERTF(!(ent->ie_vis_flags & VOS_VIS_FLAG_COVERED) || arg->snapshot_cnt > 0,
-		  "flags %x snapshot_cnt %d\n", ent->ie_vis_flags, arg->snapshot_cnt);
-	map = pl_map_find(rpt->rt_pool_uuid, oid.id_pub);
-	if (map == NULL) {
-		D_ERROR(DF_UOID ": Cannot find valid placement map" DF_UUID "\n", DP_UOID(oid),
-			DP_UUID(rpt->rt_pool_uuid));
-		D_GOTO(out, rc = -DER_INVAL);
-	}
+	int				rc;
 
 	oc_attr = daos_oclass_attr_find(oid.id_pub, NULL);
 	if (oc_attr == NULL) {
 		D_INFO(DF_UUID" skip invalid "DF_UOID"\n", DP_UUID(rpt->rt_pool_uuid),
 		       DP_UOID(oid));
-		D_GOTO(out, rc = 0);
+		return 0;
 	}
 
 	grp_size = daos_oclass_grp_size(oc_attr);
 
 	dc_obj_fetch_md(oid.id_pub, &md);
-	crt_group_rank(rpt->rt_pool->sp_group, &myrank);
 	md.omd_ver = rpt->rt_rebuild_ver;
 	md.omd_fdom_lvl = arg->co_props.dcp_redun_lvl;
-	tgts = tgt_array;
-	shards = shard_array;
-	switch (rpt->rt_rebuild_op) {
-	case RB_OP_EXCLUDE:
-	case RB_OP_DRAIN:
-	case RB_OP_REINT:
-	case RB_OP_EXTEND:
+	if (rpt->rt_rebuild_op == RB_OP_UPGRADE)
+		rc = obj_layout_diff(map, oid, rpt->rt_new_layout_ver,
+				     arg->co_props.dcp_obj_version, &md, arg->tgts, arg->shards);
+	else
 		rc = find_rebuild_shards(map, arg->co_props.dcp_obj_version, &md,
 					 rpt->rt_tgts_num, rpt->rt_rebuild_op,
 					 rpt->rt_rebuild_ver, myrank,
-					 &tgts, &shards, LOCAL_ARRAY_SIZE);
-		break;
-	case RB_OP_RECLAIM:
-	case RB_OP_FAIL_RECLAIM:
-		rc = obj_reclaim(map, arg->co_props.dcp_obj_version, rpt->rt_new_layout_ver,
-				 &md, rpt, myrank, oid, param, acts);
-		break;
-	case RB_OP_UPGRADE:
-		rc = obj_layout_diff(map, oid, rpt->rt_new_layout_ver,
-				     arg->co_props.dcp_obj_version, &md, tgts, shards);
-		break;
-	default:
-		D_ASSERT(0);
-	}
-
+					 &arg->tgts, &arg->shards, &arg->shards_size);
 	if (rc <= 0) {
 		D_CDEBUG(rc == 0, DB_REBUILD, DLOG_ERR, DF_UOID" rebuild shards:" DF_RC"\n",
 			 DP_UOID(oid), DP_RC(rc));
-		D_GOTO(out, rc);
+		return rc;
 	}
 
 	rebuild_nr = rc;
@@ -735,38 +719,157 @@ rebuild_obj_scan_cb(daos_handle_t ch, vos_iter_entry_t *ent,
 		D_DEBUG(DB_REBUILD, "rebuild obj "DF_UOID"/"DF_UUID"/"DF_UUID
 			"on %d for shard %d eph "DF_U64" visible %s\n", DP_UOID(oid),
 			DP_UUID(rpt->rt_pool_uuid), DP_UUID(arg->co_uuid),
-			tgts[i], shards[i], ent->ie_epoch,
-			ent->ie_vis_flags & VOS_VIS_FLAG_COVERED ? "no" : "yes");
+			arg->tgts[i], arg->shards[i], rse->rse_epoch,
+			rse->rse_vis_flags & VOS_VIS_FLAG_COVERED ? "no" : "yes");
 
 		/* Ignore the shard if it is not in the same group of failure shard */
-		if (oid.id_shard / grp_size != shards[i] / grp_size) {
+		if (oid.id_shard / grp_size != arg->shards[i] / grp_size) {
 			D_DEBUG(DB_REBUILD, "stale object "DF_UOID" shards %u grp_size %u\n",
-				DP_UOID(oid), shards[i], grp_size);
+				DP_UOID(oid), arg->shards[i], grp_size);
 			continue;
 		}
 
-		rc = rebuild_object(rpt, arg->co_uuid, oid, tgts[i], shards[i], myrank, ent);
+		rc = rebuild_object(rpt, arg->co_uuid, oid, arg->tgts[i], arg->shards[i], myrank,
+				    rse->rse_epoch, rse->rse_vis_flags);
 		if (rc)
-			D_GOTO(out, rc);
+			break;
 
+		arg->shards_found++;
 		arg->obj_yield_cnt--;
 	}
 
+	return rc;
+}
+
+/* Discard the collected objects which are not placed on this target anymore */
+static int
+rebuild_obj_reclaim_batch(struct rebuild_scan_arg *arg, struct pl_map *map, d_rank_t myrank,
+			  unsigned *acts)
+{
+	struct rebuild_tgt_pool_tracker *rpt = arg->rpt;
+	daos_unit_oid_t			oid;
+	int				nr = 0;
+	int				i;
+	int				rc;
+
+	for (i = 0; i < arg->batch_nr; i++) {
+		oid = arg->batch[i].rse_oid;
+		if (daos_oclass_attr_find(oid.id_pub, NULL) == NULL) {
+			D_INFO(DF_UUID" skip invalid "DF_UOID"\n", DP_UUID(rpt->rt_pool_uuid),
+			       DP_UOID(oid));
+			continue;
+		}
+
+		arg->batch[nr] = arg->batch[i];
+		dc_obj_fetch_md(oid.id_pub, &arg->mds[nr]);
+		arg->mds[nr].omd_ver = rpt->rt_rebuild_ver;
+		arg->mds[nr].omd_fdom_lvl = arg->co_props.dcp_redun_lvl;
+		nr++;
+	}
+
+	if (nr == 0)
+		return 0;
+
+	rc = pl_obj_place_batch(map, arg->co_props.dcp_obj_version, arg->mds, nr, DAOS_OO_RO,
+				-1, arg->layouts);
+	if (rc != 0) {
+		D_ERROR(DF_UUID" reclaim placement of %d objects: "DF_RC"\n",
+			DP_UUID(rpt->rt_pool_uuid), nr, DP_RC(rc));
+		return rc;
+	}
+
+	for (i = 0; i < nr; i++) {
+		if (rc == 0) {
+			rc = obj_reclaim(arg, arg->layouts[i], myrank, arg->batch[i].rse_oid, acts);
+			if (rc < 0)
+				D_ERROR(DF_UOID" reclaim: "DF_RC"\n",
+					DP_UOID(arg->batch[i].rse_oid), DP_RC(rc));
+		}
+		pl_obj_layout_free(arg->layouts[i]);
+	}
+
+	return rc;
+}
+
+/**
+ * Evaluate placement for all collected objects at once, so the placement
+ * map lookup, the rank query and the output arrays are shared by the batch.
+ * Reclaim discards the objects behind the iterator, \a acts tells it to
+ * probe again.
+ */
+static int
+rebuild_obj_scan_flush(struct rebuild_scan_arg *arg, unsigned *acts)
+{
+	struct rebuild_tgt_pool_tracker *rpt = arg->rpt;
+	struct pl_map			*map;
+	d_rank_t			myrank;
+	uint64_t			shards_found = arg->shards_found;
+	int				i;
+	int				rc = 0;
+
+	if (arg->batch_nr == 0)
+		return 0;
+
+	map = pl_map_find(rpt->rt_pool_uuid, arg->batch[0].rse_oid.id_pub);
+	if (map == NULL) {
+		D_ERROR(DF_UUID": Cannot find valid placement map\n", DP_UUID(rpt->rt_pool_uuid));
+		D_GOTO(out, rc = -DER_INVAL);
+	}
+
+	crt_group_rank(rpt->rt_pool->sp_group, &myrank);
+	if (rpt->rt_rebuild_op == RB_OP_RECLAIM || rpt->rt_rebuild_op == RB_OP_FAIL_RECLAIM) {
+		rc = rebuild_obj_reclaim_batch(arg, map, myrank, acts);
+	} else {
+		for (i = 0; i < arg->batch_nr; i++) {
+			rc = rebuild_obj_scan_one(arg, map, myrank, &arg->batch[i]);
+			if (rc)
+				break;
+		}
+	}
+
+	pl_map_decref(map);
+	if (arg->metrics != NULL)
+		d_tm_inc_counter(arg->metrics->rpm_scan_shards, arg->shards_found - shards_found);
 out:
-	if (tgts != tgt_array && tgts != NULL)
-		D_FREE(tgts);
+	arg->batch_nr = 0;
+	rebuild_scan_metrics_update(arg);
+	return rc;
+}
 
-	if (shards != shard_array && shards != NULL)
-		D_FREE(shards);
+static int
+rebuild_obj_scan_cb(daos_handle_t ch, vos_iter_entry_t *ent,
+		    vos_iter_type_t type, vos_iter_param_t *param,
+		    void *data, unsigned *acts)
+{
+	struct rebuild_scan_arg		*arg = data;
+	struct rebuild_tgt_pool_tracker *rpt = arg->rpt;
+	struct rebuild_scan_ent		*rse;
+	int				rc = 0;
 
-	if (map != NULL)
-		pl_map_decref(map);
+	if (rpt->rt_abort) {
+		D_DEBUG(DB_REBUILD, "rebuild is aborted\n");
+		return 1;
+	}
+
+	/* If the OID is invisible, then snapshots must be created on the object. */
+	D_ASSERTF(!(ent->ie_vis_flags & VOS_VIS_FLAG_COVERED) || arg->snapshot_cnt > 0,
+		  "flags %x snapshot_cnt %d\n", ent->ie_vis_flags, arg->snapshot_cnt);
+	arg->objs_scanned++;
+
+	/* Collect the object, placement is evaluated once the batch is full */
+	rse = &arg->batch[arg->batch_nr++];
+	rse->rse_oid = ent->ie_oid;
+	rse->rse_epoch = ent->ie_epoch;
+	rse->rse_vis_flags = ent->ie_vis_flags;
+	if (arg->batch_nr == SCAN_BATCH_SIZE)
+		rc = rebuild_obj_scan_flush(arg, acts);
 
 	if (--arg->yield_freq == 0 || arg->obj_yield_cnt <= 0) {
 		D_DEBUG(DB_REBUILD, DF_UUID" rebuild yield: %d\n",
 			DP_UUID(rpt->rt_pool_uuid), rc);
 		arg->yield_freq = SCAN_YIELD_FREQ;
 		arg->obj_yield_cnt = SCAN_OBJ_YIELD_CNT;
+		rebuild_scan_metrics_update(arg);
 		if (rc == 0)
 			dss_sleep(0);
 		*acts |= VOS_ITER_CB_YIELD;
@@ -790,6 +893,7 @@ rebuild_container_scan_cb(daos_handle_t ih, vos_iter_entry_t *entry,
 	struct dtx_id			dti = { 0 };
 	struct dtx_epoch		epoch = { 0 };
 	daos_unit_oid_t			oid = { 0 };
+	unsigned int			obj_acts = 0;
 	int				snapshot_cnt = 0;
 	int				rc;
 
@@ -854,8 +958,13 @@ rebuild_container_scan_cb(daos_handle_t ih, vos_iter_entry_t *entry,
 	if (snapshot_cnt > 0)
 		param.ip_flags |= VOS_IT_PUNCHED;
 
+	arg->coh = coh;
 	rc = vos_iterate(&param, VOS_ITER_OBJ, false, &anchor,
 			 rebuild_obj_scan_cb, NULL, arg, dth);
+	if (rc == 0)
+		rc = rebuild_obj_scan_flush(arg, &obj_acts);
+	else
+		arg->batch_nr = 0;
 	dtx_end(dth, NULL, rc);
 
 	vos_cont_close(coh);
@@ -932,19 +1041,39 @@ rebuild_scanner(void *data)
 	if (child == NULL)
 		D_GOTO(out, rc = -DER_NONEXIST);
 
+	D_ALLOC_ARRAY(arg.batch, SCAN_BATCH_SIZE);
+	D_ALLOC_ARRAY(arg.mds, SCAN_BATCH_SIZE);
+	D_ALLOC_ARRAY(arg.layouts, SCAN_BATCH_SIZE);
+	D_ALLOC_ARRAY(arg.tgts, LOCAL_ARRAY_SIZE);
+	D_ALLOC_ARRAY(arg.shards, LOCAL_ARRAY_SIZE);
+	if (arg.batch == NULL || arg.mds == NULL || arg.layouts == NULL || arg.tgts == NULL ||
+	    arg.shards == NULL) {
+		ds_pool_child_put(child);
+		D_GOTO(out, rc = -DER_NOMEM);
+	}
+
 	param.ip_hdl = child->spc_hdl;
 	param.ip_flags = VOS_IT_FOR_MIGRATION;
 	arg.rpt = rpt;
 	arg.yield_freq = SCAN_YIELD_FREQ;
 	arg.obj_yield_cnt = SCAN_OBJ_YIELD_CNT;
+	arg.shards_size = LOCAL_ARRAY_SIZE;
+	arg.metrics = child->spc_metrics[DAOS_REBUILD_MODULE];
+	arg.scan_start = daos_gettime_coarse();
 	if (!rebuild_status_match(rpt, PO_COMP_ST_UP)) {
 		rc = vos_iterate(&param, VOS_ITER_COUUID, false, &anchor,
 				 rebuild_container_scan_cb, NULL, &arg, NULL);
 	}
 
+	rebuild_scan_metrics_update(&arg);
 	ds_pool_child_put(child);
 
 out:
+	D_FREE(arg.batch);
+	D_FREE(arg.mds);
+	D_FREE(arg.layouts);
+	D_FREE(arg.tgts);
+	D_FREE(arg.shards);
 	tls->rebuild_pool_scan_done = 1;
 	if (ult_send != ABT_THREAD_NULL)
 		ABT_thread_free(&ult_send);
@@ -952,8 +1081,9 @@ out:
 	if (tls->rebuild_pool_status == 0 && rc != 0)
 		tls->rebuild_pool_status = rc;
 
-	D_DEBUG(DB_REBUILD, DF_UUID" iterate pool done: "DF_RC"\n",
-		DP_UUID(rpt->rt_pool_uuid), DP_RC(rc));
+	D_DEBUG(DB_REBUILD, DF_UUID" iterate pool done, "DF_U64" objs "DF_U64" shards: "
+		DF_RC"\n", DP_UUID(rpt->rt_pool_uuid), arg.objs_scanned, arg.shards_found,
+		DP_RC(rc));
 	return rc;
 }
 
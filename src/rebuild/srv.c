@@ -2519,6 +2519,58 @@ rebuild_cleanup(void)
 	return 0;
 }
 
+static void *
+rebuild_metrics_alloc(const char *path, int tgt_id)
+{
+	struct rebuild_pool_metrics	*metrics;
+	int				 rc;
+
+	D_ASSERT(tgt_id >= 0);
+
+	D_ALLOC_PTR(metrics);
+	if (metrics == NULL)
+		return NULL;
+
+	rc = d_tm_add_metric(&metrics->rpm_scan_objs, D_TM_COUNTER,
+			     "total number of objects scanned by rebuild", "objs",
+			     "%s/rebuild/scan_objs/tgt_%u", path, tgt_id);
+	if (rc != 0)
+		D_WARN("Failed to create rebuild scan objs metric: "DF_RC"\n", DP_RC(rc));
+
+	rc = d_tm_add_metric(&metrics->rpm_scan_shards, D_TM_COUNTER,
+			     "total number of shards found to rebuild by scan", "shards",
+			     "%s/rebuild/scan_shards/tgt_%u", path, tgt_id);
+	if (rc != 0)
+		D_WARN("Failed to create rebuild scan shards metric: "DF_RC"\n", DP_RC(rc));
+
+	rc = d_tm_add_metric(&metrics->rpm_scan_rate, D_TM_GAUGE,
+			     "objects scanned per second by the current rebuild", "objs/s",
+			     "%s/rebuild/scan_rate/tgt_%u", path, tgt_id);
+	if (rc != 0)
+		D_WARN("Failed to create rebuild scan rate metric: "DF_RC"\n", DP_RC(rc));
+
+	return metrics;
+}
+
+static void
+rebuild_metrics_free(void *data)
+{
+	D_FREE(data);
+}
+
+static int
+rebuild_metrics_count(void)
+{
+	return (sizeof(struct rebuild_pool_metrics) / sizeof(struct d_tm_node_t *));
+}
+
+struct dss_module_metrics rebuild_metrics = {
+	.dmm_tags = DAOS_TGT_TAG,
+	.dmm_init = rebuild_metrics_alloc,
+	.dmm_fini = rebuild_metrics_free,
+	.dmm_nr_metrics = rebuild_metrics_count,
+};
+
 struct dss_module rebuild_module = {
 	.sm_name	= "rebuild",
 	.sm_mod_id	= DAOS_REBUILD_MODULE,
@@ -2531,4 +2583,5 @@ struct dss_module rebuild_module = {
 	.sm_cli_count	= 0,
 	.sm_handlers	= rebuild_handlers,
 	.sm_key		= &rebuild_module_key,
+	.sm_metrics	= &rebuild_metrics,
 };
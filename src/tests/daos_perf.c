@@ -32,6 +32,17 @@ enum {
 int	ts_mode = TS_MODE_DAOS;
 int	ts_class = OC_SX;
 
+/* record the latency of asynchronous I/O of the workload test */
+static int
+daos_lat_comp_cb(void *arg, daos_event_t *ev, int rc)
+{
+	struct io_credit *cred = arg;
+
+	if (rc == 0 && ts_hists != NULL)
+		pf_hist_record(&ts_hists[cred->tc_op], daos_get_ntime() - cred->tc_start);
+	return rc;
+}
+
 static int
 daos_update_or_fetch(int obj_idx, enum ts_op_type op_type,
 		     struct io_credit *cred, daos_epoch_t epoch,
@@ -43,6 +54,11 @@ daos_update_or_fetch(int obj_idx, enum ts_op_type op_type,
 
 	if (!dts_is_async(&ts_ctx))
 		TS_TIME_START(duration, start);
+	if (evp != NULL && ts_hists != NULL) {
+		rc = daos_event_register_comp_cb(evp, daos_lat_comp_cb, cred);
+		if (rc)
+			return rc;
+	}
 	if (op_type == TS_DO_UPDATE) {
 		rc = daos_obj_update(ts_ohs[obj_idx], DAOS_TX_NONE, 0,
 				     &cred->tc_dkey, 1, &cred->tc_iod,
@@ -139,6 +155,24 @@ pf_fetch(struct pf_test *ts, struct pf_param *param)
 	return rc;
 }
 
+static int
+pf_workload(struct pf_test *ts, struct pf_param *param)
+{
+	int	rc;
+
+	rc = objects_open();
+	if (rc)
+		return rc;
+
+	param->pa_rw.verify = false;
+	rc = objects_workload(param);
+	if (rc)
+		return rc;
+
+	rc = objects_close();
+	return rc;
+}
+
 static int
 pf_verify(struct pf_test *ts, struct pf_param *param)
 {
@@ -243,6 +277,12 @@ struct pf_test pf_tests[] = {
 		.ts_parse	= pf_parse_oit,
 		.ts_func	= pf_oit,
 	},
+	{
+		.ts_code	= 'W',
+		.ts_name	= "WORKLOAD",
+		.ts_parse	= pf_parse_workload,
+		.ts_func	= pf_workload,
+	},
 	{
 		.ts_code	= 0,
 	},
@@ -291,7 +331,8 @@ const char perf_daos_usage[] = "\n"
 "-g dmg_conf\n"
 "	dmg configuration file.\n\n"
 "Examples:\n"
-"	$ daos_perf -C 16 -A -R 'U;p F;i=5;p V'\n";
+"	$ daos_perf -C 16 -A -R 'U;p F;i=5;p V'\n"
+"	$ daos_perf -C 16 -R 'U W;r=80;z=99;q=20k;c=200k;p;j'\n";
 
 static void
 ts_print_usage(void)
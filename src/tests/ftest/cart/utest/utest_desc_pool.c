@@ -0,0 +1,182 @@
+/*
+ * (C) Copyright 2026 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * This file is part of CaRT testing. It checks the per-context pools of RPC
+ * descriptors of the CRT_RPC_FEAT_POOLED opcodes.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+
+#include <cmocka.h>
+
+#include <cart/api.h>
+#include "../cart/crt_internal.h"
+
+#define DP_POOL_IDX	1
+#define DP_RPC_SIZE	(sizeof(struct crt_rpc_priv) + 256)
+
+static struct crt_opc_info dp_pooled = {
+	.coi_pooled	= 1,
+	.coi_pool_idx	= DP_POOL_IDX,
+	.coi_rpc_size	= DP_RPC_SIZE,
+};
+
+static struct crt_opc_info dp_plain = {
+	.coi_rpc_size	= DP_RPC_SIZE,
+};
+
+static struct crt_context *
+dp_ctx_create(void)
+{
+	struct crt_context	*ctx;
+
+	D_ALLOC_PTR(ctx);
+	assert_non_null(ctx);
+	assert_int_equal(crt_desc_pools_init(ctx), 0);
+
+	return ctx;
+}
+
+static void
+dp_ctx_destroy(struct crt_context *ctx)
+{
+	crt_desc_pools_fini(ctx);
+	D_FREE(ctx);
+}
+
+static void
+test_desc_reuse(void **state)
+{
+	struct crt_context	*ctx = dp_ctx_create();
+	struct crt_desc_pool	*pool = ctx->cc_desc_pools[DP_POOL_IDX];
+	struct crt_rpc_priv	**descs;
+	struct crt_rpc_priv	*rpc_priv;
+	struct crt_rpc_priv	*first;
+	int			 nr = CRT_DESC_POOL_MAX_NUM + 8;
+	int			 i;
+
+	/* the first descriptor warms the pool up */
+	first = crt_context_desc_get(ctx, &dp_pooled);
+	assert_non_null(first);
+	assert_true(first->crp_desc_pool == pool);
+	assert_true(pool->cdp_warm);
+	assert_int_equal(pool->cdp_num, CRT_DESC_POOL_PREPOST_NUM - 1);
+	assert_int_equal(pool->cdp_ref, 2);
+
+	/* a released descriptor is handed out again, cleared */
+	first->crp_pub.cr_ctx = ctx;
+	first->crp_timeout_sec = 10;
+	crt_context_desc_put(first);
+	assert_int_equal(pool->cdp_num, CRT_DESC_POOL_PREPOST_NUM);
+	assert_int_equal(pool->cdp_ref, 1);
+
+	rpc_priv = crt_context_desc_get(ctx, &dp_pooled);
+	assert_true(rpc_priv == first);
+	assert_null(rpc_priv->crp_pub.cr_ctx);
+	assert_int_equal(rpc_priv->crp_timeout_sec, 0);
+	assert_true(rpc_priv->crp_desc_pool == pool);
+	crt_context_desc_put(rpc_priv);
+
+	/* other opcodes and descriptors without context are not pooled */
+	rpc_priv = crt_context_desc_get(ctx, &dp_plain);
+	assert_non_null(rpc_priv);
+	assert_null(rpc_priv->crp_desc_pool);
+	crt_context_desc_put(rpc_priv);
+
+	rpc_priv = crt_context_desc_get(NULL, &dp_pooled);
+	assert_non_null(rpc_priv);
+	assert_null(rpc_priv->crp_desc_pool);
+	crt_context_desc_put(rpc_priv);
+
+	assert_int_equal(pool->cdp_num, CRT_DESC_POOL_PREPOST_NUM);
+	assert_int_equal(pool->cdp_ref, 1);
+	assert_false(ctx->cc_desc_pools[0]->cdp_warm);
+
+	/* beyond the cached ones descriptors come from the heap, the pool is capped */
+	D_ALLOC_ARRAY(descs, nr);
+	assert_non_null(descs);
+	for (i = 0; i < nr; i++) {
+		descs[i] = crt_context_desc_get(ctx, &dp_pooled);
+		assert_non_null(descs[i]);
+		assert_true(descs[i]->crp_desc_pool == pool);
+	}
+	assert_int_equal(pool->cdp_num, 0);
+	assert_int_equal(pool->cdp_ref, nr + 1);
+
+	for (i = 0; i < nr; i++)
+		crt_context_desc_put(descs[i]);
+	assert_int_equal(pool->cdp_num, CRT_DESC_POOL_MAX_NUM);
+	assert_int_equal(pool->cdp_ref, 1);
+
+	D_FREE(descs);
+	dp_ctx_destroy(ctx);
+}
+
+static void
+test_desc_put_after_destroy(void **state)
+{
+	struct crt_context	*ctx = dp_ctx_create();
+	struct crt_desc_pool	*pool;
+	struct crt_rpc_priv	*rpc_a;
+	struct crt_rpc_priv	*rpc_b;
+
+	rpc_a = crt_context_desc_get(ctx, &dp_pooled);
+	rpc_b = crt_context_desc_get(ctx, &dp_pooled);
+	assert_non_null(rpc_a);
+	assert_non_null(rpc_b);
+	rpc_a->crp_pub.cr_ctx = ctx;
+	rpc_b->crp_pub.cr_ctx = ctx;
+	pool = rpc_a->crp_desc_pool;
+
+	/* the pool outlives the context until its descriptors are released */
+	crt_desc_pools_fini(ctx);
+	assert_null(ctx->cc_desc_pools[DP_POOL_IDX]);
+	assert_false(pool->cdp_enabled);
+	assert_int_equal(pool->cdp_num, 0);
+	assert_int_equal(pool->cdp_ref, 2);
+
+	/* poison the destroyed context, releasing must not look at it */
+	memset(ctx, 0xa5, sizeof(*ctx));
+
+	crt_context_desc_put(rpc_a);
+	assert_int_equal(pool->cdp_num, 0);
+	assert_int_equal(pool->cdp_ref, 1);
+
+	/* the last descriptor frees the pool */
+	crt_context_desc_put(rpc_b);
+
+	D_FREE(ctx);
+}
+
+static int
+init_tests(void **state)
+{
+	return d_log_init();
+}
+
+static int
+fini_tests(void **state)
+{
+	d_log_fini();
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_desc_reuse),
+		cmocka_unit_test(test_desc_put_after_destroy),
+	};
+
+	d_register_alt_assert(mock_assert);
+
+	return cmocka_run_group_tests_name("utest_desc_pool", tests, init_tests,
+		fini_tests);
+}
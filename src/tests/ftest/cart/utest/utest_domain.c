@@ -0,0 +1,225 @@
+/*
+ * (C) Copyright 2026 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * This file is part of CaRT testing. It checks the CRT_TREE_DOMAIN topology.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+
+#include <cmocka.h>
+
+#include <cart/api.h>
+#include "../cart/crt_internal.h"
+
+#define DOM_MAX_RANKS	64
+
+#define DOM_RACK(key)	((uint32_t)((key) >> 32))
+#define DOM_NODE(key)	((key) & 0xFFFFFFFFULL)
+
+/* engines of node n of rack r, ranks are spread over the nodes round robin */
+struct dom_layout {
+	uint32_t	dl_racks;
+	uint32_t	dl_nodes[8];	/* nodes per rack */
+	uint32_t	dl_engines;	/* engines per node */
+};
+
+static uint32_t
+dom_keys_init(struct dom_layout *dl, uint64_t *keys, uint32_t *nr_nodes)
+{
+	uint64_t	nodes[DOM_MAX_RANKS];
+	uint32_t	nr = 0;
+	uint32_t	size = 0;
+	uint32_t	r, n, e;
+
+	for (r = 0; r < dl->dl_racks; r++) {
+		for (n = 0; n < dl->dl_nodes[r]; n++)
+			nodes[nr++] = ((uint64_t)r << 32) | (r * 100 + n);
+	}
+
+	for (e = 0; e < dl->dl_engines; e++) {
+		for (n = 0; n < nr; n++) {
+			assert_true(size < DOM_MAX_RANKS);
+			keys[size++] = nodes[n];
+		}
+	}
+
+	*nr_nodes = nr;
+	return size;
+}
+
+static void
+dom_children(uint32_t size, uint32_t ratio, uint32_t root, uint32_t self,
+	     uint64_t *keys, uint32_t *children, uint32_t *nr)
+{
+	uint32_t	cnt;
+	int		rc;
+
+	rc = crt_domain_get_children(size, ratio, root, self, keys, NULL, &cnt);
+	assert_int_equal(rc, 0);
+	rc = crt_domain_get_children(size, ratio, root, self, keys, children, nr);
+	assert_int_equal(rc, 0);
+	assert_int_equal(cnt, *nr);
+}
+
+static void
+dom_check_tree(struct dom_layout *dl, uint32_t ratio, uint32_t root)
+{
+	uint64_t	keys[DOM_MAX_RANKS];
+	uint32_t	children[DOM_MAX_RANKS];
+	uint32_t	parents[DOM_MAX_RANKS];
+	uint32_t	seen[DOM_MAX_RANKS] = { 0 };
+	uint32_t	size, nr_nodes, nr;
+	uint32_t	cross_rack = 0, cross_node = 0;
+	uint32_t	self, i;
+	int		rc;
+
+	size = dom_keys_init(dl, keys, &nr_nodes);
+	if (root >= size)
+		return;
+
+	rc = crt_domain_get_parent(size, ratio, root, root, keys, &parents[root]);
+	assert_int_equal(rc, -DER_INVAL);
+
+	for (self = 0; self < size; self++) {
+		if (self == root)
+			continue;
+		rc = crt_domain_get_parent(size, ratio, root, self, keys,
+					   &parents[self]);
+		assert_int_equal(rc, 0);
+		assert_true(parents[self] < size);
+		assert_int_not_equal(parents[self], self);
+	}
+
+	/* every child names self as parent, every non root rank is reached once */
+	for (self = 0; self < size; self++) {
+		dom_children(size, ratio, root, self, keys, children, &nr);
+		for (i = 0; i < nr; i++) {
+			assert_true(children[i] < size);
+			assert_int_not_equal(children[i], root);
+			assert_int_equal(parents[children[i]], self);
+			seen[children[i]]++;
+
+			if (DOM_RACK(keys[self]) != DOM_RACK(keys[children[i]]))
+				cross_rack++;
+			if (keys[self] != keys[children[i]])
+				cross_node++;
+		}
+	}
+	for (self = 0; self < size; self++)
+		assert_int_equal(seen[self], self == root ? 0 : 1);
+
+	/* every rack and node is entered once, by its leader */
+	assert_int_equal(cross_rack, dl->dl_racks - 1);
+	assert_int_equal(cross_node, nr_nodes - 1);
+
+	for (self = 0; self < size; self++) {
+		uint32_t	hops = 0;
+		uint32_t	steps = 0;
+		bool		left = false;
+		uint32_t	cur;
+
+		/*
+		 * Walking up, the ranks of the rack of self come first, once
+		 * out of it the path never comes back.
+		 */
+		for (cur = self; cur != root; cur = parents[cur]) {
+			uint32_t	up = parents[cur];
+
+			assert_true(++steps < size);
+			if (DOM_RACK(keys[cur]) != DOM_RACK(keys[up])) {
+				hops++;
+				left = true;
+			}
+			if (left)
+				assert_int_not_equal(DOM_RACK(keys[up]),
+						     DOM_RACK(keys[self]));
+		}
+		/* all rack leaders are children of the root */
+		if (dl->dl_racks - 1 <= ratio)
+			assert_true(hops <= 1);
+	}
+}
+
+static struct dom_layout dom_layouts[] = {
+	/* single node */
+	{ .dl_racks = 1, .dl_nodes = { 1 }, .dl_engines = 4 },
+	/* single rack */
+	{ .dl_racks = 1, .dl_nodes = { 5 }, .dl_engines = 2 },
+	/* uneven racks */
+	{ .dl_racks = 3, .dl_nodes = { 2, 3, 1 }, .dl_engines = 2 },
+	/* more racks than the tree ratio */
+	{ .dl_racks = 8, .dl_nodes = { 2, 2, 2, 2, 1, 1, 1, 1 },
+	  .dl_engines = 1 },
+	{ .dl_racks = 5, .dl_nodes = { 4, 1, 3, 2, 2 }, .dl_engines = 3 },
+};
+
+static void
+test_domain_tree(void **state)
+{
+	uint32_t	ratios[] = { CRT_TREE_MIN_RATIO, 3, 4, 8 };
+	uint32_t	i, j, root;
+
+	for (i = 0; i < ARRAY_SIZE(dom_layouts); i++) {
+		for (j = 0; j < ARRAY_SIZE(ratios); j++) {
+			for (root = 0; root < DOM_MAX_RANKS; root++)
+				dom_check_tree(&dom_layouts[i], ratios[j], root);
+		}
+	}
+}
+
+/* ranks of the same node without a rack, i.e. all keys equal */
+static void
+test_domain_flat(void **state)
+{
+	uint64_t	keys[8] = { 0 };
+	uint32_t	children[8];
+	uint32_t	parent, nr;
+	uint32_t	self;
+	int		rc;
+
+	dom_children(8, 4, 3, 3, keys, children, &nr);
+	assert_int_equal(nr, 7);
+
+	for (self = 0; self < 8; self++) {
+		if (self == 3)
+			continue;
+		rc = crt_domain_get_parent(8, 4, 3, self, keys, &parent);
+		assert_int_equal(rc, 0);
+		assert_int_equal(parent, 3);
+		dom_children(8, 4, 3, self, keys, children, &nr);
+		assert_int_equal(nr, 0);
+	}
+}
+
+static int
+init_tests(void **state)
+{
+	return d_log_init();
+}
+
+static int
+fini_tests(void **state)
+{
+	d_log_fini();
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_domain_tree),
+		cmocka_unit_test(test_domain_flat),
+	};
+
+	d_register_alt_assert(mock_assert);
+
+	return cmocka_run_group_tests_name("utest_domain", tests, init_tests,
+		fini_tests);
+}
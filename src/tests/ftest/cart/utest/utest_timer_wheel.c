@@ -0,0 +1,226 @@
+/*
+ * (C) Copyright 2026 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * This file is part of CaRT testing. It checks the RPC timeout wheel.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+
+#include <cmocka.h>
+
+#include <cart/api.h>
+#include "../cart/crt_internal.h"
+
+#define TW_LVL(n)	(1ULL << ((n) * CRT_TW_SLOT_BITS))
+#define TW_SPAN		TW_LVL(CRT_TW_LEVELS)
+
+/* deadlines relative to the current tick, around each level boundary */
+static const uint64_t tw_deltas[] = {
+	0, 1, TW_LVL(1) - 1, TW_LVL(1), TW_LVL(1) + 1,
+	TW_LVL(2) - 1, TW_LVL(2), TW_LVL(2) + TW_LVL(1) + 1,
+	TW_LVL(3) - 1, TW_LVL(3), TW_LVL(3) + 3 * TW_LVL(1) + 1,
+	TW_SPAN - 1,
+	/* beyond the wheel span */
+	TW_SPAN, TW_SPAN + TW_LVL(1) + 7,
+};
+
+#define TW_NR		ARRAY_SIZE(tw_deltas)
+
+static struct crt_rpc_priv	*tw_rpcs;
+static bool			 tw_expired[TW_NR];
+
+static void
+tw_rpc_set(struct crt_rpc_priv *rpc_priv, uint64_t tick)
+{
+	/* anywhere within the tick */
+	rpc_priv->crp_timeout_ts = (tick << CRT_TW_TICK_SHIFT) +
+				   (tick % (1ULL << CRT_TW_TICK_SHIFT));
+}
+
+/* Expire the wheel up to \a now_tick, return the number of expired RPCs */
+static int
+tw_expire(struct crt_timer_wheel *tw, uint64_t now_tick)
+{
+	struct crt_rpc_priv	*rpc_priv;
+	d_list_t		 expired;
+	int			 nr = 0;
+
+	D_INIT_LIST_HEAD(&expired);
+	crt_tw_expire(tw, now_tick, &expired);
+	while ((rpc_priv = d_list_pop_entry(&expired, struct crt_rpc_priv,
+					    crp_tmp_link))) {
+		assert_true(rpc_priv >= tw_rpcs && rpc_priv < tw_rpcs + TW_NR);
+		assert_false(tw_expired[rpc_priv - tw_rpcs]);
+		assert_int_equal(rpc_priv->crp_in_timer, 0);
+		/* never before the deadline */
+		assert_true((rpc_priv->crp_timeout_ts >> CRT_TW_TICK_SHIFT) < now_tick);
+		tw_expired[rpc_priv - tw_rpcs] = true;
+		nr++;
+	}
+
+	return nr;
+}
+
+static void
+tw_reset(struct crt_timer_wheel *tw, uint64_t start)
+{
+	memset(tw_rpcs, 0, TW_NR * sizeof(*tw_rpcs));
+	memset(tw_expired, 0, sizeof(tw_expired));
+	crt_tw_init(tw, start);
+}
+
+static void
+tw_check_levels(struct crt_timer_wheel *tw, uint64_t start)
+{
+	uint64_t	deadline;
+	int		i;
+
+	tw_reset(tw, start);
+	for (i = 0; i < TW_NR; i++) {
+		tw_rpc_set(&tw_rpcs[i], start + tw_deltas[i]);
+		assert_true(crt_tw_add(tw, &tw_rpcs[i]));
+	}
+	assert_int_equal(tw->tw_nr, TW_NR);
+
+	/* each RPC expires exactly once its deadline tick has passed */
+	for (i = 0; i < TW_NR; i++) {
+		deadline = start + tw_deltas[i];
+		assert_int_equal(tw_expire(tw, deadline), 0);
+		assert_int_equal(tw_rpcs[i].crp_in_timer, 1);
+		assert_int_equal(tw_expire(tw, deadline + 1), 1);
+		assert_true(tw_expired[i]);
+	}
+	assert_int_equal(tw->tw_nr, 0);
+}
+
+static void
+test_tw_expire(void **state)
+{
+	struct crt_timer_wheel	*tw = *state;
+
+	/* aligned and unaligned starts, so that cascading is hit at all levels */
+	tw_check_levels(tw, 0);
+	tw_check_levels(tw, 12345);
+	tw_check_levels(tw, TW_LVL(3) - 3);
+}
+
+static void
+test_tw_past_deadline(void **state)
+{
+	struct crt_timer_wheel	*tw = *state;
+
+	tw_reset(tw, 1000);
+	tw_rpc_set(&tw_rpcs[0], 10);
+	assert_true(crt_tw_add(tw, &tw_rpcs[0]));
+
+	/* expired without processing any tick */
+	assert_int_equal(tw_expire(tw, 1000), 1);
+	assert_true(tw_expired[0]);
+	assert_int_equal(tw->tw_nr, 0);
+	assert_int_equal(tw->tw_tick, 1000);
+
+	/* idle ticks are skipped */
+	assert_int_equal(tw_expire(tw, 5000), 0);
+	assert_int_equal(tw->tw_tick, 5000);
+}
+
+static void
+test_tw_cancel(void **state)
+{
+	struct crt_timer_wheel	*tw = *state;
+	uint64_t		 start = 777;
+	int			 armed;
+	int			 i;
+
+	tw_reset(tw, start);
+	for (i = 0; i < TW_NR; i++) {
+		tw_rpc_set(&tw_rpcs[i], start + tw_deltas[i]);
+		assert_true(crt_tw_add(tw, &tw_rpcs[i]));
+	}
+
+	/* cancel the RPCs of odd index, from all levels */
+	for (i = 1; i < TW_NR; i += 2) {
+		assert_true(crt_tw_del(tw, &tw_rpcs[i]));
+		assert_false(crt_tw_del(tw, &tw_rpcs[i]));
+		assert_int_equal(tw_rpcs[i].crp_in_timer, 0);
+	}
+	armed = (TW_NR + 1) / 2;
+	assert_int_equal(tw->tw_nr, armed);
+
+	/* re-arm the first RPC at the end of the wheel, it is moved */
+	tw_rpc_set(&tw_rpcs[0], start + TW_SPAN - 1);
+	assert_false(crt_tw_add(tw, &tw_rpcs[0]));
+	assert_int_equal(tw->tw_nr, armed);
+	assert_int_equal(tw_expire(tw, start + 1), 0);
+
+	/* re-arm a canceled RPC */
+	tw_rpc_set(&tw_rpcs[1], start + TW_LVL(2) + 5);
+	assert_true(crt_tw_add(tw, &tw_rpcs[1]));
+	armed++;
+
+	/* the other armed RPCs below the end of the wheel */
+	assert_int_equal(tw_expire(tw, start + TW_SPAN - 1), armed - 2);
+	assert_true(tw_expired[1]);
+	assert_false(tw_expired[0]);
+	assert_int_equal(tw_expire(tw, start + TW_SPAN), 1);
+	assert_true(tw_expired[0]);
+	assert_int_equal(tw_expire(tw, start + 2 * TW_SPAN), 1);
+
+	/* canceled RPCs never expire */
+	for (i = 0; i < TW_NR; i++)
+		assert_int_equal(tw_expired[i], i % 2 == 0 || i == 1);
+	assert_int_equal(tw->tw_nr, 0);
+}
+
+static int
+init_tests(void **state)
+{
+	struct crt_timer_wheel	*tw;
+	int			 rc;
+
+	rc = d_log_init();
+	if (rc != 0)
+		return rc;
+
+	D_ALLOC_PTR(tw);
+	D_ALLOC_ARRAY(tw_rpcs, TW_NR);
+	if (tw == NULL || tw_rpcs == NULL) {
+		D_FREE(tw);
+		D_FREE(tw_rpcs);
+		d_log_fini();
+		return -DER_NOMEM;
+	}
+
+	*state = tw;
+	return 0;
+}
+
+static int
+fini_tests(void **state)
+{
+	D_FREE(*state);
+	D_FREE(tw_rpcs);
+	d_log_fini();
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_tw_expire),
+		cmocka_unit_test(test_tw_past_deadline),
+		cmocka_unit_test(test_tw_cancel),
+	};
+
+	d_register_alt_assert(mock_assert);
+
+	return cmocka_run_group_tests_name("utest_timer_wheel", tests, init_tests,
+		fini_tests);
+}
@@ -17,6 +17,7 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <getopt.h>
+#include <math.h>
 #include <daos/common.h>
 #include <daos/tests_lib.h>
 #include <daos_test.h>
@@ -37,6 +38,7 @@ unsigned int	ts_seed;
 bool		ts_single	= true;	/* value type: single or array */
 bool		ts_random;		/* random write (array value only) */
 bool		ts_pause;
+unsigned int	ts_xs_nr	= 1;	/* # concurrent xstreams per process */
 
 bool		ts_oid_init;
 
@@ -48,10 +50,11 @@ daos_key_t	*ts_akeys;
 
 daos_handle_t	*ts_ohs;		/* all opened objects */
 daos_obj_id_t	*ts_oids;		/* object IDs */
-uint64_t	*ts_indices;
 
-struct credit_context	ts_ctx;
-pf_update_or_fetch_fn_t	ts_update_or_fetch_fn;
+__thread uint64_t		*ts_indices;
+__thread struct credit_context	ts_ctx;
+pf_update_or_fetch_fn_t		ts_update_or_fetch_fn;
+__thread struct pf_hist		*ts_hists;
 
 /* buffer for data verification */
 struct pf_stride_buf {
@@ -60,7 +63,7 @@ struct pf_stride_buf {
 	unsigned int	 sb_size;
 };
 
-struct pf_stride_buf	stride_buf;
+__thread struct pf_stride_buf	stride_buf;
 
 /* mark 16 bytes within each 4K for verification */
 static int stride_marks[] = {
@@ -198,6 +201,9 @@ akey_update_or_fetch(int obj_idx, enum ts_op_type op_type,
 	sgl  = &cred->tc_sgl;
 	recx = &cred->tc_recx;
 
+	cred->tc_start = param->pa_wl.arrival;
+	cred->tc_op    = op_type;
+
 	d_iov_set(&cred->tc_dkey, dkey->iov_buf, dkey->iov_len);
 
 	/* setup I/O descriptor */
@@ -368,6 +374,295 @@ objects_fetch(struct pf_param *param)
 	return rc;
 }
 
+/* Log-linear histogram, see struct pf_hist */
+static inline int
+pf_hist_idx(uint64_t nsec)
+{
+	int	shift;
+
+	if (nsec < PF_HIST_SUB_NR)
+		return nsec;
+
+	/* nsec >> shift is in [PF_HIST_HALF_NR, PF_HIST_SUB_NR) */
+	shift = 63 - __builtin_clzll(nsec) - (PF_HIST_SUB_BITS - 1);
+	if (shift > PF_HIST_SHIFT_MAX)
+		return PF_HIST_NR - 1;
+
+	return PF_HIST_SUB_NR + (shift - 1) * PF_HIST_HALF_NR +
+	       (nsec >> shift) - PF_HIST_HALF_NR;
+}
+
+/* The highest value of a bucket */
+static inline uint64_t
+pf_hist_idx2val(int idx)
+{
+	uint64_t	sub;
+	int		shift;
+
+	if (idx < PF_HIST_SUB_NR)
+		return idx;
+
+	shift = (idx - PF_HIST_SUB_NR) / PF_HIST_HALF_NR + 1;
+	sub = (idx - PF_HIST_SUB_NR) % PF_HIST_HALF_NR + PF_HIST_HALF_NR;
+	return ((sub + 1) << shift) - 1;
+}
+
+void
+pf_hist_record(struct pf_hist *hist, uint64_t nsec)
+{
+	if (hist->ph_nr == 0 || nsec < hist->ph_min)
+		hist->ph_min = nsec;
+	if (nsec > hist->ph_max)
+		hist->ph_max = nsec;
+	hist->ph_buckets[pf_hist_idx(nsec)]++;
+	hist->ph_sum += nsec;
+	hist->ph_nr++;
+}
+
+void
+pf_hist_merge(struct pf_hist *dst, struct pf_hist *src)
+{
+	int	i;
+
+	if (src->ph_nr == 0)
+		return;
+
+	if (dst->ph_nr == 0 || src->ph_min < dst->ph_min)
+		dst->ph_min = src->ph_min;
+	if (src->ph_max > dst->ph_max)
+		dst->ph_max = src->ph_max;
+	for (i = 0; i < PF_HIST_NR; i++)
+		dst->ph_buckets[i] += src->ph_buckets[i];
+	dst->ph_sum += src->ph_sum;
+	dst->ph_nr += src->ph_nr;
+}
+
+uint64_t
+pf_hist_value_at(struct pf_hist *hist, double percentile)
+{
+	uint64_t	target;
+	uint64_t	count = 0;
+	int		i;
+
+	if (hist->ph_nr == 0)
+		return 0;
+
+	target = ceil(percentile * hist->ph_nr / 100);
+	if (target == 0)
+		target = 1;
+
+	for (i = 0; i < PF_HIST_NR; i++) {
+		count += hist->ph_buckets[i];
+		if (count >= target)
+			return min(pf_hist_idx2val(i), hist->ph_max);
+	}
+	return hist->ph_max;
+}
+
+/* key generator of the workload test */
+struct pf_keygen {
+	int		kg_dist;
+	unsigned int	kg_seed;
+	uint64_t	kg_nr;
+	/* zipfian, see "Quickly Generating Billion-Record Synthetic Databases" */
+	double		kg_theta;
+	double		kg_zetan;
+	double		kg_alpha;
+	double		kg_eta;
+	/* hot set */
+	uint64_t	kg_hot_nr;
+	int		kg_hot_pct;
+};
+
+static inline uint64_t
+pf_rand64(unsigned int *seed)
+{
+	return ((uint64_t)rand_r(seed) << 31) ^ rand_r(seed);
+}
+
+static inline double
+pf_rand01(unsigned int *seed)
+{
+	return (double)rand_r(seed) / ((double)RAND_MAX + 1);
+}
+
+static double
+pf_zeta(uint64_t nr, double theta)
+{
+	double		sum = 0;
+	uint64_t	i;
+
+	for (i = 1; i <= nr; i++)
+		sum += 1 / pow(i, theta);
+	return sum;
+}
+
+static void
+pf_keygen_init(struct pf_keygen *kg, struct pf_param *param, uint64_t key_nr)
+{
+	double	zeta2;
+
+	memset(kg, 0, sizeof(*kg));
+	kg->kg_dist = param->pa_wl.dist;
+	kg->kg_seed = ts_seed ^ ts_ctx.tsc_mpi_rank;
+	kg->kg_nr = key_nr;
+
+	switch (kg->kg_dist) {
+	default:
+		break;
+	case PF_DIST_ZIPF:
+		kg->kg_theta = param->pa_wl.skew / 100.0;
+		kg->kg_zetan = pf_zeta(key_nr, kg->kg_theta);
+		zeta2 = pf_zeta(2, kg->kg_theta);
+		kg->kg_alpha = 1 / (1 - kg->kg_theta);
+		kg->kg_eta = (1 - pow(2.0 / key_nr, 1 - kg->kg_theta)) /
+			     (1 - zeta2 / kg->kg_zetan);
+		break;
+	case PF_DIST_HOT:
+		kg->kg_hot_nr = max(key_nr * param->pa_wl.skew / 100, 1);
+		kg->kg_hot_pct = 100 - param->pa_wl.skew;
+		break;
+	}
+}
+
+static uint64_t
+pf_keygen_next(struct pf_keygen *kg)
+{
+	uint64_t	key;
+	double		u;
+	double		uz;
+
+	switch (kg->kg_dist) {
+	default:
+		return pf_rand64(&kg->kg_seed) % kg->kg_nr;
+	case PF_DIST_ZIPF:
+		u = pf_rand01(&kg->kg_seed);
+		uz = u * kg->kg_zetan;
+		if (uz < 1)
+			return 0;
+		if (uz < 1 + pow(0.5, kg->kg_theta))
+			return min(1, kg->kg_nr - 1);
+		key = kg->kg_nr * pow(kg->kg_eta * u - kg->kg_eta + 1, kg->kg_alpha);
+		return min(key, kg->kg_nr - 1);
+	case PF_DIST_HOT:
+		if (kg->kg_hot_nr == kg->kg_nr ||
+		    rand_r(&kg->kg_seed) % 100 < kg->kg_hot_pct)
+			return pf_rand64(&kg->kg_seed) % kg->kg_hot_nr;
+		return kg->kg_hot_nr + pf_rand64(&kg->kg_seed) % (kg->kg_nr - kg->kg_hot_nr);
+	}
+}
+
+/* Sleep or spin until the intended start time of the next operation */
+static void
+pf_wait_until(uint64_t nsec)
+{
+	struct timespec	ts;
+	uint64_t	now;
+
+	while ((now = daos_get_ntime()) < nsec) {
+		/* nanosleep overshoots, spin for the last 50 usecs */
+		if (nsec - now <= 50 * 1000)
+			continue;
+
+		ts.tv_sec = 0;
+		ts.tv_nsec = min(nsec - now - 50 * 1000, NSEC_PER_SEC - 1);
+		nanosleep(&ts, NULL);
+	}
+}
+
+/**
+ * Mixed fetch and update of the keys picked by the key distribution. In open
+ * loop mode, operations are issued at the fixed rate regardless of completion,
+ * and the latency is measured from the intended start time, so the queueing
+ * delay behind slow operations is not omitted.
+ */
+int
+objects_workload(struct pf_param *param)
+{
+	struct pf_keygen	kg;
+	daos_epoch_t		epoch = d_hlc_get();
+	enum ts_op_type		op_type;
+	unsigned int		seed = ts_seed ^ ts_ctx.tsc_mpi_rank;
+	uint64_t		key_nr;
+	uint64_t		key;
+	uint64_t		start;
+	uint64_t		i;
+	int			obj_idx;
+	int			dkey_idx;
+	int			akey_idx;
+	int			recx_idx;
+	int			rc = 0;
+	int			rc_drain;
+
+	key_nr = (uint64_t)param->pa_obj_nr * param->pa_dkey_nr *
+		 param->pa_akey_nr * param->pa_recx_nr;
+	if (key_nr == 0)
+		return -DER_INVAL;
+	if (param->pa_wl.ops == 0)
+		param->pa_wl.ops = key_nr;
+
+	if (param->pa_wl.hists == NULL) {
+		D_ALLOC_ARRAY(param->pa_wl.hists, TS_DO_MAX);
+		if (param->pa_wl.hists == NULL)
+			return -DER_NOMEM;
+	}
+
+	if (!ts_indices) {
+		ts_indices = dts_rand_iarr_alloc_set(ts_recx_p_akey, 0,
+						     ts_random);
+		D_ASSERT(ts_indices != NULL);
+	}
+
+	pf_keygen_init(&kg, param, key_nr);
+	stride_buf_set(param->pa_rw.offset, param->pa_rw.size);
+	++epoch;
+
+	/* latency of asynchronous I/O is recorded on completion */
+	if (dts_is_async(&ts_ctx))
+		ts_hists = param->pa_wl.hists;
+
+	start = daos_get_ntime();
+	for (i = 0; i < param->pa_wl.ops; i++) {
+		op_type = rand_r(&seed) % 100 < param->pa_wl.read_pct ?
+			  TS_DO_FETCH : TS_DO_UPDATE;
+
+		key = pf_keygen_next(&kg);
+		recx_idx = key % param->pa_recx_nr;
+		key /= param->pa_recx_nr;
+		akey_idx = ts_const_akey ? 0 : key % param->pa_akey_nr;
+		key /= param->pa_akey_nr;
+		dkey_idx = key % param->pa_dkey_nr;
+		obj_idx = key / param->pa_dkey_nr;
+
+		if (param->pa_wl.rate != 0) {
+			param->pa_wl.arrival = start + (uint64_t)((double)i * NSEC_PER_SEC /
+								  param->pa_wl.rate);
+			pf_wait_until(param->pa_wl.arrival);
+		} else {
+			param->pa_wl.arrival = daos_get_ntime();
+		}
+
+		rc = akey_update_or_fetch(obj_idx, op_type, &ts_dkeys[dkey_idx],
+					  &ts_akeys[akey_idx], &epoch, recx_idx, param);
+		if (rc)
+			break;
+
+		if (!dts_is_async(&ts_ctx))
+			pf_hist_record(&param->pa_wl.hists[op_type],
+				       daos_get_ntime() - param->pa_wl.arrival);
+	}
+	rc_drain = credit_drain(&ts_ctx);
+	if (rc == 0)
+		rc = rc_drain;
+
+	ts_hists = NULL;
+	param->pa_wl.arrival = 0;
+	if (dts_is_async(&ts_ctx))
+		param->pa_duration += (daos_get_ntime() - start) / 1000;
+
+	return rc;
+}
+
 /* Test command Format: "C;p=x;q D;a;b"
  *
  * The upper-case character is command, e.g. U=update, F=fetch, anything after
@@ -503,15 +798,9 @@ pf_parse_rw_cb(char *str, struct pf_param *param, char **strp)
 	return 0;
 }
 
-int
-pf_parse_rw(char *str, struct pf_param *param, char **strp)
+static int
+pf_parse_rw_check(struct pf_param *param)
 {
-	int	rc;
-
-	rc = pf_parse_common(str, param, pf_parse_rw_cb, strp);
-	if (rc)
-		return rc;
-
 	if (param->pa_rw.size == 0) /* full stride write */
 		param->pa_rw.size = ts_stride;
 
@@ -526,6 +815,82 @@ pf_parse_rw(char *str, struct pf_param *param, char **strp)
 	return 0;
 }
 
+int
+pf_parse_rw(char *str, struct pf_param *param, char **strp)
+{
+	int	rc;
+
+	rc = pf_parse_common(str, param, pf_parse_rw_cb, strp);
+	if (rc)
+		return rc;
+
+	return pf_parse_rw_check(param);
+}
+
+static int
+pf_parse_workload_cb(char *str, struct pf_param *param, char **strp)
+{
+	char		c = *str;
+	uint64_t	val;
+
+	switch (c) {
+	default:
+		return pf_parse_rw_cb(str, param, strp);
+	case 'j':
+		param->pa_wl.json = true;
+		str++;
+		break;
+	case 'r':
+	case 'z':
+	case 'h':
+		str++;
+		if (*str != PARAM_ASSIGN)
+			return -1;
+		val = strtol(&str[1], &str, 0);
+		if (c == 'r') {
+			if (val > 100)
+				return -1;
+			param->pa_wl.read_pct = val;
+		} else {
+			/* theta of zipfian must be less than 1 */
+			if (val == 0 || val >= 100)
+				return -1;
+			param->pa_wl.dist = c == 'z' ? PF_DIST_ZIPF : PF_DIST_HOT;
+			param->pa_wl.skew = val;
+		}
+		break;
+	case 'q':
+	case 'c':
+		str++;
+		if (*str != PARAM_ASSIGN)
+			return -1;
+		val = strtoul(&str[1], &str, 0);
+		if (val_has_unit(*str)) {
+			val = val_unit(val, *str);
+			str++;
+		}
+		if (c == 'q')
+			param->pa_wl.rate = val;
+		else
+			param->pa_wl.ops = val;
+		break;
+	}
+	*strp = str;
+	return 0;
+}
+
+int
+pf_parse_workload(char *str, struct pf_param *param, char **strp)
+{
+	int	rc;
+
+	rc = pf_parse_common(str, param, pf_parse_workload_cb, strp);
+	if (rc)
+		return rc;
+
+	return pf_parse_rw_check(param);
+}
+
 static struct pf_test *
 find_test(char code, struct pf_test pf_tests[])
 {
@@ -559,6 +924,130 @@ pause_test(char *name)
 		par_barrier(PAR_COMM_WORLD);
 }
 
+static void
+pf_hist_reduce(struct pf_hist *hist, struct pf_hist *out)
+{
+	uint64_t	hmin;
+
+	if (ts_ctx.tsc_mpi_size == 1) {
+		*out = *hist;
+		return;
+	}
+
+	/* empty histogram should not win the minimum */
+	hmin = hist->ph_nr == 0 ? UINT64_MAX : hist->ph_min;
+	par_reduce(PAR_COMM_WORLD, hist->ph_buckets, out->ph_buckets, PF_HIST_NR, PAR_UINT64,
+		   PAR_SUM, 0);
+	par_reduce(PAR_COMM_WORLD, &hist->ph_nr, &out->ph_nr, 1, PAR_UINT64, PAR_SUM, 0);
+	par_reduce(PAR_COMM_WORLD, &hist->ph_sum, &out->ph_sum, 1, PAR_UINT64, PAR_SUM, 0);
+	par_reduce(PAR_COMM_WORLD, &hmin, &out->ph_min, 1, PAR_UINT64, PAR_MIN, 0);
+	par_reduce(PAR_COMM_WORLD, &hist->ph_max, &out->ph_max, 1, PAR_UINT64, PAR_MAX, 0);
+}
+
+static const double pf_percentiles[] = {50, 90, 99, 99.9};
+static const char *pf_percentile_names[] = {"p50", "p90", "p99", "p99.9"};
+
+static void
+pf_hist_show(const char *name, struct pf_hist *hist, bool json)
+{
+	double	mean = hist->ph_nr ? (double)hist->ph_sum / hist->ph_nr : 0;
+	int	i;
+
+	if (json) {
+		fprintf(stdout, "\"%s\":{\"ops\":%"PRIu64",\"min\":%.3f", name, hist->ph_nr,
+			hist->ph_nr ? hist->ph_min / 1000.0 : 0);
+		for (i = 0; i < ARRAY_SIZE(pf_percentiles); i++)
+			fprintf(stdout, ",\"%s\":%.3f", pf_percentile_names[i],
+				pf_hist_value_at(hist, pf_percentiles[i]) / 1000.0);
+		fprintf(stdout, ",\"max\":%.3f,\"mean\":%.3f}", hist->ph_max / 1000.0,
+			mean / 1000.0);
+		return;
+	}
+
+	fprintf(stdout, "\t%-8s %-10"PRIu64" %-10.3f", name, hist->ph_nr,
+		hist->ph_nr ? hist->ph_min / 1000.0 : 0);
+	for (i = 0; i < ARRAY_SIZE(pf_percentiles); i++)
+		fprintf(stdout, " %-10.3f", pf_hist_value_at(hist, pf_percentiles[i]) / 1000.0);
+	fprintf(stdout, " %-10.3f %-10.3f\n", hist->ph_max / 1000.0, mean / 1000.0);
+}
+
+static const char *
+pf_dist2name(int dist)
+{
+	switch (dist) {
+	default:
+		return "uniform";
+	case PF_DIST_ZIPF:
+		return "zipf";
+	case PF_DIST_HOT:
+		return "hot";
+	}
+}
+
+/* Collective, latency percentiles of the workload test across all processes */
+static void
+pf_workload_show(struct pf_param *param, uint64_t start, uint64_t end)
+{
+	struct pf_hist	*hists;
+	struct pf_hist	*all;
+	uint64_t	 first_start = start;
+	uint64_t	 last_end = end;
+	double		 duration;
+	int		 i;
+
+	D_ALLOC_ARRAY(hists, TS_DO_MAX + 1);
+	if (hists == NULL) {
+		fprintf(stderr, "no memory to show the latency\n");
+		return;
+	}
+
+	for (i = 0; i < TS_DO_MAX; i++)
+		pf_hist_reduce(&param->pa_wl.hists[i], &hists[i]);
+
+	if (ts_ctx.tsc_mpi_size > 1) {
+		par_reduce(PAR_COMM_WORLD, &start, &first_start, 1, PAR_UINT64, PAR_MIN, 0);
+		par_reduce(PAR_COMM_WORLD, &end, &last_end, 1, PAR_UINT64, PAR_MAX, 0);
+	}
+
+	if (ts_ctx.tsc_mpi_rank != 0)
+		goto out;
+
+	all = &hists[TS_DO_MAX];
+	for (i = 0; i < TS_DO_MAX; i++)
+		pf_hist_merge(all, &hists[i]);
+	duration = (last_end - first_start) / (1000.0 * 1000 * 1000);
+
+	if (param->pa_wl.json) {
+		fprintf(stdout, "{\"test\":\"WORKLOAD\",\"ranks\":%d,\"size\":%d,"
+			"\"read_pct\":%d,\"dist\":\"%s\",\"skew\":%d,"
+			"\"target_rate\":%"PRIu64",\"rate\":%.2f,\"duration\":%.6f,"
+			"\"unit\":\"us\",", ts_ctx.tsc_mpi_size, param->pa_rw.size,
+			param->pa_wl.read_pct, pf_dist2name(param->pa_wl.dist),
+			param->pa_wl.skew, param->pa_wl.rate * ts_ctx.tsc_mpi_size * ts_xs_nr,
+			all->ph_nr / duration, duration);
+		pf_hist_show("fetch", &hists[TS_DO_FETCH], true);
+		fprintf(stdout, ",");
+		pf_hist_show("update", &hists[TS_DO_UPDATE], true);
+		fprintf(stdout, ",");
+		pf_hist_show("all", all, true);
+		fprintf(stdout, "}\n");
+		goto out;
+	}
+
+	fprintf(stdout, "Latency (us), %s keys, %d%% fetch, %s loop:\n",
+		pf_dist2name(param->pa_wl.dist), param->pa_wl.read_pct,
+		param->pa_wl.rate ? "open" : "closed");
+	fprintf(stdout, "\t%-8s %-10s %-10s", "", "ops", "min");
+	for (i = 0; i < ARRAY_SIZE(pf_percentiles); i++)
+		fprintf(stdout, " %-10s", pf_percentile_names[i]);
+	fprintf(stdout, " %-10s %-10s\n", "max", "mean");
+	pf_hist_show("fetch", &hists[TS_DO_FETCH], false);
+	pf_hist_show("update", &hists[TS_DO_UPDATE], false);
+	pf_hist_show("all", all, false);
+out:
+	D_FREE(hists);
+}
+
 static int
 run_one(struct pf_test *ts, struct pf_param *param)
 {
@@ -605,12 +1094,20 @@ run_one(struct pf_test *ts, struct pf_param *param)
 
 	if (rc != 0) {
 		fprintf(stderr, "Failed: "DF_RC"\n", DP_RC(rc));
+		D_FREE(param->pa_wl.hists);
+		D_FREE(param->pa_xs_duration);
 		return rc;
 	}
 
 	if (param->pa_perf)
 		show_result(param, start, end, ts->ts_name);
 
+	if (param->pa_wl.hists != NULL) {
+		if (param->pa_perf || param->pa_wl.json)
+			pf_workload_show(param, start, end);
+		D_FREE(param->pa_wl.hists);
+	}
+	D_FREE(param->pa_xs_duration);
 	return 0;
 }
 
@@ -696,6 +1193,9 @@ show_result(struct pf_param *param, uint64_t start, uint64_t end,
 		par_reduce(PAR_COMM_WORLD, &end, &last_end, 1, PAR_UINT64, PAR_MAX, 0);
 		agg_duration = (last_end - first_start) /
 			       (1000.0 * 1000 * 1000);
+	} else if (strcmp(test_name, "WORKLOAD") == 0) {
+		/* open loop workload waits for the arrivals, use the wall time */
+		agg_duration = (end - start) / (1000.0 * 1000 * 1000);
 	} else {
 		agg_duration = param->pa_duration / (1000.0 * 1000);
 	}
@@ -716,31 +1216,36 @@ show_result(struct pf_param *param, uint64_t start, uint64_t end,
 
 	if (ts_ctx.tsc_mpi_rank == 0) {
 		unsigned long	total;
+		unsigned int	streams = ts_ctx.tsc_mpi_size * ts_xs_nr;
 		bool		show_bw = false;
 		double		bandwidth;
 		double		latency;
 		double		rate;
 
 		if (strcmp(test_name, "QUERY") == 0) {
-			total = ts_ctx.tsc_mpi_size * param->pa_iteration *
+			total = streams * param->pa_iteration *
 				param->pa_obj_nr;
 		} else if (strcmp(test_name, "AGGREGATE") == 0 ||
 			   strcmp(test_name, "DISCARD") == 0 ||
 			   strcmp(test_name, "GARBAGE COLLECTION") == 0) {
-			total = ts_ctx.tsc_mpi_size * param->pa_iteration;
+			total = streams * param->pa_iteration;
+		} else if (strcmp(test_name, "WORKLOAD") == 0) {
+			show_bw = true;
+			total = streams * param->pa_iteration * param->pa_wl.ops;
 		} else if (strcmp(test_name, "PUNCH") == 0) {
-			total = ts_ctx.tsc_mpi_size * param->pa_iteration * param->pa_obj_nr;
+			total = streams * param->pa_iteration * param->pa_obj_nr;
 			if (param->pa_rw.dkey_flag)
 				total *= param->pa_dkey_nr;
 		} else {
 			show_bw = true;
-			total = ts_ctx.tsc_mpi_size * param->pa_iteration *
+			total = streams * param->pa_iteration *
 				param->pa_obj_nr * param->pa_dkey_nr *
 				param->pa_akey_nr * param->pa_recx_nr;
 		}
 
 		rate = total / agg_duration;
-		latency = duration_max / total;
+		/* xstreams of the same process run concurrently */
+		latency = duration_max * ts_xs_nr / total;
 
 		fprintf(stdout, "%s successfully completed:\n"
 			"\tduration : %-10.6f sec\n", test_name, agg_duration);
@@ -759,6 +1264,20 @@ show_result(struct pf_param *param, uint64_t start, uint64_t end,
 			duration_min/(1000 * 1000));
 		fprintf(stdout, "\tAverage duration : %-10.6f sec\n",
 			duration_sum / ((ts_ctx.tsc_mpi_size) * 1000 * 1000));
+
+		if (param->pa_xs_duration != NULL) {
+			unsigned long	xs_total = total / streams;
+			double		xs_duration;
+			int		i;
+
+			fprintf(stdout, "Throughput and latency of xstreams (rank 0):\n");
+			for (i = 0; i < ts_xs_nr; i++) {
+				xs_duration = param->pa_xs_duration[i];
+				fprintf(stdout, "\txstream %-4d : %-10.2f IO/sec, %-10.3f us\n", i,
+					xs_total * 1000.0 * 1000 / xs_duration,
+					xs_duration / xs_total);
+			}
+		}
 	}
 }
 
@@ -796,13 +1315,22 @@ const char perf_common_usage[] = "\n"
 "	'Q'    : Query test (vos_perf only)\n"
 "	'I'    : VOS iteration test (vos_perf only)\n"
 "	'P'    : Punch test (vos_perf only)\n"
+"	'W'    : Workload test, mixed fetch and update of random keys\n"
 "	'p'    : Output performance numbers\n"
 "	'i=$N' : Iterate test $N times\n"
 "	'k'    : Don't reset key for each iteration\n"
 "	'o=$N' : Offset for update or fetch\n"
 "	's=$N' : IO size for update or fetch\n"
 "	'd'    : Dkey punch (for Punch test)\n"
-"	'v'    : Verbose mode\n\n"
+"	'v'    : Verbose mode\n"
+"	'r=$N' : Percentage of fetch (for Workload test)\n"
+"	'q=$N' : Arrivals per second of each process, closed loop if it's\n"
+"	         not set (for Workload test)\n"
+"	'c=$N' : Number of operations, all keys by default (for Workload test)\n"
+"	'z=$N' : Zipfian keys with theta $N/100 (for Workload test)\n"
+"	'h=$N' : $N% of the keys get (100 - $N)% of the operations\n"
+"	         (for Workload test)\n"
+"	'j'    : Output latency percentiles in JSON (for Workload test)\n\n"
 "	Test commands are in format of: \"C;p=x;q D;a;b\" The upper-case\n"
 "	character is command, e.g. U=update, F=fetch, anything after\n"
 "	semicolon is parameter of the command. Space or tab is the separator\n"
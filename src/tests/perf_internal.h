@@ -18,7 +18,33 @@
 
 enum ts_op_type {
 	TS_DO_UPDATE = 0,
-	TS_DO_FETCH
+	TS_DO_FETCH,
+	TS_DO_MAX,
+};
+
+/* key distributions of the workload test */
+enum {
+	PF_DIST_UNIFORM = 0,
+	PF_DIST_ZIPF,
+	PF_DIST_HOT,
+};
+
+#define PF_HIST_SUB_BITS	7
+#define PF_HIST_SUB_NR		(1 << PF_HIST_SUB_BITS)
+#define PF_HIST_HALF_NR		(PF_HIST_SUB_NR >> 1)
+#define PF_HIST_SHIFT_MAX	32
+#define PF_HIST_NR		(PF_HIST_SUB_NR + PF_HIST_SHIFT_MAX * PF_HIST_HALF_NR)
+
+/**
+ * Log-linear latency histogram (nsec), values below PF_HIST_SUB_NR are exact,
+ * the relative error of the others is below 1/PF_HIST_HALF_NR.
+ */
+struct pf_hist {
+	uint64_t	ph_buckets[PF_HIST_NR];
+	uint64_t	ph_nr;
+	uint64_t	ph_min;
+	uint64_t	ph_max;
+	uint64_t	ph_sum;
 };
 
 struct pf_param {
@@ -66,6 +92,27 @@ struct pf_param {
 			bool	force_merge;
 		} pa_agg;
 	};
+	/* private parameter for workload, it also uses pa_rw */
+	struct {
+		/* percentage of fetch in the mixed operations */
+		int		 read_pct;
+		/* key distribution, PF_DIST_* */
+		int		 dist;
+		/* zipfian theta in percent, or percentage of keys in the hot set */
+		int		 skew;
+		/* output the result in JSON */
+		bool		 json;
+		/* arrivals per second of each xstream, closed loop if it's 0 */
+		uint64_t	 rate;
+		/* # operations of each iteration */
+		uint64_t	 ops;
+		/* intended start time (nsec) of the current operation */
+		uint64_t	 arrival;
+		/* latency histograms indexed by ts_op_type */
+		struct pf_hist	*hists;
+	} pa_wl;
+	/* durations of the concurrent xstreams, vos_perf only */
+	double		*pa_xs_duration;
 };
 
 typedef int (*pf_update_or_fetch_fn_t)(int, enum ts_op_type,
@@ -98,16 +145,20 @@ extern unsigned int	ts_seed;
 extern bool		ts_single;
 extern bool		ts_random;
 extern bool		ts_pause;
+/* # xstreams running the tests concurrently in each process */
+extern unsigned int	ts_xs_nr;
 
 extern bool		ts_oid_init;
 
 extern daos_handle_t	*ts_ohs;
 extern daos_obj_id_t	*ts_oids;
 extern daos_key_t	*ts_dkeys;
-extern uint64_t		*ts_indices;
-
-extern struct credit_context	ts_ctx;
-extern pf_update_or_fetch_fn_t	ts_update_or_fetch_fn;
+/* I/O context of the xstream, each concurrent xstream has its own one */
+extern __thread uint64_t		*ts_indices;
+extern __thread struct credit_context	ts_ctx;
+extern pf_update_or_fetch_fn_t		ts_update_or_fetch_fn;
+/* histograms of the running workload, only set in asynchronous mode */
+extern __thread struct pf_hist		*ts_hists;
 
 #define TS_TIME_START(time, start)		\
 do {						\
@@ -205,6 +256,16 @@ pf_parse_common(char *str, struct pf_param *param, pf_parse_cb_t parse_cb,
 int
 pf_parse_rw(char *str, struct pf_param *param, char **strp);
 int
+objects_workload(struct pf_param *param);
+int
+pf_parse_workload(char *str, struct pf_param *param, char **strp);
+void
+pf_hist_record(struct pf_hist *hist, uint64_t nsec);
+void
+pf_hist_merge(struct pf_hist *dst, struct pf_hist *src);
+uint64_t
+pf_hist_value_at(struct pf_hist *hist, double percentile);
+int
 run_commands(char *cmds, struct pf_test pf_tests[]);
 void
 show_result(struct pf_param *param, uint64_t start, uint64_t end,
@@ -10,6 +10,7 @@
  */
 
 #include "daos_test.h"
+#include <daos/container.h>
 
 static void
 reconnect(test_arg_t *arg) {
@@ -333,6 +334,161 @@ check:
 	assert_int_equal(rc, 0);
 }
 
+/* copy of the OID lease of a container handle */
+struct oid_lease_state {
+	uint64_t	next;
+	uint64_t	end;
+	uint64_t	spare;
+	uint64_t	spare_nr;
+	uint64_t	size;
+	bool		prefetching;
+};
+
+static void
+oid_lease_get(daos_handle_t coh, struct oid_lease_state *st)
+{
+	struct dc_cont		*cont;
+	struct dc_oid_lease	*ol;
+
+	cont = dc_hdl2cont(coh);
+	assert_non_null(cont);
+	ol = &cont->dc_oid_lease;
+
+	D_MUTEX_LOCK(&ol->ol_lock);
+	st->next = ol->ol_next;
+	st->end = ol->ol_end;
+	st->spare = ol->ol_spare;
+	st->spare_nr = ol->ol_spare_nr;
+	st->size = ol->ol_size;
+	st->prefetching = ol->ol_prefetching;
+	D_MUTEX_UNLOCK(&ol->ol_lock);
+
+	dc_cont_put(cont);
+}
+
+#define NUM_LEASE_CYCLES	4
+
+/*
+ * Check on a new container handle that OIDs are served from the lease, that
+ * the lease is refilled by the prefetch before it runs out, and that it grows
+ * when it is used up quickly.
+ */
+static void
+oid_lease_check(test_arg_t *arg)
+{
+	struct oid_lease_state	st;
+	daos_cont_info_t	co_info;
+	daos_handle_t		coh;
+	uint64_t		oid;
+	uint64_t		size;
+	uint64_t		spare;
+	uint64_t		spare_nr;
+	uint64_t		size_init;
+	int			i;
+	int			rc;
+
+	rc = daos_cont_open(arg->pool.poh, arg->co_str, DAOS_COO_RW, &coh,
+			    &co_info, NULL);
+	assert_rc_equal(rc, 0);
+
+	print_message("Allocate 1 OID, the lease is taken along with it\n");
+	rc = daos_cont_alloc_oids(coh, 1, &oid, NULL);
+	assert_rc_equal(rc, 0);
+	oid_lease_get(coh, &st);
+	if (st.end == 0) {
+		print_message("OID lease disabled, skipping\n");
+		goto out;
+	}
+	assert_int_equal(st.next, oid + 1);
+	assert_int_equal(st.end - st.next, st.size);
+	size_init = st.size;
+
+	for (i = 0; i < NUM_LEASE_CYCLES; i++) {
+		size = st.size;
+
+		print_message("Use lease of "DF_U64" OIDs until the prefetch starts\n",
+			      size);
+		while (!st.prefetching && st.spare_nr == 0) {
+			assert_true(st.next < st.end);
+			rc = daos_cont_alloc_oids(coh, 1, &oid, NULL);
+			assert_rc_equal(rc, 0);
+			assert_int_equal(oid, st.next);
+			oid_lease_get(coh, &st);
+			assert_int_equal(st.next, oid + 1);
+		}
+		/* the prefetch starts while OIDs are left in the lease */
+		assert_true(st.next < st.end);
+
+		/* progress the prefetch */
+		while (st.prefetching) {
+			rc = daos_cont_query(coh, &co_info, NULL, NULL);
+			assert_rc_equal(rc, 0);
+			oid_lease_get(coh, &st);
+		}
+		assert_int_equal(st.spare_nr, size);
+		assert_true(st.next < st.end);
+		spare = st.spare;
+		spare_nr = st.spare_nr;
+
+		print_message("Use the rest of the lease, then the prefetched range\n");
+		while (st.next < st.end) {
+			rc = daos_cont_alloc_oids(coh, 1, &oid, NULL);
+			assert_rc_equal(rc, 0);
+			assert_int_equal(oid, st.next);
+			oid_lease_get(coh, &st);
+		}
+		rc = daos_cont_alloc_oids(coh, 1, &oid, NULL);
+		assert_rc_equal(rc, 0);
+		assert_int_equal(oid, spare);
+		oid_lease_get(coh, &st);
+		assert_int_equal(st.next, spare + 1);
+		assert_int_equal(st.end, spare + spare_nr);
+		assert_true(st.size >= size);
+	}
+
+	/* the lease grows as long as it is used up within a second */
+	print_message("Lease grew from "DF_U64" to "DF_U64" OIDs\n", size_init,
+		      st.size);
+	assert_true(st.size > size_init);
+out:
+	rc = daos_cont_close(coh, NULL);
+	assert_rc_equal(rc, 0);
+}
+
+#define NUM_LEASE_OIDS 2000
+
+/*
+ * Small allocations on one handle are served from the OID lease, which grows
+ * and is refilled in the background. Ranges must still never overlap.
+ */
+static void
+oid_allocator_lease(void **state)
+{
+	test_arg_t	*arg = *state;
+	uint64_t	oids[NUM_LEASE_OIDS];
+	int		num_oids[NUM_LEASE_OIDS];
+	int		i;
+	int		rc;
+
+	srand(time(NULL));
+	for (i = 0; i < NUM_LEASE_OIDS; i++) {
+		num_oids[i] = rand() % 4 + 1;
+		rc = daos_cont_alloc_oids(arg->coh, num_oids[i], &oids[i], NULL);
+		assert_rc_equal(rc, 0);
+	}
+
+	if (arg->myrank == 0)
+		print_message("Allocation done. Verifying no overlaps...\n");
+
+	rc = check_ranges(num_oids, oids, NUM_LEASE_OIDS, arg);
+	assert_int_equal(rc, 0);
+
+	par_barrier(PAR_COMM_WORLD);
+	if (arg->myrank == 0)
+		oid_lease_check(arg);
+	par_barrier(PAR_COMM_WORLD);
+}
+
 static void
 cont_oid_prop(void **state)
 {
@@ -402,6 +558,8 @@ static const struct CMUnitTest oid_alloc_tests[] = {
 	 oid_allocator_mult_hdls, async_disable, NULL},
 	{"OID_ALLOC5: OID Allocator check (blocking)",
 	 oid_allocator_checker, async_disable, NULL},
+	{"OID_ALLOC6: OID lease with small allocations (blocking)",
+	 oid_allocator_lease, async_disable, NULL},
 };
 
 int
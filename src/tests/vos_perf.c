@@ -38,6 +38,35 @@ daos_unit_oid_t	*ts_uoids;	/* object shard IDs */
 bool		ts_in_ult;	/* Run tests in ULT mode */
 static ABT_xstream	abt_xstream;
 
+#define TS_XS_MAX		64
+/* stack size of the ULTs running on the concurrent xstreams */
+#define TS_XS_STACK_SIZE	(1 << 20)
+
+/**
+ * Concurrent xstream, it has its own VOS TLS, NVMe context and pool, all the
+ * xstreams run the same test at the same time.
+ */
+struct ts_xstream {
+	ABT_xstream		 tx_xstream;
+	ABT_thread		 tx_thread;
+#ifdef ULT_MMAP_STACK
+	struct stack_pool	*tx_sp;
+#endif
+	int			 tx_id;
+	/* I/O context is initialized */
+	bool			 tx_ready;
+	int			 tx_rc;
+	/* test function and its private copy of parameters */
+	int			(*tx_func)(struct pf_param *param);
+	struct pf_param		 tx_param;
+	char			 tx_pmem_file[PATH_MAX];
+};
+
+static struct ts_xstream	*ts_xstreams;
+static ABT_thread_attr		 ts_xs_attr = ABT_THREAD_ATTR_NULL;
+/* I/O context of the main thread, it has the pool/cont UUIDs */
+static struct credit_context	*ts_main_ctx;
+
 #ifdef ULT_MMAP_STACK
 struct stack_pool *sp;
 #endif
@@ -222,6 +251,292 @@ vos_update_or_fetch(int obj_idx, enum ts_op_type op_type,
 	return rc;
 }
 
+/* prepare the I/O context of the calling thread */
+static void
+ts_ctx_prep(char *pmem_file)
+{
+	ts_ctx.tsc_cred_nr	= -1; /* VOS can only support sync mode */
+	ts_ctx.tsc_pmem_path	= ts_pmem_path;
+	ts_ctx.tsc_pmem_file	= pmem_file;
+	ts_ctx.tsc_cred_vsize	= ts_stride;
+	ts_ctx.tsc_scm_size	= ts_scm_size;
+	ts_ctx.tsc_nvme_size	= ts_nvme_size;
+}
+
+static void
+ts_xs_init_ult(void *arg)
+{
+	struct ts_xstream	*tx = arg;
+	int			 rc;
+
+	rc = vos_self_xs_init(tx->tx_id);
+	if (rc)
+		goto out;
+
+	ts_ctx.tsc_mpi_rank = ts_main_ctx->tsc_mpi_rank;
+	ts_ctx.tsc_mpi_size = ts_main_ctx->tsc_mpi_size;
+	ts_ctx.tsc_skip_pool_create = ts_main_ctx->tsc_skip_pool_create;
+	ts_ctx.tsc_skip_cont_create = ts_main_ctx->tsc_skip_cont_create;
+	/* same UUIDs on all the xstreams, like a pool spans all the targets */
+	uuid_copy(ts_ctx.tsc_pool_uuid, ts_main_ctx->tsc_pool_uuid);
+	uuid_copy(ts_ctx.tsc_cont_uuid, ts_main_ctx->tsc_cont_uuid);
+	ts_ctx_prep(tx->tx_pmem_file);
+
+	stride_buf_init(ts_stride);
+	rc = dts_ctx_init(&ts_ctx, &vos_engine);
+	if (rc) {
+		stride_buf_fini();
+		vos_self_xs_fini();
+		goto out;
+	}
+	tx->tx_ready = true;
+out:
+	tx->tx_rc = rc;
+}
+
+static void
+ts_xs_fini_ult(void *arg)
+{
+	struct ts_xstream	*tx = arg;
+
+	if (!tx->tx_ready)
+		return;
+
+	if (ts_indices) {
+		free(ts_indices);
+		ts_indices = NULL;
+	}
+	stride_buf_fini();
+	dts_ctx_fini(&ts_ctx);
+	vos_self_xs_fini();
+	tx->tx_ready = false;
+}
+
+static void
+ts_xs_run_ult(void *arg)
+{
+	struct ts_xstream	*tx = arg;
+
+	tx->tx_rc = tx->tx_func(&tx->tx_param);
+}
+
+/* run \a func on all the xstreams and wait for the completion */
+static int
+ts_xs_exec(void (*func)(void *))
+{
+	struct ts_xstream	*tx;
+	int			 created;
+	int			 rc = 0;
+	int			 i;
+
+	for (created = 0; created < ts_xs_nr; created++) {
+		tx = &ts_xstreams[created];
+		tx->tx_rc = 0;
+#ifdef ULT_MMAP_STACK
+		rc = daos_abt_thread_create_on_xstream(tx->tx_sp, NULL, tx->tx_xstream, func, tx,
+						       ts_xs_attr, &tx->tx_thread);
+#else
+		rc = daos_abt_thread_create_on_xstream(NULL, NULL, tx->tx_xstream, func, tx,
+						       ts_xs_attr, &tx->tx_thread);
+#endif
+		if (rc != ABT_SUCCESS) {
+			fprintf(stderr, "failed to create ULT on xstream %d: %d\n",
+				created, rc);
+			rc = -1;
+			break;
+		}
+	}
+
+	for (i = 0; i < created; i++) {
+		tx = &ts_xstreams[i];
+		ABT_thread_join(tx->tx_thread);
+		ABT_thread_free(&tx->tx_thread);
+		if (rc == 0)
+			rc = tx->tx_rc;
+	}
+	return rc;
+}
+
+/**
+ * Run the test body on the current thread, or on all the concurrent xstreams,
+ * each of them runs on a private copy of \a param, the durations and latency
+ * histograms are merged back into \a param.
+ */
+static int
+ts_xs_run(int (*func)(struct pf_param *param), struct pf_param *param)
+{
+	struct ts_xstream	*tx;
+	double			 duration = 0;
+	int			 rc;
+	int			 i;
+	int			 j;
+
+	if (ts_xs_nr == 1)
+		return func(param);
+
+	if (param->pa_xs_duration == NULL) {
+		D_ALLOC_ARRAY(param->pa_xs_duration, ts_xs_nr);
+		if (param->pa_xs_duration == NULL)
+			return -DER_NOMEM;
+	}
+
+	for (i = 0; i < ts_xs_nr; i++) {
+		tx = &ts_xstreams[i];
+		tx->tx_func  = func;
+		tx->tx_param = *param;
+		tx->tx_param.pa_duration    = 0;
+		tx->tx_param.pa_wl.hists    = NULL;
+		tx->tx_param.pa_xs_duration = NULL;
+	}
+
+	rc = ts_xs_exec(ts_xs_run_ult);
+
+	for (i = 0; i < ts_xs_nr; i++) {
+		tx = &ts_xstreams[i];
+		param->pa_xs_duration[i] += tx->tx_param.pa_duration;
+		/* the xstreams run concurrently */
+		duration = max(duration, tx->tx_param.pa_duration);
+
+		if (tx->tx_param.pa_wl.hists == NULL)
+			continue;
+
+		param->pa_wl.ops = tx->tx_param.pa_wl.ops;
+		if (param->pa_wl.hists == NULL)
+			D_ALLOC_ARRAY(param->pa_wl.hists, TS_DO_MAX);
+		if (param->pa_wl.hists == NULL) {
+			if (rc == 0)
+				rc = -DER_NOMEM;
+		} else {
+			for (j = 0; j < TS_DO_MAX; j++)
+				pf_hist_merge(&param->pa_wl.hists[j],
+					      &tx->tx_param.pa_wl.hists[j]);
+		}
+		D_FREE(tx->tx_param.pa_wl.hists);
+	}
+	param->pa_duration += duration;
+	return rc;
+}
+
+static void
+ts_xs_fini(void)
+{
+	struct ts_xstream	*tx;
+	int			 i;
+
+	if (ts_xstreams == NULL)
+		return;
+
+	ts_xs_exec(ts_xs_fini_ult);
+	for (i = 0; i < ts_xs_nr; i++) {
+		tx = &ts_xstreams[i];
+		if (tx->tx_xstream == ABT_XSTREAM_NULL)
+			continue;
+		ABT_xstream_join(tx->tx_xstream);
+		ABT_xstream_free(&tx->tx_xstream);
+#ifdef ULT_MMAP_STACK
+		stack_pool_destroy(tx->tx_sp);
+#endif
+	}
+	D_FREE(ts_xstreams);
+
+	if (ts_xs_attr != ABT_THREAD_ATTR_NULL)
+		ABT_thread_attr_free(&ts_xs_attr);
+	vos_self_fini();
+	ABT_finalize();
+	daos_debug_fini();
+}
+
+/**
+ * Start the concurrent xstreams, each of them creates its own pool file
+ * and NVMe context (target ID is the xstream index).
+ */
+static int
+ts_xs_init(void)
+{
+	struct ts_xstream	*tx;
+	ABT_xstream		 self;
+	int			 num_cpus = 0;
+	int			 rc;
+	int			 i;
+
+	rc = daos_debug_init(DAOS_LOG_DEFAULT);
+	if (rc)
+		return rc;
+
+	rc = ABT_init(0, NULL);
+	if (rc != ABT_SUCCESS) {
+		fprintf(stderr, "ABT init failed: %d\n", rc);
+		daos_debug_fini();
+		return -1;
+	}
+
+	/* global VOS and NVMe environment, the xstreams share it */
+	rc = vos_self_init(ts_pmem_path, false, -1);
+	if (rc) {
+		fprintf(stderr, "VOS init failed: "DF_RC"\n", DP_RC(rc));
+		ABT_finalize();
+		daos_debug_fini();
+		return rc;
+	}
+
+	D_ALLOC_ARRAY(ts_xstreams, ts_xs_nr);
+	if (ts_xstreams == NULL) {
+		vos_self_fini();
+		ABT_finalize();
+		daos_debug_fini();
+		return -DER_NOMEM;
+	}
+
+	rc = ABT_thread_attr_create(&ts_xs_attr);
+	if (rc == ABT_SUCCESS)
+		rc = ABT_thread_attr_set_stacksize(ts_xs_attr, TS_XS_STACK_SIZE);
+	if (rc != ABT_SUCCESS) {
+		fprintf(stderr, "failed to create ULT attr: %d\n", rc);
+		rc = -1;
+		goto failed;
+	}
+
+	/* no CPU affinity if Argobots is built without it */
+	if (ABT_xstream_self(&self) == ABT_SUCCESS)
+		ABT_xstream_get_affinity(self, 0, NULL, &num_cpus);
+
+	for (i = 0; i < ts_xs_nr; i++) {
+		tx = &ts_xstreams[i];
+		tx->tx_id = i;
+		tx->tx_xstream = ABT_XSTREAM_NULL;
+		snprintf(tx->tx_pmem_file, sizeof(tx->tx_pmem_file), "%s/vos_perf%d-%d.pmem",
+			 ts_pmem_path, ts_ctx.tsc_mpi_rank, i);
+
+#ifdef ULT_MMAP_STACK
+		rc = stack_pool_create(&tx->tx_sp);
+		if (rc)
+			goto failed;
+#endif
+		rc = ABT_xstream_create(ABT_SCHED_NULL, &tx->tx_xstream);
+		if (rc != ABT_SUCCESS) {
+			fprintf(stderr, "failed to create xstream %d: %d\n", i, rc);
+#ifdef ULT_MMAP_STACK
+			stack_pool_destroy(tx->tx_sp);
+#endif
+			tx->tx_xstream = ABT_XSTREAM_NULL;
+			rc = -1;
+			goto failed;
+		}
+		if (num_cpus > 0)
+			ABT_xstream_set_cpubind(tx->tx_xstream, i % num_cpus);
+	}
+
+	rc = ts_xs_exec(ts_xs_init_ult);
+	if (rc) {
+		fprintf(stderr, "failed to initialize xstreams: "DF_RC"\n", DP_RC(rc));
+		goto failed;
+	}
+	return 0;
+failed:
+	ts_xs_fini();
+	return rc;
+}
+
 static int
 objects_query(struct pf_param *param)
 {
@@ -423,7 +738,7 @@ pf_update(struct pf_test *ts, struct pf_param *param)
 	if (rc)
 		return rc;
 
-	rc = objects_update(param);
+	rc = ts_xs_run(objects_update, param);
 	if (rc)
 		return rc;
 
@@ -440,7 +755,7 @@ pf_punch(struct pf_test *ts, struct pf_param *param)
 	if (rc)
 		return rc;
 
-	rc = objects_punch(param);
+	rc = ts_xs_run(objects_punch, param);
 	if (rc)
 		return rc;
 
@@ -458,7 +773,7 @@ pf_fetch(struct pf_test *ts, struct pf_param *param)
 		return rc;
 
 	param->pa_rw.verify = false;
-	rc = objects_fetch(param);
+	rc = ts_xs_run(objects_fetch, param);
 	if (rc)
 		return rc;
 
@@ -467,7 +782,25 @@ pf_fetch(struct pf_test *ts, struct pf_param *param)
 }
 
 static int
-pf_aggregate(struct pf_test *ts, struct pf_param *param)
+pf_workload(struct pf_test *ts, struct pf_param *param)
+{
+	int	rc;
+
+	rc = objects_open();
+	if (rc)
+		return rc;
+
+	param->pa_rw.verify = false;
+	rc = ts_xs_run(objects_workload, param);
+	if (rc)
+		return rc;
+
+	rc = objects_close();
+	return rc;
+}
+
+static int
+objects_aggregate(struct pf_param *param)
 {
 	daos_epoch_t epoch = d_hlc_get();
 	daos_epoch_range_t	epr = {0, ++epoch};
@@ -489,7 +822,13 @@ pf_aggregate(struct pf_test *ts, struct pf_param *param)
 }
 
 static int
-pf_discard(struct pf_test *ts, struct pf_param *param)
+pf_aggregate(struct pf_test *ts, struct pf_param *param)
+{
+	return ts_xs_run(objects_aggregate, param);
+}
+
+static int
+objects_discard(struct pf_param *param)
 {
 	daos_epoch_t epoch = d_hlc_get();
 	daos_epoch_range_t	epr = {0, ++epoch};
@@ -506,7 +845,13 @@ pf_discard(struct pf_test *ts, struct pf_param *param)
 }
 
 static int
-pf_gc(struct pf_test *ts, struct pf_param *param)
+pf_discard(struct pf_test *ts, struct pf_param *param)
+{
+	return ts_xs_run(objects_discard, param);
+}
+
+static int
+objects_gc(struct pf_param *param)
 {
 	uint64_t		start = 0;
 
@@ -519,6 +864,12 @@ pf_gc(struct pf_test *ts, struct pf_param *param)
 	return 0;
 }
 
+static int
+pf_gc(struct pf_test *ts, struct pf_param *param)
+{
+	return ts_xs_run(objects_gc, param);
+}
+
 static int
 pf_verify(struct pf_test *ts, struct pf_param *param)
 {
@@ -534,7 +885,7 @@ pf_verify(struct pf_test *ts, struct pf_param *param)
 		return rc;
 
 	param->pa_rw.verify = true;
-	rc = objects_fetch(param);
+	rc = ts_xs_run(objects_fetch, param);
 	if (rc)
 		return rc;
 
@@ -543,11 +894,17 @@ pf_verify(struct pf_test *ts, struct pf_param *param)
 }
 
 
+static int
+objects_iterate(struct pf_param *param)
+{
+	return obj_iter_records(ts_uoids[0], param);
+}
+
 static int
 pf_iterate(struct pf_test *pf, struct pf_param *param)
 {
 	ts_nest_iterator = param->pa_iter.nested;
-	return obj_iter_records(ts_uoids[0], param);
+	return ts_xs_run(objects_iterate, param);
 }
 
 static int
@@ -574,7 +931,7 @@ pf_query(struct pf_test *ts, struct pf_param *param)
 	if (rc)
 		return rc;
 
-	rc = objects_query(param);
+	rc = ts_xs_run(objects_query, param);
 	if (rc)
 		return rc;
 
@@ -716,6 +1073,12 @@ struct pf_test pf_tests[] = {
 		.ts_parse	= pf_parse_aggregate,
 		.ts_func	= pf_gc,
 	},
+	{
+		.ts_code	= 'W',
+		.ts_name	= "WORKLOAD",
+		.ts_parse	= pf_parse_workload,
+		.ts_func	= pf_workload,
+	},
 	{
 		.ts_code	= 0,
 	},
@@ -734,8 +1097,14 @@ const char perf_vos_usage[] = "\n"
 "-i	Use integer dkeys.  Required if running QUERY test.\n\n"
 "-I	Use constant akey.  Required for QUERY test.\n\n"
 "-x	Run each test in an ABT ULT.\n\n"
+"-T number\n"
+"	Run the tests concurrently on this number of xstreams, each of them\n"
+"	has its own VOS file, pool and NVMe context. Aggregate and per-xstream\n"
+"	results are reported. It cannot be used with -x.\n\n"
 "Examples:\n"
-"	$ vos_perf -s 1024k -A -R 'U U;o=4k;s=4k V'\n";
+"	$ vos_perf -s 1024k -A -R 'U U;o=4k;s=4k V'\n"
+"	$ vos_perf -R 'U W;r=50;h=10;q=50k;c=500k;p'\n"
+"	$ vos_perf -T 8 -d 64k -R 'U;p F;p'\n";
 
 static void
 ts_print_usage(void)
@@ -754,10 +1123,11 @@ const struct option perf_vos_opts[] = {
 	{ "int_dkey",	no_argument,		NULL,	'i' },
 	{ "const_akey",	no_argument,		NULL,	'I' },
 	{ "abt_ult",	no_argument,		NULL,	'x' },
+	{ "xstreams",	required_argument,	NULL,	'T' },
 	{ NULL,		0,			NULL,	0   },
 };
 
-const char perf_vos_optstr[] = "D:ziIx";
+const char perf_vos_optstr[] = "D:ziIxT:";
 
 int
 main(int argc, char **argv)
@@ -817,10 +1187,24 @@ main(int argc, char **argv)
 		case 'x':
 			ts_in_ult = true;
 			break;
+		case 'T':
+			ts_xs_nr = strtoul(optarg, NULL, 0);
+			if (ts_xs_nr == 0 || ts_xs_nr > TS_XS_MAX) {
+				fprintf(stderr, "number of xstreams must be in [1, %d]\n",
+					TS_XS_MAX);
+				perf_free_opts(ts_opts, ts_optstr);
+				return -1;
+			}
+			break;
 		}
 	}
 	perf_free_opts(ts_opts, ts_optstr);
 
+	if (ts_in_ult && ts_xs_nr > 1) {
+		fprintf(stderr, "-x and -T are mutually exclusive\n");
+		return -1;
+	}
+
 	if (ts_const_akey)
 		ts_akey_p_dkey = 1;
 
@@ -851,13 +1235,14 @@ main(int argc, char **argv)
 			return -1;
 	}
 
-	ts_ctx.tsc_cred_nr = -1; /* VOS can only support sync mode */
 	if (ts_pmem_path[0] == '\0')
 		strcpy(ts_pmem_path, "/mnt/daos");
-	snprintf(ts_pmem_file, sizeof(ts_pmem_file), "%s/vos_perf%d.pmem", ts_pmem_path,
-		 ts_ctx.tsc_mpi_rank);
-	ts_ctx.tsc_pmem_path = ts_pmem_path;
-	ts_ctx.tsc_pmem_file = ts_pmem_file;
+	if (ts_xs_nr > 1)
+		snprintf(ts_pmem_file, sizeof(ts_pmem_file), "%s/vos_perf%d-[0-%u].pmem",
+			 ts_pmem_path, ts_ctx.tsc_mpi_rank, ts_xs_nr - 1);
+	else
+		snprintf(ts_pmem_file, sizeof(ts_pmem_file), "%s/vos_perf%d.pmem",
+			 ts_pmem_path, ts_ctx.tsc_mpi_rank);
 
 	if (ts_in_ult) {
 		rc = ts_abt_init();
@@ -868,11 +1253,7 @@ main(int argc, char **argv)
 	if (ts_stride < STRIDE_MIN)
 		ts_stride = STRIDE_MIN;
 
-	stride_buf_init(ts_stride);
-
-	ts_ctx.tsc_cred_vsize	= ts_stride;
-	ts_ctx.tsc_scm_size	= ts_scm_size;
-	ts_ctx.tsc_nvme_size	= ts_nvme_size;
+	ts_ctx_prep(ts_pmem_file);
 
 	/*
 	 * For vos_perf, if pool/cont uuids are supplied as command line
@@ -899,7 +1280,13 @@ main(int argc, char **argv)
 		return -1;
 #endif
 
-	rc = dts_ctx_init(&ts_ctx, &vos_engine);
+	if (ts_xs_nr > 1) {
+		ts_main_ctx = &ts_ctx;
+		rc = ts_xs_init();
+	} else {
+		stride_buf_init(ts_stride);
+		rc = dts_ctx_init(&ts_ctx, &vos_engine);
+	}
 	if (rc)
 		return -1;
 
@@ -920,6 +1307,7 @@ main(int argc, char **argv)
 			"\tvalue type    : %s\n"
 			"\tvalue size    : %u\n"
 			"\tzero copy     : %s\n"
+			"\txstreams      : %u\n"
 			"\tVOS file      : %s\n",
 			uuid_buf,
 			(unsigned int)(ts_scm_size >> 20),
@@ -933,6 +1321,7 @@ main(int argc, char **argv)
 			ts_val_type(),
 			ts_stride,
 			ts_yes_or_no(ts_zero_copy),
+			ts_xs_nr,
 			ts_pmem_file);
 	}
 
@@ -956,10 +1345,14 @@ main(int argc, char **argv)
 	if (ts_in_ult)
 		ts_abt_fini();
 
-	if (ts_indices)
-		free(ts_indices);
-	stride_buf_fini();
-	dts_ctx_fini(&ts_ctx);
+	if (ts_xs_nr > 1) {
+		ts_xs_fini();
+	} else {
+		if (ts_indices)
+			free(ts_indices);
+		stride_buf_fini();
+		dts_ctx_fini(&ts_ctx);
+	}
 
 #ifdef ULT_MMAP_STACK
 	stack_pool_destroy(sp);
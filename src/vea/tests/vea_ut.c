@@ -860,6 +860,77 @@ ut_inval_params_free(void **state)
 	ut_teardown(&args);
 }
 
+static void
+ut_free_batch(void **state)
+{
+	struct vea_ut_args args;
+	struct vea_free_extent vfes[8];
+	struct vea_resrvd_ext *ext;
+	struct vea_unmap_context unmap_ctxt = { 0 };
+	uint64_t capacity = ((VEA_LARGE_EXT_MB * 2) << 20); /* 128 MB */
+	d_list_t *r_list;
+	uint32_t nr_flushed;
+	int rc, i;
+
+	print_message("Free a batch of extents in one call\n");
+	ut_setup(&args);
+	rc = vea_format(&args.vua_umm, &args.vua_txd, args.vua_md, 0, 1,
+			capacity, NULL, NULL, false);
+	assert_rc_equal(rc, 0);
+
+	rc = vea_load(&args.vua_umm, &args.vua_txd, args.vua_md, &unmap_ctxt,
+		      NULL, &args.vua_vsi);
+	assert_rc_equal(rc, 0);
+	r_list = &args.vua_resrvd_list[0];
+
+	for (i = 0; i < ARRAY_SIZE(vfes); i++) {
+		rc = vea_reserve(args.vua_vsi, 16, NULL, r_list);
+		assert_rc_equal(rc, 0);
+	}
+
+	/* the reserved list will be freed on publish, save the extents */
+	i = 0;
+	d_list_for_each_entry(ext, r_list, vre_link) {
+		vfes[i].vfe_blk_off = ext->vre_blk_off;
+		vfes[i].vfe_blk_cnt = ext->vre_blk_cnt;
+		i++;
+	}
+	assert_int_equal(i, ARRAY_SIZE(vfes));
+
+	rc = umem_tx_begin(&args.vua_umm, &args.vua_txd);
+	assert_int_equal(rc, 0);
+	rc = vea_tx_publish(args.vua_vsi, NULL, r_list);
+	assert_int_equal(rc, 0);
+	rc = umem_tx_commit(&args.vua_umm);
+	assert_int_equal(rc, 0);
+
+	rc = vea_free_batch(args.vua_vsi, vfes, ARRAY_SIZE(vfes));
+	assert_rc_equal(rc, 0);
+
+	for (i = 0; i < ARRAY_SIZE(vfes); i++) {
+		rc = vea_verify_alloc(args.vua_vsi, false, vfes[i].vfe_blk_off,
+				      vfes[i].vfe_blk_cnt);
+		assert_rc_equal(rc, 1);
+	}
+
+	rc = vea_flush(args.vua_vsi, true, UINT32_MAX, &nr_flushed);
+	assert_rc_equal(rc, 0);
+
+	for (i = 0; i < ARRAY_SIZE(vfes); i++) {
+		rc = vea_verify_alloc(args.vua_vsi, true, vfes[i].vfe_blk_off,
+				      vfes[i].vfe_blk_cnt);
+		assert_rc_equal(rc, 1);
+	}
+
+	/* an invalid extent fails the whole batch */
+	vfes[0].vfe_blk_cnt = 0;
+	rc = vea_free_batch(args.vua_vsi, vfes, ARRAY_SIZE(vfes));
+	assert_rc_equal(rc, -DER_INVAL);
+
+	vea_unload(args.vua_vsi);
+	ut_teardown(&args);
+}
+
 static void
 ut_inval_params_hint_load(void **state)
 {
@@ -1276,6 +1347,7 @@ static const struct CMUnitTest vea_uts[] = {
 	{ "vea_inval_param_get_ext_vector", ut_inval_params_get_ext_vector,
 	  NULL, NULL},
 	{ "vea_free_invalid_space", ut_free_invalid_space, NULL, NULL},
+	{ "vea_free_batch", ut_free_batch, NULL, NULL},
 	{ "vea_interleaved_ops", ut_interleaved_ops, NULL, NULL},
 	{ "vea_fragmentation", ut_fragmentation, NULL, NULL}
 };
@@ -459,13 +459,15 @@ vea_tx_publish(struct vea_space_info *vsi, struct vea_hint_context *hint,
 
 struct free_commit_cb_arg {
 	struct vea_space_info	*fca_vsi;
-	struct vea_free_extent	 fca_vfe;
+	uint32_t		 fca_nr;
+	struct vea_free_extent	 fca_vfes[0];
 };
 
 static void
 free_commit_cb(void *data, bool noop)
 {
 	struct free_commit_cb_arg *fca = data;
+	uint32_t i;
 	int rc;
 
 	/* Transaction aborted, only need to free callback arg */
@@ -483,44 +485,50 @@ free_commit_cb(void *data, bool noop)
 	 * avoid is the contrary case: in-memory tree update succeeds
 	 * but persistent tree update fails, which risks data corruption.
 	 */
-	rc = aggregated_free(fca->fca_vsi, &fca->fca_vfe);
-
-	D_CDEBUG(rc, DLOG_ERR, DB_IO, "Aggregated free on vsi:%p rc %d\n",
-		 fca->fca_vsi, rc);
+	for (i = 0; i < fca->fca_nr; i++) {
+		rc = aggregated_free(fca->fca_vsi, &fca->fca_vfes[i]);
+		D_CDEBUG(rc, DLOG_ERR, DB_IO, "Aggregated free on vsi:%p rc %d\n",
+			 fca->fca_vsi, rc);
+	}
 free:
 	D_FREE(fca);
 }
 
 /*
- * Free allocated extent.
- *
- * The just recent freed extents won't be visible for allocation instantly,
- * they will stay in vsi_agg_lru for a short period time, and being coalesced
- * with each other there.
+ * Free allocated extents.
  *
- * Expired free extents in the vsi_agg_lru will be migrated to the allocation
- * visible index (vsi_free_tree, vfc_heap or vfc_lrus) from time to time, this
- * kind of migration will be triggered by vea_reserve() & vea_free() calls.
+ * All extents are added to the persistent free tree in a single (nested)
+ * transaction, and are handed to the aggregate free tree by one commit
+ * callback, so freeing many extents costs a single callback registration
+ * and at most one aging flush.
  */
 int
-vea_free(struct vea_space_info *vsi, uint64_t blk_off, uint32_t blk_cnt)
+vea_free_batch(struct vea_space_info *vsi, struct vea_free_extent *vfes,
+	       uint32_t nr)
 {
 	D_ASSERT(vsi != NULL);
 	struct umem_instance *umem = vsi->vsi_umem;
 	struct free_commit_cb_arg *fca;
+	uint32_t i;
 	int rc;
 
-	D_ALLOC_PTR(fca);
+	if (nr == 0)
+		return 0;
+
+	D_ALLOC(fca, offsetof(struct free_commit_cb_arg, fca_vfes[nr]));
 	if (fca == NULL)
 		return -DER_NOMEM;
 
 	fca->fca_vsi = vsi;
-	fca->fca_vfe.vfe_blk_off = blk_off;
-	fca->fca_vfe.vfe_blk_cnt = blk_cnt;
+	fca->fca_nr = nr;
+	for (i = 0; i < nr; i++) {
+		fca->fca_vfes[i].vfe_blk_off = vfes[i].vfe_blk_off;
+		fca->fca_vfes[i].vfe_blk_cnt = vfes[i].vfe_blk_cnt;
 
-	rc = verify_free_entry(NULL, &fca->fca_vfe);
-	if (rc)
-		goto error;
+		rc = verify_free_entry(NULL, &fca->fca_vfes[i]);
+		if (rc)
+			goto error;
+	}
 
 	/*
 	 * The transaction may have been started by caller already, here
@@ -531,10 +539,12 @@ vea_free(struct vea_space_info *vsi, uint64_t blk_off, uint32_t blk_cnt)
 	if (rc != 0)
 		goto error;
 
-	/* Add the free extent in persistent free extent tree */
-	rc = persistent_free(vsi, &fca->fca_vfe);
-	if (rc)
-		goto done;
+	/* Add the free extents in persistent free extent tree */
+	for (i = 0; i < nr; i++) {
+		rc = persistent_free(vsi, &fca->fca_vfes[i]);
+		if (rc)
+			goto done;
+	}
 
 	rc = umem_tx_add_callback(umem, vsi->vsi_txd, TX_STAGE_ONCOMMIT,
 				  free_commit_cb, fca);
@@ -563,6 +573,28 @@ error:
 	return rc;
 }
 
+/*
+ * Free allocated extent.
+ *
+ * The just recent freed extents won't be visible for allocation instantly,
+ * they will stay in vsi_agg_lru for a short period time, and being coalesced
+ * with each other there.
+ *
+ * Expired free extents in the vsi_agg_lru will be migrated to the allocation
+ * visible index (vsi_free_tree, vfc_heap or vfc_lrus) from time to time, this
+ * kind of migration will be triggered by vea_reserve() & vea_free() calls.
+ */
+int
+vea_free(struct vea_space_info *vsi, uint64_t blk_off, uint32_t blk_cnt)
+{
+	struct vea_free_extent vfe = { 0 };
+
+	vfe.vfe_blk_off = blk_off;
+	vfe.vfe_blk_cnt = blk_cnt;
+
+	return vea_free_batch(vsi, &vfe, 1);
+}
+
 /* Set an arbitrary age to a free extent with specified start offset. */
 int
 vea_set_ext_age(struct vea_space_info *vsi, uint64_t blk_off, uint64_t age)
@@ -71,6 +71,8 @@ struct evt_context {
 	uint32_t                         tc_creds    : 30;
 	/** credits is enabled */
 	uint32_t                         tc_creds_on : 1;
+	/** credits are charged per leaf node, see evt_drain_bulk */
+	uint32_t                         tc_creds_bulk : 1;
 	/** cached number of bytes per entry */
 	uint32_t			 tc_inob;
 	/** cached tree feature bits (reduce PMEM access) */
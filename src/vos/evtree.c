@@ -576,6 +576,10 @@ evt_ent_addr_update(struct evt_context *tcx, struct evt_entry *ent,
 	if (bio_addr_is_hole(&ent->en_addr))
 		return; /* Nothing to do for holes */
 
+	/* Compressed extent can only be addressed from its start */
+	if (BIO_ADDR_IS_COMPRESSED(&ent->en_addr))
+		return;
+
 	D_ASSERT(tcx->tc_inob != 0);
 	ent->en_addr.ba_off += diff * tcx->tc_inob;
 }
@@ -1324,6 +1328,30 @@ out:
 	return rc;
 }
 
+/**
+ * Check if any entry of a leaf node references an NVMe extent, such a node
+ * can't be drained in bulk because each extent has to be returned to VEA.
+ */
+static bool
+evt_node_has_nvme(struct evt_context *tcx, struct evt_node *nd)
+{
+	struct evt_node_entry	*ne;
+	struct evt_desc		*desc;
+	int			 i;
+
+	for (i = 0; i < nd->tn_nr; i++) {
+		ne = evt_node_entry_at(tcx, nd, i);
+		if (UMOFF_IS_NULL(ne->ne_child))
+			continue;
+
+		desc = evt_off2desc(tcx, ne->ne_child);
+		if (desc->dc_ex_addr.ba_type == DAOS_MEDIA_NVME &&
+		    !bio_addr_is_hole(&desc->dc_ex_addr))
+			return true;
+	}
+	return false;
+}
+
 /** check if a node is full */
 static bool
 evt_node_is_full(struct evt_context *tcx, struct evt_node *nd)
@@ -1470,6 +1498,7 @@ evt_node_destroy(struct evt_context *tcx, umem_off_t nd_off, int level,
 	struct evt_node		*nd;
 	bool			 empty;
 	bool			 leaf;
+	bool			 bulk = false;
 	int			 i;
 	int			 rc = 0;
 
@@ -1479,6 +1508,9 @@ evt_node_destroy(struct evt_context *tcx, umem_off_t nd_off, int level,
 	V_TRACE(DB_TRACE, "Destroy %s node at level %d (nr = %d)\n",
 		leaf ? "leaf" : "", level, nd->tn_nr);
 
+	if (leaf && tcx->tc_creds_on && tcx->tc_creds_bulk)
+		bulk = !evt_node_has_nvme(tcx, nd);
+
 	empty = true;
 	for (i = nd->tn_nr - 1; i >= 0; i--) {
 		if (leaf) {
@@ -1488,7 +1520,7 @@ evt_node_destroy(struct evt_context *tcx, umem_off_t nd_off, int level,
 			if (rc)
 				goto out;
 
-			if (!tcx->tc_creds_on)
+			if (!tcx->tc_creds_on || bulk)
 				continue;
 
 			D_ASSERT(tcx->tc_creds > 0);
@@ -1521,6 +1553,12 @@ evt_node_destroy(struct evt_context *tcx, umem_off_t nd_off, int level,
 		}
 	}
 
+	/* NB: leaf without NVMe extents consumes one credit in bulk mode */
+	if (bulk) {
+		D_ASSERT(tcx->tc_creds > 0);
+		tcx->tc_creds--;
+	}
+
 	if (empty) {
 		rc = evt_node_free(tcx, nd_off);
 	} else {
@@ -4014,8 +4052,8 @@ evt_overhead_get(int alloc_overhead, int tree_order,
 	return 0;
 }
 
-int
-evt_drain(daos_handle_t toh, int *credits, bool *destroyed)
+static int
+evt_drain_internal(daos_handle_t toh, int *credits, bool bulk, bool *destroyed)
 {
 	struct evt_context *tcx;
 	int		    rc;
@@ -4030,6 +4068,7 @@ evt_drain(daos_handle_t toh, int *credits, bool *destroyed)
 
 		tcx->tc_creds = *credits;
 		tcx->tc_creds_on = 1;
+		tcx->tc_creds_bulk = bulk;
 	}
 
 	rc = evt_tx_begin(tcx);
@@ -4046,10 +4085,23 @@ out:
 	rc = evt_tx_end(tcx, rc);
 
 	tcx->tc_creds_on = 0;
+	tcx->tc_creds_bulk = 0;
 	tcx->tc_creds = 0;
 	return rc;
 }
 
+int
+evt_drain(daos_handle_t toh, int *credits, bool *destroyed)
+{
+	return evt_drain_internal(toh, credits, false, destroyed);
+}
+
+int
+evt_drain_bulk(daos_handle_t toh, int *credits, bool *destroyed)
+{
+	return evt_drain_internal(toh, credits, true, destroyed);
+}
+
 int
 evt_feats_set(struct evt_root *root, struct umem_instance *umm, uint64_t feats)
 
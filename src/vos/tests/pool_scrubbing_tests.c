@@ -199,6 +199,7 @@ struct sts_context {
 	sc_yield_fn_t		 tsc_yield_fn;
 	sc_sleep_fn_t		 tsc_sleep_fn;
 	sc_is_idle_fn_t		 tsc_is_idle_fn;
+	sc_io_lat_fn_t		 tsc_io_lat_fn;
 	void			*tsc_sched_arg;
 	int			 tsc_fd;
 	int			 tsc_expected_rc;
@@ -491,6 +492,7 @@ sts_ctx_setup_scrub_ctx(struct sts_context *ctx)
 	ctx->tsc_scrub_ctx.sc_yield_fn = ctx->tsc_yield_fn;
 	ctx->tsc_scrub_ctx.sc_sleep_fn = ctx->tsc_sleep_fn;
 	ctx->tsc_scrub_ctx.sc_is_idle_fn = ctx->tsc_is_idle_fn;
+	ctx->tsc_scrub_ctx.sc_io_lat_fn = ctx->tsc_io_lat_fn;
 	ctx->tsc_scrub_ctx.sc_sched_arg = ctx->tsc_sched_arg;
 	ctx->tsc_scrub_ctx.sc_cont_lookup_fn = ctx->tsc_get_cont_fn;
 	ctx->tsc_scrub_ctx.sc_drain_pool_tgt_fn = fake_target_drain;
@@ -880,6 +882,164 @@ multiple_overlapping_extents(void **state)
 	assert_success(sts_ctx_fetch(ctx, 1, TEST_IOD_ARRAY_1, "dkey", "akey", 3));
 }
 
+static void
+set_scrub_cursor(struct sts_context *ctx, uuid_t cont, int oid_lo)
+{
+	daos_unit_oid_t	oid = {0};
+
+	set_test_oid(&oid, oid_lo);
+	assert_success(vos_scrub_cursor_set(ctx->tsc_poh, cont, &oid));
+}
+
+static void
+assert_no_scrub_cursor(struct sts_context *ctx)
+{
+	daos_unit_oid_t	oid;
+	uuid_t		cont;
+
+	assert_rc_equal(-DER_NONEXIST, vos_scrub_cursor_get(ctx->tsc_poh, cont, &oid));
+}
+
+static void
+resume_after_cursor(void **state)
+{
+	struct sts_context	*ctx = *state;
+	daos_unit_oid_t		 oid = {0};
+	daos_unit_oid_t		 cur_oid;
+	uuid_t			 cur_cont;
+	int			 i;
+
+	for (i = 1; i <= 4; i++)
+		sts_ctx_update(ctx, i, TEST_IOD_SINGLE, "dkey", "akey", 1, true);
+
+	/* interrupted pass that had fully scrubbed objects 1 and 2 */
+	set_scrub_cursor(ctx, ctx->tsc_cont_uuid, 2);
+	set_test_oid(&oid, 2);
+	assert_success(vos_scrub_cursor_get(ctx->tsc_poh, cur_cont, &cur_oid));
+	assert_int_equal(0, uuid_compare(cur_cont, ctx->tsc_cont_uuid));
+	assert_true(daos_unit_oid_compare(cur_oid, oid) == 0);
+
+	sts_ctx_do_scrub(ctx);
+
+	/* only the objects after the cursor are scrubbed */
+	assert_success(sts_ctx_fetch(ctx, 1, TEST_IOD_SINGLE, "dkey", "akey", 1));
+	assert_success(sts_ctx_fetch(ctx, 2, TEST_IOD_SINGLE, "dkey", "akey", 1));
+	assert_csum_error(sts_ctx_fetch(ctx, 3, TEST_IOD_SINGLE, "dkey", "akey", 1));
+	assert_csum_error(sts_ctx_fetch(ctx, 4, TEST_IOD_SINGLE, "dkey", "akey", 1));
+
+	/* completed pass, the next one starts over */
+	assert_no_scrub_cursor(ctx);
+	ctx->tsc_scrub_ctx.sc_pool_start_scrub.tv_sec -= 10;
+	sts_ctx_do_scrub(ctx);
+
+	assert_csum_error(sts_ctx_fetch(ctx, 1, TEST_IOD_SINGLE, "dkey", "akey", 1));
+	assert_csum_error(sts_ctx_fetch(ctx, 2, TEST_IOD_SINGLE, "dkey", "akey", 1));
+}
+
+static void
+resume_after_deleted_object(void **state)
+{
+	struct sts_context *ctx = *state;
+
+	/* the object of the cursor doesn't exist anymore */
+	sts_ctx_update(ctx, 1, TEST_IOD_SINGLE, "dkey", "akey", 1, true);
+	sts_ctx_update(ctx, 3, TEST_IOD_SINGLE, "dkey", "akey", 1, true);
+	sts_ctx_update(ctx, 4, TEST_IOD_SINGLE, "dkey", "akey", 1, true);
+	set_scrub_cursor(ctx, ctx->tsc_cont_uuid, 2);
+
+	sts_ctx_do_scrub(ctx);
+
+	/* resumes with the next object in index order */
+	assert_success(sts_ctx_fetch(ctx, 1, TEST_IOD_SINGLE, "dkey", "akey", 1));
+	assert_csum_error(sts_ctx_fetch(ctx, 3, TEST_IOD_SINGLE, "dkey", "akey", 1));
+	assert_csum_error(sts_ctx_fetch(ctx, 4, TEST_IOD_SINGLE, "dkey", "akey", 1));
+	assert_no_scrub_cursor(ctx);
+}
+
+static void
+resume_after_deleted_container(void **state)
+{
+	struct sts_context	*ctx = *state;
+	uuid_t			 cont;
+
+	sts_ctx_update(ctx, 1, TEST_IOD_SINGLE, "dkey", "akey", 1, true);
+
+	/* the container of the cursor was ordered after the test container */
+	uuid_parse("ffffffff-ffff-ffff-ffff-ffffffffffff", cont);
+	set_scrub_cursor(ctx, cont, 1);
+	sts_ctx_do_scrub(ctx);
+	assert_success(sts_ctx_fetch(ctx, 1, TEST_IOD_SINGLE, "dkey", "akey", 1));
+	assert_no_scrub_cursor(ctx);
+
+	/* the container of the cursor was ordered before the test container */
+	uuid_parse("00000000-0000-0000-0000-000000000001", cont);
+	set_scrub_cursor(ctx, cont, 1);
+	ctx->tsc_scrub_ctx.sc_pool_start_scrub.tv_sec -= 10;
+	sts_ctx_do_scrub(ctx);
+	assert_csum_error(sts_ctx_fetch(ctx, 1, TEST_IOD_SINGLE, "dkey", "akey", 1));
+	assert_no_scrub_cursor(ctx);
+}
+
+#define FAKE_IO_LAT_HIGH_US	50000
+
+static uint64_t	fake_io_lat_result;
+static int	fake_io_lat_call_count;
+static int	fake_io_lat_sleep_count;
+
+static uint64_t
+fake_io_lat(void)
+{
+	fake_io_lat_call_count++;
+	return fake_io_lat_result;
+}
+
+static int
+fake_io_lat_sleep(void *arg, uint32_t msec)
+{
+	/* other sleeps of the scrubber don't use this duration */
+	if (msec == FAKE_IO_LAT_HIGH_US / 1000)
+		fake_io_lat_sleep_count++;
+	return 0;
+}
+
+static void
+batch_size_follows_io_latency(void **state)
+{
+	struct sts_context	*ctx = *state;
+	int			 low_calls;
+	int			 i;
+
+	/* 4MB of values of a single akey, verified in batches of at most 1MB */
+	ctx->tsc_data_len = 128 * 1024;
+	for (i = 1; i <= 32; i++)
+		sts_ctx_update(ctx, 1, TEST_IOD_SINGLE, "dkey", "akey", i, false);
+
+	ctx->tsc_io_lat_fn = fake_io_lat;
+	ctx->tsc_sleep_fn = fake_io_lat_sleep;
+
+	/* low latency, the batch grows and the scrubber doesn't back off */
+	fake_io_lat_result = 0;
+	fake_io_lat_call_count = 0;
+	fake_io_lat_sleep_count = 0;
+	sts_ctx_do_scrub(ctx);
+	low_calls = fake_io_lat_call_count;
+	assert_true(low_calls > 0);
+	assert_int_equal(0, fake_io_lat_sleep_count);
+
+	/* high latency, the batch shrinks down to a single value and every batch sleeps */
+	fake_io_lat_result = FAKE_IO_LAT_HIGH_US;
+	fake_io_lat_call_count = 0;
+	fake_io_lat_sleep_count = 0;
+	ctx->tsc_scrub_ctx.sc_pool_start_scrub.tv_sec -= 10;
+	sts_ctx_do_scrub(ctx);
+	assert_true(fake_io_lat_call_count >= 2 * low_calls);
+	assert_true(fake_io_lat_call_count >= 20);
+	assert_int_equal(fake_io_lat_call_count, fake_io_lat_sleep_count);
+
+	for (i = 1; i <= 32; i++)
+		assert_success(sts_ctx_fetch(ctx, 1, TEST_IOD_SINGLE, "dkey", "akey", i));
+}
+
 static int
 sts_setup(void **state)
 {
@@ -954,6 +1114,14 @@ static const struct CMUnitTest scrubbing_tests[] = {
 	   multiple_overlapping_extents),
 	TS("CSUM_SCRUBBING_13: Evict pool target when threshold is exceeded",
 	   drain_target),
+	TS("CSUM_SCRUBBING_14: Resume an interrupted pass after the saved object",
+	   resume_after_cursor),
+	TS("CSUM_SCRUBBING_15: Resume after an object that was deleted",
+	   resume_after_deleted_object),
+	TS("CSUM_SCRUBBING_16: Resume after a container that was deleted",
+	   resume_after_deleted_container),
+	TS("CSUM_SCRUBBING_17: Batch size and pacing follow the I/O latency",
+	   batch_size_follows_io_latency),
 };
 
 int
@@ -0,0 +1,1171 @@
+/**
+ * (C) Copyright 2026 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * Microbenchmarks for the in-memory and persistent index structures used by
+ * VOS: dbtree of the generic classes, evtree, incarnation log and LRU array.
+ *
+ * Each case runs the insert, lookup, iterate, delete and aggregate phases a
+ * structure supports, over a given number of records inserted in sequential
+ * or random key order, on volatile or persistent memory. Results are printed
+ * as a table or as JSON lines, and can be saved as or compared against a
+ * baseline file.
+ */
+#define D_LOGFAC	DD_FAC(tests)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <sys/utsname.h>
+#include <daos/common.h>
+#include <daos/btree.h>
+#include <daos/btree_class.h>
+#include <daos/dtx.h>
+#include <daos_srv/evtree.h>
+#include <daos_srv/bio.h>
+#include <daos_pool.h>
+#include <utest_common.h>
+#include "ilog.h"
+#include "lru_array.h"
+
+#define BENCH_POOL_NAME		"vos_bench.pmem"
+#define BENCH_POOL_SIZE		(1024 * 1024 * 1024ULL)
+#define BENCH_SIZES_DEF		"1024,16384,262144"
+#define BENCH_SIZES_MAX		16
+#define BENCH_SIZE_MIN		16
+#define BENCH_TOLERANCE_DEF	20
+#define BENCH_VAL_SIZE		32
+#define BENCH_BTR_ORDER		16
+#define BENCH_EVT_ORDER		16
+/* width of each evtree extent */
+#define BENCH_EVT_EXT		16
+/* an incarnation log is fetched as a whole, keep it to a realistic length */
+#define BENCH_ILOG_MAX		4096
+/* entries per LRU sub array */
+#define BENCH_LRU_SUB		1024
+#define BENCH_NAME_LEN		64
+
+enum {
+	BENCH_VMEM	= (1 << 0),
+	BENCH_PMEM	= (1 << 1),
+};
+
+enum {
+	BENCH_SEQ	= (1 << 0),
+	BENCH_RAND	= (1 << 1),
+};
+
+enum {
+	BENCH_INSERT,
+	BENCH_LOOKUP,
+	BENCH_ITERATE,
+	BENCH_DELETE,
+	BENCH_AGGREGATE,
+	BENCH_OP_NR,
+};
+
+static const char *bench_op_names[BENCH_OP_NR] = {
+	"insert", "lookup", "iterate", "delete", "aggregate",
+};
+
+/* storage of the structure under test, shared by all cases of a memory class */
+union bench_root {
+	struct btr_root		br_btr;
+	struct evt_root		br_evt;
+	struct ilog_df		br_ilog;
+};
+
+struct bench_struct;
+
+struct bench_run {
+	struct bench_struct	*br_struct;
+	struct utest_context	*br_utx;
+	union bench_root	*br_root;
+	daos_handle_t		 br_hdl;
+	struct lru_array	*br_lru;
+	/* LRU index of each key */
+	uint32_t		*br_lru_idx;
+	/* keys in the order of the current phase */
+	uint64_t		*br_keys;
+	uint64_t		 br_size;
+	char			 br_val[BENCH_VAL_SIZE];
+};
+
+/*
+ * Per key operations are called for each key of the phase, whole structure
+ * ones once and return the number of records they processed. NULL if the
+ * structure does not support the operation.
+ */
+struct bench_struct {
+	const char	*bs_name;
+	unsigned int	 bs_mem;
+	unsigned int	 bs_dist;
+	uint64_t	 bs_size_max;
+	/* dbtree class and features */
+	unsigned int	 bs_class;
+	uint64_t	 bs_feats;
+	int		(*bs_create)(struct bench_run *br);
+	void		(*bs_destroy)(struct bench_run *br);
+	int		(*bs_insert)(struct bench_run *br, uint64_t key);
+	int		(*bs_lookup)(struct bench_run *br, uint64_t key);
+	int		(*bs_delete)(struct bench_run *br, uint64_t key);
+	int		(*bs_iterate)(struct bench_run *br, uint64_t *nr);
+	int		(*bs_aggregate)(struct bench_run *br, uint64_t *nr);
+};
+
+struct bench_result {
+	char		res_name[BENCH_NAME_LEN];
+	uint64_t	res_ops;
+	uint64_t	res_nsec;
+	double		res_rate;
+};
+
+static struct bench_result	*bench_results;
+static int			 bench_result_nr;
+static int			 bench_result_max;
+static bool			 bench_json;
+static unsigned int		 bench_seed;
+
+/******************************************************************************
+ * dbtree
+ ******************************************************************************/
+
+/* key buffer of the class, large enough for any of them */
+union bench_btr_key {
+	uint64_t	bk_int;
+	uuid_t		bk_uuid;
+	char		bk_name[24];
+};
+
+static void
+bench_btr_key(struct bench_run *br, uint64_t key, union bench_btr_key *kbuf,
+	      d_iov_t *iov)
+{
+	memset(kbuf, 0, sizeof(*kbuf));
+	switch (br->br_struct->bs_class) {
+	case DBTREE_CLASS_KV:
+	case DBTREE_CLASS_IV:
+	case DBTREE_CLASS_IFV:
+		kbuf->bk_int = key;
+		d_iov_set(iov, &kbuf->bk_int, sizeof(kbuf->bk_int));
+		break;
+	case DBTREE_CLASS_UV:
+		memcpy(kbuf->bk_uuid, &key, sizeof(key));
+		d_iov_set(iov, kbuf->bk_uuid, sizeof(kbuf->bk_uuid));
+		break;
+	case DBTREE_CLASS_NV:
+		snprintf(kbuf->bk_name, sizeof(kbuf->bk_name), "key-%016"PRIx64, key);
+		d_iov_set(iov, kbuf->bk_name, strlen(kbuf->bk_name) + 1);
+		break;
+	default:
+		D_ASSERT(0);
+	}
+}
+
+static int
+bench_btr_create(struct bench_run *br)
+{
+	struct bench_struct	*bs = br->br_struct;
+
+	return dbtree_create_inplace(bs->bs_class, bs->bs_feats, BENCH_BTR_ORDER,
+				     utest_utx2uma(br->br_utx), &br->br_root->br_btr,
+				     &br->br_hdl);
+}
+
+static void
+bench_btr_destroy(struct bench_run *br)
+{
+	dbtree_destroy(br->br_hdl, NULL);
+}
+
+static int
+bench_btr_insert(struct bench_run *br, uint64_t key)
+{
+	union bench_btr_key	kbuf;
+	d_iov_t			kiov;
+	d_iov_t			viov;
+
+	bench_btr_key(br, key, &kbuf, &kiov);
+	d_iov_set(&viov, br->br_val, sizeof(br->br_val));
+	return dbtree_upsert(br->br_hdl, BTR_PROBE_EQ, DAOS_INTENT_UPDATE, &kiov,
+			     &viov, NULL);
+}
+
+static int
+bench_btr_lookup(struct bench_run *br, uint64_t key)
+{
+	union bench_btr_key	kbuf;
+	d_iov_t			kiov;
+	d_iov_t			viov;
+
+	bench_btr_key(br, key, &kbuf, &kiov);
+	d_iov_set(&viov, NULL, 0);
+	return dbtree_lookup(br->br_hdl, &kiov, &viov);
+}
+
+static int
+bench_btr_delete(struct bench_run *br, uint64_t key)
+{
+	union bench_btr_key	kbuf;
+	d_iov_t			kiov;
+
+	bench_btr_key(br, key, &kbuf, &kiov);
+	return dbtree_delete(br->br_hdl, BTR_PROBE_EQ, &kiov, NULL);
+}
+
+static int
+bench_btr_iter_cb(daos_handle_t ih, d_iov_t *key, d_iov_t *val, void *arg)
+{
+	uint64_t	*nr = arg;
+
+	(*nr)++;
+	return 0;
+}
+
+static int
+bench_btr_iterate(struct bench_run *br, uint64_t *nr)
+{
+	return dbtree_iterate(br->br_hdl, DAOS_INTENT_DEFAULT, false,
+			      bench_btr_iter_cb, nr);
+}
+
+/******************************************************************************
+ * evtree, one extent of BENCH_EVT_EXT records per key, all at epoch 1
+ ******************************************************************************/
+
+static int
+bench_evt_bio_free(struct umem_instance *umm, struct evt_desc *desc,
+		   daos_size_t nob, void *args)
+{
+	/* the extents are fake NVMe addresses, nothing to free */
+	return 0;
+}
+
+static struct evt_desc_cbs bench_evt_cbs = {
+	.dc_bio_free_cb		= bench_evt_bio_free,
+};
+
+static void
+bench_evt_rect(uint64_t key, struct evt_rect *rect)
+{
+	memset(rect, 0, sizeof(*rect));
+	rect->rc_ex.ex_lo = key * BENCH_EVT_EXT;
+	rect->rc_ex.ex_hi = rect->rc_ex.ex_lo + BENCH_EVT_EXT - 1;
+	rect->rc_epc = 1;
+	rect->rc_minor_epc = 1;
+}
+
+static int
+bench_evt_create(struct bench_run *br)
+{
+	return evt_create(&br->br_root->br_evt, EVT_FEAT_DEFAULT | EVT_FEAT_DYNAMIC_ROOT,
+			  BENCH_EVT_ORDER, utest_utx2uma(br->br_utx), &bench_evt_cbs,
+			  &br->br_hdl);
+}
+
+static void
+bench_evt_destroy(struct bench_run *br)
+{
+	evt_destroy(br->br_hdl);
+}
+
+static int
+bench_evt_insert(struct bench_run *br, uint64_t key)
+{
+	struct evt_entry_in	entry = {0};
+	int			rc;
+
+	bench_evt_rect(key, &entry.ei_rect);
+	entry.ei_bound = entry.ei_rect.rc_epc;
+	entry.ei_inob = 1;
+	bio_addr_set(&entry.ei_addr, DAOS_MEDIA_NVME, entry.ei_rect.rc_ex.ex_lo);
+
+	rc = evt_insert(br->br_hdl, &entry, NULL);
+	/* 1 means the extent is covered by another one */
+	return rc == 1 ? 0 : rc;
+}
+
+static int
+bench_evt_lookup(struct bench_run *br, uint64_t key)
+{
+	struct evt_filter	filter = {0};
+	struct evt_rect		rect;
+	EVT_ENT_ARRAY_SM_PTR(ent_array);
+	int			rc;
+
+	bench_evt_rect(key, &rect);
+	filter.fr_ex = rect.rc_ex;
+	filter.fr_epr.epr_hi = rect.rc_epc;
+	filter.fr_epoch = rect.rc_epc;
+
+	evt_ent_array_init(ent_array, 0);
+	rc = evt_find(br->br_hdl, &filter, ent_array);
+	if (rc == 0 && ent_array->ea_ent_nr != 1)
+		rc = -DER_NONEXIST;
+	evt_ent_array_fini(ent_array);
+	return rc;
+}
+
+static int
+bench_evt_delete(struct bench_run *br, uint64_t key)
+{
+	struct evt_entry	ent;
+	struct evt_rect		rect;
+
+	bench_evt_rect(key, &rect);
+	return evt_delete(br->br_hdl, &rect, &ent);
+}
+
+/* sorted visible iteration, as done by fetch and aggregation */
+static int
+bench_evt_iterate(struct bench_run *br, uint64_t *nr)
+{
+	struct evt_entry	ent;
+	daos_handle_t		ih;
+	unsigned int		inob;
+	int			rc;
+	int			rc2;
+
+	rc = evt_iter_prepare(br->br_hdl, EVT_ITER_VISIBLE, NULL, &ih);
+	if (rc != 0)
+		return rc;
+
+	rc = evt_iter_probe(ih, EVT_ITER_FIRST, NULL, NULL);
+	while (rc == 0) {
+		rc = evt_iter_fetch(ih, &inob, &ent, NULL);
+		if (rc != 0)
+			break;
+		(*nr)++;
+		rc = evt_iter_next(ih);
+	}
+	if (rc == -DER_NONEXIST)
+		rc = 0;
+
+	rc2 = evt_iter_finish(ih);
+	return rc != 0 ? rc : rc2;
+}
+
+/******************************************************************************
+ * incarnation log, one entry per key at epoch key + 1, alternating creations
+ * and punches so that none of them is redundant
+ ******************************************************************************/
+
+static int
+bench_ilog_status(struct umem_instance *umm, uint32_t tx_id, daos_epoch_t epoch,
+		  uint32_t intent, bool retry, void *args)
+{
+	return ILOG_COMMITTED;
+}
+
+static int
+bench_ilog_same_tx(struct umem_instance *umm, uint32_t tx_id, daos_epoch_t epoch,
+		   bool *same, void *args)
+{
+	*same = false;
+	return 0;
+}
+
+static int
+bench_ilog_add(struct umem_instance *umm, umem_off_t ilog_off, uint32_t *tx_id,
+	       daos_epoch_t epoch, void *args)
+{
+	/* committed */
+	*tx_id = 0;
+	return 0;
+}
+
+static int
+bench_ilog_del(struct umem_instance *umm, umem_off_t ilog_off, uint32_t tx_id,
+	       daos_epoch_t epoch, bool abort, void *args)
+{
+	return 0;
+}
+
+static struct ilog_desc_cbs bench_ilog_cbs = {
+	.dc_log_status_cb	= bench_ilog_status,
+	.dc_is_same_tx_cb	= bench_ilog_same_tx,
+	.dc_log_add_cb		= bench_ilog_add,
+	.dc_log_del_cb		= bench_ilog_del,
+};
+
+static int
+bench_ilog_create(struct bench_run *br)
+{
+	int	rc;
+
+	rc = ilog_create(utest_utx2umm(br->br_utx), &br->br_root->br_ilog);
+	if (rc != 0)
+		return rc;
+
+	rc = ilog_open(utest_utx2umm(br->br_utx), &br->br_root->br_ilog, &bench_ilog_cbs,
+		       &br->br_hdl);
+	if (rc != 0)
+		ilog_destroy(utest_utx2umm(br->br_utx), &bench_ilog_cbs,
+			     &br->br_root->br_ilog);
+	return rc;
+}
+
+static void
+bench_ilog_destroy(struct bench_run *br)
+{
+	ilog_close(br->br_hdl);
+	ilog_destroy(utest_utx2umm(br->br_utx), &bench_ilog_cbs, &br->br_root->br_ilog);
+}
+
+static int
+bench_ilog_insert(struct bench_run *br, uint64_t key)
+{
+	return ilog_update(br->br_hdl, NULL, key + 1, 1, key & 1);
+}
+
+/* fetch of the whole log, the way every VOS lookup reads it */
+static int
+bench_ilog_lookup(struct bench_run *br, uint64_t key)
+{
+	struct ilog_entries	entries;
+	int			rc;
+
+	ilog_fetch_init(&entries);
+	rc = ilog_fetch(utest_utx2umm(br->br_utx), &br->br_root->br_ilog, &bench_ilog_cbs,
+			DAOS_INTENT_DEFAULT, &entries);
+	ilog_fetch_finish(&entries);
+	return rc;
+}
+
+static int
+bench_ilog_aggregate(struct bench_run *br, uint64_t *nr)
+{
+	struct ilog_entries	entries;
+	daos_epoch_range_t	epr;
+	int			rc;
+
+	epr.epr_lo = 0;
+	epr.epr_hi = br->br_size + 1;
+
+	ilog_fetch_init(&entries);
+	rc = ilog_aggregate(utest_utx2umm(br->br_utx), &br->br_root->br_ilog,
+			    &bench_ilog_cbs, &epr, false, false, 0, 0, &entries);
+	ilog_fetch_finish(&entries);
+	if (rc < 0)
+		return rc;
+
+	*nr = br->br_size;
+	return 0;
+}
+
+/******************************************************************************
+ * LRU array, volatile only, key + 1 as the entry key
+ ******************************************************************************/
+
+struct bench_lru_entry {
+	uint64_t	le_key;
+};
+
+static int
+bench_lru_create(struct bench_run *br)
+{
+	uint32_t	nr_arrays;
+	int		rc;
+
+	D_ALLOC_ARRAY(br->br_lru_idx, br->br_size);
+	if (br->br_lru_idx == NULL)
+		return -DER_NOMEM;
+
+	nr_arrays = br->br_size > BENCH_LRU_SUB ? br->br_size / BENCH_LRU_SUB : 1;
+	rc = lrua_array_alloc(&br->br_lru, br->br_size, nr_arrays,
+			      sizeof(struct bench_lru_entry), LRU_FLAG_EVICT_MANUAL, NULL,
+			      NULL);
+	if (rc != 0)
+		D_FREE(br->br_lru_idx);
+	return rc;
+}
+
+static void
+bench_lru_destroy(struct bench_run *br)
+{
+	lrua_array_free(br->br_lru);
+	br->br_lru = NULL;
+	D_FREE(br->br_lru_idx);
+}
+
+static int
+bench_lru_insert(struct bench_run *br, uint64_t key)
+{
+	struct bench_lru_entry	*entry;
+	int			 rc;
+
+	rc = lrua_allocx(br->br_lru, &br->br_lru_idx[key], key + 1, &entry);
+	if (rc != 0)
+		return rc;
+
+	entry->le_key = key;
+	return 0;
+}
+
+static int
+bench_lru_lookup(struct bench_run *br, uint64_t key)
+{
+	struct bench_lru_entry	*entry;
+
+	if (!lrua_lookupx(br->br_lru, br->br_lru_idx[key], key + 1, &entry))
+		return -DER_NONEXIST;
+	return entry->le_key == key ? 0 : -DER_MISMATCH;
+}
+
+static int
+bench_lru_delete(struct bench_run *br, uint64_t key)
+{
+	lrua_evictx(br->br_lru, br->br_lru_idx[key], key + 1);
+	return 0;
+}
+
+/* releases the sub arrays emptied by the delete phase */
+static int
+bench_lru_aggregate(struct bench_run *br, uint64_t *nr)
+{
+	lrua_array_aggregate(br->br_lru);
+	*nr = br->br_size;
+	return 0;
+}
+
+#define BENCH_BTR(name, class, feats)				\
+	{							\
+		.bs_name	= name,				\
+		.bs_mem		= BENCH_VMEM | BENCH_PMEM,	\
+		.bs_dist	= BENCH_SEQ | BENCH_RAND,	\
+		.bs_size_max	= UINT64_MAX,			\
+		.bs_class	= class,			\
+		.bs_feats	= feats,			\
+		.bs_create	= bench_btr_create,		\
+		.bs_destroy	= bench_btr_destroy,		\
+		.bs_insert	= bench_btr_insert,		\
+		.bs_lookup	= bench_btr_lookup,		\
+		.bs_delete	= bench_btr_delete,		\
+		.bs_iterate	= bench_btr_iterate,		\
+	}
+
+static struct bench_struct bench_structs[] = {
+	BENCH_BTR("btree_kv", DBTREE_CLASS_KV, 0),
+	BENCH_BTR("btree_nv", DBTREE_CLASS_NV, BTR_FEAT_DIRECT_KEY),
+	BENCH_BTR("btree_uv", DBTREE_CLASS_UV, 0),
+	BENCH_BTR("btree_iv", DBTREE_CLASS_IV, BTR_FEAT_UINT_KEY | BTR_FEAT_DIRECT_KEY),
+	BENCH_BTR("btree_ifv", DBTREE_CLASS_IFV, BTR_FEAT_UINT_KEY | BTR_FEAT_DIRECT_KEY),
+	{
+		.bs_name	= "evtree",
+		.bs_mem		= BENCH_VMEM | BENCH_PMEM,
+		.bs_dist	= BENCH_SEQ | BENCH_RAND,
+		.bs_size_max	= UINT64_MAX,
+		.bs_create	= bench_evt_create,
+		.bs_destroy	= bench_evt_destroy,
+		.bs_insert	= bench_evt_insert,
+		.bs_lookup	= bench_evt_lookup,
+		.bs_delete	= bench_evt_delete,
+		.bs_iterate	= bench_evt_iterate,
+	},
+	{
+		/* epochs of a log only grow */
+		.bs_name	= "ilog",
+		.bs_mem		= BENCH_VMEM | BENCH_PMEM,
+		.bs_dist	= BENCH_SEQ,
+		.bs_size_max	= BENCH_ILOG_MAX,
+		.bs_create	= bench_ilog_create,
+		.bs_destroy	= bench_ilog_destroy,
+		.bs_insert	= bench_ilog_insert,
+		.bs_lookup	= bench_ilog_lookup,
+		.bs_aggregate	= bench_ilog_aggregate,
+	},
+	{
+		.bs_name	= "lru",
+		.bs_mem		= BENCH_VMEM,
+		.bs_dist	= BENCH_SEQ | BENCH_RAND,
+		.bs_size_max	= UINT32_MAX,
+		.bs_create	= bench_lru_create,
+		.bs_destroy	= bench_lru_destroy,
+		.bs_insert	= bench_lru_insert,
+		.bs_lookup	= bench_lru_lookup,
+		.bs_delete	= bench_lru_delete,
+		.bs_aggregate	= bench_lru_aggregate,
+	},
+};
+
+/******************************************************************************
+ * driver
+ ******************************************************************************/
+
+static int
+bench_classes_register(void)
+{
+	struct {
+		unsigned int	 class;
+		uint64_t	 feats;
+		btr_ops_t	*ops;
+	} classes[] = {
+		{ DBTREE_CLASS_KV, 0, &dbtree_kv_ops },
+		{ DBTREE_CLASS_NV, BTR_FEAT_DIRECT_KEY, &dbtree_nv_ops },
+		{ DBTREE_CLASS_UV, 0, &dbtree_uv_ops },
+		{ DBTREE_CLASS_IV, BTR_FEAT_UINT_KEY | BTR_FEAT_DIRECT_KEY, &dbtree_iv_ops },
+		{ DBTREE_CLASS_IFV, BTR_FEAT_UINT_KEY | BTR_FEAT_DIRECT_KEY, &dbtree_ifv_ops },
+	};
+	int	i;
+	int	rc;
+
+	for (i = 0; i < ARRAY_SIZE(classes); i++) {
+		rc = dbtree_class_register(classes[i].class, classes[i].feats,
+					   classes[i].ops);
+		if (rc != 0 && rc != -DER_EXIST)
+			return rc;
+	}
+	/* the incarnation log tree class */
+	return ilog_init();
+}
+
+/* lays out the keys of a phase, shuffled again for each random phase */
+static void
+bench_keys_order(struct bench_run *br, unsigned int dist)
+{
+	uint64_t	i;
+	uint64_t	j;
+	uint64_t	tmp;
+
+	if (dist == BENCH_SEQ) {
+		for (i = 0; i < br->br_size; i++)
+			br->br_keys[i] = i;
+		return;
+	}
+
+	for (i = br->br_size - 1; i > 0; i--) {
+		j = ((uint64_t)rand_r(&bench_seed) << 31 | rand_r(&bench_seed)) % (i + 1);
+		tmp = br->br_keys[i];
+		br->br_keys[i] = br->br_keys[j];
+		br->br_keys[j] = tmp;
+	}
+}
+
+static int
+bench_result_add(const char *mem, const char *dist, struct bench_run *br, int op,
+		 uint64_t ops, uint64_t nsec)
+{
+	struct bench_result	*res;
+
+	if (bench_result_nr == bench_result_max) {
+		int	max = bench_result_max ? bench_result_max * 2 : 64;
+
+		D_REALLOC_ARRAY(res, bench_results, bench_result_max, max);
+		if (res == NULL)
+			return -DER_NOMEM;
+		bench_results = res;
+		bench_result_max = max;
+	}
+
+	res = &bench_results[bench_result_nr++];
+	snprintf(res->res_name, sizeof(res->res_name), "%s.%s.%s.%s.%"PRIu64,
+		 br->br_struct->bs_name, bench_op_names[op], mem, dist, br->br_size);
+	res->res_ops = ops;
+	res->res_nsec = nsec;
+	res->res_rate = nsec ? ops * 1e9 / nsec : 0;
+
+	if (bench_json) {
+		fprintf(stdout, "{\"case\":\"%s\",\"structure\":\"%s\",\"op\":\"%s\","
+			"\"mem\":\"%s\",\"dist\":\"%s\",\"size\":%"PRIu64",\"ops\":%"PRIu64","
+			"\"nsec\":%"PRIu64",\"rate\":%.2f}\n", res->res_name,
+			br->br_struct->bs_name, bench_op_names[op], mem, dist, br->br_size,
+			ops, nsec, res->res_rate);
+	} else {
+		fprintf(stdout, "%-48s %12"PRIu64" %14.2f\n", res->res_name, ops,
+			res->res_rate);
+	}
+	return 0;
+}
+
+static int
+bench_key_phase(struct bench_run *br, int (*func)(struct bench_run *, uint64_t),
+		uint64_t *nsec)
+{
+	uint64_t	start;
+	uint64_t	i;
+	int		rc;
+
+	start = daos_get_ntime();
+	for (i = 0; i < br->br_size; i++) {
+		rc = func(br, br->br_keys[i]);
+		if (rc != 0) {
+			D_ERROR("%s: key "DF_U64" failed: "DF_RC"\n",
+				br->br_struct->bs_name, br->br_keys[i], DP_RC(rc));
+			return rc;
+		}
+	}
+	*nsec = daos_get_ntime() - start;
+	return 0;
+}
+
+static int
+bench_all_phase(struct bench_run *br, int (*func)(struct bench_run *, uint64_t *),
+		uint64_t *nr, uint64_t *nsec)
+{
+	uint64_t	start;
+	int		rc;
+
+	*nr = 0;
+	start = daos_get_ntime();
+	rc = func(br, nr);
+	*nsec = daos_get_ntime() - start;
+	if (rc != 0) {
+		D_ERROR("%s: failed: "DF_RC"\n", br->br_struct->bs_name, DP_RC(rc));
+		return rc;
+	}
+	return 0;
+}
+
+static int
+bench_case_run(struct bench_run *br, const char *mem, unsigned int dist)
+{
+	struct bench_struct	*bs = br->br_struct;
+	const char		*dname = dist == BENCH_SEQ ? "seq" : "rand";
+	uint64_t		 nsec;
+	uint64_t		 nr;
+	int			 rc;
+
+	D_ALLOC_ARRAY(br->br_keys, br->br_size);
+	if (br->br_keys == NULL)
+		return -DER_NOMEM;
+
+	bench_keys_order(br, BENCH_SEQ);
+	rc = bs->bs_create(br);
+	if (rc != 0) {
+		D_ERROR("%s: create failed: "DF_RC"\n", bs->bs_name, DP_RC(rc));
+		D_GOTO(out, rc);
+	}
+
+	bench_keys_order(br, dist);
+	rc = bench_key_phase(br, bs->bs_insert, &nsec);
+	if (rc != 0)
+		D_GOTO(destroy, rc);
+	rc = bench_result_add(mem, dname, br, BENCH_INSERT, br->br_size, nsec);
+	if (rc != 0)
+		D_GOTO(destroy, rc);
+
+	bench_keys_order(br, dist);
+	rc = bench_key_phase(br, bs->bs_lookup, &nsec);
+	if (rc != 0)
+		D_GOTO(destroy, rc);
+	rc = bench_result_add(mem, dname, br, BENCH_LOOKUP, br->br_size, nsec);
+	if (rc != 0)
+		D_GOTO(destroy, rc);
+
+	if (bs->bs_iterate) {
+		rc = bench_all_phase(br, bs->bs_iterate, &nr, &nsec);
+		if (rc != 0)
+			D_GOTO(destroy, rc);
+		if (nr != br->br_size) {
+			D_ERROR("%s: iterated "DF_U64" of "DF_U64" records\n", bs->bs_name,
+				nr, br->br_size);
+			D_GOTO(destroy, rc = -DER_MISMATCH);
+		}
+		rc = bench_result_add(mem, dname, br, BENCH_ITERATE, nr, nsec);
+		if (rc != 0)
+			D_GOTO(destroy, rc);
+	}
+
+	if (bs->bs_delete) {
+		bench_keys_order(br, dist);
+		rc = bench_key_phase(br, bs->bs_delete, &nsec);
+		if (rc != 0)
+			D_GOTO(destroy, rc);
+		rc = bench_result_add(mem, dname, br, BENCH_DELETE, br->br_size, nsec);
+		if (rc != 0)
+			D_GOTO(destroy, rc);
+	}
+
+	if (bs->bs_aggregate) {
+		rc = bench_all_phase(br, bs->bs_aggregate, &nr, &nsec);
+		if (rc != 0)
+			D_GOTO(destroy, rc);
+		rc = bench_result_add(mem, dname, br, BENCH_AGGREGATE, nr, nsec);
+	}
+
+destroy:
+	bs->bs_destroy(br);
+out:
+	D_FREE(br->br_keys);
+	return rc;
+}
+
+static bool
+bench_struct_selected(struct bench_struct *bs, char *filter)
+{
+	char	*tmp;
+	char	*name;
+	char	*saveptr;
+	bool	 found = false;
+
+	if (filter == NULL)
+		return true;
+
+	D_STRNDUP(tmp, filter, strlen(filter));
+	if (tmp == NULL)
+		return true;
+
+	for (name = strtok_r(tmp, ",", &saveptr); name != NULL && !found;
+	     name = strtok_r(NULL, ",", &saveptr))
+		found = strncmp(bs->bs_name, name, strlen(name)) == 0;
+
+	D_FREE(tmp);
+	return found;
+}
+
+static int
+bench_mem_run(unsigned int mem, const char *dir, char *filter, uint64_t *sizes,
+	      int size_nr, unsigned int dists)
+{
+	struct utest_context	*utx;
+	struct bench_run	 br;
+	const char		*mname = mem == BENCH_VMEM ? "vmem" : "pmem";
+	char			*path = NULL;
+	unsigned int		 dist;
+	int			 i;
+	int			 j;
+	int			 rc;
+
+	if (mem == BENCH_VMEM) {
+		rc = utest_vmem_create(sizeof(union bench_root), &utx);
+	} else {
+		D_ASPRINTF(path, "%s/%s", dir, BENCH_POOL_NAME);
+		if (path == NULL)
+			return -DER_NOMEM;
+		unlink(path);
+		rc = utest_pmem_create(path, BENCH_POOL_SIZE, sizeof(union bench_root),
+				       &utx);
+	}
+	if (rc != 0) {
+		D_ERROR("failed to create %s pool: "DF_RC"\n", mname, DP_RC(rc));
+		D_GOTO(out, rc);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(bench_structs); i++) {
+		struct bench_struct *bs = &bench_structs[i];
+
+		if (!(bs->bs_mem & mem) || !bench_struct_selected(bs, filter))
+			continue;
+
+		for (dist = BENCH_SEQ; dist <= BENCH_RAND; dist <<= 1) {
+			if (!(bs->bs_dist & dists & dist))
+				continue;
+
+			for (j = 0; j < size_nr; j++) {
+				if (sizes[j] > bs->bs_size_max)
+					continue;
+
+				memset(&br, 0, sizeof(br));
+				br.br_struct = bs;
+				br.br_utx = utx;
+				br.br_root = utest_utx2root(utx);
+				br.br_size = sizes[j];
+				memset(br.br_val, 'v', sizeof(br.br_val));
+
+				rc = bench_case_run(&br, mname, dist);
+				if (rc != 0)
+					D_GOTO(destroy, rc);
+			}
+		}
+	}
+
+destroy:
+	utest_utx_destroy(utx);
+	if (path != NULL)
+		unlink(path);
+out:
+	D_FREE(path);
+	return rc;
+}
+
+/* Record the command line and the node a baseline was measured on */
+static void
+bench_baseline_header(FILE *fp, int argc, char **argv, const char *dir)
+{
+	struct utsname	 uts;
+	FILE		*cpu;
+	char		 line[256];
+	char		*model = NULL;
+	time_t		 now = time(NULL);
+	int		 i;
+
+	fprintf(fp, "# vos_bench baseline: <case> <ops per second>\n");
+	fprintf(fp, "# command:");
+	for (i = 0; i < argc; i++)
+		fprintf(fp, " %s", argv[i]);
+	fprintf(fp, "\n");
+
+	if (uname(&uts) == 0)
+		fprintf(fp, "# host: %s, %s %s %s\n", uts.nodename, uts.sysname,
+			uts.release, uts.machine);
+
+	cpu = fopen("/proc/cpuinfo", "r");
+	if (cpu != NULL) {
+		while (fgets(line, sizeof(line), cpu) != NULL) {
+			if (strncmp(line, "model name", 10) != 0)
+				continue;
+			model = strchr(line, ':');
+			if (model != NULL) {
+				model += strspn(model, ": \t");
+				model[strcspn(model, "\n")] = '\0';
+			}
+			break;
+		}
+		fclose(cpu);
+	}
+	fprintf(fp, "# cpu: %s, %ld online\n", model != NULL ? model : "unknown",
+		sysconf(_SC_NPROCESSORS_ONLN));
+	fprintf(fp, "# pmem dir: %s\n", dir);
+	fprintf(fp, "# date: %s", ctime(&now));
+}
+
+static int
+bench_baseline_write(const char *file, int argc, char **argv, const char *dir)
+{
+	FILE	*fp;
+	int	 i;
+
+	fp = fopen(file, "w");
+	if (fp == NULL) {
+		D_ERROR("failed to open %s: %s\n", file, strerror(errno));
+		return daos_errno2der(errno);
+	}
+
+	bench_baseline_header(fp, argc, argv, dir);
+	for (i = 0; i < bench_result_nr; i++)
+		fprintf(fp, "%s %.0f\n", bench_results[i].res_name, bench_results[i].res_rate);
+
+	fclose(fp);
+	return 0;
+}
+
+/*
+ * Compare the results with the baseline, a case is a regression if its rate
+ * is more than \a tolerance percent below the baseline. Cases missing from
+ * either side are not compared.
+ */
+static int
+bench_baseline_check(const char *file, int tolerance)
+{
+	FILE	*fp;
+	char	 line[256];
+	char	 name[BENCH_NAME_LEN];
+	double	 base;
+	double	 delta;
+	int	 compared = 0;
+	int	 regressed = 0;
+	int	 i;
+
+	fp = fopen(file, "r");
+	if (fp == NULL) {
+		D_ERROR("failed to open %s: %s\n", file, strerror(errno));
+		return daos_errno2der(errno);
+	}
+
+	while (fgets(line, sizeof(line), fp) != NULL) {
+		if (line[0] == '#' || sscanf(line, "%63s %lf", name, &base) != 2)
+			continue;
+
+		for (i = 0; i < bench_result_nr; i++) {
+			if (strcmp(bench_results[i].res_name, name) == 0)
+				break;
+		}
+		if (i == bench_result_nr || base <= 0)
+			continue;
+
+		compared++;
+		delta = (bench_results[i].res_rate - base) * 100 / base;
+		if (delta < -tolerance) {
+			regressed++;
+			fprintf(stdout, "REGRESSION %-48s %14.2f < %14.2f (%+.1f%%)\n", name,
+				bench_results[i].res_rate, base, delta);
+		}
+	}
+	fclose(fp);
+
+	fprintf(stdout, "%d of %d cases regressed by more than %d%% against %s\n",
+		regressed, compared, tolerance, file);
+	return regressed ? -DER_MISMATCH : 0;
+}
+
+static int
+bench_sizes_parse(char *str, uint64_t *sizes, int *size_nr)
+{
+	char	*tok;
+	char	*saveptr;
+	char	*end;
+	int	 nr = 0;
+
+	for (tok = strtok_r(str, ",", &saveptr); tok != NULL;
+	     tok = strtok_r(NULL, ",", &saveptr)) {
+		if (nr == BENCH_SIZES_MAX)
+			return -DER_INVAL;
+
+		sizes[nr] = strtoull(tok, &end, 0);
+		/* the LRU array needs power of two sizes */
+		if (*end != '\0' || sizes[nr] < BENCH_SIZE_MIN ||
+		    (sizes[nr] & (sizes[nr] - 1)) != 0)
+			return -DER_INVAL;
+		nr++;
+	}
+	*size_nr = nr;
+	return nr ? 0 : -DER_INVAL;
+}
+
+static void
+bench_print_usage(void)
+{
+	printf("vos_bench -- microbenchmarks of the VOS index structures\n\n");
+	printf("Structures: btree_kv, btree_nv, btree_uv, btree_iv, btree_ifv, "
+	       "evtree, ilog, lru\n");
+	printf("Cases are named <structure>.<op>.<mem>.<dist>.<size>\n\n");
+	printf("Options:\n");
+	printf("-S name[,name]	Structures to run, by name prefix, default all\n");
+	printf("-s n[,n]	Records per case, powers of two, default %s\n",
+	       BENCH_SIZES_DEF);
+	printf("-m vmem|pmem|all	Memory class, default all\n");
+	printf("-d seq|rand|all	Key order, default all\n");
+	printf("-D dir		Directory of the pmem pool, default /mnt/daos\n");
+	printf("-r seed		Seed of the random key order\n");
+	printf("-j		Print results as JSON lines\n");
+	printf("-o file		Save the results as a baseline\n");
+	printf("-b file		Compare the results with a baseline\n");
+	printf("-t pct		Regression tolerance, default %d%%\n",
+	       BENCH_TOLERANCE_DEF);
+	printf("-h		Print this message\n");
+}
+
+static struct option bench_opts[] = {
+	{ "structs",	required_argument,	NULL,	'S' },
+	{ "sizes",	required_argument,	NULL,	's' },
+	{ "mem",	required_argument,	NULL,	'm' },
+	{ "dist",	required_argument,	NULL,	'd' },
+	{ "dir",	required_argument,	NULL,	'D' },
+	{ "seed",	required_argument,	NULL,	'r' },
+	{ "json",	no_argument,		NULL,	'j' },
+	{ "output",	required_argument,	NULL,	'o' },
+	{ "baseline",	required_argument,	NULL,	'b' },
+	{ "tolerance",	required_argument,	NULL,	't' },
+	{ "help",	no_argument,		NULL,	'h' },
+	{ NULL,		0,			NULL,	0   },
+};
+
+int
+main(int argc, char **argv)
+{
+	char		 size_str[] = BENCH_SIZES_DEF;
+	uint64_t	 sizes[BENCH_SIZES_MAX];
+	int		 size_nr;
+	char		*filter = NULL;
+	char		*dir = "/mnt/daos";
+	char		*output = NULL;
+	char		*baseline = NULL;
+	unsigned int	 mems = BENCH_VMEM | BENCH_PMEM;
+	unsigned int	 dists = BENCH_SEQ | BENCH_RAND;
+	int		 tolerance = BENCH_TOLERANCE_DEF;
+	int		 rc;
+
+	bench_seed = time(NULL);
+	rc = bench_sizes_parse(size_str, sizes, &size_nr);
+	D_ASSERT(rc == 0);
+
+	while ((rc = getopt_long(argc, argv, "S:s:m:d:D:r:jo:b:t:h", bench_opts,
+				 NULL)) != -1) {
+		switch (rc) {
+		case 'S':
+			filter = optarg;
+			break;
+		case 's':
+			if (bench_sizes_parse(optarg, sizes, &size_nr) != 0) {
+				fprintf(stderr, "invalid sizes %s\n", optarg);
+				return -1;
+			}
+			break;
+		case 'm':
+			if (strcmp(optarg, "vmem") == 0) {
+				mems = BENCH_VMEM;
+			} else if (strcmp(optarg, "pmem") == 0) {
+				mems = BENCH_PMEM;
+			} else if (strcmp(optarg, "all") != 0) {
+				fprintf(stderr, "invalid memory class %s\n", optarg);
+				return -1;
+			}
+			break;
+		case 'd':
+			if (strcmp(optarg, "seq") == 0) {
+				dists = BENCH_SEQ;
+			} else if (strcmp(optarg, "rand") == 0) {
+				dists = BENCH_RAND;
+			} else if (strcmp(optarg, "all") != 0) {
+				fprintf(stderr, "invalid key order %s\n", optarg);
+				return -1;
+			}
+			break;
+		case 'D':
+			dir = optarg;
+			break;
+		case 'r':
+			bench_seed = strtoul(optarg, NULL, 0);
+			break;
+		case 'j':
+			bench_json = true;
+			break;
+		case 'o':
+			output = optarg;
+			break;
+		case 'b':
+			baseline = optarg;
+			break;
+		case 't':
+			tolerance = atoi(optarg);
+			break;
+		case 'h':
+			bench_print_usage();
+			return 0;
+		default:
+			bench_print_usage();
+			return -1;
+		}
+	}
+
+	rc = daos_debug_init(DAOS_LOG_DEFAULT);
+	if (rc != 0)
+		return rc;
+
+	rc = bench_classes_register();
+	if (rc != 0) {
+		D_ERROR("failed to register tree classes: "DF_RC"\n", DP_RC(rc));
+		D_GOTO(out, rc);
+	}
+
+	if (!bench_json)
+		fprintf(stdout, "%-48s %12s %14s\n", "case", "ops", "ops/sec");
+
+	if (mems & BENCH_VMEM) {
+		rc = bench_mem_run(BENCH_VMEM, dir, filter, sizes, size_nr, dists);
+		if (rc != 0)
+			D_GOTO(out, rc);
+	}
+	if (mems & BENCH_PMEM) {
+		rc = bench_mem_run(BENCH_PMEM, dir, filter, sizes, size_nr, dists);
+		if (rc != 0)
+			D_GOTO(out, rc);
+	}
+
+	if (output != NULL) {
+		rc = bench_baseline_write(output, argc, argv, dir);
+		if (rc != 0)
+			D_GOTO(out, rc);
+	}
+	if (baseline != NULL)
+		rc = bench_baseline_check(baseline, tolerance);
+out:
+	D_FREE(bench_results);
+	daos_debug_fini();
+	return rc;
+}
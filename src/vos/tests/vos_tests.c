@@ -39,6 +39,7 @@ print_usage()
 	print_message("vos_tests -X|--dtx\n");
 	print_message("vos_tests -l|--ilog\n");
 	print_message("vos_tests -z|--csum\n");
+	print_message("vos_tests -D|--dedup\n");
 	print_message("vos_tests -A|--all <size>\n");
 	print_message("vos_tests -m|--punch_model\n");
 	print_message("vos_tests -C|--mvcc\n");
@@ -89,6 +90,7 @@ run_all_tests(int keys, bool nest_iterators)
 		failed += run_dtx_tests(cfg_desc_io);
 		failed += run_ilog_tests(cfg_desc_io);
 		failed += run_csum_extent_tests(cfg_desc_io);
+		failed += run_dedup_tests(cfg_desc_io);
 
 		it = "standalone";
 	} else {
@@ -114,7 +116,7 @@ main(int argc, char **argv)
 	int	keys;
 	bool	nest_iterators = false;
 	const char          *vos_command    = NULL;
-	const char          *short_options  = "apcdglzni:mXA:S:hf:e:tCr:";
+	const char          *short_options  = "apcdglzDni:mXA:S:hf:e:tCr:";
 	static struct option long_options[] = {
 	    {"all", required_argument, 0, 'A'},
 	    {"pool", no_argument, 0, 'p'},
@@ -130,6 +132,7 @@ main(int argc, char **argv)
 	    {"epoch_cache", no_argument, 0, 't'},
 	    {"mvcc", no_argument, 0, 'C'},
 	    {"csum", no_argument, 0, 'z'},
+	    {"dedup", no_argument, 0, 'D'},
 	    {"run_vos_cmd", required_argument, 0, 'r'},
 	    {"help", no_argument, 0, 'h'},
 	    {"filter", required_argument, 0, 'f'},
@@ -271,6 +274,10 @@ main(int argc, char **argv)
 			nr_failed += run_csum_extent_tests("");
 			test_run = true;
 			break;
+		case 'D':
+			nr_failed += run_dedup_tests("");
+			test_run = true;
+			break;
 		case 't':
 			nr_failed += run_ts_tests("");
 			test_run = true;
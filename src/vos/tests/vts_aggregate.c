@@ -2859,6 +2859,161 @@ aggregate_35(void **state)
 	assert_int_equal(feats & INIT_FEATS, INIT_FEATS);
 }
 
+#define COMP_REC_NR	(8 << 10)
+
+static int
+compressed_cb(daos_handle_t ih, vos_iter_entry_t *entry, vos_iter_type_t type,
+	      vos_iter_param_t *param, void *cb_arg, unsigned int *acts)
+{
+	int	*nr = cb_arg;
+
+	assert_int_equal(type, VOS_ITER_RECX);
+	if (BIO_ADDR_IS_COMPRESSED(&entry->ie_biov.bi_addr))
+		(*nr)++;
+	return 0;
+}
+
+/* Number of physical records which are compressed */
+static int
+compressed_recs_nr(struct io_test_args *arg, daos_unit_oid_t oid, char *dkey, char *akey)
+{
+	struct vos_iter_anchors	anchors = { 0 };
+	vos_iter_param_t	iter_param = { 0 };
+	int			rc, nr = 0;
+
+	iter_param.ip_hdl = arg->ctx.tc_co_hdl;
+	iter_param.ip_oid = oid;
+	d_iov_set(&iter_param.ip_dkey, dkey, strlen(dkey));
+	d_iov_set(&iter_param.ip_akey, akey, strlen(akey));
+	iter_param.ip_epr.epr_lo = 0;
+	iter_param.ip_epr.epr_hi = DAOS_EPOCH_MAX;
+	iter_param.ip_epc_expr = VOS_IT_EPC_GE;
+	iter_param.ip_flags = VOS_IT_RECX_ALL;
+
+	rc = vos_iterate(&iter_param, VOS_ITER_RECX, false, &anchors, compressed_cb, NULL,
+			 &nr, NULL);
+	assert_rc_equal(rc, 0);
+	return nr;
+}
+
+/* Fetch [idx, idx + nr) and compare it with the same range of @expected */
+static void
+compress_verify(struct io_test_args *arg, daos_unit_oid_t oid, daos_epoch_t epoch,
+		char *dkey, char *akey, uint64_t idx, uint64_t nr, char *expected)
+{
+	daos_recx_t	 recx = { .rx_idx = idx, .rx_nr = nr };
+	char		*buf;
+
+	D_ALLOC(buf, nr);
+	assert_non_null(buf);
+	fetch_value(arg, oid, epoch, 0, dkey, akey, DAOS_IOD_ARRAY, 1, &recx, buf);
+	assert_memory_equal(buf, expected + idx, nr);
+	D_FREE(buf);
+}
+
+/*
+ * Aggregate adjacent compressible extents of a compression-enabled container,
+ * the merged extent is compressed when the pool has VOS_POOL_FEAT_COMPRESS.
+ */
+static void
+aggregate_compress(void **state, bool feat)
+{
+	struct io_test_args	*arg = *state;
+	struct vos_pool		*pool = vos_hdl2pool(arg->ctx.tc_po_hdl);
+	struct daos_compressor	*compressor = NULL;
+	daos_epoch_range_t	 epr;
+	daos_unit_oid_t		 oid;
+	daos_recx_t		 recx;
+	uint64_t		 feats = pool->vp_feats;
+	char			 dkey[UPDATE_DKEY_SIZE] = { 0 };
+	char			 akey[UPDATE_AKEY_SIZE] = { 0 };
+	char			*data;
+	int			 i, rc;
+
+	rc = daos_compressor_init_with_type(&compressor, COMPRESS_TYPE_DEFLATE, true,
+					    COMP_REC_NR);
+	if (rc != 0) {
+		print_message("Deflate isn't available, skip test\n");
+		skip();
+	}
+	daos_compressor_destroy(&compressor);
+
+	if (!feat)
+		pool->vp_feats &= ~VOS_POOL_FEAT_COMPRESS;
+	assert_true(!!(pool->vp_feats & VOS_POOL_FEAT_COMPRESS) == feat);
+
+	rc = vos_cont_set_compress(arg->ctx.tc_co_hdl, COMPRESS_TYPE_DEFLATE);
+	assert_rc_equal(rc, 0);
+
+	D_ALLOC(data, COMP_REC_NR * 3);
+	assert_non_null(data);
+	for (i = 0; i < COMP_REC_NR * 3; i++)
+		data[i] = 'a' + (i / 64) % 16;
+
+	oid = dts_unit_oid_gen(0, 0);
+	dts_key_gen(dkey, UPDATE_DKEY_SIZE, UPDATE_DKEY);
+	dts_key_gen(akey, UPDATE_AKEY_SIZE, UPDATE_AKEY);
+	arg->ta_flags |= TF_USE_VAL;
+
+	/* Two adjacent extents are merged into one on aggregation */
+	for (i = 0; i < 2; i++) {
+		recx.rx_idx = i * COMP_REC_NR;
+		recx.rx_nr = COMP_REC_NR;
+		update_value(arg, oid, i + 1, 0, dkey, akey, DAOS_IOD_ARRAY, 1, &recx,
+			     data + recx.rx_idx);
+	}
+
+	epr.epr_lo = 0;
+	epr.epr_hi = 3;
+	rc = vos_aggregate(arg->ctx.tc_co_hdl, &epr, NULL, NULL, VOS_AGG_FL_FORCE_MERGE);
+	assert_rc_equal(rc, 0);
+
+	epr.epr_hi = DAOS_EPOCH_MAX;
+	assert_int_equal(phy_recs_nr(arg, oid, &epr, dkey, akey, DAOS_IOD_ARRAY), 1);
+	assert_int_equal(compressed_recs_nr(arg, oid, dkey, akey), feat ? 1 : 0);
+
+	/* Full and partial fetch of the merged extent */
+	compress_verify(arg, oid, 3, dkey, akey, 0, COMP_REC_NR * 2, data);
+	compress_verify(arg, oid, 3, dkey, akey, 1000, 3000, data);
+	compress_verify(arg, oid, 3, dkey, akey, COMP_REC_NR * 2 - 100, 100, data);
+
+	/* The compressed extent is read back and merged with a new one */
+	recx.rx_idx = COMP_REC_NR * 2;
+	recx.rx_nr = COMP_REC_NR;
+	update_value(arg, oid, 4, 0, dkey, akey, DAOS_IOD_ARRAY, 1, &recx,
+		     data + recx.rx_idx);
+
+	epr.epr_lo = 0;
+	epr.epr_hi = 5;
+	rc = vos_aggregate(arg->ctx.tc_co_hdl, &epr, NULL, NULL, VOS_AGG_FL_FORCE_MERGE);
+	assert_rc_equal(rc, 0);
+
+	epr.epr_hi = DAOS_EPOCH_MAX;
+	assert_int_equal(phy_recs_nr(arg, oid, &epr, dkey, akey, DAOS_IOD_ARRAY), 1);
+	assert_int_equal(compressed_recs_nr(arg, oid, dkey, akey), feat ? 1 : 0);
+	compress_verify(arg, oid, 5, dkey, akey, 0, COMP_REC_NR * 3, data);
+	compress_verify(arg, oid, 5, dkey, akey, COMP_REC_NR - 10, COMP_REC_NR, data);
+
+	arg->ta_flags &= ~TF_USE_VAL;
+	pool->vp_feats = feats;
+	rc = vos_cont_set_compress(arg->ctx.tc_co_hdl, COMPRESS_TYPE_UNKNOWN);
+	assert_rc_equal(rc, 0);
+	D_FREE(data);
+	cleanup();
+}
+
+static void
+aggregate_36(void **state)
+{
+	aggregate_compress(state, true);
+}
+
+static void
+aggregate_37(void **state)
+{
+	aggregate_compress(state, false);
+}
+
 static int
 agg_tst_teardown(void **state)
 {
@@ -2975,6 +3130,10 @@ static const struct CMUnitTest aggregate_tests[] = {
 	  aggregate_34, NULL, agg_tst_teardown },
 	{ "VOS435: Test aggregation timestamp functions",
 	  aggregate_35, NULL, NULL },
+	{ "VOS436: Aggregate EV with compression, full and partial fetch",
+	  aggregate_36, NULL, agg_tst_teardown },
+	{ "VOS437: No compression without the pool feature",
+	  aggregate_37, NULL, agg_tst_teardown },
 };
 
 int
@@ -0,0 +1,422 @@
+/**
+ * (C) Copyright 2022 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * This file is part of vos/tests/
+ *
+ * vos/tests/vts_dedup.c
+ *
+ * Tests of the persistent dedup index: creation on the first dedup update,
+ * insertion, CLOCK eviction, reference counts of the shared extents,
+ * transaction abort and reload on pool reopen.
+ */
+#define D_LOGFAC	DD_FAC(tests)
+
+#include <daos/checksum.h>
+#include "vts_io.h"
+
+#define DEDUP_SLOTS	4
+#define DEDUP_EXT_SIZE	4096
+
+struct dedup_test_args {
+	struct vos_test_ctx	dt_ctx;
+	unsigned int		dt_slots_saved;
+	daos_epoch_t		dt_epoch;
+};
+
+static struct dedup_test_args	dedup_args;
+
+static void
+dedup_iod_init(daos_iod_t *iod, daos_recx_t *recx, daos_key_t *dkey)
+{
+	d_iov_set(dkey, "dkey", strlen("dkey"));
+
+	memset(iod, 0, sizeof(*iod));
+	d_iov_set(&iod->iod_name, "akey", strlen("akey"));
+	iod->iod_type	= DAOS_IOD_ARRAY;
+	iod->iod_size	= 1;
+	iod->iod_nr	= 1;
+	iod->iod_recxs	= recx;
+	recx->rx_idx	= 0;
+	recx->rx_nr	= DEDUP_EXT_SIZE;
+}
+
+/** Write an extent filled by \a pattern to \a oid with dedup enabled */
+static int
+dedup_update(struct dedup_test_args *args, daos_unit_oid_t oid, char pattern)
+{
+	struct daos_csummer	*csummer = NULL;
+	struct dcs_iod_csums	*iod_csums = NULL;
+	daos_iod_t		 iod;
+	daos_recx_t		 recx;
+	daos_key_t		 dkey;
+	d_sg_list_t		 sgl;
+	d_iov_t			 iov;
+	char			 buf[DEDUP_EXT_SIZE];
+	int			 rc;
+
+	memset(buf, pattern, sizeof(buf));
+	d_iov_set(&iov, buf, sizeof(buf));
+	sgl.sg_nr = 1;
+	sgl.sg_nr_out = 0;
+	sgl.sg_iovs = &iov;
+	dedup_iod_init(&iod, &recx, &dkey);
+
+	assert_success(daos_csummer_init_with_type(&csummer, HASH_TYPE_CRC64,
+						   DEDUP_EXT_SIZE, 0));
+	rc = daos_csummer_calc_iods(csummer, &sgl, &iod, NULL, 1, false, NULL, 0,
+				    &iod_csums);
+	assert_success(rc);
+
+	rc = vos_obj_update(args->dt_ctx.tc_co_hdl, oid, ++args->dt_epoch, 0,
+			    VOS_OF_DEDUP, &dkey, 1, &iod, iod_csums, &sgl);
+
+	daos_csummer_free_ic(csummer, &iod_csums);
+	daos_csummer_destroy(&csummer);
+	return rc;
+}
+
+/** Return the address of the extent written to \a oid */
+static uint64_t
+dedup_addr(struct dedup_test_args *args, daos_unit_oid_t oid)
+{
+	struct bio_sglist	*bsgl;
+	daos_handle_t		 ioh;
+	daos_iod_t		 iod;
+	daos_recx_t		 recx;
+	daos_key_t		 dkey;
+	uint64_t		 off;
+	int			 rc;
+
+	dedup_iod_init(&iod, &recx, &dkey);
+	rc = vos_fetch_begin(args->dt_ctx.tc_co_hdl, oid, args->dt_epoch, &dkey, 1,
+			     &iod, 0, NULL, &ioh, NULL);
+	assert_success(rc);
+
+	bsgl = vos_iod_sgl_at(ioh, 0);
+	assert_non_null(bsgl);
+	assert_int_equal(bsgl->bs_nr_out, 1);
+	assert_false(bio_addr_is_hole(&bsgl->bs_iovs[0].bi_addr));
+	off = bsgl->bs_iovs[0].bi_addr.ba_off;
+
+	rc = vos_fetch_end(ioh, NULL, 0);
+	assert_success(rc);
+	return off;
+}
+
+/** Return the reference count of the extent at \a off, 0 if it isn't indexed */
+static uint32_t
+dedup_refs(struct dedup_test_args *args, uint64_t off)
+{
+	struct vos_pool		*pool = vos_hdl2pool(args->dt_ctx.tc_po_hdl);
+	struct vos_dedup_df	*dd_df;
+	struct vos_dedup_ent_df	*ent_df;
+	int			 i;
+
+	assert_false(UMOFF_IS_NULL(pool->vp_pool_df->pd_dedup));
+	dd_df = umem_off2ptr(vos_pool2umm(pool), pool->vp_pool_df->pd_dedup);
+	assert_int_equal(dd_df->dd_slots, DEDUP_SLOTS);
+
+	for (i = 0; i < dd_df->dd_slots; i++) {
+		ent_df = &dd_df->dd_ents[i];
+		if (ent_df->de_csum_len != 0 && ent_df->de_addr.ba_off == off)
+			return ent_df->de_refs;
+	}
+	return 0;
+}
+
+static int
+dedup_setup(void **state)
+{
+	struct dedup_test_args	*args = &dedup_args;
+	int			 rc;
+
+	memset(args, 0, sizeof(*args));
+	/* The slot count is taken when the index is created by the first dedup update */
+	args->dt_slots_saved = vos_dedup_slots;
+	vos_dedup_slots = DEDUP_SLOTS;
+
+	rc = vts_ctx_init(&args->dt_ctx, VPOOL_16M);
+	if (rc) {
+		vos_dedup_slots = args->dt_slots_saved;
+		return rc;
+	}
+
+	*state = args;
+	return 0;
+}
+
+static int
+dedup_teardown(void **state)
+{
+	struct dedup_test_args	*args = *state;
+
+	vts_ctx_fini(&args->dt_ctx);
+	vos_dedup_slots = args->dt_slots_saved;
+	return 0;
+}
+
+/** Write an extent filled by \a pattern to \a oid with dedup disabled */
+static int
+dedup_update_plain(struct dedup_test_args *args, daos_unit_oid_t oid, char pattern)
+{
+	daos_iod_t	 iod;
+	daos_recx_t	 recx;
+	daos_key_t	 dkey;
+	d_sg_list_t	 sgl;
+	d_iov_t		 iov;
+	char		 buf[DEDUP_EXT_SIZE];
+
+	memset(buf, pattern, sizeof(buf));
+	d_iov_set(&iov, buf, sizeof(buf));
+	sgl.sg_nr = 1;
+	sgl.sg_nr_out = 0;
+	sgl.sg_iovs = &iov;
+	dedup_iod_init(&iod, &recx, &dkey);
+
+	return vos_obj_update(args->dt_ctx.tc_co_hdl, oid, ++args->dt_epoch, 0, 0, &dkey, 1,
+			      &iod, NULL, &sgl);
+}
+
+/** The index is only created by a dedup update to a pool which can keep the refs */
+static void
+dedup_create(void **state)
+{
+	struct dedup_test_args	*args = *state;
+	struct vos_pool		*pool = vos_hdl2pool(args->dt_ctx.tc_po_hdl);
+	daos_unit_oid_t		 oids[2];
+	uint64_t		 feats = pool->vp_feats;
+
+	assert_true(UMOFF_IS_NULL(pool->vp_pool_df->pd_dedup));
+	assert_null(pool->vp_dedup_ents);
+
+	oids[0] = dts_unit_oid_gen(0, 0);
+	assert_success(dedup_update_plain(args, oids[0], 'a'));
+	assert_true(UMOFF_IS_NULL(pool->vp_pool_df->pd_dedup));
+
+	/* No refcounted extents in a pool without the feature */
+	pool->vp_feats &= ~VOS_POOL_FEAT_DEDUP_REFS;
+	oids[0] = dts_unit_oid_gen(0, 0);
+	assert_success(dedup_update(args, oids[0], 'a'));
+	oids[1] = dts_unit_oid_gen(0, 0);
+	assert_success(dedup_update(args, oids[1], 'a'));
+	pool->vp_feats = feats;
+	assert_true(UMOFF_IS_NULL(pool->vp_pool_df->pd_dedup));
+	assert_int_not_equal(dedup_addr(args, oids[0]), dedup_addr(args, oids[1]));
+
+	oids[0] = dts_unit_oid_gen(0, 0);
+	assert_success(dedup_update(args, oids[0], 'a'));
+	assert_non_null(pool->vp_dedup_ents);
+	assert_int_equal(dedup_refs(args, dedup_addr(args, oids[0])), 1);
+}
+
+/** Same data is shared by the second record, different data is not */
+static void
+dedup_insert(void **state)
+{
+	struct dedup_test_args	*args = *state;
+	daos_unit_oid_t		 oids[3];
+	uint64_t		 off;
+	int			 i;
+
+	for (i = 0; i < 3; i++)
+		oids[i] = dts_unit_oid_gen(0, 0);
+
+	assert_success(dedup_update(args, oids[0], 'a'));
+	off = dedup_addr(args, oids[0]);
+	assert_int_equal(dedup_refs(args, off), 1);
+
+	assert_success(dedup_update(args, oids[1], 'a'));
+	assert_int_equal(dedup_addr(args, oids[1]), off);
+	assert_int_equal(dedup_refs(args, off), 2);
+
+	assert_success(dedup_update(args, oids[2], 'b'));
+	assert_int_not_equal(dedup_addr(args, oids[2]), off);
+	assert_int_equal(dedup_refs(args, dedup_addr(args, oids[2])), 1);
+}
+
+/** Unshared extents are evicted by CLOCK, shared ones are pinned */
+static void
+dedup_evict(void **state)
+{
+	struct dedup_test_args	*args = *state;
+	daos_unit_oid_t		 oid;
+	daos_unit_oid_t		 shared;
+	uint64_t		 off_a;
+	uint64_t		 off_b;
+	char			 pattern;
+
+	oid = dts_unit_oid_gen(0, 0);
+	assert_success(dedup_update(args, oid, 'a'));
+	off_a = dedup_addr(args, oid);
+
+	/* Share 'b', so its slot can't be replaced */
+	oid = dts_unit_oid_gen(0, 0);
+	assert_success(dedup_update(args, oid, 'b'));
+	off_b = dedup_addr(args, oid);
+	shared = dts_unit_oid_gen(0, 0);
+	assert_success(dedup_update(args, shared, 'b'));
+	assert_int_equal(dedup_addr(args, shared), off_b);
+
+	/* Twice as many distinct extents as slots */
+	for (pattern = 'c'; pattern < 'c' + DEDUP_SLOTS * 2; pattern++) {
+		oid = dts_unit_oid_gen(0, 0);
+		assert_success(dedup_update(args, oid, pattern));
+	}
+
+	assert_int_equal(dedup_refs(args, off_a), 0);
+	assert_int_equal(dedup_refs(args, off_b), 2);
+
+	/* 'a' was evicted, it's written to a new extent */
+	oid = dts_unit_oid_gen(0, 0);
+	assert_success(dedup_update(args, oid, 'a'));
+	assert_int_not_equal(dedup_addr(args, oid), off_a);
+
+	oid = dts_unit_oid_gen(0, 0);
+	assert_success(dedup_update(args, oid, 'b'));
+	assert_int_equal(dedup_addr(args, oid), off_b);
+	assert_int_equal(dedup_refs(args, off_b), 3);
+}
+
+/** Freeing a shared extent only drops a reference */
+static void
+dedup_free(void **state)
+{
+	struct dedup_test_args	*args = *state;
+	daos_unit_oid_t		 oids[2];
+	daos_epoch_range_t	 epr;
+	uint64_t		 off;
+	char			 buf[DEDUP_EXT_SIZE];
+	char			 expected[DEDUP_EXT_SIZE];
+	daos_iod_t		 iod;
+	daos_recx_t		 recx;
+	daos_key_t		 dkey;
+	d_sg_list_t		 sgl;
+	d_iov_t			 iov;
+	int			 rc;
+
+	oids[0] = dts_unit_oid_gen(0, 0);
+	oids[1] = dts_unit_oid_gen(0, 0);
+
+	assert_success(dedup_update(args, oids[0], 'f'));
+	epr.epr_lo = epr.epr_hi = args->dt_epoch;
+	off = dedup_addr(args, oids[0]);
+	assert_success(dedup_update(args, oids[1], 'f'));
+	assert_int_equal(dedup_refs(args, off), 2);
+
+	/* Discard the original record, the extent is kept for the other one */
+	rc = vos_discard(args->dt_ctx.tc_co_hdl, &oids[0], &epr, NULL, NULL);
+	assert_success(rc);
+	assert_int_equal(dedup_refs(args, off), 1);
+
+	memset(expected, 'f', sizeof(expected));
+	memset(buf, 0, sizeof(buf));
+	d_iov_set(&iov, buf, sizeof(buf));
+	sgl.sg_nr = 1;
+	sgl.sg_nr_out = 0;
+	sgl.sg_iovs = &iov;
+	dedup_iod_init(&iod, &recx, &dkey);
+	rc = vos_obj_fetch(args->dt_ctx.tc_co_hdl, oids[1], args->dt_epoch, 0, &dkey, 1,
+			   &iod, &sgl);
+	assert_success(rc);
+	assert_memory_equal(buf, expected, sizeof(buf));
+
+	/* The last reference releases the slot */
+	epr.epr_lo = epr.epr_hi = args->dt_epoch;
+	rc = vos_discard(args->dt_ctx.tc_co_hdl, &oids[1], &epr, NULL, NULL);
+	assert_success(rc);
+	assert_int_equal(dedup_refs(args, off), 0);
+}
+
+/** Aborted updates leave neither new slots nor references behind */
+static void
+dedup_abort(void **state)
+{
+	struct dedup_test_args	*args = *state;
+	daos_unit_oid_t		 oid;
+	uint64_t		 off;
+	int			 rc;
+
+	FAULT_INJECTION_REQUIRED();
+
+	/* Aborted insertion */
+	oid = dts_unit_oid_gen(0, 0);
+	daos_fail_loc_set(DAOS_VOS_UPDATE_ABORT | DAOS_FAIL_ONCE);
+	rc = dedup_update(args, oid, 'x');
+	daos_fail_loc_set(0);
+	assert_rc_equal(rc, -DER_IO);
+
+	oid = dts_unit_oid_gen(0, 0);
+	assert_success(dedup_update(args, oid, 'x'));
+	off = dedup_addr(args, oid);
+	assert_int_equal(dedup_refs(args, off), 1);
+
+	/* Aborted reference */
+	oid = dts_unit_oid_gen(0, 0);
+	daos_fail_loc_set(DAOS_VOS_UPDATE_ABORT | DAOS_FAIL_ONCE);
+	rc = dedup_update(args, oid, 'x');
+	daos_fail_loc_set(0);
+	assert_rc_equal(rc, -DER_IO);
+	assert_int_equal(dedup_refs(args, off), 1);
+
+	oid = dts_unit_oid_gen(0, 0);
+	assert_success(dedup_update(args, oid, 'x'));
+	assert_int_equal(dedup_addr(args, oid), off);
+	assert_int_equal(dedup_refs(args, off), 2);
+}
+
+/** The index survives pool reopen */
+static void
+dedup_reload(void **state)
+{
+	struct dedup_test_args	*args = *state;
+	struct vos_test_ctx	*ctx = &args->dt_ctx;
+	daos_unit_oid_t		 oid;
+	uint64_t		 off;
+	int			 rc;
+
+	oid = dts_unit_oid_gen(0, 0);
+	assert_success(dedup_update(args, oid, 'r'));
+	off = dedup_addr(args, oid);
+
+	rc = vos_cont_close(ctx->tc_co_hdl);
+	assert_success(rc);
+	rc = vos_pool_close(ctx->tc_po_hdl);
+	assert_success(rc);
+
+	/* Slot count of an existing index doesn't change */
+	vos_dedup_slots = DEDUP_SLOTS * 2;
+	rc = vos_pool_open(ctx->tc_po_name, ctx->tc_po_uuid, 0, &ctx->tc_po_hdl);
+	vos_dedup_slots = DEDUP_SLOTS;
+	assert_success(rc);
+	rc = vos_cont_open(ctx->tc_po_hdl, ctx->tc_co_uuid, &ctx->tc_co_hdl);
+	assert_success(rc);
+
+	assert_int_equal(dedup_refs(args, off), 1);
+	oid = dts_unit_oid_gen(0, 0);
+	assert_success(dedup_update(args, oid, 'r'));
+	assert_int_equal(dedup_addr(args, oid), off);
+	assert_int_equal(dedup_refs(args, off), 2);
+}
+
+static const struct CMUnitTest dedup_tests[] = {
+	{ "VOS1000: Dedup index insertion", dedup_insert, dedup_setup, dedup_teardown},
+	{ "VOS1001: Dedup index CLOCK eviction", dedup_evict, dedup_setup, dedup_teardown},
+	{ "VOS1002: Dedup shared extent free", dedup_free, dedup_setup, dedup_teardown},
+	{ "VOS1003: Dedup index transaction abort", dedup_abort, dedup_setup,
+	  dedup_teardown},
+	{ "VOS1004: Dedup index reload on pool open", dedup_reload, dedup_setup,
+	  dedup_teardown},
+	{ "VOS1005: Dedup index creation", dedup_create, dedup_setup, dedup_teardown},
+};
+
+int
+run_dedup_tests(const char *cfg)
+{
+	char	test_name[DTS_CFG_MAX];
+
+	dts_create_config(test_name, "VOS dedup index tests %s", cfg);
+	return cmocka_run_group_tests_name(test_name, dedup_tests, NULL, NULL);
+}
@@ -17,6 +17,10 @@
 
 unsigned int vos_agg_nvme_thresh = VOS_MW_NVME_THRESH;
 
+/* Segment size range for inline compression on merge window flush */
+#define VOS_COMP_SEG_MIN	(1UL << 12)	/* 4KB */
+#define VOS_COMP_SEG_MAX	VOS_MW_FLUSH_THRESH
+
 /*
  * EV tree sorted iterator returns logical entry in extent start order, and
  * the information like: physical entry it belongs to, visibility, is it the
@@ -116,6 +120,10 @@ struct agg_io_context {
 	struct vos_rsrvd_scm	*ic_rsrvd_scm;
 	/* Reserved NVMe extents for new physical entries */
 	d_list_t		 ic_nvme_exts;
+	/* Compressor & buffer for compressing segments, kept for entire aggregation */
+	struct daos_compressor	*ic_compressor;
+	void			*ic_comp_buf;
+	daos_size_t		 ic_comp_buf_len;
 };
 
 /* Merge window for evtree aggregation */
@@ -143,6 +151,8 @@ struct agg_merge_window {
 	/* I/O context for transferring data on flush */
 	struct agg_io_context		 mw_io_ctxt;
 	uint16_t			 mw_csum_type;
+	/* DAOS_COMPRESS_TYPE for the new physical entries */
+	uint16_t			 mw_comp_type;
 };
 
 struct vos_agg_credits {
@@ -1088,6 +1098,160 @@ verify_and_recalc(struct bio_sglist *bsgl, struct evt_entry_in *ent_in,
 	return args.cra_rc;
 }
 
+static inline bool
+seg_compressible(struct agg_merge_window *mw, struct agg_lgc_seg *lgc_seg, daos_size_t seg_size)
+{
+	/*
+	 * Checksums are calculated over uncompressed data and fetched by chunk, so
+	 * don't compress when checksum is enabled. Truncated physical entry is kept
+	 * uncompressed, it could be addressed by offset on next window flush.
+	 */
+	return mw->mw_comp_type != COMPRESS_TYPE_UNKNOWN && mw->mw_csum_type == 0 &&
+	       lgc_seg->ls_phy_ent == NULL && seg_size >= VOS_COMP_SEG_MIN &&
+	       seg_size <= VOS_COMP_SEG_MAX;
+}
+
+struct agg_comp_args {
+	int	ca_produced;
+	int	ca_status;
+	bool	ca_done;
+};
+
+static void
+agg_comp_cb(void *cb_data, int produced, int status)
+{
+	struct agg_comp_args	*args = cb_data;
+
+	args->ca_produced = produced;
+	args->ca_status = status;
+	args->ca_done = true;
+}
+
+static int
+agg_compress(struct agg_io_context *io, uint16_t type, uint8_t *src, size_t src_len,
+	     uint8_t *dst, size_t dst_len, size_t *produced)
+{
+	struct agg_comp_args	args = { 0 };
+	int			rc;
+
+	if (io->ic_compressor == NULL) {
+		rc = daos_compressor_init_with_type(&io->ic_compressor, type, true,
+						    VOS_COMP_SEG_MAX);
+		if (rc) {
+			D_ERROR("Failed to init compressor %u: "DF_RC"\n", type, DP_RC(rc));
+			return rc;
+		}
+	}
+
+	if (io->ic_compressor->dc_algo->cf_compress_async == NULL)
+		return daos_compressor_compress(io->ic_compressor, src, src_len, dst, dst_len,
+						produced);
+
+	/* Offloaded to QAT, yield to other ULTs while waiting for the completion */
+	rc = daos_compressor_compress_async(io->ic_compressor, src, src_len, dst, dst_len,
+					    agg_comp_cb, &args);
+	if (rc)
+		return rc;
+
+	while (!args.ca_done) {
+		daos_compressor_poll_response(io->ic_compressor);
+		if (!args.ca_done)
+			ABT_thread_yield();
+	}
+
+	if (args.ca_status == 0)
+		*produced = args.ca_produced;
+	return args.ca_status;
+}
+
+/*
+ * Read the source extents of a segment into DRAM, compress it and write the
+ * compressed data into a newly reserved extent. The segment is written in the
+ * plain form if the compression doesn't save at least 1/8 space, and it'll be
+ * marked as incompressible to avoid being compressed again.
+ */
+static int
+compress_one_segment(struct vos_object *obj, struct agg_merge_window *mw,
+		     struct evt_entry_in *ent_in, struct bio_sglist *bsgl,
+		     daos_size_t seg_size, unsigned int seg_count)
+{
+	struct agg_io_context	*io = &mw->mw_io_ctxt;
+	struct bio_io_context	*bio_ctxt = obj->obj_cont->vc_pool->vp_io_ctxt;
+	struct vos_agg_metrics	*vam = agg_cont2metrics(obj->obj_cont);
+	d_sg_list_t		 sgl;
+	d_iov_t			 iov;
+	uint8_t			*src, *dst;
+	size_t			 dst_len, produced = 0;
+	daos_size_t		 write_size;
+	bool			 compressed;
+	int			 rc;
+
+	if (io->ic_comp_buf_len < seg_size * 2) {
+		D_FREE(io->ic_comp_buf);
+		io->ic_comp_buf_len = 0;
+
+		D_ALLOC_NZ(io->ic_comp_buf, seg_size * 2);
+		if (io->ic_comp_buf == NULL)
+			return -DER_NOMEM;
+		io->ic_comp_buf_len = seg_size * 2;
+	}
+	src = io->ic_comp_buf;
+	dst = src + seg_size;
+
+	/* Compressed source extents are decompressed by bio */
+	d_iov_set(&iov, src, seg_size);
+	sgl.sg_iovs = &iov;
+	sgl.sg_nr = 1;
+	sgl.sg_nr_out = 0;
+	rc = bio_readv(bio_ctxt, bsgl, &sgl);
+	if (rc) {
+		D_ERROR("Read "DF_RECT" error: "DF_RC"\n", DP_RECT(&ent_in->ei_rect), DP_RC(rc));
+		return rc;
+	}
+
+	dst_len = seg_size - (seg_size >> 3);
+	rc = agg_compress(io, mw->mw_comp_type, src, seg_size, dst, dst_len, &produced);
+	compressed = (rc == 0 && produced > 0 && produced <= dst_len);
+	if (rc && rc != DC_STATUS_OVERFLOW)
+		D_DEBUG(DB_EPC, "Compress "DF_RECT" error: "DF_RC"\n",
+			DP_RECT(&ent_in->ei_rect), DP_RC(rc));
+
+	write_size = compressed ? produced : seg_size;
+	rc = reserve_segment(obj, io, write_size, &ent_in->ei_addr);
+	if (rc) {
+		D_CDEBUG(rc == -DER_NOSPACE, DB_EPC, DLOG_ERR,
+			 "Reserve "DF_U64" segment error: "DF_RC"\n", write_size, DP_RC(rc));
+		return rc;
+	}
+	D_ASSERT(!bio_addr_is_hole(&ent_in->ei_addr));
+
+	d_iov_set(&iov, compressed ? dst : src, write_size);
+	rc = bio_write(bio_ctxt, ent_in->ei_addr, &iov);
+	if (rc) {
+		D_ERROR("Write to "DF_RECT" error "DF_RC"\n", DP_RECT(&ent_in->ei_rect),
+			DP_RC(rc));
+		return rc;
+	}
+
+	if (compressed)
+		bio_addr_set_compressed(&ent_in->ei_addr, mw->mw_comp_type, write_size);
+	else
+		ent_in->ei_addr.ba_ctype = mw->mw_comp_type;
+
+	if (vam) {
+		if (vam->vam_merge_recs)
+			d_tm_inc_counter(vam->vam_merge_recs, seg_count);
+		if (vam->vam_merge_size)
+			d_tm_inc_counter(vam->vam_merge_size, seg_size);
+		if (vam->vam_comp_in)
+			d_tm_inc_counter(vam->vam_comp_in, seg_size);
+		if (vam->vam_comp_out)
+			d_tm_inc_counter(vam->vam_comp_out, write_size);
+	}
+
+	return 0;
+}
+
 static int
 fill_one_segment(daos_handle_t ih, struct agg_merge_window *mw,
 		 struct agg_lgc_seg *lgc_seg, unsigned int *acts)
@@ -1176,11 +1340,25 @@ fill_one_segment(daos_handle_t ih, struct agg_merge_window *mw,
 		copy_size = evt_extent_width(&ext) * ent_in->ei_inob;
 
 		addr_src = phy_ent->pe_addr;
-		addr_src.ba_off += (ext.ex_lo - phy_lo) * ent_in->ei_inob;
-
 		D_ASSERT(!bio_addr_is_hole(&addr_src));
-
 		D_ASSERT(biov_idx < bsgl.bs_nr);
+
+		if (BIO_ADDR_IS_COMPRESSED(&addr_src)) {
+			/*
+			 * Compressed entry is never head-truncated in place, its address is
+			 * always the start of the original in-tree extent.
+			 */
+			D_ASSERT(mw->mw_csum_type == 0);
+			bio_iov_set_compressed(&bsgl.bs_iovs[biov_idx], addr_src,
+					       (ext.ex_lo - phy_ent->pe_rect.rc_ex.ex_lo) *
+					       ent_in->ei_inob, copy_size,
+					       evt_rect_width(&phy_ent->pe_rect) * ent_in->ei_inob);
+			biov_idx++;
+			read_size += copy_size;
+			continue;
+		}
+
+		addr_src.ba_off += (ext.ex_lo - phy_lo) * ent_in->ei_inob;
 		bio_iov_set(&bsgl.bs_iovs[biov_idx], addr_src, copy_size);
 
 		if (mw->mw_csum_type) {
@@ -1194,6 +1372,12 @@ fill_one_segment(daos_handle_t ih, struct agg_merge_window *mw,
 	}
 	D_ASSERT(seg_size == read_size);
 
+	if (seg_compressible(mw, lgc_seg, seg_size)) {
+		bsgl.bs_nr_out = biov_idx;
+		rc = compress_one_segment(obj, mw, ent_in, &bsgl, seg_size, seg_count);
+		goto out;
+	}
+
 	rc = reserve_segment(obj, io, seg_size, &ent_in->ei_addr);
 	if (rc) {
 		D_CDEBUG(rc == -DER_NOSPACE, DB_EPC, DLOG_ERR,
@@ -1202,6 +1386,9 @@ fill_one_segment(daos_handle_t ih, struct agg_merge_window *mw,
 	}
 	D_ASSERT(!bio_addr_is_hole(&ent_in->ei_addr));
 	bio_iov_set(&bsgl_dst.bs_iovs[0], ent_in->ei_addr, seg_size);
+	/* Segment isn't eligible for compression, don't try it again */
+	if (mw->mw_comp_type != COMPRESS_TYPE_UNKNOWN)
+		ent_in->ei_addr.ba_ctype = mw->mw_comp_type;
 
 	copy_desc = bio_copy_prep(bio_ctxt, &bsgl, &bsgl_dst);
 	if (copy_desc == NULL) {
@@ -1717,6 +1904,13 @@ need_flush(daos_handle_t ih, struct vos_agg_param *agg_param, bool last)
 		    lgc_ext.ex_hi != phy_ext.ex_hi)
 			return true;
 
+		/* Any physical entry hasn't been compressed (or found incompressible) yet */
+		if (mw->mw_comp_type != COMPRESS_TYPE_UNKNOWN && mw->mw_csum_type == 0 &&
+		    !bio_addr_is_hole(&phy_ent->pe_addr) &&
+		    phy_ent->pe_addr.ba_ctype == COMPRESS_TYPE_UNKNOWN &&
+		    evt_extent_width(&phy_ext) * mw->mw_rsize >= VOS_COMP_SEG_MIN)
+			return true;
+
 		if (i == 0 || (hole != bio_addr_is_hole(&phy_ent->pe_addr))) {
 			if (i && need_merge(ih, src_media, lgc_cnt, seg_width * mw->mw_rsize))
 				return true;
@@ -2613,6 +2807,16 @@ merge_window_init(struct agg_merge_window *mw)
 	D_INIT_LIST_HEAD(&io->ic_nvme_exts);
 }
 
+static void
+merge_window_fini(struct agg_merge_window *mw)
+{
+	struct agg_io_context *io = &mw->mw_io_ctxt;
+
+	daos_compressor_destroy(&io->ic_compressor);
+	D_FREE(io->ic_comp_buf);
+	io->ic_comp_buf_len = 0;
+}
+
 struct agg_data {
 	vos_iter_param_t	ad_iter_param;
 	struct vos_agg_param	ad_agg_param;
@@ -2682,6 +2886,13 @@ vos_aggregate(daos_handle_t coh, daos_epoch_range_t *epr,
 	ad->ad_agg_param.ap_yield_arg = yield_arg;
 	run_agg = true;
 	merge_window_init(&ad->ad_agg_param.ap_window);
+	/*
+	 * The compressed flag lives in the bio_addr_t padding, older engines
+	 * would take a compressed extent as plain data, so only compress in
+	 * pools of a format they refuse to open (VOS_POOL_DF_2_6).
+	 */
+	if (cont->vc_pool->vp_feats & VOS_POOL_FEAT_COMPRESS)
+		ad->ad_agg_param.ap_window.mw_comp_type = cont->vc_compress_type;
 	ad->ad_agg_param.ap_flags = flags;
 
 	ad->ad_iter_param.ip_flags |= VOS_IT_FOR_PURGE;
@@ -2707,8 +2918,11 @@ update_hae:
 exit:
 	aggregate_exit(cont, AGG_MODE_AGGREGATE);
 
-	if (run_agg && merge_window_status(&ad->ad_agg_param.ap_window) != MW_CLOSED)
-		D_ASSERTF(false, "Merge window resource leaked.\n");
+	if (run_agg) {
+		if (merge_window_status(&ad->ad_agg_param.ap_window) != MW_CLOSED)
+			D_ASSERTF(false, "Merge window resource leaked.\n");
+		merge_window_fini(&ad->ad_agg_param.ap_window);
+	}
 
 free_agg_data:
 	D_FREE(ad);
@@ -33,6 +33,12 @@ struct vos_self_mode		 self_mode = {
 	.self_lock	= PTHREAD_MUTEX_INITIALIZER,
 };
 
+#ifdef VOS_STANDALONE
+/* Private TLS & NVMe context of the calling xstream, see vos_self_xs_init() */
+static __thread struct vos_tls		*self_xs_tls;
+static __thread struct bio_xs_context	*self_xs_nvme;
+#endif
+
 #define DF_MAX_BUF 128
 void
 vos_report_layout_incompat(const char *type, int version, int min_version,
@@ -59,7 +65,7 @@ struct vos_tls *
 vos_tls_get(void)
 {
 #ifdef VOS_STANDALONE
-	return self_mode.self_tls;
+	return self_xs_tls != NULL ? self_xs_tls : self_mode.self_tls;
 #else
 	return dss_module_key_get(dss_tls_get(), &vos_module_key);
 #endif
@@ -139,7 +145,7 @@ struct bio_xs_context *
 vos_xsctxt_get(void)
 {
 #ifdef VOS_STANDALONE
-	return self_mode.self_xs_ctxt;
+	return self_xs_nvme != NULL ? self_xs_nvme : self_mode.self_xs_ctxt;
 #else
 	return dss_get_module_info()->dmi_nvme_ctxt;
 #endif
@@ -153,6 +159,15 @@ vos_bio_addr_free(struct vos_pool *pool, bio_addr_t *addr, daos_size_t nob)
 	if (bio_addr_is_hole(addr))
 		return 0;
 
+	/* The extent is still shared by other deduplicated records */
+	rc = vos_dedup_unref(pool, addr);
+	if (rc)
+		return rc < 0 ? rc : 0;
+
+	/* Only the compressed data is allocated on media */
+	if (BIO_ADDR_IS_COMPRESSED(addr))
+		nob = addr->ba_csize;
+
 	if (addr->ba_type == DAOS_MEDIA_SCM) {
 		rc = umem_free(&pool->vp_umm, addr->ba_off);
 	} else {
@@ -163,7 +178,10 @@ vos_bio_addr_free(struct vos_pool *pool, bio_addr_t *addr, daos_size_t nob)
 		blk_off = vos_byte2blkoff(addr->ba_off);
 		blk_cnt = vos_byte2blkcnt(nob);
 
-		rc = vea_free(pool->vp_vea_info, blk_off, blk_cnt);
+		if (pool->vp_gc_defer)
+			rc = gc_defer_free(pool, blk_off, blk_cnt);
+		else
+			rc = vea_free(pool->vp_vea_info, blk_off, blk_cnt);
 		if (rc)
 			D_ERROR("Error on block ["DF_U64", %u] free. "DF_RC"\n",
 				blk_off, blk_cnt, DP_RC(rc));
@@ -503,6 +521,10 @@ vos_mod_init(void)
 	d_getenv_bool("DAOS_DKEY_PUNCH_PROPAGATE", &vos_dkey_punch_propagate);
 	D_INFO("DKEY punch propagation is %s\n", vos_dkey_punch_propagate ? "enabled" : "disabled");
 
+	d_getenv_int("DAOS_DEDUP_INDEX_SLOTS", &vos_dedup_slots);
+	if (vos_dedup_slots == 0)
+		vos_dedup_slots = VOS_DEDUP_SLOTS_DEF;
+
 
 	return rc;
 }
@@ -516,7 +538,8 @@ vos_mod_fini(void)
 static inline int
 vos_metrics_count(void)
 {
-	return vea_metrics_count();
+	return vea_metrics_count() +
+	       (sizeof(struct vos_dedup_metrics) / sizeof(struct d_tm_node_t *));
 }
 
 static void
@@ -530,6 +553,7 @@ vos_metrics_free(void *data)
 }
 
 #define VOS_AGG_DIR	"vos_aggregation"
+#define VOS_DEDUP_DIR	"vos_dedup"
 
 static inline char *
 agg_op2str(unsigned int agg_op)
@@ -551,6 +575,7 @@ vos_metrics_alloc(const char *path, int tgt_id)
 {
 	struct vos_pool_metrics	*vp_metrics;
 	struct vos_agg_metrics	*vam;
+	struct vos_dedup_metrics *vdm;
 	char			 desc[40];
 	int			 i, rc;
 
@@ -638,6 +663,50 @@ vos_metrics_alloc(const char *path, int tgt_id)
 	if (rc)
 		D_WARN("Failed to create 'merged_size' telemetry : "DF_RC"\n", DP_RC(rc));
 
+	/* VOS aggregation total size before compression */
+	rc = d_tm_add_metric(&vam->vam_comp_in, D_TM_COUNTER, "total size before compression",
+			     "bytes", "%s/%s/compress_in/tgt_%u", path, VOS_AGG_DIR, tgt_id);
+	if (rc)
+		D_WARN("Failed to create 'compress_in' telemetry : "DF_RC"\n", DP_RC(rc));
+
+	/* VOS aggregation total size after compression */
+	rc = d_tm_add_metric(&vam->vam_comp_out, D_TM_COUNTER, "total size after compression",
+			     "bytes", "%s/%s/compress_out/tgt_%u", path, VOS_AGG_DIR, tgt_id);
+	if (rc)
+		D_WARN("Failed to create 'compress_out' telemetry : "DF_RC"\n", DP_RC(rc));
+
+	vdm = &vp_metrics->vp_dedup_metrics;
+
+	/* VOS dedup lookups */
+	rc = d_tm_add_metric(&vdm->vdm_lookups, D_TM_COUNTER, "dedup lookups", NULL,
+			     "%s/%s/lookups/tgt_%u", path, VOS_DEDUP_DIR, tgt_id);
+	if (rc)
+		D_WARN("Failed to create 'lookups' telemetry : "DF_RC"\n", DP_RC(rc));
+
+	/* VOS dedup lookups hit */
+	rc = d_tm_add_metric(&vdm->vdm_hits, D_TM_COUNTER, "dedup hits", NULL,
+			     "%s/%s/hits/tgt_%u", path, VOS_DEDUP_DIR, tgt_id);
+	if (rc)
+		D_WARN("Failed to create 'hits' telemetry : "DF_RC"\n", DP_RC(rc));
+
+	/* VOS dedup index insertions */
+	rc = d_tm_add_metric(&vdm->vdm_inserts, D_TM_COUNTER, "dedup index insertions", NULL,
+			     "%s/%s/inserts/tgt_%u", path, VOS_DEDUP_DIR, tgt_id);
+	if (rc)
+		D_WARN("Failed to create 'inserts' telemetry : "DF_RC"\n", DP_RC(rc));
+
+	/* VOS dedup index evictions */
+	rc = d_tm_add_metric(&vdm->vdm_evicts, D_TM_COUNTER, "dedup index evictions", NULL,
+			     "%s/%s/evicts/tgt_%u", path, VOS_DEDUP_DIR, tgt_id);
+	if (rc)
+		D_WARN("Failed to create 'evicts' telemetry : "DF_RC"\n", DP_RC(rc));
+
+	/* VOS dedup index entries */
+	rc = d_tm_add_metric(&vdm->vdm_entries, D_TM_GAUGE, "dedup index entries", NULL,
+			     "%s/%s/entries/tgt_%u", path, VOS_DEDUP_DIR, tgt_id);
+	if (rc)
+		D_WARN("Failed to create 'entries' telemetry : "DF_RC"\n", DP_RC(rc));
+
 	return vp_metrics;
 }
 
@@ -830,3 +899,54 @@ failed:
 	D_MUTEX_UNLOCK(&self_mode.self_lock);
 	return rc;
 }
+
+int
+vos_self_xs_init(int tgt_id)
+{
+#ifdef VOS_STANDALONE
+	int	rc = 0;
+
+	D_ASSERT(self_xs_tls == NULL);
+
+	D_MUTEX_LOCK(&self_mode.self_lock);
+	if (self_mode.self_ref == 0)
+		D_GOTO(out, rc = -DER_UNINIT);
+
+	self_xs_tls = vos_tls_init(0, -1);
+	if (self_xs_tls == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+
+	rc = bio_xsctxt_alloc(&self_xs_nvme, tgt_id, true);
+	if (rc) {
+		D_ERROR("Failed to init NVMe context of tgt %d: "DF_RC"\n",
+			tgt_id, DP_RC(rc));
+		vos_tls_fini(self_xs_tls);
+		self_xs_tls = NULL;
+	}
+out:
+	D_MUTEX_UNLOCK(&self_mode.self_lock);
+	return rc;
+#else
+	return -DER_NOSYS;
+#endif
+}
+
+void
+vos_self_xs_fini(void)
+{
+#ifdef VOS_STANDALONE
+	if (self_xs_tls == NULL)
+		return;
+
+	gc_wait();
+
+	D_MUTEX_LOCK(&self_mode.self_lock);
+	if (self_xs_nvme != NULL) {
+		bio_xsctxt_free(self_xs_nvme);
+		self_xs_nvme = NULL;
+	}
+	vos_tls_fini(self_xs_tls);
+	self_xs_tls = NULL;
+	D_MUTEX_UNLOCK(&self_mode.self_lock);
+#endif
+}
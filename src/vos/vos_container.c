@@ -508,6 +508,24 @@ vos_cont_query(daos_handle_t coh, vos_cont_info_t *cont_info)
 	return 0;
 }
 
+int
+vos_cont_set_compress(daos_handle_t coh, uint32_t type)
+{
+	struct vos_container	*cont;
+
+	cont = vos_hdl2cont(coh);
+	if (cont == NULL) {
+		D_ERROR("Empty container handle for setting compression\n");
+		return -DER_NO_HDL;
+	}
+
+	if (type >= COMPRESS_TYPE_END)
+		return -DER_INVAL;
+
+	cont->vc_compress_type = type;
+	return 0;
+}
+
 /**
  * Set container state
  */
@@ -556,8 +574,6 @@ vos_cont_destroy(daos_handle_t poh, uuid_t co_uuid)
 	}
 	uuid_copy(pkey.uuid, pool->vp_id);
 
-	vos_dedup_invalidate(pool);
-
 	rc = cont_lookup(&key, &pkey, &cont);
 	if (rc != -DER_NONEXIST) {
 		D_ASSERT(rc == 0);
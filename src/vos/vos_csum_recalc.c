@@ -150,8 +150,16 @@ vos_csum_recalc_fn(void *recalc_args)
 		return rc;
 	}
 
-	daos_csummer_init_with_type(&csummer, csum_info.cs_type,
-				    csum_info.cs_chunksize, 0);
+	/* Running on helper XS, so it can't share the container csummer */
+	rc = daos_csummer_init_with_type(&csummer, csum_info.cs_type,
+					 csum_info.cs_chunksize, 0);
+	if (rc) {
+		d_sgl_fini(&sgl, false);
+		d_sgl_fini(&sgl_dst, false);
+		args->cra_rc = rc;
+		return rc;
+	}
+
 	for (i = 0; i < args->cra_seg_cnt; i++) {
 		bool		is_valid = false;
 		unsigned int	this_rec_nr, this_rec_idx;
@@ -22,6 +22,16 @@ enum {
 	GC_CREDS_MAX	= 4096,	/**< maximum credits for vos_gc_run/pool() */
 };
 
+enum {
+	/**
+	 * Credits are multiplied by this factor while tearing down a destroyed
+	 * container, so one transaction drains several bags.
+	 */
+	GC_BULK_FACTOR	= 4,
+	/** maximum number of NVMe extents deferred in one GC transaction */
+	GC_FREES_MAX	= 256,
+};
+
 /**
  * Default garbage bag size consumes <= 4K space
  * - header of vos_gc_bag_df is 64 bytes
@@ -91,9 +101,15 @@ gc_drain_btr(struct vos_gc *gc, struct vos_pool *pool, daos_handle_t coh,
 	if (rc)
 		goto failed;
 
-	D_DEBUG(DB_TRACE, "drain btree for %s, creds=%d\n",
-		gc->gc_name, *credits);
-	rc = dbtree_drain(toh, credits, vos_hdl2cont(coh), empty);
+	D_DEBUG(DB_TRACE, "drain btree for %s, creds=%d, bulk=%d\n",
+		gc->gc_name, *credits, pool->vp_gc_bulk);
+	/* NB: only value trees are drained in bulk, key and object trees
+	 * flatten their children into GC bags which is charged per record.
+	 */
+	if (pool->vp_gc_bulk && gc->gc_type == GC_AKEY)
+		rc = dbtree_drain_bulk(toh, credits, vos_hdl2cont(coh), empty);
+	else
+		rc = dbtree_drain(toh, credits, vos_hdl2cont(coh), empty);
 	dbtree_close(toh);
 	if (rc)
 		goto failed;
@@ -128,8 +144,12 @@ gc_drain_evt(struct vos_gc *gc, struct vos_pool *pool, daos_handle_t coh,
 	if (rc)
 		goto failed;
 
-	D_DEBUG(DB_TRACE, "drain %s evtree, creds=%d\n", gc->gc_name, *credits);
-	rc = evt_drain(toh, credits, empty);
+	D_DEBUG(DB_TRACE, "drain %s evtree, creds=%d, bulk=%d\n", gc->gc_name,
+		*credits, pool->vp_gc_bulk);
+	if (pool->vp_gc_bulk)
+		rc = evt_drain_bulk(toh, credits, empty);
+	else
+		rc = evt_drain(toh, credits, empty);
 	D_ASSERT(evt_close(toh) == 0);
 	if (rc)
 		goto failed;
@@ -175,7 +195,9 @@ gc_drain_key(struct vos_gc *gc, struct vos_pool *pool, daos_handle_t coh,
 	if (gc->gc_type == GC_DKEY)
 		return 0;
 
-	/* gather value stats for akey */
+	/* gather value stats for akey, NB: it counts tree nodes rather than
+	 * values in bulk mode.
+	 */
 	creds -= *credits;
 	if (key->kr_bmap & KREC_BF_BTR)
 		pool->vp_gc_stat.gs_singvs += creds;
@@ -277,10 +299,13 @@ gc_drain_cont(struct vos_gc *gc, struct vos_pool *pool, daos_handle_t coh,
 			return rc;
 
 		/** Indicate to caller that we've taken over container bags */
+		pool->vp_gc_bulk = true;
 		return 1;
 	}
 
 	D_ASSERT(daos_handle_is_inval(coh));
+	/* the whole container is garbage, tear it down in bulk */
+	pool->vp_gc_bulk = true;
 	return gc_drain_btr(gc, pool, coh, &cont->cd_obj_root,
 			    credits, empty);
 }
@@ -689,6 +714,78 @@ gc_get_container(struct vos_pool *pool)
 	return cont;
 }
 
+static int
+gc_free_cmp(const void *a, const void *b)
+{
+	const struct vea_free_extent *vfe_a = a;
+	const struct vea_free_extent *vfe_b = b;
+
+	if (vfe_a->vfe_blk_off < vfe_b->vfe_blk_off)
+		return -1;
+	return vfe_a->vfe_blk_off > vfe_b->vfe_blk_off;
+}
+
+/**
+ * Sort and coalesce the NVMe extents deferred by the running GC transaction,
+ * then return them to VEA in one batch.
+ */
+static int
+gc_flush_frees(struct vos_pool *pool)
+{
+	struct vea_free_extent	*vfes = pool->vp_gc_frees;
+	uint32_t		 nr = pool->vp_gc_frees_nr;
+	uint32_t		 i, j;
+	int			 rc;
+
+	if (nr == 0)
+		return 0;
+
+	pool->vp_gc_frees_nr = 0;
+	qsort(vfes, nr, sizeof(*vfes), gc_free_cmp);
+	for (i = 0, j = 1; j < nr; j++) {
+		if (vfes[i].vfe_blk_off + vfes[i].vfe_blk_cnt ==
+		    vfes[j].vfe_blk_off &&
+		    (uint64_t)vfes[i].vfe_blk_cnt + vfes[j].vfe_blk_cnt <=
+		    UINT32_MAX) {
+			vfes[i].vfe_blk_cnt += vfes[j].vfe_blk_cnt;
+			continue;
+		}
+		vfes[++i] = vfes[j];
+	}
+
+	D_DEBUG(DB_TRACE, "GC frees %u NVMe extents (%u coalesced)\n",
+		i + 1, nr);
+	rc = vea_free_batch(pool->vp_vea_info, vfes, i + 1);
+	if (rc)
+		D_ERROR("Failed to free %u NVMe extents for "DF_UUID": "
+			DF_RC"\n", i + 1, DP_UUID(pool->vp_id), DP_RC(rc));
+	return rc;
+}
+
+/**
+ * Defer an NVMe extent free to the end of the running GC transaction, see
+ * vos_bio_addr_free().
+ */
+int
+gc_defer_free(struct vos_pool *pool, uint64_t blk_off, uint32_t blk_cnt)
+{
+	struct vea_free_extent *vfe;
+	int			rc;
+
+	D_ASSERT(pool->vp_gc_defer && pool->vp_gc_frees != NULL);
+	if (pool->vp_gc_frees_nr == GC_FREES_MAX) {
+		rc = gc_flush_frees(pool);
+		if (rc)
+			return rc;
+	}
+
+	vfe = &pool->vp_gc_frees[pool->vp_gc_frees_nr++];
+	vfe->vfe_blk_off = blk_off;
+	vfe->vfe_blk_cnt = blk_cnt;
+	vfe->vfe_age	 = 0;
+	return 0;
+}
+
 /**
  * Run garbage collector for a pool, it returns if all @credits are consumed
  * or there is nothing to be reclaimed.
@@ -698,6 +795,8 @@ gc_reclaim_pool(struct vos_pool *pool, int *credits, bool *empty_ret)
 {
 	struct vos_container	*cont = gc_get_container(pool);
 	struct vos_gc		*gc    = &gc_table[0]; /* start from akey */
+	bool			 bulk  = pool->vp_gc_bulk;
+	bool			 defer = false;
 	int			 creds = *credits;
 	int			 rc;
 
@@ -706,6 +805,21 @@ gc_reclaim_pool(struct vos_pool *pool, int *credits, bool *empty_ret)
 		return 0;
 	}
 
+	/* NB: the returned credits are divided by the same factor, so it's
+	 * still less than the input credits if anything has been reclaimed.
+	 */
+	if (bulk)
+		creds *= GC_BULK_FACTOR;
+
+	/* batch NVMe frees, unless this is a nested reclaim (see gc_add_item)
+	 * which shares the batch of the outer one.
+	 */
+	if (pool->vp_vea_info != NULL && !pool->vp_gc_defer) {
+		if (pool->vp_gc_frees == NULL)
+			D_ALLOC_ARRAY(pool->vp_gc_frees, GC_FREES_MAX);
+		defer = (pool->vp_gc_frees != NULL);
+	}
+
 	/* take an extra ref to avoid concurrent container destroy/free */
 	if (cont != NULL)
 		vos_cont_addref(cont);
@@ -719,6 +833,11 @@ gc_reclaim_pool(struct vos_pool *pool, int *credits, bool *empty_ret)
 		return rc;
 	}
 
+	if (defer) {
+		D_ASSERT(pool->vp_gc_frees_nr == 0);
+		pool->vp_gc_defer = true;
+	}
+
 	*empty_ret = false;
 	while (creds > 0) {
 		struct vos_gc_item *item;
@@ -745,6 +864,7 @@ gc_reclaim_pool(struct vos_pool *pool, int *credits, bool *empty_ret)
 			} else if (gc->gc_type == GC_CONT) { /* top level GC */
 				D_DEBUG(DB_TRACE, "Nothing to reclaim\n");
 				*empty_ret = true;
+				pool->vp_gc_bulk = false;
 				break;
 			}
 			D_DEBUG(DB_TRACE, "GC=%s is empty\n", gc->gc_name);
@@ -791,12 +911,20 @@ gc_reclaim_pool(struct vos_pool *pool, int *credits, bool *empty_ret)
 		gc--;
 	}
 	D_DEBUG(DB_TRACE,
-		"pool="DF_UUID", creds origin=%d, current=%d, rc=%s\n",
-		DP_UUID(pool->vp_id), *credits, creds, d_errstr(rc));
+		"pool="DF_UUID", creds origin=%d, current=%d, bulk=%d, rc=%s\n",
+		DP_UUID(pool->vp_id), *credits, creds, bulk, d_errstr(rc));
+
+	if (defer) {
+		if (rc == 0)
+			rc = gc_flush_frees(pool);
+		/* extents of an aborted transaction are still referenced */
+		pool->vp_gc_frees_nr = 0;
+		pool->vp_gc_defer = false;
+	}
 
 	rc = umem_tx_end(&pool->vp_umm, rc);
 	if (rc == 0)
-		*credits = creds;
+		*credits = bulk ? creds / GC_BULK_FACTOR : creds;
 
 	if (cont != NULL && d_list_empty(&cont->vc_gc_link)) {
 		/** The container may not be empty so add it back to end of
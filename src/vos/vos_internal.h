@@ -18,6 +18,7 @@
 #include <daos/btree.h>
 #include <daos/common.h>
 #include <daos/lru.h>
+#include <daos/compression.h>
 #include <daos_srv/daos_engine.h>
 #include <daos_srv/bio.h>
 #include <daos_srv/policy.h>
@@ -134,6 +135,11 @@ enum {
 extern unsigned int vos_agg_nvme_thresh;
 extern bool vos_dkey_punch_propagate;
 
+/* Default number of slots of the persistent dedup index */
+#define VOS_DEDUP_SLOTS_DEF	16384
+
+extern unsigned int vos_dedup_slots;
+
 static inline uint32_t vos_byte2blkcnt(uint64_t bytes)
 {
 	D_ASSERT(bytes != 0);
@@ -177,11 +183,22 @@ struct vos_agg_metrics {
 	struct d_tm_node_t	*vam_del_ev;		/* Deleted EV records */
 	struct d_tm_node_t	*vam_merge_recs;	/* Total merged EV records */
 	struct d_tm_node_t	*vam_merge_size;	/* Total merged size */
+	struct d_tm_node_t	*vam_comp_in;		/* Total size before compression */
+	struct d_tm_node_t	*vam_comp_out;		/* Total size after compression */
+};
+
+struct vos_dedup_metrics {
+	struct d_tm_node_t	*vdm_lookups;		/* Dedup lookups */
+	struct d_tm_node_t	*vdm_hits;		/* Dedup lookups hit the index */
+	struct d_tm_node_t	*vdm_inserts;		/* Entries inserted into the index */
+	struct d_tm_node_t	*vdm_evicts;		/* Entries evicted from the index */
+	struct d_tm_node_t	*vdm_entries;		/* Entries in the index */
 };
 
 struct vos_pool_metrics {
 	void			*vp_vea_metrics;
 	struct vos_agg_metrics	 vp_agg_metrics;
+	struct vos_dedup_metrics vp_dedup_metrics;
 	/* TODO: add more metrics for VOS */
 };
 
@@ -198,6 +215,10 @@ struct vos_pool {
 	int			vp_excl:1;
 	/** caller specifies pool is small (for sys space reservation) */
 	bool			vp_small;
+	/** GC is tearing down a destroyed container, drain trees in bulk */
+	bool			vp_gc_bulk;
+	/** NVMe frees are deferred to the end of the GC transaction */
+	bool			vp_gc_defer;
 	/** UUID of vos pool */
 	uuid_t			vp_id;
 	/** memory attribute of the @vp_umm */
@@ -216,6 +237,10 @@ struct vos_pool {
 	d_list_t		vp_gc_link;
 	/** List of open containers with objects in gc pool */
 	d_list_t		vp_gc_cont;
+	/** NVMe extents freed by the running GC transaction */
+	struct vea_free_extent	*vp_gc_frees;
+	/** Number of extents in \a vp_gc_frees */
+	uint32_t		 vp_gc_frees_nr;
 	/** address of durable-format pool in SCM */
 	struct vos_pool_df	*vp_pool_df;
 	/** I/O context */
@@ -228,6 +253,14 @@ struct vos_pool {
 	daos_size_t		vp_space_held[DAOS_MEDIA_MAX];
 	/** Dedup hash */
 	struct d_hash_table	*vp_dedup_hash;
+	/** Dedup entries by extent address, for the extent reference counts */
+	struct d_hash_table	*vp_dedup_addr_hash;
+	/** In-memory entries of the persistent dedup index, by slot */
+	struct dedup_entry	**vp_dedup_ents;
+	/** Number of slots of the dedup index */
+	uint32_t		 vp_dedup_slots;
+	/** CLOCK hand for the dedup index retention */
+	uint32_t		 vp_dedup_hand;
 	struct vos_pool_metrics	*vp_metrics;
 	/* The count of committed DTXs for the whole pool. */
 	uint32_t		 vp_dtx_committed_count;
@@ -280,6 +313,8 @@ struct vos_container {
 	uint64_t		vc_agg_nospc_ts;
 	/* Last timestamp when IO reporting ENOSPACE */
 	uint64_t		vc_io_nospc_ts;
+	/* Compression type (DAOS_COMPRESS_TYPE) for aggregated array values */
+	uint32_t		vc_compress_type;
 	/* Various flags */
 	unsigned int		vc_in_aggregation:1,
 				vc_in_discard:1,
@@ -1139,10 +1174,12 @@ vos_recx2irec_size(daos_size_t rsize, struct dcs_csum_info *csum);
 
 int
 vos_dedup_init(struct vos_pool *pool);
+int
+vos_dedup_load(struct vos_pool *pool);
 void
 vos_dedup_fini(struct vos_pool *pool);
-void
-vos_dedup_invalidate(struct vos_pool *pool);
+int
+vos_dedup_unref(struct vos_pool *pool, bio_addr_t *addr);
 
 umem_off_t
 vos_reserve_scm(struct vos_container *cont, struct vos_rsrvd_scm *rsrvd_scm,
@@ -1203,6 +1240,8 @@ gc_add_item(struct vos_pool *pool, daos_handle_t coh,
 	    enum vos_gc_type type, umem_off_t item_off, uint64_t args);
 int
 vos_gc_pool_tight(daos_handle_t poh, int *credits);
+int
+gc_defer_free(struct vos_pool *pool, uint64_t blk_off, uint32_t blk_cnt);
 void
 gc_reserve_space(daos_size_t *rsrvd);
 
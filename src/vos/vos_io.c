@@ -57,8 +57,6 @@ struct vos_io_context {
 	unsigned int		 ic_iod_nr;
 	/** deduplication threshold size */
 	uint32_t		 ic_dedup_th;
-	/** dedup entries to be inserted after transaction done */
-	d_list_t		 ic_dedup_entries;
 	/** duped SG lists for dedup verify */
 	struct bio_sglist	*ic_dedup_bsgls;
 	/** bulk data buffers for dedup verify */
@@ -90,14 +88,35 @@ struct vos_io_context {
 	struct daos_recx_ep_list *ic_recx_lists;
 };
 
+/** Number of slots of the persistent dedup index, for newly created index */
+unsigned int vos_dedup_slots = VOS_DEDUP_SLOTS_DEF;
+
+/**
+ * DRAM view of one slot of the persistent dedup index. The slot is the source
+ * of truth: an entry whose slot was released or reused is stale, and it's
+ * dropped lazily when it's found by lookup, by address or by the CLOCK hand.
+ */
 struct dedup_entry {
 	d_list_t	 de_link;
+	/** link in vos_pool::vp_dedup_addr_hash */
+	d_list_t	 de_addr_link;
+	struct vos_pool	*de_pool;
 	uint8_t		*de_csum_buf;
 	uint16_t	 de_csum_type;
 	int		 de_csum_len;
 	bio_addr_t	 de_addr;
 	size_t           de_data_len;
 	int		 de_ref;
+	/** slot in the persistent dedup index */
+	int		 de_slot;
+	/** entry replaced by this one, restored if the transaction aborts */
+	struct dedup_entry *de_victim;
+	/** referenced since last visited by the CLOCK hand */
+	uint32_t	 de_referenced:1,
+	/** written to the slot by an uncommitted transaction */
+			 de_pending:1,
+	/** the replaced slot was in use */
+			 de_evict:1;
 };
 
 static inline struct dedup_entry *
@@ -106,6 +125,12 @@ dedup_rlink2entry(d_list_t *rlink)
 	return container_of(rlink, struct dedup_entry, de_link);
 }
 
+static inline struct dedup_entry *
+dedup_alink2entry(d_list_t *alink)
+{
+	return container_of(alink, struct dedup_entry, de_addr_link);
+}
+
 static bool
 dedup_key_cmp(struct d_hash_table *htable, d_list_t *rlink,
 	      const void *key, unsigned int csum_len)
@@ -162,17 +187,24 @@ dedup_rec_decref(struct d_hash_table *htable, d_list_t *rlink)
 }
 
 static void
-dedup_rec_free(struct d_hash_table *htable, d_list_t *rlink)
+dedup_entry_free(struct dedup_entry *entry)
 {
-	struct dedup_entry	*entry = dedup_rlink2entry(rlink);
-
-	D_ASSERT(entry->de_ref == 0);
 	D_ASSERT(entry->de_csum_buf != NULL);
+	D_ASSERT(d_list_empty(&entry->de_addr_link));
 
 	D_FREE(entry->de_csum_buf);
 	D_FREE(entry);
 }
 
+static void
+dedup_rec_free(struct d_hash_table *htable, d_list_t *rlink)
+{
+	struct dedup_entry	*entry = dedup_rlink2entry(rlink);
+
+	D_ASSERT(entry->de_ref == 0);
+	dedup_entry_free(entry);
+}
+
 static d_hash_table_ops_t dedup_hash_ops = {
 	.hop_key_cmp	= dedup_key_cmp,
 	.hop_key_hash	= dedup_key_hash,
@@ -181,6 +213,152 @@ static d_hash_table_ops_t dedup_hash_ops = {
 	.hop_rec_free	= dedup_rec_free,
 };
 
+static bool
+dedup_addr_key_cmp(struct d_hash_table *htable, d_list_t *alink,
+		   const void *key, unsigned int ksize)
+{
+	struct dedup_entry	*entry = dedup_alink2entry(alink);
+	const bio_addr_t	*addr = key;
+
+	D_ASSERT(ksize == sizeof(*addr));
+	return entry->de_addr.ba_type == addr->ba_type &&
+	       entry->de_addr.ba_off == addr->ba_off;
+}
+
+static uint32_t
+dedup_addr_key_hash(struct d_hash_table *htable, const void *key,
+		    unsigned int ksize)
+{
+	const bio_addr_t	*addr = key;
+
+	D_ASSERT(ksize == sizeof(*addr));
+	return d_hash_string_u32((const char *)&addr->ba_off, sizeof(addr->ba_off));
+}
+
+/** Entries are owned by the checksum hash, the address hash takes no reference */
+static d_hash_table_ops_t dedup_addr_hash_ops = {
+	.hop_key_cmp	= dedup_addr_key_cmp,
+	.hop_key_hash	= dedup_addr_key_hash,
+};
+
+static inline struct vos_dedup_metrics *
+dedup_pool2metrics(struct vos_pool *pool)
+{
+	if (pool->vp_metrics == NULL)
+		return NULL;
+
+	return &pool->vp_metrics->vp_dedup_metrics;
+}
+
+static inline struct vos_dedup_df *
+dedup_pool2df(struct vos_pool *pool)
+{
+	if (pool->vp_pool_df == NULL || UMOFF_IS_NULL(pool->vp_pool_df->pd_dedup))
+		return NULL;
+
+	return umem_off2ptr(vos_pool2umm(pool), pool->vp_pool_df->pd_dedup);
+}
+
+/** Number of records sharing the extent, slots written by older code have no count */
+static inline uint32_t
+dedup_ent_df_refs(struct vos_dedup_ent_df *ent_df)
+{
+	return ent_df->de_refs == 0 ? 1 : ent_df->de_refs;
+}
+
+/** Return the slot of \a entry, or NULL if the entry is stale */
+static struct vos_dedup_ent_df *
+dedup_entry2df(struct vos_pool *pool, struct dedup_entry *entry)
+{
+	struct vos_dedup_df	*dd_df = dedup_pool2df(pool);
+	struct vos_dedup_ent_df	*ent_df;
+
+	D_ASSERT(dd_df != NULL);
+	D_ASSERT(entry->de_slot >= 0 && entry->de_slot < pool->vp_dedup_slots);
+
+	ent_df = &dd_df->dd_ents[entry->de_slot];
+	if (ent_df->de_csum_len != entry->de_csum_len ||
+	    ent_df->de_csum_type != entry->de_csum_type ||
+	    ent_df->de_addr.ba_type != entry->de_addr.ba_type ||
+	    ent_df->de_addr.ba_off != entry->de_addr.ba_off ||
+	    memcmp(ent_df->de_csum, entry->de_csum_buf, entry->de_csum_len) != 0)
+		return NULL;
+
+	return ent_df;
+}
+
+static struct dedup_entry *
+dedup_entry_alloc(struct vos_pool *pool, struct dcs_csum_info *csum,
+		  daos_size_t csum_len, bio_addr_t *addr, size_t data_len)
+{
+	struct dedup_entry	*entry;
+
+	D_ALLOC_PTR(entry);
+	if (entry == NULL)
+		return NULL;
+
+	D_INIT_LIST_HEAD(&entry->de_link);
+	D_INIT_LIST_HEAD(&entry->de_addr_link);
+
+	D_ASSERT(csum_len != 0);
+	D_ALLOC(entry->de_csum_buf, csum_len);
+	if (entry->de_csum_buf == NULL) {
+		D_FREE(entry);
+		return NULL;
+	}
+	entry->de_pool		= pool;
+	entry->de_csum_len	= csum_len;
+	entry->de_csum_type	= csum->cs_type;
+	entry->de_addr		= *addr;
+	entry->de_data_len	= data_len;
+	entry->de_slot		= -1;
+	BIO_ADDR_CLEAR_DEDUP(&entry->de_addr);
+	memcpy(entry->de_csum_buf, csum->cs_csum, csum_len);
+
+	return entry;
+}
+
+/** Link a committed entry into the DRAM view */
+static int
+dedup_entry_link(struct vos_pool *pool, struct dedup_entry *entry)
+{
+	struct dcs_csum_info	csum = { 0 };
+	int			rc;
+
+	csum.cs_csum = entry->de_csum_buf;
+	csum.cs_type = entry->de_csum_type;
+
+	rc = d_hash_rec_insert(pool->vp_dedup_addr_hash, &entry->de_addr,
+			       sizeof(entry->de_addr), &entry->de_addr_link, true);
+	if (rc)
+		return rc;
+
+	/* Same fingerprint could be indexed in several slots, it's not unique */
+	rc = d_hash_rec_insert(pool->vp_dedup_hash, &csum, entry->de_csum_len,
+			       &entry->de_link, false);
+	if (rc) {
+		d_hash_rec_delete_at(pool->vp_dedup_addr_hash, &entry->de_addr_link);
+		return rc;
+	}
+
+	pool->vp_dedup_ents[entry->de_slot] = entry;
+	return 0;
+}
+
+/** Remove an entry from the DRAM view, it's freed on the last reference */
+static void
+dedup_entry_drop(struct vos_pool *pool, struct dedup_entry *entry)
+{
+	struct vos_dedup_metrics	*vdm = dedup_pool2metrics(pool);
+
+	if (entry->de_slot >= 0 && pool->vp_dedup_ents[entry->de_slot] == entry)
+		pool->vp_dedup_ents[entry->de_slot] = NULL;
+
+	d_hash_rec_delete_at(pool->vp_dedup_addr_hash, &entry->de_addr_link);
+	if (d_hash_rec_delete_at(pool->vp_dedup_hash, &entry->de_link) && vdm != NULL)
+		d_tm_dec_gauge(vdm->vdm_entries, 1);
+}
+
 int
 vos_dedup_init(struct vos_pool *pool)
 {
@@ -189,6 +367,15 @@ vos_dedup_init(struct vos_pool *pool)
 	rc = d_hash_table_create(D_HASH_FT_NOLOCK, 13, /* 8k buckets */
 				 NULL, &dedup_hash_ops,
 				 &pool->vp_dedup_hash);
+	if (rc == 0) {
+		rc = d_hash_table_create(D_HASH_FT_NOLOCK, 13, NULL,
+					 &dedup_addr_hash_ops,
+					 &pool->vp_dedup_addr_hash);
+		if (rc) {
+			d_hash_table_destroy(pool->vp_dedup_hash, true);
+			pool->vp_dedup_hash = NULL;
+		}
+	}
 
 	if (rc)
 		D_ERROR(DF_UUID": Init dedup hash failed. "DF_RC".\n",
@@ -196,38 +383,310 @@ vos_dedup_init(struct vos_pool *pool)
 	return rc;
 }
 
+/**
+ * Load all the valid slots of the persistent dedup index in one pass, it's
+ * called on pool open. Failing to load an existing index is fatal: the index
+ * carries the reference counts of the shared extents.
+ */
+int
+vos_dedup_load(struct vos_pool *pool)
+{
+	struct vos_dedup_df		*dd_df;
+	struct vos_dedup_metrics	*vdm;
+	struct vos_dedup_ent_df		*ent_df;
+	struct dedup_entry		*entry;
+	struct dcs_csum_info		 csum = { 0 };
+	uint32_t			 loaded = 0;
+	uint32_t			 i;
+	int				 rc;
+
+	dd_df = dedup_pool2df(pool);
+	if (dd_df == NULL)
+		return 0;
+
+	if (pool->vp_pool_df->pd_version < VOS_POOL_DF_2_6) {
+		D_ERROR(DF_UUID": Dedup index in pool of DF version %u\n",
+			DP_UUID(pool->vp_id), pool->vp_pool_df->pd_version);
+		return -DER_DF_INVAL;
+	}
+
+	if (dd_df->dd_magic != VOS_DEDUP_DF_MAGIC || dd_df->dd_slots == 0) {
+		D_ERROR(DF_UUID": Invalid dedup index, magic %x, slots %u\n",
+			DP_UUID(pool->vp_id), dd_df->dd_magic, dd_df->dd_slots);
+		return -DER_DF_INVAL;
+	}
+
+	D_ASSERT(pool->vp_dedup_ents == NULL);
+	D_ALLOC_ARRAY(pool->vp_dedup_ents, dd_df->dd_slots);
+	if (pool->vp_dedup_ents == NULL)
+		return -DER_NOMEM;
+	pool->vp_dedup_slots = dd_df->dd_slots;
+	pool->vp_dedup_hand = 0;
+
+	for (i = 0; i < dd_df->dd_slots; i++) {
+		ent_df = &dd_df->dd_ents[i];
+		if (ent_df->de_csum_len == 0)
+			continue;
+
+		if (ent_df->de_csum_len > VOS_DEDUP_CSUM_MAX) {
+			D_ERROR(DF_UUID": Invalid dedup slot %u, csum len %u\n",
+				DP_UUID(pool->vp_id), i, ent_df->de_csum_len);
+			D_GOTO(failed, rc = -DER_DF_INVAL);
+		}
+
+		csum.cs_csum = ent_df->de_csum;
+		csum.cs_type = ent_df->de_csum_type;
+		entry = dedup_entry_alloc(pool, &csum, ent_df->de_csum_len, &ent_df->de_addr,
+					  ent_df->de_data_len);
+		if (entry == NULL)
+			D_GOTO(failed, rc = -DER_NOMEM);
+
+		entry->de_slot = i;
+		rc = dedup_entry_link(pool, entry);
+		if (rc) {
+			dedup_entry_free(entry);
+			goto failed;
+		}
+		loaded++;
+	}
+
+	vdm = dedup_pool2metrics(pool);
+	if (vdm != NULL)
+		d_tm_set_gauge(vdm->vdm_entries, loaded);
+	D_DEBUG(DB_MGMT, DF_UUID": Loaded %u/%u dedup entries\n", DP_UUID(pool->vp_id),
+		loaded, dd_df->dd_slots);
+	return 0;
+failed:
+	D_ERROR(DF_UUID": Failed to load dedup index. "DF_RC"\n", DP_UUID(pool->vp_id),
+		DP_RC(rc));
+	return rc;
+}
+
+/**
+ * Allocate the persistent dedup index in its own transaction, the slot array
+ * of the DRAM view is allocated by vos_dedup_load().
+ */
+static int
+dedup_index_create(struct vos_pool *pool)
+{
+	struct umem_instance	*umm = vos_pool2umm(pool);
+	struct vos_pool_df	*pool_df = pool->vp_pool_df;
+	struct vos_dedup_df	*dd_df;
+	umem_off_t		 dd_off;
+	uint32_t		 slots = vos_dedup_slots;
+	int			 rc;
+
+	rc = umem_tx_begin(umm, NULL);
+	if (rc)
+		return rc;
+
+	/* Created by another ULT while this one was waiting for the transaction */
+	if (!UMOFF_IS_NULL(pool_df->pd_dedup))
+		goto out;
+
+	dd_off = umem_zalloc(umm, sizeof(*dd_df) + slots * sizeof(struct vos_dedup_ent_df));
+	if (UMOFF_IS_NULL(dd_off))
+		D_GOTO(out, rc = -DER_NOSPACE);
+
+	rc = umem_tx_add_ptr(umm, &pool_df->pd_dedup, sizeof(pool_df->pd_dedup));
+	if (rc)
+		goto out;
+
+	dd_df = umem_off2ptr(umm, dd_off);
+	dd_df->dd_magic = VOS_DEDUP_DF_MAGIC;
+	dd_df->dd_slots = slots;
+	pool_df->pd_dedup = dd_off;
+out:
+	return umem_tx_end(umm, rc);
+}
+
+/**
+ * Make sure the dedup index is usable before the first deduplicated update of
+ * the pool, creating it if needed. It's called outside of the update
+ * transaction, so pools never written by a dedup enabled container don't pay
+ * for the index. Deduplication is skipped if the pool format can't keep the
+ * reference counts, or if the index can't be created.
+ */
+static bool
+vos_dedup_index_get(struct vos_pool *pool)
+{
+	int	rc;
+
+	if (pool->vp_dedup_ents != NULL)
+		return true;
+
+	if (!(pool->vp_feats & VOS_POOL_FEAT_DEDUP_REFS))
+		return false;
+
+	rc = dedup_index_create(pool);
+	if (rc == 0 && pool->vp_dedup_ents == NULL)
+		rc = vos_dedup_load(pool);
+	if (rc) {
+		D_WARN(DF_UUID": Failed to create dedup index, dedup is skipped. "DF_RC"\n",
+		       DP_UUID(pool->vp_id), DP_RC(rc));
+		return false;
+	}
+
+	return pool->vp_dedup_ents != NULL;
+}
+
 void
 vos_dedup_fini(struct vos_pool *pool)
 {
+	/* Entries are owned by the checksum hash, drop the address hash first */
+	if (pool->vp_dedup_addr_hash) {
+		d_hash_table_destroy(pool->vp_dedup_addr_hash, true);
+		pool->vp_dedup_addr_hash = NULL;
+	}
 	if (pool->vp_dedup_hash) {
 		d_hash_table_destroy(pool->vp_dedup_hash, true);
 		pool->vp_dedup_hash = NULL;
 	}
+	D_FREE(pool->vp_dedup_ents);
+	pool->vp_dedup_slots = 0;
+	pool->vp_dedup_hand = 0;
 }
 
-void
-vos_dedup_invalidate(struct vos_pool *pool)
+/**
+ * Find a slot for new entry by CLOCK: entries referenced since the hand passed
+ * them last time get a second chance, the first unreferenced one is replaced.
+ * Slots of extents shared by more than one record are never replaced, since
+ * they carry the reference count. Returns -1 if no slot can be replaced.
+ */
+static int
+dedup_slot_get(struct vos_pool *pool, struct dedup_entry **victim, bool *evict)
 {
-	vos_dedup_fini(pool);
-	vos_dedup_init(pool);
+	struct vos_dedup_df	*dd_df = dedup_pool2df(pool);
+	struct vos_dedup_ent_df	*ent_df;
+	struct dedup_entry	*entry;
+	uint32_t		 slot;
+	uint32_t		 i;
+
+	/* The first round could only clear the referenced bits */
+	for (i = 0; i < pool->vp_dedup_slots * 2; i++) {
+		slot = pool->vp_dedup_hand;
+		pool->vp_dedup_hand = (slot + 1) % pool->vp_dedup_slots;
+
+		entry = pool->vp_dedup_ents[slot];
+		if (entry != NULL && entry->de_pending)
+			continue;
+
+		ent_df = &dd_df->dd_ents[slot];
+		if (ent_df->de_csum_len == 0) {
+			*victim = entry;
+			*evict = false;
+			return slot;
+		}
+
+		if (dedup_ent_df_refs(ent_df) > 1)
+			continue;
+
+		if (entry != NULL && entry->de_referenced) {
+			entry->de_referenced = 0;
+			continue;
+		}
+
+		*victim = entry;
+		*evict = true;
+		return slot;
+	}
+
+	return -1;
+}
+
+/**
+ * Transaction stage callback of a new entry: link it into the DRAM view and
+ * drop the replaced one on commit, restore the replaced one on abort.
+ */
+static void
+dedup_entry_commit_cb(void *data, bool noop)
+{
+	struct dedup_entry		*entry = data;
+	struct dedup_entry		*victim = entry->de_victim;
+	struct vos_pool			*pool = entry->de_pool;
+	struct vos_dedup_metrics	*vdm = dedup_pool2metrics(pool);
+	d_list_t			*alink;
+	int				 rc;
+
+	D_ASSERT(entry->de_pending);
+	D_ASSERT(pool->vp_dedup_ents[entry->de_slot] == entry);
+	entry->de_pending = 0;
+	entry->de_victim = NULL;
+
+	if (noop) {
+		/* Aborted, the slot is rolled back to the replaced entry */
+		pool->vp_dedup_ents[entry->de_slot] = NULL;
+		if (victim != NULL && !d_list_empty(&victim->de_link))
+			pool->vp_dedup_ents[entry->de_slot] = victim;
+		goto free;
+	}
+
+	if (victim != NULL)
+		dedup_entry_drop(pool, victim);
+	if (entry->de_evict && vdm != NULL)
+		d_tm_inc_counter(vdm->vdm_evicts, 1);
+
+	/* The address could be held by a stale entry of a released extent */
+	alink = d_hash_rec_find(pool->vp_dedup_addr_hash, &entry->de_addr,
+				sizeof(entry->de_addr));
+	if (alink != NULL)
+		dedup_entry_drop(pool, dedup_alink2entry(alink));
+
+	rc = dedup_entry_link(pool, entry);
+	if (rc) {
+		/* The slot is left unknown to DRAM until the pool is reopened */
+		D_ERROR(DF_UUID": Failed to link dedup entry. "DF_RC"\n",
+			DP_UUID(pool->vp_id), DP_RC(rc));
+		pool->vp_dedup_ents[entry->de_slot] = NULL;
+		goto free;
+	}
+
+	if (vdm != NULL) {
+		d_tm_inc_counter(vdm->vdm_inserts, 1);
+		d_tm_inc_gauge(vdm->vdm_entries, 1);
+	}
+	D_DEBUG(DB_IO, "Inserted dedup entry to slot %d\n", entry->de_slot);
+	if (victim != NULL)
+		d_hash_rec_decref(pool->vp_dedup_hash, &victim->de_link);
+	return;
+free:
+	if (victim != NULL)
+		d_hash_rec_decref(pool->vp_dedup_hash, &victim->de_link);
+	dedup_entry_free(entry);
 }
 
 static bool
 vos_dedup_lookup(struct vos_pool *pool, struct dcs_csum_info *csum,
 		 daos_size_t csum_len, struct bio_iov *biov)
 {
-	struct dedup_entry	*entry;
-	d_list_t		*rlink;
+	struct vos_dedup_metrics	*vdm;
+	struct dedup_entry		*entry;
+	d_list_t			*rlink;
 
-	if (!ci_is_valid(csum))
+	if (pool->vp_dedup_ents == NULL || !ci_is_valid(csum))
 		return false;
 
+	vdm = biov != NULL ? dedup_pool2metrics(pool) : NULL;
+	if (vdm != NULL)
+		d_tm_inc_counter(vdm->vdm_lookups, 1);
+
 	rlink = d_hash_rec_find(pool->vp_dedup_hash, csum, csum_len);
 	if (rlink == NULL)
 		return false;
 
 	entry = dedup_rlink2entry(rlink);
+	if (dedup_entry2df(pool, entry) == NULL) {
+		/* The extent was released, unless the slot is being replaced */
+		if (pool->vp_dedup_ents[entry->de_slot] == entry)
+			dedup_entry_drop(pool, entry);
+		d_hash_rec_decref(pool->vp_dedup_hash, rlink);
+		return false;
+	}
+
 	if (biov) {
+		if (vdm != NULL)
+			d_tm_inc_counter(vdm->vdm_hits, 1);
+		entry->de_referenced = 1;
 		biov->bi_addr = entry->de_addr;
 		BIO_ADDR_SET_DEDUP(&biov->bi_addr);
 		biov->bi_data_len = entry->de_data_len;
@@ -241,76 +700,158 @@ vos_dedup_lookup(struct vos_pool *pool, struct dcs_csum_info *csum,
 	return true;
 }
 
-static void
-vos_dedup_update(struct vos_pool *pool, struct dcs_csum_info *csum,
-		 daos_size_t csum_len, struct bio_iov *biov, d_list_t *list)
+/** Find the valid slot indexing the extent at \a addr */
+static struct vos_dedup_ent_df *
+dedup_addr2df(struct vos_pool *pool, bio_addr_t *addr)
 {
-	struct dedup_entry	*entry;
+	d_list_t	*alink;
 
-	if (!ci_is_valid(csum) || csum_len == 0 ||
-	    BIO_ADDR_IS_DEDUP(&biov->bi_addr))
-		return;
+	if (pool->vp_dedup_ents == NULL)
+		return NULL;
 
-	if (bio_addr_is_hole(&biov->bi_addr))
-		return;
+	alink = d_hash_rec_find(pool->vp_dedup_addr_hash, addr, sizeof(*addr));
+	if (alink == NULL)
+		return NULL;
 
-	if (vos_dedup_lookup(pool, csum, csum_len, NULL))
-		return;
+	return dedup_entry2df(pool, dedup_alink2entry(alink));
+}
 
-	D_ALLOC_PTR(entry);
-	if (entry == NULL) {
-		return;
+/**
+ * Take a reference on the extent shared by a new record, it's called within
+ * the update transaction. The extent could have been released since it was
+ * found on reserve, the update has to be restarted in that case.
+ */
+static int
+vos_dedup_ref(struct vos_pool *pool, bio_addr_t *addr)
+{
+	struct vos_dedup_ent_df	*ent_df;
+	int			 rc;
+
+	ent_df = dedup_addr2df(pool, addr);
+	if (ent_df == NULL) {
+		D_DEBUG(DB_IO, "Deduplicated extent was released\n");
+		return -DER_TX_RESTART;
 	}
-	D_INIT_LIST_HEAD(&entry->de_link);
 
-	D_ASSERT(csum_len != 0);
-	D_ALLOC(entry->de_csum_buf, csum_len);
-	if (entry->de_csum_buf == NULL) {
-		D_FREE(entry);
-		return;
+	rc = umem_tx_add_ptr(vos_pool2umm(pool), &ent_df->de_refs, sizeof(ent_df->de_refs));
+	if (rc)
+		return rc;
+
+	ent_df->de_refs = dedup_ent_df_refs(ent_df) + 1;
+	return 0;
+}
+
+/**
+ * Drop a reference on an extent being freed, it's called within the freeing
+ * transaction. Returns 1 if the extent is still shared by other records and
+ * must not be freed. Releasing the last reference releases the slot as well,
+ * the DRAM entry becomes stale and it's dropped lazily, so nothing needs to
+ * be undone if the transaction aborts.
+ */
+int
+vos_dedup_unref(struct vos_pool *pool, bio_addr_t *addr)
+{
+	struct umem_instance	*umm = vos_pool2umm(pool);
+	struct vos_dedup_ent_df	*ent_df;
+	int			 rc;
+
+	ent_df = dedup_addr2df(pool, addr);
+	if (ent_df == NULL)
+		return 0;
+
+	if (dedup_ent_df_refs(ent_df) > 1) {
+		rc = umem_tx_add_ptr(umm, &ent_df->de_refs, sizeof(ent_df->de_refs));
+		if (rc)
+			return rc;
+		ent_df->de_refs--;
+		return 1;
 	}
-	entry->de_csum_len	= csum_len;
-	entry->de_csum_type	= csum->cs_type;
-	entry->de_addr		= biov->bi_addr;
-	entry->de_data_len	= biov->bi_data_len;
-	memcpy(entry->de_csum_buf, csum->cs_csum, csum_len);
 
-	d_list_add_tail(&entry->de_link, list);
-	D_DEBUG(DB_IO, "Inserted dedup entry in list\n");
+	rc = umem_tx_add_ptr(umm, ent_df, sizeof(*ent_df));
+	if (rc)
+		return rc;
+	ent_df->de_csum_len = 0;
+	ent_df->de_refs = 0;
+	return 0;
 }
 
-static void
-vos_dedup_process(struct vos_pool *pool, d_list_t *list, bool abort)
+/**
+ * Index a newly written extent, it's called within the update transaction.
+ * The slot is written in the same transaction, the DRAM view is updated by
+ * the transaction stage callback.
+ */
+static int
+vos_dedup_update(struct vos_pool *pool, struct dcs_csum_info *csum,
+		 daos_size_t csum_len, struct bio_iov *biov)
 {
-	struct dedup_entry	*entry, *tmp;
-	struct dcs_csum_info	 csum = { 0 };
+	struct umem_instance	*umm = vos_pool2umm(pool);
+	struct vos_dedup_ent_df	*ent_df;
+	struct dedup_entry	*entry;
+	struct dedup_entry	*victim;
+	bool			 evict;
+	int			 slot;
 	int			 rc;
 
-	d_list_for_each_entry_safe(entry, tmp, list, de_link) {
-		d_list_del_init(&entry->de_link);
+	if (pool->vp_dedup_ents == NULL)
+		return 0;
 
-		if (abort)
-			goto free_entry;
+	if (!ci_is_valid(csum) || csum_len == 0 ||
+	    BIO_ADDR_IS_DEDUP(&biov->bi_addr))
+		return 0;
 
-		/*
-		 * No yield since vos_dedup_update() is called, so it's safe
-		 * to insert entries to hash without checking.
-		 */
-		csum.cs_csum = entry->de_csum_buf;
-		csum.cs_type = entry->de_csum_type;
+	if (bio_addr_is_hole(&biov->bi_addr))
+		return 0;
 
-		rc = d_hash_rec_insert(pool->vp_dedup_hash, &csum,
-				       entry->de_csum_len, &entry->de_link,
-				       false);
-		if (rc == 0) {
-			D_DEBUG(DB_IO, "Inserted dedup entry\n");
-			continue;
-		}
-		D_ERROR("Insert dedup entry failed. "DF_RC"\n", DP_RC(rc));
-free_entry:
-		D_FREE(entry->de_csum_buf);
-		D_FREE(entry);
+	/* Fingerprint too large to be kept in the persistent dedup index */
+	if (csum_len > VOS_DEDUP_CSUM_MAX)
+		return 0;
+
+	if (vos_dedup_lookup(pool, csum, csum_len, NULL))
+		return 0;
+
+	slot = dedup_slot_get(pool, &victim, &evict);
+	if (slot < 0)
+		return 0;
+
+	entry = dedup_entry_alloc(pool, csum, csum_len, &biov->bi_addr, biov->bi_data_len);
+	if (entry == NULL)
+		return 0;
+
+	ent_df = &dedup_pool2df(pool)->dd_ents[slot];
+	rc = umem_tx_add_ptr(umm, ent_df, sizeof(*ent_df));
+	if (rc)
+		goto failed;
+
+	ent_df->de_addr		= entry->de_addr;
+	ent_df->de_data_len	= entry->de_data_len;
+	ent_df->de_csum_type	= entry->de_csum_type;
+	ent_df->de_csum_len	= entry->de_csum_len;
+	ent_df->de_refs		= 1;
+	memcpy(ent_df->de_csum, entry->de_csum_buf, entry->de_csum_len);
+
+	/* Keep the replaced entry alive until the transaction ends */
+	if (victim != NULL)
+		d_hash_rec_addref(pool->vp_dedup_hash, &victim->de_link);
+	entry->de_slot = slot;
+	entry->de_victim = victim;
+	entry->de_evict = evict;
+	entry->de_pending = 1;
+	pool->vp_dedup_ents[slot] = entry;
+
+	rc = umem_tx_add_callback(umm, vos_txd_get(), TX_STAGE_ONCOMMIT,
+				  dedup_entry_commit_cb, entry);
+	if (rc == 0) {
+		D_DEBUG(DB_IO, "Write dedup entry to slot %d\n", slot);
+		return 0;
 	}
+
+	/* The update fails, so the slot will be rolled back */
+	pool->vp_dedup_ents[slot] = victim;
+	if (victim != NULL)
+		d_hash_rec_decref(pool->vp_dedup_hash, &victim->de_link);
+failed:
+	dedup_entry_free(entry);
+	return rc;
 }
 
 static void
@@ -521,7 +1062,6 @@ vos_ioc_reserve_fini(struct vos_io_context *ioc)
 	}
 
 	D_ASSERT(d_list_empty(&ioc->ic_blk_exts));
-	D_ASSERT(d_list_empty(&ioc->ic_dedup_entries));
 	D_FREE(ioc->ic_umoffs);
 }
 
@@ -649,7 +1189,6 @@ vos_ioc_create(daos_handle_t coh, daos_unit_oid_t oid, bool read_only,
 	vos_ilog_fetch_init(&ioc->ic_akey_info);
 	D_INIT_LIST_HEAD(&ioc->ic_blk_exts);
 	ioc->ic_shadows = shadows;
-	D_INIT_LIST_HEAD(&ioc->ic_dedup_entries);
 
 	rc = vos_ioc_reserve_init(ioc, dth);
 	if (rc != 0)
@@ -999,8 +1538,17 @@ akey_fetch_recx(daos_handle_t toh, const daos_epoch_range_t *epr,
 			if (rc != 0)
 				goto failed;
 		}
-		bio_iov_set(&biov, ent->en_addr, nr * inob);
 		ioc->ic_io_size += nr * inob;
+		if (BIO_ADDR_IS_COMPRESSED(&ent->en_addr)) {
+			/* Aggregation never compresses extents with checksum */
+			D_ASSERT(!ci_is_valid(&ent->en_csum));
+			bio_iov_set_compressed(&biov, ent->en_addr,
+					       (lo - ent->en_ext.ex_lo) * inob, nr * inob,
+					       evt_extent_width(&ent->en_ext) * inob);
+			goto fetch;
+		}
+
+		bio_iov_set(&biov, ent->en_addr, nr * inob);
 		if (ci_is_valid(&ent->en_csum)) {
 			rc = save_csum(ioc, &ent->en_csum, ent, rsize);
 			if (rc != 0)
@@ -1013,7 +1561,7 @@ akey_fetch_recx(daos_handle_t toh, const daos_epoch_range_t *epr,
 				D_ERROR("Checksum found in some entries, "
 					"but not all\n");
 		}
-
+fetch:
 		rc = iod_fetch(ioc, &biov);
 		if (rc != 0)
 			goto failed;
@@ -1637,13 +2185,19 @@ akey_update_recx(daos_handle_t toh, uint32_t pm_ver, daos_recx_t *recx,
 	if (ioc->ic_remove)
 		return evt_remove_all(toh, &ent.ei_rect.rc_ex, &ioc->ic_epr);
 
+	/* The record shares an extent found in the dedup index */
+	if (BIO_ADDR_IS_DEDUP(&biov->bi_addr)) {
+		rc = vos_dedup_ref(vos_cont2pool(ioc->ic_cont), &biov->bi_addr);
+		if (rc)
+			return rc;
+	}
+
 	rc = evt_insert(toh, &ent, NULL);
 
 	if (ioc->ic_dedup && !rc && (rsize * recx->rx_nr) >= ioc->ic_dedup_th) {
 		daos_size_t csum_len = recx_csum_len(recx, csum, rsize);
 
-		vos_dedup_update(vos_cont2pool(ioc->ic_cont), csum, csum_len,
-				 biov, &ioc->ic_dedup_entries);
+		rc = vos_dedup_update(vos_cont2pool(ioc->ic_cont), csum, csum_len, biov);
 	}
 	return rc;
 }
@@ -2142,6 +2696,7 @@ vos_reserve_recx(struct vos_io_context *ioc, uint16_t media, daos_size_t size,
 	}
 
 	if (ioc->ic_dedup && size >= ioc->ic_dedup_th &&
+	    vos_dedup_index_get(vos_cont2pool(ioc->ic_cont)) &&
 	    vos_dedup_lookup(vos_cont2pool(ioc->ic_cont), csum, csum_len,
 			     &biov)) {
 		if (biov.bi_data_len == size) {
@@ -2295,10 +2850,6 @@ update_cancel(struct vos_io_context *ioc)
 				umem_free(umem, ioc->ic_umoffs[i]);
 		}
 	}
-
-	/* Abort dedup entries */
-	vos_dedup_process(vos_cont2pool(ioc->ic_cont), &ioc->ic_dedup_entries,
-			  true /* abort */);
 }
 
 int
@@ -2361,6 +2912,9 @@ vos_update_end(daos_handle_t ioh, uint32_t pm_ver, daos_key_t *dkey, int err,
 		goto abort;
 	}
 
+	if (DAOS_FAIL_CHECK(DAOS_VOS_UPDATE_ABORT))
+		D_GOTO(abort, err = -DER_IO);
+
 	/** Now that we are past the existence checks, ensure there isn't a
 	 * read conflict
 	 */
@@ -2400,8 +2954,6 @@ abort:
 					    false, false);
 			dth->dth_cos_done = 1;
 		}
-		vos_dedup_process(vos_cont2pool(ioc->ic_cont),
-				  &ioc->ic_dedup_entries, false);
 	} else if (daes != NULL) {
 		vos_dtx_post_handle(ioc->ic_cont, daes, dces,
 				    dth->dth_dti_cos_count, false, true);
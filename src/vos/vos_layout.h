@@ -99,7 +99,7 @@ enum vos_gc_type {
  */
 
 /** Current durable format version */
-#define POOL_DF_VERSION                         VOS_POOL_DF_2_4
+#define POOL_DF_VERSION                         VOS_POOL_DF_2_6
 
 /** 2.2 features */
 #define VOS_POOL_FEAT_2_2                       (VOS_POOL_FEAT_AGG_OPT)
@@ -107,6 +107,54 @@ enum vos_gc_type {
 /** 2.4 features */
 #define VOS_POOL_FEAT_2_4                       (VOS_POOL_FEAT_CHK | VOS_POOL_FEAT_DYN_ROOT)
 
+/** 2.6 features */
+#define VOS_POOL_FEAT_2_6                       (VOS_POOL_FEAT_COMPRESS | VOS_POOL_FEAT_DEDUP_REFS)
+
+/** Max checksum bytes of an extent which can be kept in the dedup index */
+#define VOS_DEDUP_CSUM_MAX			64
+
+/** Durable format of one slot of the dedup index */
+struct vos_dedup_ent_df {
+	/** Address of the extent being referenced by deduplicated records */
+	bio_addr_t				de_addr;
+	/** Data length of the extent */
+	uint64_t				de_data_len;
+	/** Checksum type */
+	uint16_t				de_csum_type;
+	/** Length of the checksums, 0 for an unused slot */
+	uint16_t				de_csum_len;
+	/** Number of records sharing the extent, 0 is taken as 1 */
+	uint32_t				de_refs;
+	/** Checksums of the extent, used as the fingerprint */
+	uint8_t					de_csum[VOS_DEDUP_CSUM_MAX];
+};
+
+#define VOS_DEDUP_DF_MAGIC			0xdedf0001
+
+/** Durable format of the space-bounded dedup index, rooted at vos_pool_df::pd_dedup */
+struct vos_dedup_df {
+	uint32_t				dd_magic;
+	/** Number of slots in dd_ents */
+	uint32_t				dd_slots;
+	struct vos_dedup_ent_df			dd_ents[0];
+};
+
+#define VOS_SCRUB_DF_MAGIC			0x5c2b0001
+
+/**
+ * Durable position of the checksum scrubber, rooted at vos_pool_df::pd_scrub.
+ * Scrubbing resumes from the object after sd_oid in container sd_cont after
+ * engine restart.
+ */
+struct vos_scrub_df {
+	uint32_t				sd_magic;
+	/** Non-zero if a scrubbing pass is in progress */
+	uint32_t				sd_active;
+	uuid_t					sd_cont;
+	/** Last object whose values have all been scrubbed */
+	daos_unit_oid_t				sd_oid;
+};
+
 /**
  * Durable format for VOS pool
  */
@@ -124,8 +172,8 @@ struct vos_pool_df {
 	 * a new format, containers with old format can be attached at here.
 	 */
 	uint64_t				pd_reserv_upgrade;
-	/** Reserved for future usage */
-	uint64_t				pd_reserv;
+	/** offset of the scrubber cursor, see vos_scrub_df */
+	umem_off_t				pd_scrub;
 	/** Unique PoolID for each VOS pool assigned on creation */
 	uuid_t					pd_id;
 	/** Total space in bytes on SCM */
@@ -134,7 +182,11 @@ struct vos_pool_df {
 	uint64_t				pd_nvme_sz;
 	/** # of containers in this pool */
 	uint64_t				pd_cont_nr;
-	/** offset for the btree of the dedup table (placeholder) */
+	/**
+	 * offset of the dedup index, see vos_dedup_df. It's only created for
+	 * pools with VOS_POOL_FEAT_DEDUP_REFS, since the index carries the
+	 * reference counts of the shared extents.
+	 */
 	umem_off_t				pd_dedup;
 	/** Typed PMEMoid pointer for the container index table */
 	struct btr_root				pd_cont_root;
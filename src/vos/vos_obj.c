@@ -1577,6 +1577,24 @@ recx_iter_copy(struct vos_obj_iter *oiter, vos_iter_entry_t *it_entry,
 	bioc = oiter->it_obj->obj_cont->vc_pool->vp_io_ctxt;
 	D_ASSERT(bioc != NULL);
 
+	if (BIO_ADDR_IS_COMPRESSED(&biov->bi_addr)) {
+		struct bio_sglist	bsgl;
+		struct bio_iov		biov_c;
+		d_sg_list_t		sgl;
+		daos_size_t		rsize = it_entry->ie_rsize;
+
+		bio_iov_set_compressed(&biov_c, biov->bi_addr,
+				       (it_entry->ie_recx.rx_idx - it_entry->ie_orig_recx.rx_idx) *
+				       rsize, bio_iov2len(biov), it_entry->ie_orig_recx.rx_nr * rsize);
+		bsgl.bs_iovs = &biov_c;
+		bsgl.bs_nr = bsgl.bs_nr_out = 1;
+		sgl.sg_iovs = iov_out;
+		sgl.sg_nr = 1;
+		sgl.sg_nr_out = 0;
+
+		return bio_readv(bioc, &bsgl, &sgl);
+	}
+
 	return bio_read(bioc, biov->bi_addr, iov_out);
 }
 
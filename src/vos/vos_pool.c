@@ -158,6 +158,7 @@ pool_hop_free(struct d_ulink *hlink)
 		vos_pmemobj_close(pool->vp_uma.uma_pool);
 
 	vos_dedup_fini(pool);
+	D_FREE(pool->vp_gc_frees);
 
 	if (pool->vp_dying)
 		vos_delete_blob(pool->vp_id);
@@ -694,6 +695,11 @@ pool_open(PMEMobjpool *ph, struct vos_pool_df *pool_df, unsigned int flags, void
 	if (rc)
 		goto failed;
 
+	pool->vp_pool_df = pool_df;
+	rc = vos_dedup_load(pool);
+	if (rc)
+		goto failed;
+
 	/* Insert the opened pool to the uuid hash table */
 	uuid_copy(ukey.uuid, pool_df->pd_id);
 	rc = pool_link(pool, &ukey, poh);
@@ -703,7 +709,6 @@ pool_open(PMEMobjpool *ph, struct vos_pool_df *pool_df, unsigned int flags, void
 	}
 
 	pool->vp_dtx_committed_count = 0;
-	pool->vp_pool_df = pool_df;
 	pool->vp_opened = 1;
 	pool->vp_excl = !!(flags & VOS_POF_EXCL);
 	pool->vp_small = !!(flags & VOS_POF_SMALL);
@@ -711,6 +716,8 @@ pool_open(PMEMobjpool *ph, struct vos_pool_df *pool_df, unsigned int flags, void
 		pool->vp_feats |= VOS_POOL_FEAT_2_2;
 	if (pool_df->pd_version >= VOS_POOL_DF_2_4)
 		pool->vp_feats |= VOS_POOL_FEAT_2_4;
+	if (pool_df->pd_version >= VOS_POOL_DF_2_6)
+		pool->vp_feats |= VOS_POOL_FEAT_2_6;
 
 	vos_space_sys_init(pool);
 	/* Ensure GC is triggered after server restart */
@@ -837,10 +844,11 @@ vos_pool_upgrade(daos_handle_t poh, uint32_t version)
 
 	pool_df = pool->vp_pool_df;
 
-	if (version == pool_df->pd_version)
+	/* Pools created with a newer format, e.g. VOS_POOL_DF_2_6, are kept as is */
+	if (version <= pool_df->pd_version)
 		return 0;
 
-	D_ASSERTF(version > pool_df->pd_version && version <= POOL_DF_VERSION,
+	D_ASSERTF(version <= POOL_DF_VERSION,
 		  "Invalid pool upgrade version %d, current version is %d\n", version,
 		  pool_df->pd_version);
 
@@ -864,6 +872,8 @@ end:
 		pool->vp_feats |= VOS_POOL_FEAT_2_2;
 	if (version >= VOS_POOL_DF_2_4)
 		pool->vp_feats |= VOS_POOL_FEAT_2_4;
+	if (version >= VOS_POOL_DF_2_6)
+		pool->vp_feats |= VOS_POOL_FEAT_2_6;
 
 	return 0;
 }
@@ -21,10 +21,73 @@
 #define m_inc_counter(m) d_tm_inc_counter((m), 1)
 #define m_reset_counter(m) d_tm_set_counter((m), 0)
 
+/* Max number of values read & verified together */
+#define SC_BATCH_MAX_NR		64
+/* Bounds of the (latency adaptive) amount of data read by one batch */
+#define SC_BATCH_MIN_SIZE	(64UL << 10)
+#define SC_BATCH_MAX_SIZE	(4UL << 20)
+#define SC_BATCH_DEF_SIZE	(1UL << 20)
+/* Scheduler cycle latency (in micro-seconds) above which the scrubber backs off */
+#define SC_LAT_TARGET_US	2000
+#define SC_LAT_SLEEP_MAX_MS	100
+/* Bounds of the backoff while waiting for an idle engine in lazy mode */
+#define SC_BUSY_WAIT_MIN_MS	10
+#define SC_BUSY_WAIT_MAX_MS	1000
+/* How often (in seconds) the scrubbing position is persisted */
+#define SC_CURSOR_INTVL		5
+
+/** A value queued for verification */
+struct scrub_ent {
+	/* Position of the value within the akey, to find it again for marking corrupted */
+	daos_anchor_t		 se_anchor;
+	struct bio_iov		 se_biov;
+	daos_recx_t		 se_recx;
+	daos_epoch_t		 se_epoch;
+	daos_size_t		 se_rsize;
+	daos_size_t		 se_len;
+	/* cs_csum is set to the copy in scrub_batch::sb_csums when verifying */
+	struct dcs_csum_info	 se_csum;
+	uint32_t		 se_csum_off;
+	uint16_t		 se_minor_epc;
+};
+
+/**
+ * Values of the same akey which are read with a single bio_readv() and
+ * verified with a single multi-buffer checksum calculation.
+ */
+struct scrub_batch {
+	/* Iterator param of the values, ip_ih is the akey iterator */
+	vos_iter_param_t	 sb_param;
+	vos_iter_type_t		 sb_type;
+	uint32_t		 sb_nr;
+	daos_size_t		 sb_bytes;
+	daos_size_t		 sb_max_bytes;
+	struct scrub_ent	 sb_ents[SC_BATCH_MAX_NR];
+	struct bio_iov		 sb_biovs[SC_BATCH_MAX_NR];
+	/* Copy of the stored checksums of all the values */
+	uint8_t			*sb_csums;
+	uint32_t		 sb_csums_len;
+	uint32_t		 sb_csums_size;
+	/* Data buffer */
+	uint8_t			*sb_data;
+	daos_size_t		 sb_data_size;
+	/* Per chunk buffers and checksums for daos_csummer_calc_bufs() */
+	uint8_t			**sb_bufs;
+	uint32_t		*sb_buf_lens;
+	uint8_t			**sb_hashes;
+	uint8_t			*sb_hash_buf;
+	uint32_t		 sb_chunks_size;
+	/* Position to resume the pass from, loaded from vos_scrub_df */
+	uuid_t			 sb_resume_cont;
+	daos_unit_oid_t		 sb_resume_oid;
+	uint64_t		 sb_cursor_ts;
+	bool			 sb_resume;
+};
+
 static inline void
-sc_csum_calc_inc(struct scrub_ctx *ctx)
+sc_csum_calc_inc(struct scrub_ctx *ctx, uint32_t nr)
 {
-	ctx->sc_pool_csum_calcs++;
+	ctx->sc_pool_csum_calcs += nr;
 }
 
 static inline void
@@ -77,10 +140,10 @@ sc_m_pool_stop(struct scrub_ctx *ctx)
 }
 
 static void
-sc_m_pool_csum_inc(struct scrub_ctx *ctx)
+sc_m_pool_csum_inc(struct scrub_ctx *ctx, uint32_t nr)
 {
-	m_inc_counter(ctx->sc_metrics.scm_csum_calcs);
-	m_inc_counter(ctx->sc_metrics.scm_csum_calcs_total);
+	d_tm_inc_counter(ctx->sc_metrics.scm_csum_calcs, nr);
+	d_tm_inc_counter(ctx->sc_metrics.scm_csum_calcs_total, nr);
 }
 
 static void
@@ -104,10 +167,9 @@ sc_csummer(const struct scrub_ctx *ctx)
 }
 
 static inline uint32_t
-sc_chunksize(const struct scrub_ctx *ctx)
+sc_chunksize(const struct scrub_ctx *ctx, daos_size_t rsize)
 {
-	return daos_csummer_get_rec_chunksize(sc_csummer(ctx),
-					      ctx->sc_iod.iod_size);
+	return daos_csummer_get_rec_chunksize(sc_csummer(ctx), rsize);
 }
 
 static inline int
@@ -248,26 +310,6 @@ sc_should_start(struct scrub_ctx *ctx)
 	return false;
 }
 
-/**
- * Get the number of records in the chunk at index 'i' of the current recx
- * set within the scrubbing context
- */
-static daos_size_t
-sc_get_rec_in_chunk_at_idx(const struct scrub_ctx *ctx, uint32_t i)
-{
-	daos_recx_t		*recx;
-	daos_size_t		 rec_len;
-	uint32_t		 chunksize;
-	struct daos_csum_range	 range;
-
-	recx = &ctx->sc_iod.iod_recxs[0];
-	rec_len = ctx->sc_iod.iod_size;
-	chunksize = sc_chunksize(ctx);
-	range = csum_recx_chunkidx2range(recx, rec_len, chunksize, i);
-
-	return range.dcr_nr;
-}
-
 static void
 sc_wait_until_should_continue(struct scrub_ctx *ctx)
 {
@@ -282,13 +324,16 @@ sc_wait_until_should_continue(struct scrub_ctx *ctx)
 			sc_sleep(ctx, min(1000, msec_between));
 		}
 	} else if (sc_mode(ctx) == DAOS_SCRUB_MODE_LAZY) {
+		uint32_t	wait_ms = SC_BUSY_WAIT_MIN_MS;
+
 		sc_sleep(ctx, 0);
 		while (!ctx->sc_is_idle_fn()) {
 			sc_m_track_busy(ctx);
-			/* Don't actually know how long it will be but wait for 1 second before
-			 * trying again
+			/* Don't actually know how long it will be, so back off exponentially
+			 * up to 1 second before trying again
 			 */
-			sc_sleep(ctx, 1000);
+			sc_sleep(ctx, wait_ms);
+			wait_ms = min(wait_ms * 2, SC_BUSY_WAIT_MAX_MS);
 		}
 		sc_m_track_idle(ctx);
 	} else {
@@ -296,14 +341,39 @@ sc_wait_until_should_continue(struct scrub_ctx *ctx)
 	}
 }
 
+/** Account for \a nr checksum calculations then pace the scrubber */
 static void
-sc_verify_finish(struct scrub_ctx *ctx)
+sc_verify_finish_nr(struct scrub_ctx *ctx, uint32_t nr)
 {
-	sc_csum_calc_inc(ctx);
-	sc_m_pool_csum_inc(ctx);
+	sc_csum_calc_inc(ctx, nr);
+	sc_m_pool_csum_inc(ctx, nr);
 	sc_wait_until_should_continue(ctx);
 }
 
+/**
+ * Additive increase / multiplicative decrease of the batch size against the
+ * I/O latency seen by the scheduler, so that the scrubber backs off when the
+ * engine is loaded instead of sleeping a fixed amount of time.
+ */
+static void
+sc_batch_throttle(struct scrub_ctx *ctx)
+{
+	struct scrub_batch	*sb = ctx->sc_batch;
+	uint64_t		 lat;
+
+	if (ctx->sc_io_lat_fn == NULL)
+		return;
+
+	lat = ctx->sc_io_lat_fn();
+	if (lat > SC_LAT_TARGET_US) {
+		sb->sb_max_bytes = max(sb->sb_max_bytes / 2, SC_BATCH_MIN_SIZE);
+		C_TRACE("I/O latency "DF_U64" us, batch size "DF_U64"\n", lat, sb->sb_max_bytes);
+		sc_sleep(ctx, min(max(lat / 1000, 1), SC_LAT_SLEEP_MAX_MS));
+	} else {
+		sb->sb_max_bytes = min(sb->sb_max_bytes + SC_BATCH_MIN_SIZE, SC_BATCH_MAX_SIZE);
+	}
+}
+
 static void
 sc_raise_ras(struct scrub_ctx *ctx)
 {
@@ -317,11 +387,54 @@ sc_raise_ras(struct scrub_ctx *ctx)
 	}
 }
 
+static bool
+sc_ent_is_same(struct scrub_batch *sb, struct scrub_ent *ent, vos_iter_entry_t *entry)
+{
+	if (sb->sb_type == VOS_ITER_RECX &&
+	    (ent->se_recx.rx_idx != entry->ie_recx.rx_idx ||
+	     ent->se_recx.rx_nr != entry->ie_recx.rx_nr))
+		return false;
+	return ent->se_epoch == entry->ie_epoch && ent->se_minor_epc == entry->ie_minor_epc;
+}
+
+/**
+ * The value has been verified after the iterator moved on, so find it again
+ * from its anchor before marking it corrupted.
+ *
+ * \return	0 if marked, 1 if the value no longer exists, negative on error
+ */
 static int
-sc_mark_corrupt(struct scrub_ctx *ctx)
+sc_mark_corrupt(struct scrub_batch *sb, struct scrub_ent *ent)
 {
-	return vos_iter_process(ctx->sc_vos_iter_handle,
-				VOS_ITER_PROC_OP_MARK_CORRUPT, NULL);
+	vos_iter_entry_t	entry;
+	daos_anchor_t		anchor = ent->se_anchor;
+	daos_handle_t		ih;
+	int			rc;
+
+	/* Make sure the akey is still there if anything happened during a yield */
+	rc = vos_iter_validate(sb->sb_param.ip_ih);
+	if (rc != 0)
+		return rc;
+
+	rc = vos_iter_prepare(sb->sb_type, &sb->sb_param, &ih, NULL);
+	if (rc != 0)
+		return rc == -DER_NONEXIST ? 1 : rc;
+
+	rc = vos_iter_probe(ih, &anchor);
+	if (rc == 0)
+		rc = vos_iter_fetch(ih, &entry, &anchor);
+	if (rc == -DER_NONEXIST)
+		D_GOTO(out, rc = 1);
+	if (rc != 0)
+		goto out;
+
+	if (!sc_ent_is_same(sb, ent, &entry))
+		D_GOTO(out, rc = 1);
+
+	rc = vos_iter_process(ih, VOS_ITER_PROC_OP_MARK_CORRUPT, NULL);
+out:
+	vos_iter_finish(ih);
+	return rc;
 }
 
 static int
@@ -354,26 +467,25 @@ sc_is_first_pass(struct scrub_ctx *ctx)
 }
 
 static int
-sc_handle_corruption(struct scrub_ctx *ctx)
+sc_handle_corruption(struct scrub_ctx *ctx, struct scrub_ent *ent)
 {
 	int rc;
 
 	/** It's ok if we do the checksum calculation after a yield, hoping for the best, but we
-	 *  absolutely must check before modifying data at the current iterator position.  If the
-	 *  entry has been deleted, we can ignore any corruption we found and move on.
+	 *  absolutely must check before modifying the value.  If the entry has been deleted, we
+	 *  can ignore any corruption we found and move on.
 	 */
-	rc = vos_iter_validate(ctx->sc_vos_iter_handle);
-	if (rc < 0)
-		return rc;
+	rc = sc_mark_corrupt(ctx->sc_batch, ent);
 	if (rc > 0) /** value no longer exists */
 		return 0;
 
 	sc_raise_ras(ctx);
 	sc_m_pool_corr_inc(ctx);
-	rc = sc_mark_corrupt(ctx);
 
+	ctx->sc_cur_biov = &ent->se_biov;
 	if (sc_is_nvme(ctx))
 		bio_log_csum_err(ctx->sc_dmi->dmi_nvme_ctxt);
+	ctx->sc_cur_biov = NULL;
 	if (rc != 0) {
 		/* Log error but don't let it stop the scrubbing process */
 		D_ERROR("Error trying to mark corrupt: "DF_RC"\n", DP_RC(rc));
@@ -399,167 +511,429 @@ sc_handle_corruption(struct scrub_ctx *ctx)
 	return rc;
 }
 
-/**
- * Will verify the checksum(s) for the current recx. It will do it one chunk
- * at a time instead of all at once so that it can yield/sleep between each
- * calculation.
- */
 static int
-sc_verify_recx(struct scrub_ctx *ctx, d_iov_t *data)
+sc_batch_init(struct scrub_ctx *ctx)
 {
-	daos_key_t		 chunk_iov = {0};
-	uint8_t			*csum_buf = NULL;
-	daos_recx_t		*recx;
-	daos_size_t		 rec_len;
-	daos_size_t		 processed_bytes = 0;
-	uint32_t		 i;
-	uint32_t		 chunksize;
-	uint32_t		 csum_nr;
-	int			 rc = 0;
-	uint16_t		 csum_len;
+	struct scrub_batch	*sb;
+
+	D_ALLOC_PTR(sb);
+	if (sb == NULL)
+		return -DER_NOMEM;
 
-	D_ASSERT(ctx->sc_iod.iod_nr == 1);
-	D_ASSERT(data != NULL);
-	D_ASSERT(ctx->sc_iod.iod_recxs != NULL);
+	sb->sb_max_bytes = SC_BATCH_DEF_SIZE;
+	ctx->sc_batch = sb;
+	return 0;
+}
 
-	recx = &ctx->sc_iod.iod_recxs[0];
-	rec_len = ctx->sc_iod.iod_size;
-	chunksize = sc_chunksize(ctx);
-	csum_nr = daos_recx_calc_chunks(*recx, rec_len, chunksize);
-	csum_len = daos_csummer_get_csum_len(sc_csummer(ctx));
+static void
+sc_batch_fini(struct scrub_ctx *ctx)
+{
+	struct scrub_batch	*sb = ctx->sc_batch;
 
-	/** Create a buffer to calculate the checksum into */
-	D_ALLOC(csum_buf, csum_len);
+	if (sb == NULL)
+		return;
 
-	/**
-	 * loop through each checksum and chunk of the recx based
-	 * on chunk size.
-	 */
-	for (i = 0; i < csum_nr; i++) {
-		uint8_t		*orig_csum = NULL;
-		bool		 match;
-		daos_size_t	 rec_in_chunk;
+	D_FREE(sb->sb_csums);
+	D_FREE(sb->sb_data);
+	D_FREE(sb->sb_bufs);
+	D_FREE(sb->sb_buf_lens);
+	D_FREE(sb->sb_hashes);
+	D_FREE(sb->sb_hash_buf);
+	D_FREE(sb);
+	ctx->sc_batch = NULL;
+}
 
-		if (sc_cont_is_stopping(ctx))
-			D_GOTO(done, rc = 0);
+static inline void
+sc_batch_reset(struct scrub_batch *sb)
+{
+	sb->sb_nr = 0;
+	sb->sb_bytes = 0;
+	sb->sb_csums_len = 0;
+}
 
-		orig_csum = ci_idx2csum(ctx->sc_csum_to_verify, i);
-		rec_in_chunk = sc_get_rec_in_chunk_at_idx(ctx, i);
+/** Number of checksum chunks of a queued value */
+static uint32_t
+sc_ent_chunks(struct scrub_ctx *ctx, struct scrub_batch *sb, struct scrub_ent *ent)
+{
+	if (sb->sb_type != VOS_ITER_RECX)
+		return 1;
 
-		/** set an iov with just the data for the current chunk */
-		d_iov_set(&chunk_iov, data->iov_buf + processed_bytes,
-			  rec_in_chunk * rec_len);
-		D_ASSERT(processed_bytes + chunk_iov.iov_len <= data->iov_len);
+	return daos_recx_calc_chunks(ent->se_recx, ent->se_rsize,
+				     sc_chunksize(ctx, ent->se_rsize));
+}
 
-		rc = daos_csummer_calc_for_iov(sc_csummer(ctx), &chunk_iov, csum_buf, csum_len);
-		if (rc != 0) {
-			D_ERROR("daos_csummer_calc_for_iov error: "DF_RC"\n", DP_RC(rc));
-			D_GOTO(done, rc);
-		}
+static int
+sc_batch_buf_prep(struct scrub_batch *sb, uint32_t chunks, uint16_t csum_len)
+{
+	if (sb->sb_data_size < sb->sb_bytes) {
+		D_FREE(sb->sb_data);
+		sb->sb_data_size = 0;
+		D_ALLOC_NZ(sb->sb_data, sb->sb_bytes);
+		if (sb->sb_data == NULL)
+			return -DER_NOMEM;
+		sb->sb_data_size = sb->sb_bytes;
+	}
 
-		sc_scrub_bytes_scrubbed(ctx, chunk_iov.iov_len);
+	if (sb->sb_chunks_size >= chunks)
+		return 0;
 
-		match = daos_csummer_csum_compare(sc_csummer(ctx), orig_csum, csum_buf, csum_len);
+	D_FREE(sb->sb_bufs);
+	D_FREE(sb->sb_buf_lens);
+	D_FREE(sb->sb_hashes);
+	D_FREE(sb->sb_hash_buf);
+	sb->sb_chunks_size = 0;
+
+	D_ALLOC_ARRAY(sb->sb_bufs, chunks);
+	D_ALLOC_ARRAY(sb->sb_buf_lens, chunks);
+	D_ALLOC_ARRAY(sb->sb_hashes, chunks);
+	D_ALLOC(sb->sb_hash_buf, chunks * csum_len);
+	if (sb->sb_bufs == NULL || sb->sb_buf_lens == NULL || sb->sb_hashes == NULL ||
+	    sb->sb_hash_buf == NULL)
+		return -DER_NOMEM;
+	sb->sb_chunks_size = chunks;
 
-		if (!match) {
-			D_ERROR("Corruption found for chunk #%d of recx: "DF_RECX", epoch: %lu\n",
-				i, DP_RECX(*recx), ctx->sc_epoch);
+	return 0;
+}
 
-			rc = sc_handle_corruption(ctx);
+/** Read the data of all the queued values with one bio request */
+static int
+sc_batch_read(struct scrub_ctx *ctx, struct scrub_batch *sb)
+{
+	struct vos_pool		*pool = vos_hdl2pool(ctx->sc_vos_pool_hdl);
+	struct bio_sglist	 bsgl;
+	d_sg_list_t		 sgl;
+	d_iov_t			 iov;
+	uint32_t		 i;
 
-			sc_verify_finish(ctx);
+	for (i = 0; i < sb->sb_nr; i++)
+		sb->sb_biovs[i] = sb->sb_ents[i].se_biov;
 
-			D_GOTO(done, rc);
-		}
+	bsgl.bs_iovs = sb->sb_biovs;
+	bsgl.bs_nr = bsgl.bs_nr_out = sb->sb_nr;
+
+	d_iov_set(&iov, sb->sb_data, sb->sb_bytes);
+	sgl.sg_iovs = &iov;
+	sgl.sg_nr = 1;
+	sgl.sg_nr_out = 0;
+
+	return bio_readv(pool->vp_io_ctxt, &bsgl, &sgl);
+}
+
+/**
+ * Calculate the checksums of all the chunks of the queued values at once so
+ * the checksum algorithm can work on multiple buffers in parallel.
+ */
+static int
+sc_batch_calc(struct scrub_ctx *ctx, struct scrub_batch *sb, uint32_t *chunks_nr)
+{
+	struct daos_csummer	*csummer = sc_csummer(ctx);
+	uint16_t		 csum_len = daos_csummer_get_csum_len(csummer);
+	uint8_t			*data = sb->sb_data;
+	uint32_t		 chunks = 0;
+	uint32_t		 nr = 0;
+	uint32_t		 i, j;
+	int			 rc;
+
+	for (i = 0; i < sb->sb_nr; i++)
+		chunks += sc_ent_chunks(ctx, sb, &sb->sb_ents[i]);
+
+	rc = sc_batch_buf_prep(sb, chunks, csum_len);
+	if (rc != 0)
+		return rc;
+
+	rc = sc_batch_read(ctx, sb);
+	if (rc != 0) {
+		D_WARN("Unable to fetch data for scrubber: "DF_RC"\n", DP_RC(rc));
+		return rc;
+	}
+
+	for (i = 0; i < sb->sb_nr; i++) {
+		struct scrub_ent	*ent = &sb->sb_ents[i];
+		uint32_t		 ent_chunks = sc_ent_chunks(ctx, sb, ent);
+		daos_size_t		 processed = 0;
 
-		processed_bytes += chunk_iov.iov_len;
+		for (j = 0; j < ent_chunks; j++, nr++) {
+			daos_size_t		chunk_len = ent->se_len;
+			struct daos_csum_range	range;
 
-		sc_verify_finish(ctx);
+			if (sb->sb_type == VOS_ITER_RECX) {
+				range = csum_recx_chunkidx2range(&ent->se_recx, ent->se_rsize,
+								 sc_chunksize(ctx, ent->se_rsize),
+								 j);
+				chunk_len = range.dcr_nr * ent->se_rsize;
+			}
+			D_ASSERT(processed + chunk_len <= ent->se_len);
+
+			sb->sb_bufs[nr] = data + processed;
+			sb->sb_buf_lens[nr] = chunk_len;
+			sb->sb_hashes[nr] = sb->sb_hash_buf + nr * csum_len;
+			processed += chunk_len;
+		}
+		data += ent->se_len;
 	}
+	D_ASSERT(nr == chunks);
 
-done:
-	D_FREE(csum_buf);
+	D_MUTEX_LOCK(&csummer->dcs_lock);
+	rc = daos_csummer_calc_bufs(csummer, sb->sb_bufs, sb->sb_buf_lens, sb->sb_hashes, nr);
+	D_MUTEX_UNLOCK(&csummer->dcs_lock);
+	if (rc != 0) {
+		D_ERROR("daos_csummer_calc_bufs error: "DF_RC"\n", DP_RC(rc));
+		return rc;
+	}
 
-	return rc;
+	*chunks_nr = nr;
+	return 0;
 }
 
+/**
+ * Verify all the queued values, then pace the scrubber once for the whole
+ * batch instead of after every chunk.
+ */
 static int
-sc_verify_sv(struct scrub_ctx *ctx, d_iov_t *data)
+sc_batch_flush(struct scrub_ctx *ctx)
 {
-	int rc;
+	struct scrub_batch	*sb = ctx->sc_batch;
+	struct daos_csummer	*csummer = sc_csummer(ctx);
+	uint16_t		 csum_len = daos_csummer_get_csum_len(csummer);
+	uint32_t		 chunks_nr = 0;
+	uint32_t		 nr = 0;
+	uint32_t		 i, j;
+	int			 rc;
 
-	if (sc_cont_is_stopping(ctx))
+	if (sb->sb_nr == 0)
 		return 0;
 
-	rc = daos_csummer_verify_key(sc_csummer(ctx), data, ctx->sc_csum_to_verify);
-	if (rc == -DER_CSUM)
-		rc = sc_handle_corruption(ctx);
-	sc_verify_finish(ctx);
+	if (sc_cont_is_stopping(ctx))
+		D_GOTO(out, rc = 0);
+
+	rc = sc_batch_calc(ctx, sb, &chunks_nr);
+	if (rc != 0)
+		goto out;
+
+	for (i = 0; i < sb->sb_nr; i++) {
+		struct scrub_ent	*ent = &sb->sb_ents[i];
+		uint32_t		 ent_chunks = sc_ent_chunks(ctx, sb, ent);
+		bool			 match = true;
+
+		ent->se_csum.cs_csum = sb->sb_csums + ent->se_csum_off;
+		for (j = 0; j < ent_chunks; j++) {
+			if (!ci_is_valid(&ent->se_csum) || j >= ent->se_csum.cs_nr) {
+				match = false;
+				break;
+			}
+			match = daos_csummer_csum_compare(csummer, ci_idx2csum(&ent->se_csum, j),
+							  sb->sb_hashes[nr + j], csum_len);
+			if (!match)
+				break;
+		}
+		nr += ent_chunks;
+		sc_scrub_bytes_scrubbed(ctx, ent->se_len);
 
-	sc_scrub_bytes_scrubbed(ctx, data->iov_len);
+		if (match)
+			continue;
+
+		if (sb->sb_type == VOS_ITER_RECX)
+			D_ERROR("Corruption found for chunk #%u of recx: "DF_RECX", epoch: "
+				DF_U64"\n", j, DP_RECX(ent->se_recx), ent->se_epoch);
+		else
+			D_ERROR("Corruption found for single value, epoch: "DF_U64"\n",
+				ent->se_epoch);
+
+		rc = sc_handle_corruption(ctx, ent);
+		if (rc != 0)
+			break;
+	}
 
+	sc_verify_finish_nr(ctx, chunks_nr);
+	sc_batch_throttle(ctx);
+out:
+	if (rc != 0)
+		D_ERROR("Error while scrubbing: "DF_RC"\n", DP_RC(rc));
+	sc_batch_reset(sb);
 	return rc;
 }
 
+/** Queue the value for verification, the batch is verified once it's full */
 static int
-sc_verify_obj_value(struct scrub_ctx *ctx, struct bio_iov *biov, daos_handle_t ih)
-{
-	d_iov_t			 data;
-	daos_iod_t		*iod = &ctx->sc_iod;
-	uint64_t		 data_len;
-	struct bio_io_context	*bio_ctx;
-	struct vos_iterator	*iter;
-	struct vos_obj_iter	*oiter;
+sc_batch_add(struct scrub_ctx *ctx, daos_handle_t ih, vos_iter_entry_t *entry,
+	     vos_iter_type_t type, vos_iter_param_t *param)
+{
+	struct scrub_batch	*sb = ctx->sc_batch;
+	struct vos_iterator	*iter = vos_hdl2iter(ih);
+	struct dcs_csum_info	*ci = &entry->ie_csum;
+	struct scrub_ent	*ent;
+	bio_addr_t		 addr = entry->ie_biov.bi_addr;
+	daos_size_t		 len;
+	uint32_t		 csum_size = 0;
 	int			 rc;
 
 	/* Don't verify a hole */
-	if (bio_addr_is_hole(&biov->bi_addr))
+	if (bio_addr_is_hole(&addr))
 		return 0;
 
-	/*
-	 * Know that there will always only be 1 recx because verifying a
-	 * single extent at a time so use first recx in iod for data_len
-	 * calculation
-	 */
-	data_len = iod->iod_type == DAOS_IOD_ARRAY ?
-		   iod->iod_recxs[0].rx_nr * iod->iod_size :
-		   iod->iod_size;
-	/* allocate memory to fetch data into */
-	D_ALLOC(data.iov_buf, data_len);
-	data.iov_buf_len = data_len;
-	data.iov_len = data_len;
-
-	/* Fetch data */
-	iter = vos_hdl2iter(ih);
-	oiter = vos_iter2oiter(iter);
-	bio_ctx = oiter->it_obj->obj_cont->vc_pool->vp_io_ctxt;
-	rc = bio_read(bio_ctx, biov->bi_addr, &data);
-
-	if (BIO_ADDR_IS_CORRUPTED(&biov->bi_addr)) {
-		/* Already know this is corrupt so just return */
+	if (BIO_ADDR_IS_CORRUPTED(&addr)) {
+		/* Already know this is corrupt so just skip it */
 		if (sc_is_first_pass(ctx))
 			/* Because metrics aren't persisted across engine resets,
 			 * need to count the number of corrupted records found previously
 			 */
 			d_tm_inc_counter(ctx->sc_metrics.scm_corruption_total, 1);
-		D_GOTO(out, rc = DER_SUCCESS);
-	} else if (rc != 0) {
-		D_WARN("Unable to fetch data for scrubber: "DF_RC"\n", DP_RC(rc));
-		D_GOTO(out, rc);
+		return 0;
 	}
 
-	ctx->sc_cur_biov = biov;
-	rc = iod->iod_type == DAOS_IOD_ARRAY ?
-	     sc_verify_recx(ctx, &data) :
-	     sc_verify_sv(ctx, &data);
-	ctx->sc_cur_biov = NULL;
+	len = type == VOS_ITER_RECX ? entry->ie_recx.rx_nr * entry->ie_rsize : entry->ie_rsize;
+	if (sb->sb_nr > 0 && sb->sb_bytes + len > sb->sb_max_bytes) {
+		rc = sc_batch_flush(ctx);
+		if (rc != 0)
+			return rc;
+	}
+
+	if (ci_is_valid(ci))
+		csum_size = ci->cs_nr * ci->cs_len;
+	if (sb->sb_csums_len + csum_size > sb->sb_csums_size) {
+		uint32_t	 size = max(sb->sb_csums_size * 2, sb->sb_csums_len + csum_size);
+		uint8_t		*buf;
+
+		D_REALLOC_NZ(buf, sb->sb_csums, size);
+		if (buf == NULL)
+			return -DER_NOMEM;
+		sb->sb_csums = buf;
+		sb->sb_csums_size = size;
+	}
+
+	/* A batch only holds values of the same akey */
+	if (sb->sb_nr == 0) {
+		sb->sb_param = *param;
+		sb->sb_type = type;
+	}
+
+	ent = &sb->sb_ents[sb->sb_nr];
+	ent->se_anchor = type == VOS_ITER_RECX ? iter->it_anchors->ia_ev :
+			 iter->it_anchors->ia_sv;
+	ent->se_recx = entry->ie_recx;
+	ent->se_epoch = entry->ie_epoch;
+	ent->se_minor_epc = entry->ie_minor_epc;
+	ent->se_rsize = entry->ie_rsize;
+	ent->se_len = len;
+	if (BIO_ADDR_IS_COMPRESSED(&addr))
+		bio_iov_set_compressed(&ent->se_biov, addr,
+				       (entry->ie_recx.rx_idx - entry->ie_orig_recx.rx_idx) *
+				       entry->ie_rsize, len,
+				       entry->ie_orig_recx.rx_nr * entry->ie_rsize);
+	else
+		bio_iov_set(&ent->se_biov, addr, len);
+
+	ent->se_csum = *ci;
+	ent->se_csum.cs_csum = NULL;
+	ent->se_csum_off = sb->sb_csums_len;
+	if (csum_size > 0)
+		memcpy(sb->sb_csums + sb->sb_csums_len, ci->cs_csum, csum_size);
+	sb->sb_csums_len += csum_size;
+
+	sb->sb_nr++;
+	sb->sb_bytes += len;
+	if (sb->sb_nr == SC_BATCH_MAX_NR || sb->sb_bytes >= sb->sb_max_bytes)
+		return sc_batch_flush(ctx);
+
+	return 0;
+}
+
+int
+vos_scrub_cursor_set(daos_handle_t poh, uuid_t cont, daos_unit_oid_t *oid)
+{
+	struct vos_pool		*pool = vos_hdl2pool(poh);
+	struct umem_instance	*umm;
+	struct vos_pool_df	*pool_df;
+	struct vos_scrub_df	*sd_df;
+	umem_off_t		 sd_off;
+	int			 rc;
+
+	if (pool == NULL)
+		return -DER_NO_HDL;
+	umm = vos_pool2umm(pool);
+	pool_df = pool->vp_pool_df;
+
+	/* Nothing to clear */
+	if (oid == NULL && UMOFF_IS_NULL(pool_df->pd_scrub))
+		return 0;
+
+	rc = umem_tx_begin(umm, NULL);
 	if (rc != 0)
-		D_ERROR("Error while scrubbing: "DF_RC"\n", DP_RC(rc));
+		return rc;
 
-out:
-	D_FREE(data.iov_buf);
+	sd_off = pool_df->pd_scrub;
+	if (UMOFF_IS_NULL(sd_off)) {
+		sd_off = umem_zalloc(umm, sizeof(*sd_df));
+		if (UMOFF_IS_NULL(sd_off))
+			D_GOTO(end, rc = -DER_NOSPACE);
 
-	return rc;
+		rc = umem_tx_add_ptr(umm, &pool_df->pd_scrub, sizeof(pool_df->pd_scrub));
+		if (rc != 0)
+			goto end;
+		pool_df->pd_scrub = sd_off;
+		sd_df = umem_off2ptr(umm, sd_off);
+		sd_df->sd_magic = VOS_SCRUB_DF_MAGIC;
+	} else {
+		sd_df = umem_off2ptr(umm, sd_off);
+		rc = umem_tx_add_ptr(umm, sd_df, sizeof(*sd_df));
+		if (rc != 0)
+			goto end;
+	}
+
+	if (oid != NULL) {
+		sd_df->sd_active = 1;
+		uuid_copy(sd_df->sd_cont, cont);
+		sd_df->sd_oid = *oid;
+	} else {
+		sd_df->sd_active = 0;
+	}
+end:
+	return umem_tx_end(umm, rc);
+}
+
+int
+vos_scrub_cursor_get(daos_handle_t poh, uuid_t cont, daos_unit_oid_t *oid)
+{
+	struct vos_pool		*pool = vos_hdl2pool(poh);
+	struct vos_scrub_df	*sd_df;
+
+	if (pool == NULL)
+		return -DER_NO_HDL;
+	if (UMOFF_IS_NULL(pool->vp_pool_df->pd_scrub))
+		return -DER_NONEXIST;
+
+	sd_df = umem_off2ptr(vos_pool2umm(pool), pool->vp_pool_df->pd_scrub);
+	if (sd_df->sd_magic != VOS_SCRUB_DF_MAGIC || !sd_df->sd_active)
+		return -DER_NONEXIST;
+
+	uuid_copy(cont, sd_df->sd_cont);
+	*oid = sd_df->sd_oid;
+	return 0;
+}
+
+static void
+sc_cursor_save(struct scrub_ctx *ctx, daos_unit_oid_t *oid)
+{
+	int	rc;
+
+	rc = vos_scrub_cursor_set(ctx->sc_vos_pool_hdl, *sc_cont_uuid(ctx), oid);
+	if (rc != 0)
+		D_WARN("Failed to save scrubbing position: "DF_RC"\n", DP_RC(rc));
+}
+
+static void
+sc_cursor_load(struct scrub_ctx *ctx)
+{
+	struct scrub_batch	*sb = ctx->sc_batch;
+
+	sb->sb_cursor_ts = daos_gettime_coarse();
+	sb->sb_resume = vos_scrub_cursor_get(ctx->sc_vos_pool_hdl, sb->sb_resume_cont,
+					     &sb->sb_resume_oid) == 0;
+	if (!sb->sb_resume)
+		return;
+
+	C_TRACE("Resume scrubbing after "DF_UOID" of cont "DF_UUID"\n",
+		DP_UOID(sb->sb_resume_oid), DP_UUID(sb->sb_resume_cont));
 }
 
 static void
@@ -579,8 +953,6 @@ sc_obj_val_setup(struct scrub_ctx *ctx, vos_iter_entry_t *entry,
 	ctx->sc_iod.iod_name = param->ip_akey;
 	ctx->sc_iod.iod_recxs = &entry->ie_recx;
 
-	ctx->sc_csum_to_verify = &entry->ie_csum;
-
 	ctx->sc_vos_iter_handle = ih;
 }
 
@@ -590,6 +962,13 @@ oids_are_same(daos_unit_oid_t a, daos_unit_oid_t b)
 	return daos_unit_oid_compare(a, b) == 0;
 }
 
+/* Order of the objects in the object index, see oi_hkey_cmp() */
+static inline int
+sc_oid_cmp(daos_unit_oid_t *a, daos_unit_oid_t *b)
+{
+	return memcmp(a, b, sizeof(*a));
+}
+
 static inline bool
 keys_are_same(daos_key_t key1, daos_key_t key2)
 {
@@ -659,6 +1038,14 @@ obj_iter_scrub_pre_cb(daos_handle_t ih, vos_iter_entry_t *entry,
 
 	switch (type) {
 	case VOS_ITER_OBJ:
+		if (ctx->sc_batch->sb_resume) {
+			/* Skip the objects up to the cursor, see vos_scrub_cursor_set() */
+			if (sc_oid_cmp(&entry->ie_oid, &ctx->sc_batch->sb_resume_oid) <= 0) {
+				*acts |= VOS_ITER_CB_SKIP;
+				break;
+			}
+			ctx->sc_batch->sb_resume = false;
+		}
 		if (oids_are_same(ctx->sc_cur_oid, entry->ie_oid)) {
 			*acts |= VOS_ITER_CB_SKIP;
 			memset(&ctx->sc_cur_oid, 0, sizeof(ctx->sc_cur_oid));
@@ -696,7 +1083,7 @@ obj_iter_scrub_pre_cb(daos_handle_t ih, vos_iter_entry_t *entry,
 		} else {
 			sc_obj_val_setup(ctx, entry, type, param, ih);
 
-			rc = sc_verify_obj_value(ctx, &entry->ie_biov, ih);
+			rc = sc_batch_add(ctx, ih, entry, type, param);
 
 			if (rc != 0) {
 				D_ERROR("Error Verifying:"DF_RC"\n", DP_RC(rc));
@@ -715,6 +1102,48 @@ obj_iter_scrub_pre_cb(daos_handle_t ih, vos_iter_entry_t *entry,
 	return 0;
 }
 
+/** vos_iter_cb_t */
+static int
+obj_iter_scrub_post_cb(daos_handle_t ih, vos_iter_entry_t *entry,
+		       vos_iter_type_t type, vos_iter_param_t *param,
+		       void *cb_arg, unsigned int *acts)
+{
+	struct scrub_ctx	*ctx = cb_arg;
+	struct scrub_batch	*sb = ctx->sc_batch;
+	uint64_t		 now;
+	int			 rc;
+
+	switch (type) {
+	case VOS_ITER_AKEY:
+		/* verify what's left of the akey */
+		rc = sc_batch_flush(ctx);
+		if (rc != 0) {
+			D_ERROR("Error Verifying:"DF_RC"\n", DP_RC(rc));
+			return rc;
+		}
+		break;
+	case VOS_ITER_OBJ:
+		/*
+		 * All the akeys of the object have been iterated and their
+		 * values verified. Only record an object scrubbed by this pass
+		 * with nothing left queued.
+		 */
+		if (sb->sb_resume || sb->sb_nr != 0 ||
+		    !oids_are_same(ctx->sc_cur_oid, entry->ie_oid))
+			break;
+		now = daos_gettime_coarse();
+		if (now - sb->sb_cursor_ts >= SC_CURSOR_INTVL) {
+			sc_cursor_save(ctx, &entry->ie_oid);
+			sb->sb_cursor_ts = now;
+		}
+		break;
+	default:
+		break;
+	}
+
+	return 0;
+}
+
 static int
 sc_scrub_cont(struct scrub_ctx *ctx)
 {
@@ -738,7 +1167,9 @@ sc_scrub_cont(struct scrub_ctx *ctx)
 	 * this case. srv_csum.c has some logic that might be useful/reused.
 	 */
 	rc = vos_iterate(&param, VOS_ITER_OBJ, true, &anchor,
-			 obj_iter_scrub_pre_cb, NULL, ctx, NULL);
+			 obj_iter_scrub_pre_cb, obj_iter_scrub_post_cb, ctx, NULL);
+	/* Iteration aborted with values queued */
+	sc_batch_reset(ctx->sc_batch);
 
 	if (rc != DER_SUCCESS) {
 		if (rc == -DER_INPROGRESS)
@@ -796,6 +1227,19 @@ cont_iter_scrub_cb(daos_handle_t ih, vos_iter_entry_t *entry,
 
 	D_ASSERT(type == VOS_ITER_COUUID);
 
+	if (ctx->sc_batch->sb_resume) {
+		/* Skip the containers before the cursor, see vos_scrub_cursor_set() */
+		rc = memcmp(entry->ie_couuid, ctx->sc_batch->sb_resume_cont, sizeof(uuid_t));
+		if (rc < 0) {
+			*acts = VOS_ITER_CB_SKIP;
+			return 0;
+		}
+		/* The container of the cursor is gone, resume with the next one */
+		if (rc > 0)
+			ctx->sc_batch->sb_resume = false;
+		rc = 0;
+	}
+
 	if (uuids_are_same(*sc_cont_uuid(ctx), entry->ie_couuid)) {
 		*acts = VOS_ITER_CB_SKIP;
 		uuid_clear(ctx->sc_cont_uuid);
@@ -808,6 +1252,8 @@ cont_iter_scrub_cb(daos_handle_t ih, vos_iter_entry_t *entry,
 		}
 
 		rc = sc_scrub_cont(ctx);
+		/* Past the container of the cursor, scrub everything from now on */
+		ctx->sc_batch->sb_resume = false;
 
 		sc_cont_teardown(ctx);
 		*acts = VOS_ITER_CB_YIELD;
@@ -839,6 +1285,7 @@ sc_pool_start(struct scrub_ctx *ctx)
 	sc_scrub_bytes_scrubbed_reset(ctx);
 	ctx->sc_status = SCRUB_STATUS_RUNNING;
 	sc_reset_iterator_checks(ctx);
+	sc_cursor_load(ctx);
 }
 
 static void
@@ -848,6 +1295,18 @@ sc_pool_stop(struct scrub_ctx *ctx)
 	ctx->sc_status = SCRUB_STATUS_NOT_RUNNING;
 }
 
+static int
+sc_scrub_pool_conts(struct scrub_ctx *ctx)
+{
+	vos_iter_param_t	param = {0};
+	struct vos_iter_anchors	anchor = {0};
+
+	param.ip_hdl = ctx->sc_vos_pool_hdl;
+	param.ip_epr.epr_hi = DAOS_EPOCH_MAX;
+	return vos_iterate(&param, VOS_ITER_COUUID, false, &anchor,
+			   NULL, cont_iter_scrub_cb, ctx, NULL);
+}
+
 /* structure for the cont_iter_is_loaded_cb args */
 struct cont_are_loaded_args {
 	struct scrub_ctx	*args_ctx;
@@ -917,8 +1376,6 @@ sc_ensure_containers_are_loaded(struct scrub_ctx *ctx)
 int
 vos_scrub_pool(struct scrub_ctx *ctx)
 {
-	vos_iter_param_t	param = {0};
-	struct vos_iter_anchors	anchor = {0};
 	int			rc = 0;
 
 	ctx->sc_status = SCRUB_STATUS_NOT_RUNNING;
@@ -936,14 +1393,19 @@ vos_scrub_pool(struct scrub_ctx *ctx)
 		return rc;
 	}
 
+	rc = sc_batch_init(ctx);
+	if (rc != 0)
+		return rc;
+
 	sc_pool_start(ctx);
 
-	param.ip_hdl = ctx->sc_vos_pool_hdl;
-	param.ip_epr.epr_hi = DAOS_EPOCH_MAX;
-	rc = vos_iterate(&param, VOS_ITER_COUUID, false, &anchor,
-			 NULL, cont_iter_scrub_cb, ctx, NULL);
+	rc = sc_scrub_pool_conts(ctx);
 	sc_scrub_count_inc(ctx);
 	sc_pool_stop(ctx);
+	/* Pass completed, start over from the beginning after restart */
+	if (rc == 0)
+		sc_cursor_save(ctx, NULL);
+	sc_batch_fini(ctx);
 	if (rc == SCRUB_POOL_OFF)
 		return 0;
 
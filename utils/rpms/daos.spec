@@ -511,6 +511,7 @@ getent passwd daos_agent >/dev/null || useradd -s /sbin/nologin -r -g daos_agent
 %{_bindir}/pl_bench
 %{_bindir}/rdbt
 %{_bindir}/ring_pl_map
+%{_bindir}/straw_pl_map
 %{_bindir}/smd_ut
 %{_bindir}/srv_checksum_tests
 %{_bindir}/pool_scrubbing_tests
@@ -519,6 +520,7 @@ getent passwd daos_agent >/dev/null || useradd -s /sbin/nologin -r -g daos_agent
 %{_bindir}/vea_stress
 %{_bindir}/obj_ctl
 %{_bindir}/vos_perf
+%{_bindir}/vos_bench
 
 %files devel
 %doc README.md
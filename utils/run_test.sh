@@ -192,6 +192,9 @@ if [ -d "/mnt/daos" ]; then
     run_test "${SL_BUILD_DIR}/src/tests/ftest/cart/utest/test_linkage"
     run_test "${SL_BUILD_DIR}/src/tests/ftest/cart/utest/utest_hlc"
     run_test "${SL_BUILD_DIR}/src/tests/ftest/cart/utest/utest_swim"
+    run_test "${SL_BUILD_DIR}/src/tests/ftest/cart/utest/utest_domain"
+    run_test "${SL_BUILD_DIR}/src/tests/ftest/cart/utest/utest_timer_wheel"
+    run_test "${SL_BUILD_DIR}/src/tests/ftest/cart/utest/utest_desc_pool"
 
     COMP="UTEST_gurt"
     run_test "${SL_BUILD_DIR}/src/gurt/tests/test_gurt"